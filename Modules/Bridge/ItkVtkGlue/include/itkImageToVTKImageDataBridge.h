@@ -0,0 +1,174 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageToVTKImageDataBridge_h
+#define __itkImageToVTKImageDataBridge_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkConceptChecking.h"
+#include "itkImageRegionSpans.h"
+#include "vtkImageData.h"
+
+namespace itk
+{
+
+/** \class ImageToVTKImageDataBridge
+ * \brief Shares the pixel buffer of an ITK image with a vtkImageData.
+ *
+ * ImageToVTKImageFilter connects the ITK and VTK pipelines through
+ * callbacks, which run again at each update of the VTK pipeline, and
+ * leaves the VTK image pointing to the ITK buffer whatever the lifetime
+ * of the ITK image.  ImageToVTKImageDataBridge gives a vtkImageData whose
+ * scalar array is the pixel container of the ITK image itself, without
+ * any copy:
+ *
+ *   - the scalar array holds a reference to the ITK pixel container, which
+ *     is released when the array is deleted, so the container stays alive
+ *     as long as VTK uses it, even after the ITK image and the bridge are
+ *     deleted.  The buffer itself is only valid until the container
+ *     replaces it: when the image gets a new buffer, even in the same
+ *     container as with ImportImageContainer::Reserve(), the scalars point
+ *     to freed memory until the next Update();
+ *
+ *   - Update() updates the ITK image and shares its buffer again only if
+ *     the image got a new buffer or buffered region.  Otherwise only the
+ *     modification of the data is signaled to VTK.
+ *
+ * The pixels modified in place, outside of the ITK pipeline, are declared
+ * with AddModifiedRegion() before Update().  GetModifiedExtent() then
+ * gives the VTK extent of the pixels modified since the previous Update(),
+ * so that the consumers of the VTK image, like a texture, only need to
+ * reload this extent.  When the image is regenerated by its pipeline, the
+ * whole buffered extent is modified.
+ *
+ * The direction of the image is ignored, as in VTKImageExport.  The image
+ * must give a direct access to its buffer: image adaptors and VectorImage
+ * are not supported, which the concept checking reports at compile time.
+ *
+ * \sa ImageToVTKImageFilter
+ * \ingroup   ITK-ItkVtkGlue
+ */
+template <class TInputImage >
+class ITK_EXPORT ImageToVTKImageDataBridge : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToVTKImageDataBridge Self;
+  typedef Object                    Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageToVTKImageDataBridge, Object);
+
+  /** Some typedefs. */
+  typedef TInputImage                                 InputImageType;
+  typedef typename InputImageType::ConstPointer       InputImagePointer;
+  typedef typename InputImageType::RegionType         RegionType;
+  typedef typename InputImageType::PixelType          PixelType;
+  typedef typename InputImageType::PixelContainer     PixelContainerType;
+  typedef typename PixelContainerType::ConstPointer   PixelContainerConstPointer;
+
+  itkStaticConstMacro(InputImageDimension, unsigned int,
+                      InputImageType::ImageDimension);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  itkConceptMacro( ImageDimensionCheck,
+                   ( Concept::SameDimensionOrMinusOneOrTwo<
+                     3, itkGetStaticConstMacro(InputImageDimension) > ) );
+  itkConceptMacro( DirectBufferAccessCheck,
+                   ( Concept::HasDirectBufferAccess< InputImageType > ) );
+#endif
+
+  /** Set the input in the form of an itk::Image */
+  void SetInput( const InputImageType * );
+
+  const InputImageType * GetInput() const;
+
+  /** Get the VTK image sharing the buffer of the input, after Update().
+   * The VTK image belongs to the bridge: call Register() on it to keep it
+   * after the bridge is deleted. */
+  vtkImageData * GetOutput() const;
+
+  /** Update the input, and share its buffer with the output or signal the
+   * modification of its pixels. */
+  void Update();
+
+  /** Declare the region of the pixels of the input modified in place since
+   * the previous Update(). */
+  void AddModifiedRegion( const RegionType & region );
+
+  /** VTK extent of the pixels modified by the last Update(), empty
+   * (GetModifiedExtent()[0] > GetModifiedExtent()[1]) if none was. */
+  const int * GetModifiedExtent() const
+  { return m_ModifiedExtent; }
+
+  /** Number of times the buffer of the input was shared with the output.
+   * It only increases when the input gets a new buffer. */
+  itkGetConstMacro(NumberOfSharedBuffers, unsigned long);
+
+protected:
+  ImageToVTKImageDataBridge();
+  virtual ~ImageToVTKImageDataBridge();
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ImageToVTKImageDataBridge(const Self&); //purposely not implemented
+  void operator=(const Self&);            //purposely not implemented
+
+  /** Make the output use the buffer of the input */
+  void ShareBuffer();
+
+  /** Copy the geometry of the input to the output */
+  void CopyGeometry();
+
+  /** Extent of a region of the input */
+  static void ComputeExtent( const RegionType & region, int extent[6] );
+
+  /** Called when the scalar array of the output is deleted, to release
+   * the pixel container it references */
+  static void ReleasePixelContainer(vtkObject *, unsigned long, void *clientData, void *);
+
+  InputImagePointer           m_Input;
+  vtkImageData *              m_Output;
+
+  /** The pixel container and the region shared with the output */
+  PixelContainerConstPointer  m_SharedPixelContainer;
+  const PixelType *           m_SharedBuffer;
+  RegionType                  m_SharedRegion;
+  unsigned long               m_SharedMTime;
+  unsigned long               m_NumberOfSharedBuffers;
+
+  /** Extent of the regions declared with AddModifiedRegion() */
+  bool                        m_RegionModified;
+  int                         m_DeclaredExtent[6];
+
+  int                         m_ModifiedExtent[6];
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToVTKImageDataBridge.txx"
+#endif
+
+#endif
@@ -0,0 +1,325 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageToVTKImageDataBridge_txx
+#define __itkImageToVTKImageDataBridge_txx
+
+#include "itkImageToVTKImageDataBridge.h"
+#include "itkPixelTraits.h"
+
+#include "vtkCallbackCommand.h"
+#include "vtkDataArray.h"
+#include "vtkPointData.h"
+#include "vtkTypeTraits.h"
+#include "vtkVersion.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+/**
+ * Constructor
+ */
+template <class TInputImage>
+ImageToVTKImageDataBridge<TInputImage>
+::ImageToVTKImageDataBridge()
+{
+  m_Output = vtkImageData::New();
+  m_SharedBuffer = 0;
+  m_SharedMTime = 0;
+  m_NumberOfSharedBuffers = 0;
+  m_RegionModified = false;
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    m_DeclaredExtent[2 * i] = 0;
+    m_DeclaredExtent[2 * i + 1] = -1;
+    m_ModifiedExtent[2 * i] = 0;
+    m_ModifiedExtent[2 * i + 1] = -1;
+    }
+}
+
+/**
+ * Destructor
+ */
+template <class TInputImage>
+ImageToVTKImageDataBridge<TInputImage>
+::~ImageToVTKImageDataBridge()
+{
+  // the scalars, and so the pixel container, may still be used by VTK
+  if( m_Output )
+    {
+    m_Output->Delete();
+    m_Output = 0;
+    }
+}
+
+/**
+ * Set an itk::Image as input
+ */
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::SetInput( const InputImageType * inputImage )
+{
+  if ( m_Input.GetPointer() != inputImage )
+    {
+    m_Input = inputImage;
+    this->Modified();
+    }
+}
+
+template <class TInputImage>
+const typename ImageToVTKImageDataBridge<TInputImage>::InputImageType *
+ImageToVTKImageDataBridge<TInputImage>
+::GetInput() const
+{
+  return m_Input.GetPointer();
+}
+
+/**
+ * Get a vtkImage as output
+ */
+template <class TInputImage>
+vtkImageData *
+ImageToVTKImageDataBridge<TInputImage>
+::GetOutput() const
+{
+  return m_Output;
+}
+
+/**
+ * Declare a region modified in place
+ */
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::AddModifiedRegion( const RegionType & region )
+{
+  int extent[6];
+  Self::ComputeExtent( region, extent );
+
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    if ( extent[2 * i] > extent[2 * i + 1] )
+      {
+      return;
+      }
+    }
+  if ( !m_RegionModified )
+    {
+    std::copy( extent, extent + 6, m_DeclaredExtent );
+    m_RegionModified = true;
+    return;
+    }
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    m_DeclaredExtent[2 * i] = std::min( m_DeclaredExtent[2 * i], extent[2 * i] );
+    m_DeclaredExtent[2 * i + 1] = std::max( m_DeclaredExtent[2 * i + 1], extent[2 * i + 1] );
+    }
+}
+
+/**
+ * Update the input and share its buffer
+ */
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::Update()
+{
+  if ( !m_Input )
+    {
+    itkExceptionMacro(<< "The input is not set");
+    }
+
+  // as VTKImageExport, update the input through its const pointer
+  InputImageType *input = const_cast< InputImageType * >( m_Input.GetPointer() );
+  input->Update();
+
+  const RegionType & bufferedRegion = input->GetBufferedRegion();
+  int                bufferedExtent[6];
+  Self::ComputeExtent( bufferedRegion, bufferedExtent );
+
+  if ( input->GetPixelContainer() != m_SharedPixelContainer.GetPointer()
+       || input->GetBufferPointer() != m_SharedBuffer
+       || bufferedRegion != m_SharedRegion )
+    {
+    // a new buffer: the scalars of the output are replaced
+    this->ShareBuffer();
+    std::copy( bufferedExtent, bufferedExtent + 6, m_ModifiedExtent );
+    }
+  else if ( input->GetMTime() != m_SharedMTime || m_RegionModified )
+    {
+    // the same buffer: VTK only needs to know that it was modified
+    if ( input->GetMTime() != m_SharedMTime )
+      {
+      // regenerated by the pipeline, or modified as a whole
+      std::copy( bufferedExtent, bufferedExtent + 6, m_ModifiedExtent );
+      }
+    else
+      {
+      for ( unsigned int i = 0; i < 3; ++i )
+        {
+        m_ModifiedExtent[2 * i] = std::max( m_DeclaredExtent[2 * i], bufferedExtent[2 * i] );
+        m_ModifiedExtent[2 * i + 1] = std::min( m_DeclaredExtent[2 * i + 1], bufferedExtent[2 * i + 1] );
+        }
+      }
+    this->CopyGeometry();
+    m_Output->GetPointData()->GetScalars()->Modified();
+    m_Output->Modified();
+    }
+  else
+    {
+    for ( unsigned int i = 0; i < 3; ++i )
+      {
+      m_ModifiedExtent[2 * i] = 0;
+      m_ModifiedExtent[2 * i + 1] = -1;
+      }
+    }
+
+  m_SharedMTime = input->GetMTime();
+  m_RegionModified = false;
+}
+
+/**
+ * Make the output use the buffer of the input
+ */
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::ShareBuffer()
+{
+  typedef typename PixelTraits< PixelType >::ValueType ValueType;
+  const int numberOfComponents = PixelTraits< PixelType >::Dimension;
+
+  const PixelContainerType *container = m_Input->GetPixelContainer();
+  const RegionType &        bufferedRegion = m_Input->GetBufferedRegion();
+  const vtkIdType           numberOfValues =
+    static_cast< vtkIdType >( bufferedRegion.GetNumberOfPixels() ) * numberOfComponents;
+
+  // VTK must not free the buffer (save = 1): the pixel container does
+  vtkDataArray *scalars = vtkDataArray::CreateDataArray( vtkTypeTraits< ValueType >::VTKTypeID() );
+  scalars->SetNumberOfComponents(numberOfComponents);
+  scalars->SetVoidArray( const_cast< PixelType * >( m_Input->GetBufferPointer() ), numberOfValues, 1 );
+
+  // the scalars hold a reference to the pixel container until they are
+  // deleted, whoever holds them last
+  container->Register();
+  vtkCallbackCommand *release = vtkCallbackCommand::New();
+  release->SetCallback(&Self::ReleasePixelContainer);
+  release->SetClientData( const_cast< PixelContainerType * >( container ) );
+  scalars->AddObserver(vtkCommand::DeleteEvent, release);
+  release->Delete();
+
+  int extent[6];
+  Self::ComputeExtent( bufferedRegion, extent );
+  m_Output->SetExtent(extent);
+#if VTK_MAJOR_VERSION <= 5
+  m_Output->SetWholeExtent(extent);
+  m_Output->SetUpdateExtent(extent);
+  m_Output->SetScalarType( vtkTypeTraits< ValueType >::VTKTypeID() );
+  m_Output->SetNumberOfScalarComponents(numberOfComponents);
+#endif
+  this->CopyGeometry();
+  m_Output->GetPointData()->SetScalars(scalars);
+  scalars->Delete();
+  m_Output->Modified();
+
+  m_SharedPixelContainer = container;
+  m_SharedBuffer = m_Input->GetBufferPointer();
+  m_SharedRegion = bufferedRegion;
+  ++m_NumberOfSharedBuffers;
+}
+
+/**
+ * Copy the spacing and the origin of the input to the output
+ */
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::CopyGeometry()
+{
+  double spacing[3];
+  double origin[3];
+
+  unsigned int i = 0;
+  for (; i < InputImageDimension; ++i )
+    {
+    spacing[i] = static_cast< double >( m_Input->GetSpacing()[i] );
+    origin[i] = static_cast< double >( m_Input->GetOrigin()[i] );
+    }
+  for (; i < 3; ++i )
+    {
+    spacing[i] = 1;
+    origin[i] = 0;
+    }
+  m_Output->SetSpacing(spacing);
+  m_Output->SetOrigin(origin);
+}
+
+/**
+ * Extent of a region of the input
+ */
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::ComputeExtent( const RegionType & region, int extent[6] )
+{
+  unsigned int i = 0;
+  for (; i < InputImageDimension; ++i )
+    {
+    extent[2 * i] = static_cast< int >( region.GetIndex()[i] );
+    extent[2 * i + 1] = static_cast< int >( region.GetIndex()[i] + region.GetSize()[i] ) - 1;
+    }
+  for (; i < 3; ++i )
+    {
+    extent[2 * i] = 0;
+    extent[2 * i + 1] = 0;
+    }
+}
+
+/**
+ * Release the reference of deleted scalars to their pixel container
+ */
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::ReleasePixelContainer(vtkObject *, unsigned long, void *clientData, void *)
+{
+  static_cast< const PixelContainerType * >( clientData )->UnRegister();
+}
+
+template <class TInputImage>
+void
+ImageToVTKImageDataBridge<TInputImage>
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Input: " << m_Input.GetPointer() << std::endl;
+  os << indent << "Output: " << m_Output << std::endl;
+  os << indent << "NumberOfSharedBuffers: " << m_NumberOfSharedBuffers << std::endl;
+  os << indent << "ModifiedExtent: [";
+  for ( unsigned int i = 0; i < 6; ++i )
+    {
+    os << m_ModifiedExtent[i] << ( i < 5 ? ", " : "]" );
+    }
+  os << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageToVTKImageDataBridge.h"
+
+#include "itkImage.h"
+#include "itkRandomImageSource.h"
+#include "vtkDataArray.h"
+#include "vtkPointData.h"
+
+// The VTK image must use the buffer of the ITK image without copy, report
+// only the modified extents, and keep the buffer alive after the ITK image
+// and the bridge are deleted.
+
+namespace
+{
+bool CheckExtent(const int *extent, int x0, int x1, int y0, int y1, int z0, int z1)
+{
+  const int expected[6] = { x0, x1, y0, y1, z0, z1 };
+  for ( unsigned int i = 0; i < 6; ++i )
+    {
+    if ( extent[i] != expected[i] )
+      {
+      std::cerr << "Modified extent: [" << extent[0] << ", " << extent[1] << ", "
+                << extent[2] << ", " << extent[3] << ", " << extent[4] << ", "
+                << extent[5] << "] instead of [" << x0 << ", " << x1 << ", "
+                << y0 << ", " << y1 << ", " << z0 << ", " << z1 << "]" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageToVTKImageDataBridgeTest(int, char *[])
+{
+  typedef itk::Image< float, 3 >                    ImageType;
+  typedef itk::RandomImageSource< ImageType >       SourceType;
+  typedef itk::ImageToVTKImageDataBridge<ImageType> BridgeType;
+
+  ImageType::SizeType size;
+  size[0] = 20;
+  size[1] = 16;
+  size[2] = 8;
+  SourceType::Pointer source = SourceType::New();
+  source->SetSize(size);
+
+  ImageType::Pointer image = source->GetOutput();
+
+  BridgeType::Pointer bridge = BridgeType::New();
+  bridge->SetInput(image);
+  bridge->Update();
+
+  vtkImageData *vtkImage = bridge->GetOutput();
+  vtkDataArray *scalars = vtkImage->GetPointData()->GetScalars();
+  if ( !scalars || scalars->GetVoidPointer(0) != image->GetBufferPointer() )
+    {
+    std::cerr << "The VTK image does not use the ITK buffer" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int *dimensions = vtkImage->GetDimensions();
+  if ( dimensions[0] != 20 || dimensions[1] != 16 || dimensions[2] != 8
+       || scalars->GetNumberOfTuples() != 20 * 16 * 8 )
+    {
+    std::cerr << "Wrong dimensions of the VTK image" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !CheckExtent(bridge->GetModifiedExtent(), 0, 19, 0, 15, 0, 7) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // nothing modified
+  unsigned long vtkMTime = vtkImage->GetMTime();
+  bridge->Update();
+  if ( !CheckExtent(bridge->GetModifiedExtent(), 0, -1, 0, -1, 0, -1)
+       || vtkImage->GetMTime() != vtkMTime )
+    {
+    std::cerr << "The VTK image was modified without change" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // pixels modified in place are seen by VTK, only their extent is reported
+  ImageType::SizeType onePixel;
+  onePixel.Fill(1);
+  ImageType::IndexType index;
+  index[0] = 3;
+  index[1] = 4;
+  index[2] = 5;
+  image->SetPixel(index, 1234.0f);
+  bridge->AddModifiedRegion( ImageType::RegionType(index, onePixel) );
+  index[0] = 7;
+  image->SetPixel(index, 4321.0f);
+  bridge->AddModifiedRegion( ImageType::RegionType(index, onePixel) );
+  bridge->Update();
+
+  if ( !CheckExtent(bridge->GetModifiedExtent(), 3, 7, 4, 4, 5, 5) )
+    {
+    return EXIT_FAILURE;
+    }
+  if ( vtkImage->GetMTime() == vtkMTime || bridge->GetNumberOfSharedBuffers() != 1 )
+    {
+    std::cerr << "The modification was not signaled to VTK, or the buffer was shared again" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( vtkImage->GetScalarComponentAsDouble(3, 4, 5, 0) != 1234.0
+       || vtkImage->GetScalarComponentAsDouble(7, 4, 5, 0) != 4321.0 )
+    {
+    std::cerr << "The modified pixels are not seen by VTK" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // regenerated by the pipeline: the whole image is modified
+  source->Modified();
+  bridge->Update();
+  if ( !CheckExtent(bridge->GetModifiedExtent(), 0, 19, 0, 15, 0, 7) )
+    {
+    return EXIT_FAILURE;
+    }
+  scalars = vtkImage->GetPointData()->GetScalars();
+  if ( scalars->GetVoidPointer(0) != image->GetBufferPointer() )
+    {
+    std::cerr << "The VTK image does not use the regenerated ITK buffer" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  bridge->Print(std::cout);
+
+  // the VTK image keeps the pixel container after the ITK objects are deleted
+  ImageType::PixelContainerPointer container = image->GetPixelContainer();
+  const float                      value = image->GetPixel(index);
+  vtkImage->Register(0);
+  bridge = 0;
+  image = 0;
+  source = 0;
+
+  if ( container->GetReferenceCount() != 2 )
+    {
+    std::cerr << "The VTK image holds " << container->GetReferenceCount() - 1
+              << " references to the pixel container instead of 1" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( vtkImage->GetScalarComponentAsDouble(7, 4, 5, 0) != value )
+    {
+    std::cerr << "The VTK image lost its buffer" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // and releases it when it is deleted
+  vtkImage->Delete();
+  if ( container->GetReferenceCount() != 1 )
+    {
+    std::cerr << "The pixel container was not released by VTK" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkAtomicIntegerDetail_h
+#define __itkAtomicIntegerDetail_h
+
+#include "itkMacro.h"
+
+// Select the lock-free atomic operations of the target, in order:
+// - the __sync builtins of gcc 4.3 and later, clang and the Intel compiler,
+//   whatever the standard library;
+// - the Interlocked functions of Windows;
+// - the OSAtomic functions of Mac OS X 10.5 and later.
+// ITK_HAVE_ATOMIC_INTEGER is left undefined when none of them is available,
+// in which case the counters must be protected by a lock.
+#if defined( __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4 ) \
+  && ( !defined( __LP64__ ) || defined( __GCC_HAVE_SYNC_COMPARE_AND_SWAP_8 ) ) \
+  && !defined( __GCCXML__ )
+  #define ITK_HAVE_ATOMIC_INTEGER
+  #define ITK_ATOMIC_INTEGER_USE_SYNC_BUILTINS
+
+#elif defined( _WIN32 )
+  #include "itkWindows.h"
+  #define ITK_HAVE_ATOMIC_INTEGER
+  #define ITK_ATOMIC_INTEGER_USE_INTERLOCKED
+
+#elif defined( __APPLE__ )
+  #include <AvailabilityMacros.h>
+  #if MAC_OS_X_VERSION_MIN_REQUIRED >= 1050
+    #include <libkern/OSAtomic.h>
+    #define ITK_HAVE_ATOMIC_INTEGER
+    #define ITK_ATOMIC_INTEGER_USE_OSATOMIC
+  #endif
+#endif
+
+namespace itk
+{
+/** \brief Lock-free increment and decrement of the integers shared by
+ * threads, used for the reference counts of the objects and the global
+ * modified time.
+ *
+ * Increment() and Decrement() return the new value and are full memory
+ * barriers.
+ *
+ * \ingroup ITK-Common
+ */
+namespace AtomicIntegerDetail
+{
+#if defined( ITK_ATOMIC_INTEGER_USE_SYNC_BUILTINS )
+
+typedef int           ReferenceCountType;
+typedef unsigned long ModifiedTimeType;
+
+template< class T >
+inline T Increment(volatile T *value)
+{
+  return __sync_add_and_fetch(value, 1);
+}
+
+template< class T >
+inline T Decrement(volatile T *value)
+{
+  return __sync_sub_and_fetch(value, 1);
+}
+
+#elif defined( ITK_ATOMIC_INTEGER_USE_INTERLOCKED )
+
+typedef LONG ReferenceCountType;
+typedef LONG ModifiedTimeType;
+
+inline LONG Increment(volatile LONG *value)
+{
+  return InterlockedIncrement(value);
+}
+
+inline LONG Decrement(volatile LONG *value)
+{
+  return InterlockedDecrement(value);
+}
+
+#elif defined( ITK_ATOMIC_INTEGER_USE_OSATOMIC )
+
+#if defined ( __LP64__ ) && __LP64__
+typedef int64_t ReferenceCountType;
+typedef int64_t ModifiedTimeType;
+#else
+typedef int32_t ReferenceCountType;
+typedef int32_t ModifiedTimeType;
+#endif
+
+inline int32_t Increment(volatile int32_t *value)
+{
+  return OSAtomicIncrement32Barrier(value);
+}
+
+inline int32_t Decrement(volatile int32_t *value)
+{
+  return OSAtomicDecrement32Barrier(value);
+}
+
+inline int64_t Increment(volatile int64_t *value)
+{
+  return OSAtomicIncrement64Barrier(value);
+}
+
+inline int64_t Decrement(volatile int64_t *value)
+{
+  return OSAtomicDecrement64Barrier(value);
+}
+
+#else
+
+typedef int           ReferenceCountType;
+typedef unsigned long ModifiedTimeType;
+
+#endif
+} // end namespace AtomicIntegerDetail
+} // end namespace itk
+
+#endif
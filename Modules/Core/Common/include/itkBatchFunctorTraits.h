@@ -0,0 +1,576 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBatchFunctorTraits_h
+#define __itkBatchFunctorTraits_h
+
+#include "itkNumericTraits.h"
+#include <algorithm>
+
+#if ( defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) ) \
+  && !defined( __GCCXML__ )
+#include <emmintrin.h> // sse 2 intrinsics
+#define ITK_BATCH_FUNCTOR_USE_SSE2 1
+#else
+#define ITK_BATCH_FUNCTOR_USE_SSE2 0
+#endif
+
+namespace itk
+{
+/** \class BatchFunctorTraits
+ * \brief Apply a pixel functor to spans of pixels contiguous in memory.
+ *
+ * UnaryFunctorImageFilter, BinaryFunctorImageFilter and
+ * TernaryFunctorImageFilter call their functor through BatchFunctorTraits
+ * when the pixels of their images can be accessed directly in the buffers,
+ * with a pointer to each span of input pixels and to the span of output
+ * pixels (see ImageRegionSpans).  The default implementation calls the
+ * functor on each pixel, in a plain loop over the pointers that the
+ * compiler can inline and vectorize much more easily than the loops over
+ * the image iterators.
+ *
+ * A functor can provide a faster implementation by specializing
+ * BatchFunctorTraits, which must give the same output as the functor called
+ * on each pixel.  The pointers may be equal when a filter runs in place.
+ * The specializations for the arithmetic, minimum and maximum, cast and
+ * threshold functors of ITK use SSE2 instructions for the float and double
+ * pixels, when they are available.
+ *
+ * \sa BinaryBatchFunctorTraits ImageRegionSpans
+ * \ingroup ITK-Common
+ */
+template< class TFunction >
+class BatchFunctorTraits
+{
+public:
+  typedef TFunction FunctorType;
+
+  /** output[i] = functor(input[i]) for i < n */
+  template< class TInput, class TOutput >
+  static void Apply(FunctorType & functor, const TInput *input, TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(input[i]);
+      }
+  }
+
+  /** output[i] = functor(input1[i], input2[i]) for i < n */
+  template< class TInput1, class TInput2, class TOutput >
+  static void Apply(FunctorType & functor, const TInput1 *input1, const TInput2 *input2,
+                    TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(input1[i], input2[i]);
+      }
+  }
+
+  /** output[i] = functor(constant1, input2[i]) for i < n */
+  template< class TInput1, class TInput2, class TOutput >
+  static void ApplyConstant1(FunctorType & functor, const TInput1 & constant1, const TInput2 *input2,
+                             TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(constant1, input2[i]);
+      }
+  }
+
+  /** output[i] = functor(input1[i], constant2) for i < n */
+  template< class TInput1, class TInput2, class TOutput >
+  static void ApplyConstant2(FunctorType & functor, const TInput1 *input1, const TInput2 & constant2,
+                             TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(input1[i], constant2);
+      }
+  }
+
+  /** output[i] = functor(input1[i], input2[i], input3[i]) for i < n */
+  template< class TInput1, class TInput2, class TInput3, class TOutput >
+  static void Apply(FunctorType & functor, const TInput1 *input1, const TInput2 *input2,
+                    const TInput3 *input3, TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(input1[i], input2[i], input3[i]);
+      }
+  }
+};
+
+namespace BatchFunctorDetail
+{
+/** The operations of the binary functors on SSE2 vectors.  They must give
+ * the same results as the functors on each element. */
+struct AddOperation
+{
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+  static __m128 Evaluate(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+  static __m128d Evaluate(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+#endif
+};
+
+struct SubtractOperation
+{
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+  static __m128 Evaluate(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+  static __m128d Evaluate(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+#endif
+};
+
+struct MultiplyOperation
+{
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+  static __m128 Evaluate(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+  static __m128d Evaluate(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+#endif
+};
+
+/** a / b, or the largest value where b is zero.  The zeros are replaced by
+ * ones before the division, not to raise floating point exceptions. */
+struct DivideOperation
+{
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+  static __m128 Evaluate(__m128 a, __m128 b)
+  {
+    const __m128 nonzero = _mm_cmpneq_ps( b, _mm_setzero_ps() );
+    const __m128 divisor = _mm_or_ps( _mm_and_ps(nonzero, b), _mm_andnot_ps( nonzero, _mm_set1_ps(1.0f) ) );
+    const __m128 maximum = _mm_set1_ps( NumericTraits< float >::max() );
+
+    return _mm_or_ps( _mm_and_ps( nonzero, _mm_div_ps(a, divisor) ), _mm_andnot_ps(nonzero, maximum) );
+  }
+
+  static __m128d Evaluate(__m128d a, __m128d b)
+  {
+    const __m128d nonzero = _mm_cmpneq_pd( b, _mm_setzero_pd() );
+    const __m128d divisor = _mm_or_pd( _mm_and_pd(nonzero, b), _mm_andnot_pd( nonzero, _mm_set1_pd(1.0) ) );
+    const __m128d maximum = _mm_set1_pd( NumericTraits< double >::max() );
+
+    return _mm_or_pd( _mm_and_pd( nonzero, _mm_div_pd(a, divisor) ), _mm_andnot_pd(nonzero, maximum) );
+  }
+#endif
+};
+
+/** (a < b) ? a : b, which is what minps computes, NaN included */
+struct MinimumOperation
+{
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+  static __m128 Evaluate(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+  static __m128d Evaluate(__m128d a, __m128d b) { return _mm_min_pd(a, b); }
+#endif
+};
+
+/** (a > b) ? a : b */
+struct MaximumOperation
+{
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+  static __m128 Evaluate(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+  static __m128d Evaluate(__m128d a, __m128d b) { return _mm_max_pd(a, b); }
+#endif
+};
+
+/** Spans of a binary operation, computed by the functor in general */
+template< class TOperation, class TInput1, class TInput2, class TOutput >
+struct BinaryKernel
+{
+  template< class TFunction >
+  static void Apply(TFunction & functor, const TInput1 *input1, const TInput2 *input2,
+                    TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(input1[i], input2[i]);
+      }
+  }
+
+  template< class TFunction >
+  static void ApplyConstant1(TFunction & functor, const TInput1 & constant1, const TInput2 *input2,
+                             TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(constant1, input2[i]);
+      }
+  }
+
+  template< class TFunction >
+  static void ApplyConstant2(TFunction & functor, const TInput1 *input1, const TInput2 & constant2,
+                             TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(input1[i], constant2);
+      }
+  }
+};
+
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+/** Loads and stores of the SSE2 vectors of float and double */
+template< class T >
+struct SSE2Vector;
+
+template< >
+struct SSE2Vector< float >
+{
+  typedef __m128 Type;
+  itkStaticConstMacro(Length, unsigned int, 4);
+  static Type Load(const float *p) { return _mm_loadu_ps(p); }
+  static Type Broadcast(float value) { return _mm_set1_ps(value); }
+  static void Store(float *p, Type v) { _mm_storeu_ps(p, v); }
+};
+
+template< >
+struct SSE2Vector< double >
+{
+  typedef __m128d Type;
+  itkStaticConstMacro(Length, unsigned int, 2);
+  static Type Load(const double *p) { return _mm_loadu_pd(p); }
+  static Type Broadcast(double value) { return _mm_set1_pd(value); }
+  static void Store(double *p, Type v) { _mm_storeu_pd(p, v); }
+};
+
+/** Spans of a binary operation on pixels of the same floating point type,
+ * computed by vectors, and by the functor for the last pixels */
+template< class TOperation, class T >
+struct SSE2BinaryKernel
+{
+  typedef SSE2Vector< T > VectorType;
+
+  template< class TFunction >
+  static void Apply(TFunction & functor, const T *input1, const T *input2, T *output, SizeValueType n)
+  {
+    SizeValueType i = 0;
+
+    for (; i + VectorType::Length <= n; i += VectorType::Length )
+      {
+      VectorType::Store( output + i,
+                         TOperation::Evaluate( VectorType::Load(input1 + i), VectorType::Load(input2 + i) ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = functor(input1[i], input2[i]);
+      }
+  }
+
+  template< class TFunction >
+  static void ApplyConstant1(TFunction & functor, const T & constant1, const T *input2, T *output, SizeValueType n)
+  {
+    const typename VectorType::Type constant = VectorType::Broadcast(constant1);
+    SizeValueType                   i = 0;
+
+    for (; i + VectorType::Length <= n; i += VectorType::Length )
+      {
+      VectorType::Store( output + i, TOperation::Evaluate( constant, VectorType::Load(input2 + i) ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = functor(constant1, input2[i]);
+      }
+  }
+
+  template< class TFunction >
+  static void ApplyConstant2(TFunction & functor, const T *input1, const T & constant2, T *output, SizeValueType n)
+  {
+    const typename VectorType::Type constant = VectorType::Broadcast(constant2);
+    SizeValueType                   i = 0;
+
+    for (; i + VectorType::Length <= n; i += VectorType::Length )
+      {
+      VectorType::Store( output + i, TOperation::Evaluate( VectorType::Load(input1 + i), constant ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = functor(input1[i], constant2);
+      }
+  }
+};
+
+template< class TOperation >
+struct BinaryKernel< TOperation, float, float, float >:
+  public SSE2BinaryKernel< TOperation, float > {};
+
+template< class TOperation >
+struct BinaryKernel< TOperation, double, double, double >:
+  public SSE2BinaryKernel< TOperation, double > {};
+#endif
+
+/** Spans of static_cast< TOutput >( input ) */
+template< class TInput, class TOutput >
+struct ConvertKernel
+{
+  static void Apply(const TInput *input, TOutput *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = static_cast< TOutput >( input[i] );
+      }
+  }
+};
+
+template< class T >
+struct ConvertKernel< T, T >
+{
+  static void Apply(const T *input, T *output, SizeValueType n)
+  {
+    if ( input != output )
+      {
+      std::copy(input, input + n, output);
+      }
+  }
+};
+
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+/** The integers are widened to 32 bits and converted, exactly for the
+ * types shorter than 32 bits, and rounded like static_cast for int. */
+template< >
+struct ConvertKernel< unsigned char, float >
+{
+  static void Apply(const unsigned char *input, float *output, SizeValueType n)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    SizeValueType i = 0;
+
+    for (; i + 16 <= n; i += 16 )
+      {
+      const __m128i bytes = _mm_loadu_si128( reinterpret_cast< const __m128i * >( input + i ) );
+      const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+      const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+      _mm_storeu_ps( output + i, _mm_cvtepi32_ps( _mm_unpacklo_epi16(low, zero) ) );
+      _mm_storeu_ps( output + i + 4, _mm_cvtepi32_ps( _mm_unpackhi_epi16(low, zero) ) );
+      _mm_storeu_ps( output + i + 8, _mm_cvtepi32_ps( _mm_unpacklo_epi16(high, zero) ) );
+      _mm_storeu_ps( output + i + 12, _mm_cvtepi32_ps( _mm_unpackhi_epi16(high, zero) ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = static_cast< float >( input[i] );
+      }
+  }
+};
+
+template< >
+struct ConvertKernel< short, float >
+{
+  static void Apply(const short *input, float *output, SizeValueType n)
+  {
+    SizeValueType i = 0;
+
+    for (; i + 8 <= n; i += 8 )
+      {
+      // the shorts are moved to the high halves of 32 bits, and shifted
+      // back with their sign
+      const __m128i shorts = _mm_loadu_si128( reinterpret_cast< const __m128i * >( input + i ) );
+      _mm_storeu_ps( output + i, _mm_cvtepi32_ps( _mm_srai_epi32(_mm_unpacklo_epi16(shorts, shorts), 16) ) );
+      _mm_storeu_ps( output + i + 4, _mm_cvtepi32_ps( _mm_srai_epi32(_mm_unpackhi_epi16(shorts, shorts), 16) ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = static_cast< float >( input[i] );
+      }
+  }
+};
+
+template< >
+struct ConvertKernel< unsigned short, float >
+{
+  static void Apply(const unsigned short *input, float *output, SizeValueType n)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    SizeValueType i = 0;
+
+    for (; i + 8 <= n; i += 8 )
+      {
+      const __m128i shorts = _mm_loadu_si128( reinterpret_cast< const __m128i * >( input + i ) );
+      _mm_storeu_ps( output + i, _mm_cvtepi32_ps( _mm_unpacklo_epi16(shorts, zero) ) );
+      _mm_storeu_ps( output + i + 4, _mm_cvtepi32_ps( _mm_unpackhi_epi16(shorts, zero) ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = static_cast< float >( input[i] );
+      }
+  }
+};
+
+template< >
+struct ConvertKernel< int, float >
+{
+  static void Apply(const int *input, float *output, SizeValueType n)
+  {
+    SizeValueType i = 0;
+
+    for (; i + 4 <= n; i += 4 )
+      {
+      _mm_storeu_ps( output + i,
+                     _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast< const __m128i * >( input + i ) ) ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = static_cast< float >( input[i] );
+      }
+  }
+};
+
+template< >
+struct ConvertKernel< float, double >
+{
+  static void Apply(const float *input, double *output, SizeValueType n)
+  {
+    SizeValueType i = 0;
+
+    for (; i + 4 <= n; i += 4 )
+      {
+      const __m128 values = _mm_loadu_ps(input + i);
+      _mm_storeu_pd( output + i, _mm_cvtps_pd(values) );
+      _mm_storeu_pd( output + i + 2, _mm_cvtps_pd( _mm_movehl_ps(values, values) ) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = static_cast< double >( input[i] );
+      }
+  }
+};
+
+template< >
+struct ConvertKernel< double, float >
+{
+  static void Apply(const double *input, float *output, SizeValueType n)
+  {
+    SizeValueType i = 0;
+
+    for (; i + 4 <= n; i += 4 )
+      {
+      const __m128 low = _mm_cvtpd_ps( _mm_loadu_pd(input + i) );
+      const __m128 high = _mm_cvtpd_ps( _mm_loadu_pd(input + i + 2) );
+      _mm_storeu_ps( output + i, _mm_movelh_ps(low, high) );
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = static_cast< float >( input[i] );
+      }
+  }
+};
+#endif
+
+/** Spans of ( lower <= input && input <= upper ) ? inside : outside */
+template< class TInput, class TOutput >
+struct ThresholdKernel
+{
+  static void Apply(const TInput *input, TOutput *output, SizeValueType n,
+                    const TInput & lower, const TInput & upper,
+                    const TOutput & inside, const TOutput & outside)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = ( lower <= input[i] && input[i] <= upper ) ? inside : outside;
+      }
+  }
+};
+
+#if ITK_BATCH_FUNCTOR_USE_SSE2
+/** The comparisons are made by vectors, without branches */
+template< class T, class TOutput >
+struct SSE2ThresholdKernel
+{
+  typedef SSE2Vector< T > VectorType;
+
+  static void Apply(const T *input, TOutput *output, SizeValueType n,
+                    const T & lower, const T & upper,
+                    const TOutput & inside, const TOutput & outside)
+  {
+    const typename VectorType::Type lowerVector = VectorType::Broadcast(lower);
+    const typename VectorType::Type upperVector = VectorType::Broadcast(upper);
+    const TOutput                   values[2] = { outside, inside };
+    SizeValueType                   i = 0;
+
+    for (; i + VectorType::Length <= n; i += VectorType::Length )
+      {
+      const typename VectorType::Type value = VectorType::Load(input + i);
+      const int                       mask = Self::Mask(lowerVector, value, upperVector);
+      for ( unsigned int k = 0; k < VectorType::Length; k++ )
+        {
+        output[i + k] = values[( mask >> k ) & 1];
+        }
+      }
+    for (; i < n; i++ )
+      {
+      output[i] = ( lower <= input[i] && input[i] <= upper ) ? inside : outside;
+      }
+  }
+
+private:
+  typedef SSE2ThresholdKernel Self;
+
+  /** Bit k is set if lower <= value <= upper for the element k */
+  static int Mask(__m128 lower, __m128 value, __m128 upper)
+  { return _mm_movemask_ps( _mm_and_ps( _mm_cmple_ps(lower, value), _mm_cmple_ps(value, upper) ) ); }
+
+  static int Mask(__m128d lower, __m128d value, __m128d upper)
+  { return _mm_movemask_pd( _mm_and_pd( _mm_cmple_pd(lower, value), _mm_cmple_pd(value, upper) ) ); }
+};
+
+template< class TOutput >
+struct ThresholdKernel< float, TOutput >:public SSE2ThresholdKernel< float, TOutput > {};
+
+template< class TOutput >
+struct ThresholdKernel< double, TOutput >:public SSE2ThresholdKernel< double, TOutput > {};
+#endif
+} // end namespace BatchFunctorDetail
+
+/** \class BinaryBatchFunctorTraits
+ * \brief BatchFunctorTraits of a binary functor computing an operation that
+ * can be applied to vectors of pixels.
+ *
+ * TOperation is one of the operations of the BatchFunctorDetail namespace.
+ * The spans of float or double pixels, with the three pixel types equal,
+ * are computed with SSE2 instructions, and the others by the functor.
+ *
+ * \ingroup ITK-Common
+ */
+template< class TFunction, class TOperation >
+class BinaryBatchFunctorTraits
+{
+public:
+  typedef TFunction FunctorType;
+
+  template< class TInput1, class TInput2, class TOutput >
+  static void Apply(FunctorType & functor, const TInput1 *input1, const TInput2 *input2,
+                    TOutput *output, SizeValueType n)
+  {
+    BatchFunctorDetail::BinaryKernel< TOperation, TInput1, TInput2, TOutput >
+    ::Apply(functor, input1, input2, output, n);
+  }
+
+  template< class TInput1, class TInput2, class TOutput >
+  static void ApplyConstant1(FunctorType & functor, const TInput1 & constant1, const TInput2 *input2,
+                             TOutput *output, SizeValueType n)
+  {
+    BatchFunctorDetail::BinaryKernel< TOperation, TInput1, TInput2, TOutput >
+    ::ApplyConstant1(functor, constant1, input2, output, n);
+  }
+
+  template< class TInput1, class TInput2, class TOutput >
+  static void ApplyConstant2(FunctorType & functor, const TInput1 *input1, const TInput2 & constant2,
+                             TOutput *output, SizeValueType n)
+  {
+    BatchFunctorDetail::BinaryKernel< TOperation, TInput1, TInput2, TOutput >
+    ::ApplyConstant2(functor, input1, constant2, output, n);
+  }
+};
+} // end namespace itk
+
+#endif
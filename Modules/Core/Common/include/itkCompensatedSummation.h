@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkCompensatedSummation_h
+#define __itkCompensatedSummation_h
+
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+/** \class CompensatedSummation
+ * \brief Sum of floating point values with a compensation of the rounding
+ * errors.
+ *
+ * The naive sum of N values has an error that grows with N: in double
+ * precision, the sum of the 10^9 voxels of an image loses several digits.
+ * CompensatedSummation keeps the rounding error of each addition in a
+ * separate term (Kahan-Babuska, or Neumaier, summation), so the error of
+ * the sum does not depend on the number of values, at the cost of a few
+ * more floating point operations per value.
+ *
+ * Partial sums, computed for instance by several threads or over several
+ * regions of an image, are combined with operator+=(const Self &).
+ *
+ *     CompensatedSummation< double > sum;
+ *     for ( ... ) { sum += value; }
+ *     double result = sum.GetSum();
+ *
+ * The compensation relies on the exact IEEE rounding of each operation, and
+ * is lost if the code is compiled with options allowing the compiler to
+ * reassociate the floating point operations, like -ffast-math.
+ *
+ * \ingroup ITK-Common
+ */
+template< class TFloat >
+class CompensatedSummation
+{
+public:
+  /** Standard class typedefs. */
+  typedef CompensatedSummation Self;
+
+  /** Type of the values summed. */
+  typedef TFloat FloatType;
+
+  CompensatedSummation():
+    m_Sum(NumericTraits< FloatType >::Zero),
+    m_Compensation(NumericTraits< FloatType >::Zero)
+  {}
+
+  /** Start from a given value. */
+  CompensatedSummation(const FloatType & value):
+    m_Sum(value),
+    m_Compensation(NumericTraits< FloatType >::Zero)
+  {}
+
+  /** Add a value to the sum. */
+  void AddElement(const FloatType & value);
+
+  Self & operator+=(const FloatType & value)
+  {
+    this->AddElement(value);
+    return *this;
+  }
+
+  /** Add a partial sum, with its compensation. */
+  Self & operator+=(const Self & other);
+
+  /** Reset the sum to zero. */
+  void ResetToZero()
+  {
+    m_Sum = NumericTraits< FloatType >::Zero;
+    m_Compensation = NumericTraits< FloatType >::Zero;
+  }
+
+  /** Return the compensated sum. */
+  FloatType GetSum() const
+  { return m_Sum + m_Compensation; }
+
+private:
+  FloatType m_Sum;
+
+  /** Sum of the rounding errors of the additions to m_Sum */
+  FloatType m_Compensation;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkCompensatedSummation.txx"
+#endif
+
+#endif
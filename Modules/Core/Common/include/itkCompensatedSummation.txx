@@ -0,0 +1,56 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkCompensatedSummation_txx
+#define __itkCompensatedSummation_txx
+
+#include "itkCompensatedSummation.h"
+
+namespace itk
+{
+template< class TFloat >
+void
+CompensatedSummation< TFloat >
+::AddElement(const FloatType & value)
+{
+  const FloatType sum = m_Sum + value;
+
+  // the rounding error of the addition is exactly recovered from the
+  // larger of the two terms
+  if ( ( m_Sum < 0 ? -m_Sum : m_Sum ) >= ( value < 0 ? -value : value ) )
+    {
+    m_Compensation += ( m_Sum - sum ) + value;
+    }
+  else
+    {
+    m_Compensation += ( value - sum ) + m_Sum;
+    }
+  m_Sum = sum;
+}
+
+template< class TFloat >
+CompensatedSummation< TFloat > &
+CompensatedSummation< TFloat >
+::operator+=(const Self & other)
+{
+  this->AddElement(other.m_Sum);
+  m_Compensation += other.m_Compensation;
+  return *this;
+}
+} // end namespace itk
+
+#endif
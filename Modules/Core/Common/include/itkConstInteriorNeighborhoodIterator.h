@@ -0,0 +1,197 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkConstInteriorNeighborhoodIterator_h
+#define __itkConstInteriorNeighborhoodIterator_h
+
+#include "itkImage.h"
+#include <vector>
+
+namespace itk
+{
+/** \class ConstInteriorNeighborhoodIterator
+ * \brief Fast const neighborhood iterator for the regions where no boundary
+ * condition is needed.
+ *
+ * ConstInteriorNeighborhoodIterator walks a region of an image like
+ * ConstNeighborhoodIterator, but it requires the neighborhoods of all the
+ * pixels of the region to be inside the buffered region of the image: this
+ * is the case of the first region returned by
+ * NeighborhoodAlgorithm::ImageBoundaryFacesCalculator, or of any region for
+ * which IsInterior() returns true. In exchange, none of its methods is
+ * virtual, the pixels are read without any test of the boundary, and the
+ * iterator only holds the pointer to the center of the neighborhood: the
+ * linear offsets of the neighbors from the center are computed once, by
+ * Initialize(). GetPixel(i) is then one addition and one read, and the
+ * filters can also use GetCenterPointer() and GetNeighborOffsets() directly.
+ *
+ * The neighbors are numbered as in Neighborhood and ConstNeighborhoodIterator,
+ * the first axis varying fastest, so the same operators can be applied.
+ *
+ * For a VectorImage, the pointers and offsets are counted in pixels, and must
+ * be dereferenced with the NeighborhoodAccessorFunctor of the image, as
+ * GetPixel() does.
+ *
+ * \sa ConstNeighborhoodIterator NeighborhoodAlgorithm::ImageBoundaryFacesCalculator
+ * \ingroup ImageIterators
+ * \ingroup ITK-Common
+ */
+template< class TImage >
+class ITK_EXPORT ConstInteriorNeighborhoodIterator
+{
+public:
+  /** Standard class typedefs. */
+  typedef ConstInteriorNeighborhoodIterator Self;
+
+  /** Extract image type information. */
+  itkStaticConstMacro(Dimension, unsigned int, TImage::ImageDimension);
+
+  typedef TImage                                ImageType;
+  typedef typename TImage::RegionType           RegionType;
+  typedef typename TImage::SizeType             SizeType;
+  typedef typename TImage::IndexType            IndexType;
+  typedef typename TImage::OffsetType           OffsetType;
+  typedef typename TImage::PixelType            PixelType;
+  typedef typename TImage::InternalPixelType    InternalPixelType;
+  typedef SizeType                              RadiusType;
+  typedef unsigned int                          NeighborIndexType;
+  typedef std::vector< OffsetValueType >        NeighborOffsetsType;
+
+  typedef typename ImageType::NeighborhoodAccessorFunctorType
+  NeighborhoodAccessorFunctorType;
+
+  /** Default constructor. Initialize() must be called before using the
+   * iterator. */
+  ConstInteriorNeighborhoodIterator();
+
+  /** Constructor calling Initialize() */
+  ConstInteriorNeighborhoodIterator(const RadiusType & radius,
+                                    const ImageType *image,
+                                    const RegionType & region)
+  { this->Initialize(radius, image, region); }
+
+  /** Set the radius, image and region to walk, compute the offsets of the
+   * neighbors, and go to the beginning of the region. Throw an exception if
+   * the region is not interior. */
+  void Initialize(const RadiusType & radius, const ImageType *image,
+                  const RegionType & region);
+
+  /** Return whether the neighborhoods of all the pixels of the region are in
+   * the buffered region of the image */
+  static bool IsInterior(const RadiusType & radius, const ImageType *image,
+                         const RegionType & region);
+
+  /** Move to the first pixel of the region */
+  void GoToBegin();
+
+  /** Return whether the iterator walked past the last pixel of the region */
+  bool IsAtEnd() const
+  { return m_Position[Dimension - 1] >= m_EndIndex[Dimension - 1]; }
+
+  /** Move to the next pixel of the region */
+  Self & operator++()
+  {
+    ++m_Center;
+    if ( ++m_Position[0] >= m_EndIndex[0] )
+      {
+      this->NextLine();
+      }
+    return *this;
+  }
+
+  /** Number of pixels of the neighborhood */
+  NeighborIndexType Size() const
+  { return static_cast< NeighborIndexType >( m_NeighborOffsets.size() ); }
+
+  NeighborIndexType GetCenterNeighborhoodIndex() const
+  { return this->Size() / 2; }
+
+  /** Position of a neighbor in the numbering of the neighborhood */
+  NeighborIndexType GetNeighborhoodIndex(const OffsetType & offset) const;
+
+  /** Pointer to the center pixel */
+  const InternalPixelType * GetCenterPointer() const
+  { return m_Center; }
+
+  /** Linear offsets of the neighbors from the center pixel */
+  const NeighborOffsetsType & GetNeighborOffsets() const
+  { return m_NeighborOffsets; }
+
+  /** Pointer to the i-th neighbor */
+  const InternalPixelType * operator[](NeighborIndexType i) const
+  { return m_Center + m_NeighborOffsets[i]; }
+
+  /** Value of the i-th neighbor */
+  PixelType GetPixel(NeighborIndexType i) const
+  { return m_NeighborhoodAccessorFunctor.Get(m_Center + m_NeighborOffsets[i]); }
+
+  /** Value of the neighbor at the given offset from the center */
+  PixelType GetPixel(const OffsetType & offset) const
+  { return m_NeighborhoodAccessorFunctor.Get( m_Center + this->ComputeLinearOffset(offset) ); }
+
+  PixelType GetCenterPixel() const
+  { return m_NeighborhoodAccessorFunctor.Get(m_Center); }
+
+  /** Linear offset of the next pixel along the axis */
+  OffsetValueType GetStride(unsigned int axis) const
+  { return m_ImageStrides[axis]; }
+
+  /** Index of the center pixel */
+  const IndexType & GetIndex() const
+  { return m_Position; }
+
+  const RadiusType & GetRadius() const
+  { return m_Radius; }
+
+  const RegionType & GetRegion() const
+  { return m_Region; }
+
+  const ImageType * GetImagePointer() const
+  { return m_Image; }
+
+protected:
+  /** Move to the beginning of the next line of the region */
+  void NextLine();
+
+  OffsetValueType ComputeLinearOffset(const OffsetType & offset) const;
+
+private:
+  const ImageType *m_Image;
+  RegionType       m_Region;
+  RadiusType       m_Radius;
+
+  /** Linear offsets of the neighbors, of the next pixel along each axis, and
+   * from the end of a row along an axis to the beginning of the next row
+   * along the following axis */
+  NeighborOffsetsType m_NeighborOffsets;
+  OffsetValueType     m_ImageStrides[Dimension];
+  OffsetValueType     m_Wrap[Dimension];
+
+  const InternalPixelType *m_Begin;
+  const InternalPixelType *m_Center;
+  IndexType                m_Position;
+  IndexType                m_EndIndex;
+
+  NeighborhoodAccessorFunctorType m_NeighborhoodAccessorFunctor;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkConstInteriorNeighborhoodIterator.txx"
+#endif
+
+#endif
@@ -0,0 +1,184 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkConstInteriorNeighborhoodIterator_txx
+#define __itkConstInteriorNeighborhoodIterator_txx
+
+#include "itkConstInteriorNeighborhoodIterator.h"
+
+namespace itk
+{
+template< class TImage >
+ConstInteriorNeighborhoodIterator< TImage >
+::ConstInteriorNeighborhoodIterator()
+{
+  m_Image = 0;
+  m_Radius.Fill(0);
+  m_Begin = 0;
+  m_Center = 0;
+  m_Position.Fill(0);
+  m_EndIndex.Fill(0);
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    m_ImageStrides[d] = 0;
+    m_Wrap[d] = 0;
+    }
+}
+
+template< class TImage >
+bool
+ConstInteriorNeighborhoodIterator< TImage >
+::IsInterior(const RadiusType & radius, const ImageType *image,
+             const RegionType & region)
+{
+  const RegionType & buffered = image->GetBufferedRegion();
+
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    if ( region.GetSize(d) == 0 )
+      {
+      continue;
+      }
+    const OffsetValueType r = static_cast< OffsetValueType >( radius[d] );
+    if ( region.GetIndex(d) - r < buffered.GetIndex(d)
+         || region.GetIndex(d) + static_cast< OffsetValueType >( region.GetSize(d) ) + r
+         > buffered.GetIndex(d) + static_cast< OffsetValueType >( buffered.GetSize(d) ) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< class TImage >
+void
+ConstInteriorNeighborhoodIterator< TImage >
+::Initialize(const RadiusType & radius, const ImageType *image,
+             const RegionType & region)
+{
+  if ( !Self::IsInterior(radius, image, region) )
+    {
+    itkGenericExceptionMacro(<< "The neighborhoods of radius " << radius << " of the region of index "
+                             << region.GetIndex() << " and size " << region.GetSize()
+                             << " are not inside the buffered region");
+    }
+
+  m_Image = image;
+  m_Region = region;
+  m_Radius = radius;
+
+  const OffsetValueType *offsetTable = image->GetOffsetTable();
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    m_ImageStrides[d] = offsetTable[d];
+    m_Wrap[d] = offsetTable[d + 1] - static_cast< OffsetValueType >( region.GetSize(d) ) * offsetTable[d];
+    m_EndIndex[d] = region.GetIndex(d) + static_cast< OffsetValueType >( region.GetSize(d) );
+    }
+
+  // the offsets of the neighbors, the first axis varying fastest
+  SizeValueType size = 1;
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    size *= 2 * radius[d] + 1;
+    }
+  m_NeighborOffsets.resize(size);
+  for ( SizeValueType i = 0; i < size; i++ )
+    {
+    OffsetValueType offset = 0;
+    SizeValueType   position = i;
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      const SizeValueType span = 2 * radius[d] + 1;
+      offset += ( static_cast< OffsetValueType >( position % span ) - static_cast< OffsetValueType >( radius[d] ) )
+                * offsetTable[d];
+      position /= span;
+      }
+    m_NeighborOffsets[i] = offset;
+    }
+
+  m_NeighborhoodAccessorFunctor = image->GetNeighborhoodAccessor();
+  m_NeighborhoodAccessorFunctor.SetBegin( image->GetBufferPointer() );
+
+  m_Begin = image->GetBufferPointer() + image->ComputeOffset( region.GetIndex() );
+  this->GoToBegin();
+}
+
+template< class TImage >
+void
+ConstInteriorNeighborhoodIterator< TImage >
+::GoToBegin()
+{
+  m_Center = m_Begin;
+  m_Position = m_Region.GetIndex();
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    if ( m_Region.GetSize(d) == 0 )
+      {
+      m_Position[Dimension - 1] = m_EndIndex[Dimension - 1];
+      }
+    }
+}
+
+template< class TImage >
+void
+ConstInteriorNeighborhoodIterator< TImage >
+::NextLine()
+{
+  for ( unsigned int d = 0; d + 1 < Dimension; d++ )
+    {
+    if ( m_Position[d] < m_EndIndex[d] )
+      {
+      return;
+      }
+    m_Position[d] = m_Region.GetIndex(d);
+    ++m_Position[d + 1];
+    m_Center += m_Wrap[d];
+    }
+}
+
+template< class TImage >
+typename ConstInteriorNeighborhoodIterator< TImage >::NeighborIndexType
+ConstInteriorNeighborhoodIterator< TImage >
+::GetNeighborhoodIndex(const OffsetType & offset) const
+{
+  NeighborIndexType index = 0;
+  NeighborIndexType stride = 1;
+
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    index += static_cast< NeighborIndexType >( offset[d] + static_cast< OffsetValueType >( m_Radius[d] ) ) * stride;
+    stride *= static_cast< NeighborIndexType >( 2 * m_Radius[d] + 1 );
+    }
+  return index;
+}
+
+template< class TImage >
+OffsetValueType
+ConstInteriorNeighborhoodIterator< TImage >
+::ComputeLinearOffset(const OffsetType & offset) const
+{
+  OffsetValueType linearOffset = 0;
+
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    linearOffset += offset[d] * m_ImageStrides[d];
+    }
+  return linearOffset;
+}
+} // end namespace itk
+
+#endif
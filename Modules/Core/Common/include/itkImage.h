@@ -194,7 +194,8 @@ public:
   virtual void Initialize();
 
   /** Fill the image buffer with a value.  Be sure to call Allocate()
-   * first. */
+   * first. When the ImageBufferAllocator is enabled, large buffers are
+   * filled by several threads, see ImageBufferAllocator::Fill(). */
   void FillBuffer(const TPixel & value);
 
   /** \brief Set a pixel value.
@@ -307,6 +308,10 @@ private:
   Image(const Self &);          //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 
+  /** Fill the pixels [first, last) of a buffer, for
+   * ImageBufferAllocator::Fill() */
+  static void FillPixels(void *buffer, size_t first, size_t last, const void *value);
+
   /** Memory for the current buffer. */
   PixelContainerPointer m_Buffer;
 };
@@ -30,6 +30,7 @@
 
 #include "itkImage.h"
 #include "itkProcessObject.h"
+#include "itkImageBufferAllocator.h"
 
 namespace itk
 {
@@ -84,12 +85,34 @@ Image< TPixel, VImageDimension >
   const SizeValueType numberOfPixels =
     this->GetBufferedRegion().GetNumberOfPixels();
 
+  // the buffers of the allocator are placed by the threads using them
+  if ( ImageBufferAllocator::GetEnabled() )
+    {
+    ImageBufferAllocator::Fill(m_Buffer->GetBufferPointer(), numberOfPixels, sizeof( TPixel ),
+                               &Self::FillPixels, &value);
+    return;
+    }
+
   for ( SizeValueType i = 0; i < numberOfPixels; i++ )
     {
     ( *m_Buffer )[i] = value;
     }
 }
 
+template< class TPixel, unsigned int VImageDimension >
+void
+Image< TPixel, VImageDimension >
+::FillPixels(void *buffer, size_t first, size_t last, const void *value)
+{
+  TPixel *     pixels = static_cast< TPixel * >( buffer );
+  const TPixel pixel = *static_cast< const TPixel * >( value );
+
+  for ( size_t i = first; i < last; i++ )
+    {
+    pixels[i] = pixel;
+    }
+}
+
 template< class TPixel, unsigned int VImageDimension >
 void
 Image< TPixel, VImageDimension >
@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageBufferAllocator_h
+#define __itkImageBufferAllocator_h
+
+#include "itkWin32Header.h" // for ITK_EXPORT
+#include <cstddef>
+#include <iostream>
+
+namespace itk
+{
+/** \class ImageBufferAllocator
+ * \brief Aligned, recycling allocator for the buffers of the images.
+ *
+ * When it is enabled, ImportImageContainer gets its memory from this
+ * allocator instead of new[]. The buffers are aligned on Alignment bytes,
+ * 64 by default, which suits the vector instructions; use the page size to
+ * align them on pages.
+ *
+ * The buffers released are kept in a pool, up to MaximumPoolSize bytes, and
+ * given back to the next allocations of about the same size. This avoids
+ * the cost of getting fresh pages from the system in pipelines and iterative
+ * filters which allocate and release many images of the same size.
+ *
+ * The allocator is disabled by default, since the buffers it allocates can
+ * not be released with delete[]: an application taking over the memory of
+ * a container with ContainerManageMemoryOff() must release it with
+ * Deallocate(). It is enabled with SetEnabled(), or when the environment
+ * variable ITK_USE_IMAGE_BUFFER_ALLOCATOR is set to ON. The environment
+ * variable ITK_IMAGE_BUFFER_POOL_SIZE gives the default size of the pool, in
+ * megabytes.
+ *
+ * Each container remembers whether its buffer comes from the allocator, so
+ * the allocator may be enabled or disabled while images are allocated, and
+ * the containers release their buffer without calling the allocator when
+ * it is disabled.
+ *
+ * This is a single, global allocator switched on or off, not a policy set
+ * on each container: all the images allocated while it is enabled use it.
+ * To allocate the buffers of some images differently, override
+ * ImportImageContainer::AllocateElements() and DeallocateManagedMemory()
+ * in a subclass registered with the ObjectFactory, which takes precedence
+ * over this allocator.
+ *
+ * The statistics of the allocations are kept while the allocator is
+ * enabled. All the methods are thread safe; GetEnabled() does not lock.
+ *
+ * \ingroup ITK-Common
+ */
+class ITKCommon_EXPORT ImageBufferAllocator
+{
+public:
+  /** Set/Get whether the image buffers are allocated by this allocator */
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+
+  /** Set/Get the alignment of the buffers, in bytes. It must be a power of
+   * two, and is at least the size of a pointer. */
+  static void SetAlignment(size_t alignment);
+  static size_t GetAlignment();
+
+  /** Set/Get the maximum number of bytes kept in the pool of released
+   * buffers. Zero disables the recycling. */
+  static void SetMaximumPoolSize(size_t size);
+  static size_t GetMaximumPoolSize();
+
+  /** Allocate an aligned buffer of at least the given number of bytes,
+   * recycling a released one if possible. Return a null pointer if the
+   * memory can't be allocated. */
+  static void * Allocate(size_t size);
+
+  /** Release a buffer allocated by Allocate(). It goes to the pool if there
+   * is room. */
+  static void Deallocate(void *buffer);
+
+  /** Return whether the buffer was allocated by Allocate() and not released
+   * yet */
+  static bool IsAllocated(const void *buffer);
+
+  /** Free the buffers kept in the pool */
+  static void ReleasePool();
+
+  /** Function writing the elements [first, last) of a buffer */
+  typedef void (*FillFunctionType)(void *buffer, size_t first, size_t last, const void *value);
+
+  /** Fill a buffer of numberOfElements elements of elementSize bytes with
+   * fill(). The buffers of 4 MB and more are filled by the default number
+   * of threads, each writing the part of the buffer it is likely to
+   * process in the multithreaded filters, so that the memory pages are
+   * first touched, and placed, by the thread which uses them on NUMA
+   * systems. */
+  static void Fill(void *buffer, size_t numberOfElements, size_t elementSize,
+                   FillFunctionType fill, const void *value);
+
+  /** Statistics: the number of calls to Allocate(), those served from the
+   * pool, the number of calls to Deallocate(), the number of bytes currently
+   * allocated and their maximum, and the number of bytes in the pool. */
+  static size_t GetNumberOfAllocations();
+  static size_t GetNumberOfRecycledAllocations();
+  static size_t GetNumberOfDeallocations();
+  static size_t GetAllocatedSize();
+  static size_t GetPeakAllocatedSize();
+  static size_t GetPoolSize();
+
+  /** Reset the numbers of allocations and deallocations, and the peak
+   * allocated size to the current one */
+  static void ResetStatistics();
+
+  /** Print the settings and the statistics */
+  static void Print(std::ostream & os);
+
+private:
+  ImageBufferAllocator();                             // Not implemented.
+  ImageBufferAllocator(const ImageBufferAllocator &); // Not implemented.
+  void operator=(const ImageBufferAllocator &);       // Not implemented.
+};
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageRegionSpans_h
+#define __itkImageRegionSpans_h
+
+#include "itkImageRegion.h"
+#include "itkDefaultPixelAccessor.h"
+#include "itkConceptChecking.h"
+
+namespace itk
+{
+namespace ImageRegionSpansDetail
+{
+template< class T1, class T2 >
+struct SameType { enum { Value = false }; };
+
+template< class T >
+struct SameType< T, T > { enum { Value = true }; };
+}
+
+/** \class DirectBufferAccessTraits
+ * \brief Tell whether the pixels of an image type can be read and written
+ * directly in its buffer.
+ *
+ * This is the case of the images whose pixel accessor is the
+ * DefaultPixelAccessor, like Image, but not of the VectorImage or of the
+ * image adaptors, whose buffers hold some internal pixel type converted by
+ * their accessor.
+ *
+ * \ingroup ITK-Common
+ */
+template< class TImage >
+class DirectBufferAccessTraits
+{
+public:
+  itkStaticConstMacro(Supported, bool,
+                      ( ImageRegionSpansDetail::SameType< typename TImage::AccessorType,
+                                                          DefaultPixelAccessor< typename TImage::PixelType > >::Value ) );
+};
+
+namespace Concept
+{
+/** Concept requiring the pixels of TImage to be accessed directly in its
+ * buffer, see DirectBufferAccessTraits. */
+template< class TImage >
+struct HasDirectBufferAccess {
+  struct Constraints {
+    typedef Detail::UniqueType_bool< true >                                            TrueT;
+    typedef Detail::UniqueType_bool< DirectBufferAccessTraits< TImage >::Supported > SupportedT;
+    void constraints()
+    {
+      SupportedT a = TrueT();
+
+      Detail::IgnoreUnusedVariable(a);
+    }
+  };
+
+  itkConceptConstraintsMacro();
+};
+}
+
+/** \class ImageRegionSpans
+ * \brief Walk a region of images as spans of pixels contiguous in their
+ * buffers.
+ *
+ * A span is a line of the region along the first axis.  When the region
+ * covers the whole buffered regions of the images along the first axes,
+ * the lines are contiguous in the buffers and the span is made of several
+ * lines, up to MaximumMergedSpanLength pixels.  The buffered regions of all
+ * the images must be given with AddBufferedRegion() before the walk.
+ *
+ * At each span, GetIndex() is the index of its first pixel, so
+ *
+ *     image->GetBufferPointer() + image->ComputeOffset( spans.GetIndex() )
+ *
+ * points to the GetSpanLength() pixels of the span in the buffer of image.
+ *
+ * \sa BatchFunctorTraits DirectBufferAccessTraits
+ * \ingroup ImageIterators
+ * \ingroup ITK-Common
+ */
+template< unsigned int VDimension >
+class ImageRegionSpans
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageRegionSpans Self;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, VDimension);
+
+  typedef ImageRegion< VDimension >     RegionType;
+  typedef typename RegionType::IndexType IndexType;
+  typedef typename RegionType::SizeType  SizeType;
+
+  /** Lines are not merged in spans longer than this */
+  itkStaticConstMacro(MaximumMergedSpanLength, SizeValueType, 65536);
+
+  /** Walk the given region */
+  ImageRegionSpans(const RegionType & region);
+
+  /** Only merge the lines contiguous in a buffer of this region */
+  void AddBufferedRegion(const RegionType & bufferedRegion);
+
+  /** Number of pixels of each span */
+  SizeValueType GetSpanLength() const;
+
+  SizeValueType GetNumberOfSpans() const;
+
+  /** Move to the first span of the region */
+  void GoToBegin();
+
+  bool IsAtEnd() const
+  { return m_RemainingSpans == 0; }
+
+  /** Move to the next span */
+  Self & operator++();
+
+  /** Index of the first pixel of the span */
+  const IndexType & GetIndex() const
+  { return m_Index; }
+
+  const RegionType & GetRegion() const
+  { return m_Region; }
+
+private:
+  /** Number of first axes along which the spans extend */
+  unsigned int GetNumberOfSpanDimensions() const;
+
+  RegionType m_Region;
+
+  /** Number of first axes along which the region covers all the buffered
+   * regions */
+  unsigned int m_NumberOfCoveredDimensions;
+
+  unsigned int  m_NumberOfSpanDimensions;
+  IndexType     m_Index;
+  SizeValueType m_RemainingSpans;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageRegionSpans.txx"
+#endif
+
+#endif
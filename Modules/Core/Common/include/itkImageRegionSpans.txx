@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageRegionSpans_txx
+#define __itkImageRegionSpans_txx
+
+#include "itkImageRegionSpans.h"
+
+namespace itk
+{
+template< unsigned int VDimension >
+ImageRegionSpans< VDimension >
+::ImageRegionSpans(const RegionType & region):
+  m_Region(region)
+{
+  m_NumberOfCoveredDimensions = VDimension;
+  m_NumberOfSpanDimensions = 1;
+  m_Index = region.GetIndex();
+  m_RemainingSpans = 0;
+}
+
+template< unsigned int VDimension >
+void
+ImageRegionSpans< VDimension >
+::AddBufferedRegion(const RegionType & bufferedRegion)
+{
+  unsigned int covered = 0;
+
+  while ( covered < m_NumberOfCoveredDimensions
+          && m_Region.GetSize(covered) == bufferedRegion.GetSize(covered) )
+    {
+    covered++;
+    }
+  m_NumberOfCoveredDimensions = covered;
+}
+
+template< unsigned int VDimension >
+unsigned int
+ImageRegionSpans< VDimension >
+::GetNumberOfSpanDimensions() const
+{
+  // the line along an axis can be appended to the previous one if the
+  // region covers the buffers along all the previous axes
+  unsigned int  dimensions = 1;
+  SizeValueType length = m_Region.GetSize(0);
+
+  while ( dimensions < VDimension && dimensions <= m_NumberOfCoveredDimensions
+          && length * m_Region.GetSize(dimensions) <= MaximumMergedSpanLength )
+    {
+    length *= m_Region.GetSize(dimensions);
+    dimensions++;
+    }
+  return dimensions;
+}
+
+template< unsigned int VDimension >
+SizeValueType
+ImageRegionSpans< VDimension >
+::GetSpanLength() const
+{
+  SizeValueType      length = 1;
+  const unsigned int dimensions = this->GetNumberOfSpanDimensions();
+
+  for ( unsigned int d = 0; d < dimensions; d++ )
+    {
+    length *= m_Region.GetSize(d);
+    }
+  return length;
+}
+
+template< unsigned int VDimension >
+SizeValueType
+ImageRegionSpans< VDimension >
+::GetNumberOfSpans() const
+{
+  const SizeValueType length = this->GetSpanLength();
+
+  if ( length == 0 )
+    {
+    return 0;
+    }
+  return m_Region.GetNumberOfPixels() / length;
+}
+
+template< unsigned int VDimension >
+void
+ImageRegionSpans< VDimension >
+::GoToBegin()
+{
+  m_NumberOfSpanDimensions = this->GetNumberOfSpanDimensions();
+  m_Index = m_Region.GetIndex();
+  m_RemainingSpans = this->GetNumberOfSpans();
+}
+
+template< unsigned int VDimension >
+ImageRegionSpans< VDimension > &
+ImageRegionSpans< VDimension >
+::operator++()
+{
+  if ( --m_RemainingSpans == 0 )
+    {
+    return *this;
+    }
+  for ( unsigned int d = m_NumberOfSpanDimensions; d < VDimension; d++ )
+    {
+    if ( ++m_Index[d] < m_Region.GetIndex(d) + static_cast< OffsetValueType >( m_Region.GetSize(d) ) )
+      {
+      break;
+      }
+    m_Index[d] = m_Region.GetIndex(d);
+    }
+  return *this;
+}
+} // end namespace itk
+
+#endif
@@ -28,6 +28,7 @@
 #ifndef __itkImageSource_txx
 #define __itkImageSource_txx
 #include "itkImageSource.h"
+#include "itkPipelineProfiler.h"
 
 #include "vnl/vnl_math.h"
 
@@ -301,7 +302,17 @@ ImageSource< TOutputImage >
 
   if ( threadId < total )
     {
-    str->Filter->ThreadedGenerateData(splitRegion, threadId);
+    if ( PipelineProfiler::GetEnabled() )
+      {
+      const double start = PipelineProfiler::GetTime();
+      str->Filter->ThreadedGenerateData(splitRegion, threadId);
+      PipelineProfiler::AddThreadRecord(str->Filter, threadId, start, PipelineProfiler::GetTime() - start,
+                                        splitRegion.GetNumberOfPixels());
+      }
+    else
+      {
+      str->Filter->ThreadedGenerateData(splitRegion, threadId);
+      }
     }
   // else
   //   {
@@ -37,6 +37,10 @@ namespace itk
  * TElement =
  *    The element type stored in the container.
  *
+ * The memory is allocated with new[], or by the ImageBufferAllocator when
+ * it is enabled. The allocation is customized by overriding
+ * AllocateElements() and DeallocateManagedMemory() in a subclass.
+ *
  * \ingroup ImageObjects
  * \ingroup IOFilters
  * \ingroup ITK-Common
@@ -174,6 +178,11 @@ private:
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  /** Whether m_ImportPointer was allocated by ImageBufferAllocator, and
+   * whether the last buffer returned by AllocateElements() was. */
+  bool               m_BufferFromAllocator;
+  mutable bool       m_AllocationFromAllocator;
 };
 } // end namespace itk
 
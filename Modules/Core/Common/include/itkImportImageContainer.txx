@@ -29,7 +29,10 @@
 #define __itkImportImageContainer_txx
 
 #include "itkImportImageContainer.h"
+#include "itkImageBufferAllocator.h"
+#include "itkPipelineProfiler.h"
 #include <cstring>
+#include <new>
 #include <stdlib.h>
 #include <string.h>
 
@@ -41,6 +44,8 @@ ImportImageContainer< TElementIdentifier, TElement >
 {
   m_ImportPointer = 0;
   m_ContainerManageMemory = true;
+  m_BufferFromAllocator = false;
+  m_AllocationFromAllocator = false;
   m_Capacity = 0;
   m_Size = 0;
 }
@@ -68,6 +73,7 @@ ImportImageContainer< TElementIdentifier, TElement >
     {
     if ( size > m_Capacity )
       {
+      m_AllocationFromAllocator = false;
       TElement *temp = this->AllocateElements(size);
       // only copy the portion of the data used in the old buffer
       memcpy( temp, m_ImportPointer, m_Size * sizeof( TElement ) );
@@ -75,6 +81,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_BufferFromAllocator = m_AllocationFromAllocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -88,7 +95,9 @@ ImportImageContainer< TElementIdentifier, TElement >
     }
   else
     {
+    m_AllocationFromAllocator = false;
     m_ImportPointer = this->AllocateElements(size);
+    m_BufferFromAllocator = m_AllocationFromAllocator;
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -110,12 +119,14 @@ ImportImageContainer< TElementIdentifier, TElement >
     if ( m_Size < m_Capacity )
       {
       const TElementIdentifier size = m_Size;
-      TElement *               temp = this->AllocateElements(size);
+      m_AllocationFromAllocator = false;
+      TElement *temp = this->AllocateElements(size);
       memcpy( temp, m_ImportPointer, size * sizeof( TElement ) );
 
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_BufferFromAllocator = m_AllocationFromAllocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -176,13 +187,33 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
   // does not do this by default.
   TElement *data;
 
-  try
+  m_AllocationFromAllocator = ImageBufferAllocator::GetEnabled();
+  if ( m_AllocationFromAllocator )
     {
-    data = new TElement[size];
+    data = static_cast< TElement * >( ImageBufferAllocator::Allocate( size * sizeof( TElement ) ) );
+    try
+      {
+      for ( ElementIdentifier i = 0; data && i < size; i++ )
+        {
+        new ( data + i ) TElement;
+        }
+      }
+    catch ( ... )
+      {
+      ImageBufferAllocator::Deallocate(data);
+      data = 0;
+      }
     }
-  catch ( ... )
+  else
     {
-    data = 0;
+    try
+      {
+      data = new TElement[size];
+      }
+    catch ( ... )
+      {
+      data = 0;
+      }
     }
   if ( !data )
     {
@@ -192,6 +223,10 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
                                 "Failed to allocate memory for image.",
                                 ITK_LOCATION);
     }
+  if ( PipelineProfiler::GetEnabled() )
+    {
+    PipelineProfiler::AddAllocation( size * sizeof( TElement ) );
+    }
   return data;
 }
 
@@ -202,9 +237,21 @@ void ImportImageContainer< TElementIdentifier, TElement >
   // Encapsulate all image memory deallocation here
   if ( m_ImportPointer && m_ContainerManageMemory )
     {
-    delete[] m_ImportPointer;
+    if ( m_BufferFromAllocator )
+      {
+      for ( ElementIdentifier i = 0; i < m_Capacity; i++ )
+        {
+        m_ImportPointer[i].~TElement();
+        }
+      ImageBufferAllocator::Deallocate(m_ImportPointer);
+      }
+    else
+      {
+      delete[] m_ImportPointer;
+      }
     }
   m_ImportPointer = 0;
+  m_BufferFromAllocator = false;
   m_Capacity = 0;
   m_Size = 0;
 }
@@ -22,18 +22,11 @@
 #include "itkTimeStamp.h"
 #include "itkIndent.h"
 #include "itkSimpleFastMutexLock.h"
+#include "itkAtomicIntegerDetail.h"
 
 #include <iostream>
 #include <typeinfo>
 
-#if defined( _WIN32 )
-// To get LONG defined
-  #include "itkWindows.h"
-#elif defined( __APPLE__ )
-// To get MAC_OS_X_VERSION_MIN_REQUIRED defined
-  #include <AvailabilityMacros.h>
-#endif
-
 namespace itk
 {
 /** \class LightObject
@@ -129,24 +122,13 @@ protected:
 
   /** Define the type of the reference count according to the
       target. This allows the use of atomic operations */
-#if ( defined( WIN32 ) || defined( _WIN32 ) )
-  typedef LONG InternalReferenceCountType;
-#elif defined( __APPLE__ ) && ( MAC_OS_X_VERSION_MIN_REQUIRED >= 1050 )
- #if defined ( __LP64__ ) && __LP64__
-  typedef volatile int64_t InternalReferenceCountType;
- #else
-  typedef volatile int32_t InternalReferenceCountType;
- #endif
-#elif defined( __GLIBCPP__ ) || defined( __GLIBCXX__ )
-  typedef _Atomic_word InternalReferenceCountType;
-#else
-  typedef int InternalReferenceCountType;
-#endif
+  typedef AtomicIntegerDetail::ReferenceCountType InternalReferenceCountType;
 
   /** Number of uses of this object by other objects. */
   mutable InternalReferenceCountType m_ReferenceCount;
 
-  /** Mutex lock to protect modification to the reference count */
+  /** Mutex lock to protect modification to the reference count when the
+   * target has no atomic operations, and in SetReferenceCount() */
   mutable SimpleFastMutexLock m_ReferenceCountLock;
 private:
   LightObject(const Self &);    //purposely not implemented
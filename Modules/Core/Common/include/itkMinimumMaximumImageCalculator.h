@@ -20,6 +20,8 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkMultiThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -29,6 +31,11 @@ namespace itk
  * Minimum value is needed, just call ComputeMaximum() (ComputeMinimum())
  * otherwise Compute() will compute both.
  *
+ * The region is split between several threads, each thread finding the
+ * extrema of its part, which are then combined.  The indices returned are
+ * those of the first extrema in the order of the image iterators, as when
+ * the region is walked by a single thread.
+ *
  * \ingroup Operators
  * \ingroup ITK-Common
  *
@@ -98,6 +105,14 @@ public:
   /** Set the region over which the values will be computed */
   void SetRegion(const RegionType & region);
 
+  /** Set/Get the maximum number of threads used for the computation.
+   * Small regions are processed by fewer threads. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstReferenceMacro(NumberOfThreads, ThreadIdType);
+
+  /** Minimum number of pixels processed by a thread */
+  itkStaticConstMacro(MinimumNumberOfPixelsPerThread, SizeValueType, 65536);
+
 protected:
   MinimumMaximumImageCalculator();
   virtual ~MinimumMaximumImageCalculator() {}
@@ -116,6 +131,28 @@ private:
 
   RegionType m_Region;
   bool       m_RegionSetByUser;
+
+  /** Extrema of the part of the region processed by a thread */
+  struct ThreadExtrema {
+    RegionType Region;
+    PixelType  Minimum;
+    PixelType  Maximum;
+    IndexType  IndexOfMinimum;
+    IndexType  IndexOfMaximum;
+  };
+
+  /** Find the requested extrema of m_Region with several threads */
+  void ComputeExtrema(bool computeMinimum, bool computeMaximum);
+
+  /** Find the extrema of the part of the region of a thread */
+  void ThreadedComputeExtrema(ThreadExtrema & extrema) const;
+
+  static ITK_THREAD_RETURN_TYPE ComputeExtremaThreaderCallback(void *arg);
+
+  ThreadIdType                  m_NumberOfThreads;
+  std::vector< ThreadExtrema > m_ThreadExtrema;
+  bool                          m_ComputeMinimum;
+  bool                          m_ComputeMaximum;
 };
 } // end namespace itk
 
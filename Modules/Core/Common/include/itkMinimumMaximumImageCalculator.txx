@@ -20,7 +20,10 @@
 
 #include "itkMinimumMaximumImageCalculator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionSplitter.h"
 #include "itkNumericTraits.h"
+#include "itkPipelineProfiler.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -37,6 +40,9 @@ MinimumMaximumImageCalculator< TInputImage >
   m_IndexOfMinimum.Fill(0);
   m_IndexOfMaximum.Fill(0);
   m_RegionSetByUser = false;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_ComputeMinimum = true;
+  m_ComputeMaximum = true;
 }
 
 /**
@@ -46,84 +52,189 @@ template< class TInputImage >
 void
 MinimumMaximumImageCalculator< TInputImage >
 ::Compute(void)
+{
+  this->ComputeExtrema(true, true);
+}
+
+/**
+ * Compute the minimum intensity value of the image
+ */
+template< class TInputImage >
+void
+MinimumMaximumImageCalculator< TInputImage >
+::ComputeMinimum(void)
+{
+  this->ComputeExtrema(true, false);
+}
+
+/**
+ * Compute the maximum intensity value of the image
+ */
+template< class TInputImage >
+void
+MinimumMaximumImageCalculator< TInputImage >
+::ComputeMaximum(void)
+{
+  this->ComputeExtrema(false, true);
+}
+
+template< class TInputImage >
+void
+MinimumMaximumImageCalculator< TInputImage >
+::ComputeExtrema(bool computeMinimum, bool computeMaximum)
 {
   if ( !m_RegionSetByUser )
     {
     m_Region = m_Image->GetRequestedRegion();
     }
+  m_ComputeMinimum = computeMinimum;
+  m_ComputeMaximum = computeMaximum;
 
-  ImageRegionConstIteratorWithIndex< TInputImage > it(m_Image, m_Region);
-  m_Maximum = NumericTraits< PixelType >::NonpositiveMin();
-  m_Minimum = NumericTraits< PixelType >::max();
+  // Split the region along its outermost axis, so that the parts of the
+  // threads follow each other in the order of the iterators
+  typedef ImageRegionSplitter< TInputImage::ImageDimension > SplitterType;
+  typename SplitterType::Pointer splitter = SplitterType::New();
+
+  const SizeValueType numberOfPixels = m_Region.GetNumberOfPixels();
+  ThreadIdType        numberOfThreads = m_NumberOfThreads;
+  if ( numberOfPixels / MinimumNumberOfPixelsPerThread < numberOfThreads )
+    {
+    numberOfThreads = std::max( static_cast< ThreadIdType >( numberOfPixels / MinimumNumberOfPixelsPerThread ),
+                                static_cast< ThreadIdType >( 1 ) );
+    }
+  if ( numberOfThreads > 1 )
+    {
+    numberOfThreads = splitter->GetNumberOfSplits(m_Region, numberOfThreads);
+    }
+
+  m_ThreadExtrema.resize(numberOfThreads);
+  m_ThreadExtrema[0].Region = m_Region;
+  for ( ThreadIdType i = 0; numberOfThreads > 1 && i < numberOfThreads; i++ )
+    {
+    m_ThreadExtrema[i].Region = splitter->GetSplit(i, numberOfThreads, m_Region);
+    }
+
+  if ( numberOfThreads > 1 )
+    {
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(Self::ComputeExtremaThreaderCallback, this);
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    this->ThreadedComputeExtrema(m_ThreadExtrema[0]);
+    }
 
-  while ( !it.IsAtEnd() )
+  // Combine the extrema of the threads in the order of their parts, so the
+  // first extremum is kept when several pixels have the same value
+  if ( computeMinimum )
+    {
+    m_Minimum = NumericTraits< PixelType >::max();
+    }
+  if ( computeMaximum )
+    {
+    m_Maximum = NumericTraits< PixelType >::NonpositiveMin();
+    }
+  for ( ThreadIdType i = 0; i < m_ThreadExtrema.size(); i++ )
     {
-    const PixelType value = it.Get();
-    if ( value > m_Maximum )
+    const ThreadExtrema & extrema = m_ThreadExtrema[i];
+    if ( computeMinimum && extrema.Minimum < m_Minimum )
       {
-      m_Maximum = value;
-      m_IndexOfMaximum = it.GetIndex();
+      m_Minimum = extrema.Minimum;
+      m_IndexOfMinimum = extrema.IndexOfMinimum;
       }
-    if ( value < m_Minimum )
+    if ( computeMaximum && extrema.Maximum > m_Maximum )
       {
-      m_Minimum = value;
-      m_IndexOfMinimum = it.GetIndex();
+      m_Maximum = extrema.Maximum;
+      m_IndexOfMaximum = extrema.IndexOfMaximum;
       }
-    ++it;
     }
 }
 
-/**
- * Compute the minimum intensity value of the image
- */
 template< class TInputImage >
-void
+ITK_THREAD_RETURN_TYPE
 MinimumMaximumImageCalculator< TInputImage >
-::ComputeMinimum(void)
+::ComputeExtremaThreaderCallback(void *arg)
 {
-  if ( !m_RegionSetByUser )
-    {
-    m_Region = m_Image->GetRequestedRegion();
-    }
-  ImageRegionConstIteratorWithIndex< TInputImage > it(m_Image,  m_Region);
-  m_Minimum = NumericTraits< PixelType >::max();
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+
+  ThreadInfoType *infoStruct = static_cast< ThreadInfoType * >( arg );
+  Self *          self = static_cast< Self * >( infoStruct->UserData );
 
-  while ( !it.IsAtEnd() )
+  if ( infoStruct->ThreadID < self->m_ThreadExtrema.size() )
     {
-    const PixelType value = it.Get();
-    if ( value < m_Minimum )
+    ThreadExtrema & extrema = self->m_ThreadExtrema[infoStruct->ThreadID];
+    if ( PipelineProfiler::GetEnabled() )
       {
-      m_Minimum = value;
-      m_IndexOfMinimum = it.GetIndex();
+      const double start = PipelineProfiler::GetTime();
+      self->ThreadedComputeExtrema(extrema);
+      PipelineProfiler::AddThreadRecord(infoStruct->ThreadID, start, PipelineProfiler::GetTime() - start,
+                                        extrema.Region.GetNumberOfPixels());
+      }
+    else
+      {
+      self->ThreadedComputeExtrema(extrema);
       }
-    ++it;
     }
+  return ITK_THREAD_RETURN_VALUE;
 }
 
-/**
- * Compute the maximum intensity value of the image
- */
 template< class TInputImage >
 void
 MinimumMaximumImageCalculator< TInputImage >
-::ComputeMaximum(void)
+::ThreadedComputeExtrema(ThreadExtrema & extrema) const
 {
-  if ( !m_RegionSetByUser )
+  ImageRegionConstIteratorWithIndex< TInputImage > it(m_Image, extrema.Region);
+
+  extrema.Minimum = NumericTraits< PixelType >::max();
+  extrema.Maximum = NumericTraits< PixelType >::NonpositiveMin();
+  extrema.IndexOfMinimum.Fill(0);
+  extrema.IndexOfMaximum.Fill(0);
+
+  if ( m_ComputeMinimum && m_ComputeMaximum )
     {
-    m_Region = m_Image->GetRequestedRegion();
+    while ( !it.IsAtEnd() )
+      {
+      const PixelType value = it.Get();
+      if ( value > extrema.Maximum )
+        {
+        extrema.Maximum = value;
+        extrema.IndexOfMaximum = it.GetIndex();
+        }
+      if ( value < extrema.Minimum )
+        {
+        extrema.Minimum = value;
+        extrema.IndexOfMinimum = it.GetIndex();
+        }
+      ++it;
+      }
     }
-  ImageRegionConstIteratorWithIndex< TInputImage > it(m_Image,  m_Region);
-  m_Maximum = NumericTraits< PixelType >::NonpositiveMin();
-
-  while ( !it.IsAtEnd() )
+  else if ( m_ComputeMinimum )
+    {
+    while ( !it.IsAtEnd() )
+      {
+      const PixelType value = it.Get();
+      if ( value < extrema.Minimum )
+        {
+        extrema.Minimum = value;
+        extrema.IndexOfMinimum = it.GetIndex();
+        }
+      ++it;
+      }
+    }
+  else
     {
-    const PixelType value = it.Get();
-    if ( value > m_Maximum )
+    while ( !it.IsAtEnd() )
       {
-      m_Maximum = value;
-      m_IndexOfMaximum = it.GetIndex();
+      const PixelType value = it.Get();
+      if ( value > extrema.Maximum )
+        {
+        extrema.Maximum = value;
+        extrema.IndexOfMaximum = it.GetIndex();
+        }
+      ++it;
       }
-    ++it;
     }
 }
 
@@ -156,6 +267,7 @@ MinimumMaximumImageCalculator< TInputImage >
   os << indent << "Region: " << std::endl;
   m_Region.Print( os, indent.GetNextIndent() );
   os << indent << "Region set by User: " << m_RegionSetByUser << std::endl;
+  os << indent << "Number of Threads: " << m_NumberOfThreads << std::endl;
 }
 } // end namespace itk
 
@@ -19,6 +19,7 @@
 #define __itkNeighborhoodInnerProduct_h
 
 #include "itkNeighborhoodIterator.h"
+#include "itkConstInteriorNeighborhoodIterator.h"
 #include "itkConstSliceIterator.h"
 #include "itkImageBoundaryCondition.h"
 
@@ -75,6 +76,17 @@ public:
     return this->operator()(std::slice(0, it.Size(), 1), it, op);
   }
 
+  /** Inner product without boundary condition, for the interior regions */
+  OutputPixelType operator()(const std::slice & s,
+                             const ConstInteriorNeighborhoodIterator< TImage > & it,
+                             const OperatorType & op) const;
+
+  OutputPixelType operator()(const ConstInteriorNeighborhoodIterator< TImage > & it,
+                             const OperatorType & op) const
+  {
+    return this->operator()(std::slice(0, it.Size(), 1), it, op);
+  }
+
   OutputPixelType operator()(const std::slice & s,
                              const NeighborhoodType & N,
                              const OperatorType & op) const;
@@ -56,6 +56,39 @@ NeighborhoodInnerProduct< TImage, TOperator, TComputation >
   return static_cast< OutputPixelType >( sum );
 }
 
+template< class TImage, class TOperator, class TComputation >
+typename NeighborhoodInnerProduct< TImage, TOperator, TComputation >::OutputPixelType
+NeighborhoodInnerProduct< TImage, TOperator, TComputation >
+::operator()(const std::slice & s,
+             const ConstInteriorNeighborhoodIterator< TImage > & it,
+             const OperatorType & op) const
+{
+  typename OperatorType::ConstIterator o_it;
+
+  typedef typename TImage::PixelType                                    InputPixelType;
+  typedef typename NumericTraits< InputPixelType >::RealType            InputPixelRealType;
+  typedef typename NumericTraits< InputPixelRealType >::AccumulateType  AccumulateRealType;
+
+  AccumulateRealType sum = NumericTraits< AccumulateRealType >::Zero;
+
+  typedef typename NumericTraits<OutputPixelType>::ValueType
+      OutputPixelValueType;
+
+  o_it = op.Begin();
+  const typename OperatorType::ConstIterator op_end = op.End();
+
+  const unsigned int start  = static_cast< unsigned int >( s.start() );
+  const unsigned int stride = static_cast< unsigned int >( s.stride() );
+  for ( unsigned int i = start; o_it < op_end; i += stride, ++o_it )
+    {
+    sum += static_cast< AccumulateRealType >(
+      static_cast< OutputPixelValueType >( *o_it ) *
+      static_cast< InputPixelRealType >( it.GetPixel(i) ) );
+    }
+
+  return static_cast< OutputPixelType >( sum );
+}
+
 template< class TImage, class TOperator, class TComputation >
 typename NeighborhoodInnerProduct< TImage, TOperator, TComputation >::OutputPixelType
 NeighborhoodInnerProduct< TImage, TOperator, TComputation >
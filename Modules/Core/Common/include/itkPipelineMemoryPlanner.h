@@ -0,0 +1,155 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPipelineMemoryPlanner_h
+#define __itkPipelineMemoryPlanner_h
+
+#include "itkProcessObject.h"
+#include <vector>
+
+namespace itk
+{
+/** \class PipelineMemoryPlanner
+ * \brief Update a pipeline releasing the intermediate data as soon as it
+ * has been used.
+ *
+ * The planner walks the pipeline upstream of its outputs and finds the
+ * order in which the process objects execute in an update, the same order
+ * as ProcessObject::UpdateOutputData(). This gives the lifetime of each
+ * intermediate data object: from the execution of its source to the
+ * execution of its last consumer in the pipeline.
+ *
+ * Update() updates the outputs and releases each intermediate data object
+ * when its last consumer finishes, so only the data still needed downstream
+ * is kept in memory. Unlike the ReleaseDataFlag, which releases the data
+ * after its first consumer, data used by several process objects is not
+ * computed twice.
+ *
+ * When ReuseBuffers is on, the ImageBufferAllocator is enabled during the
+ * update: the released buffers go to its pool, and the outputs allocated
+ * next with the same size take them over instead of getting new memory.
+ * The peak memory of a long chain of filters is then a few buffers instead
+ * of one per filter. ReuseBuffers is off by default, since the allocator is
+ * global: any image allocated during the update, in this thread or another
+ * one, gets a buffer of the allocator, which must not be released with
+ * delete[] by an application taking it over with ContainerManageMemoryOff().
+ * Such buffers are released with ImageBufferAllocator::Deallocate().
+ *
+ * The outputs added to the planner are kept, as well as the data objects
+ * without source, like the images given as input to the pipeline. Any other
+ * data object of the pipeline the application needs after the update must
+ * be added as an output. An intermediate data object used outside of the
+ * pipeline of the planner is updated again when it is used.
+ *
+ * Update() computes the plan again with Plan(), since the pipeline may
+ * have been connected differently since the last update.
+ *
+ * \sa ImageBufferAllocator ProcessObject::ReleaseDataFlag
+ * \ingroup DataProcessing
+ * \ingroup ITK-Common
+ */
+class ITKCommon_EXPORT PipelineMemoryPlanner:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef PipelineMemoryPlanner      Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PipelineMemoryPlanner, Object);
+
+  /** Add a data object to update and keep */
+  void AddOutput(DataObject *output);
+
+  /** Remove all the outputs */
+  void ClearOutputs();
+
+  /** Set/Get whether the released buffers are recycled by the
+   * ImageBufferAllocator during the update. Off by default. */
+  itkSetMacro(ReuseBuffers, bool);
+  itkGetConstMacro(ReuseBuffers, bool);
+  itkBooleanMacro(ReuseBuffers);
+
+  /** Compute the order of execution and the lifetimes of the data objects
+   * of the pipeline */
+  void Plan();
+
+  /** Update the outputs, releasing the intermediate data objects after
+   * their last use */
+  void Update();
+
+  /** Number of process objects of the pipeline, in the order of
+   * execution */
+  unsigned int GetNumberOfProcessObjects() const
+  { return static_cast< unsigned int >( m_ProcessObjects.size() ); }
+  ProcessObject * GetProcessObject(unsigned int step) const
+  { return m_ProcessObjects[step]; }
+
+  /** Number of data objects produced by the process objects of the
+   * pipeline */
+  itkGetConstMacro(NumberOfDataObjects, unsigned int);
+
+  /** Number of data objects released during the update */
+  itkGetConstMacro(NumberOfReleasedDataObjects, unsigned int);
+
+  /** Largest number of data objects produced by the pipeline which are in
+   * memory at the same time during an update */
+  itkGetConstMacro(PeakNumberOfDataObjects, unsigned int);
+
+protected:
+  PipelineMemoryPlanner();
+  ~PipelineMemoryPlanner() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Release the data objects whose last consumer just finished */
+  void ReleaseConsumedData(Object *caller, const EventObject & event);
+
+private:
+  PipelineMemoryPlanner(const Self &); //purposely not implemented
+  void operator=(const Self &);        //purposely not implemented
+
+  typedef std::vector< DataObject::Pointer >    DataObjectArrayType;
+  typedef std::vector< ProcessObject::Pointer > ProcessObjectArrayType;
+
+  /** Add the process objects upstream of the data object to the plan */
+  void Visit(DataObject *data, DataObjectArrayType & visited);
+
+  /** Return the step of the process object, or the number of steps if it
+   * is not in the pipeline */
+  unsigned int FindStep(const ProcessObject *process) const;
+
+  bool IsOutput(const DataObject *data) const;
+
+  DataObjectArrayType    m_Outputs;
+  ProcessObjectArrayType m_ProcessObjects;
+
+  /** For each step, the data objects to release when it finishes */
+  std::vector< DataObjectArrayType > m_Releases;
+
+  bool         m_ReuseBuffers;
+  unsigned int m_NumberOfDataObjects;
+  unsigned int m_NumberOfReleasedDataObjects;
+  unsigned int m_PeakNumberOfDataObjects;
+};
+} // end namespace itk
+
+#endif
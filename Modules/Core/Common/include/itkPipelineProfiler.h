@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPipelineProfiler_h
+#define __itkPipelineProfiler_h
+
+#include "itkWin32Header.h" // for ITK_EXPORT
+#include "itkIntTypes.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+class ProcessObject;
+
+/** \class PipelineProfiler
+ * \brief Record where the pipeline updates spend their time and memory.
+ *
+ * When the profiler is enabled, each execution of a process object in
+ * ProcessObject::UpdateOutputData() is recorded: the wall time of its
+ * GenerateData(), the bytes allocated for the image buffers during it, the
+ * memory used by the process before and after it, and the number of pixels
+ * in the requested and buffered regions of its image outputs. The filters
+ * using ImageSource::ThreadedGenerateData() also record the busy time and
+ * the number of pixels of each thread, which shows how well the requested
+ * region was split between the threads. The threads started with a
+ * callback of their own are recorded only where the callback calls
+ * AddThreadRecord(), as those of CannyEdgeDetectionImageFilter, the Hough
+ * transform filters, MinimumMaximumImageCalculator and the parallel
+ * ImageBufferAllocator::Fill().
+ *
+ * The records can be written as a CSV table, with one line per execution,
+ * or in the Chrome trace event format, to be displayed by chrome://tracing,
+ * with one row for the filters and one for each thread.
+ *
+ * The profiler is disabled by default. It is enabled with SetEnabled(), or
+ * when the environment variable ITK_PIPELINE_PROFILER is set to ON. The times
+ * are in seconds since the profiler was enabled or cleared. The executions
+ * of mini pipelines are recorded with a larger depth than the filter running
+ * them. The records assume the pipelines are updated by one thread at a
+ * time.
+ *
+ * \sa TimeProbe MemoryProbe ResourceProbesCollectorBase
+ * \ingroup ITK-Common
+ */
+class ITKCommon_EXPORT PipelineProfiler
+{
+public:
+  /** Execution of a part of the work of a process object by one thread */
+  struct ThreadRecord {
+    ThreadIdType ThreadId;
+    double Start;
+    double Time;
+    SizeValueType NumberOfPixels;
+  };
+
+  /** Execution of a process object */
+  struct Record {
+    std::string NameOfClass;
+    const void *ProcessObject;
+    unsigned int Depth;
+    double Start;
+    double Time;
+    SizeValueType BytesAllocated;
+    SizeValueType MemoryUsageBefore; // kB
+    SizeValueType MemoryUsageAfter;  // kB
+    SizeValueType RequestedNumberOfPixels;
+    SizeValueType BufferedNumberOfPixels;
+    std::vector< ThreadRecord > Threads;
+  };
+
+  /** Set/Get whether the pipeline updates are recorded. GetEnabled() does
+   * not lock, so it is cheap enough to be called by each filter. */
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+
+  /** Remove the records and restart the time */
+  static void Clear();
+
+  /** Time in seconds since the profiler was enabled or cleared */
+  static double GetTime();
+
+  /** Called by ProcessObject::UpdateOutputData() around GenerateData() */
+  static void StartProcessObject(const ProcessObject *process);
+  static void StopProcessObject(const ProcessObject *process);
+
+  /** Called by the threads of a process object after their
+   * ThreadedGenerateData() */
+  static void AddThreadRecord(const ProcessObject *process, ThreadIdType threadId,
+                              double start, double time, SizeValueType numberOfPixels);
+
+  /** Called by the threads started by an object which is not a process
+   * object, like MinimumMaximumImageCalculator: the thread is recorded in
+   * the innermost process object executing */
+  static void AddThreadRecord(ThreadIdType threadId, double start, double time,
+                              SizeValueType numberOfPixels);
+
+  /** Called when an image buffer is allocated */
+  static void AddAllocation(SizeValueType bytes);
+
+  /** Access to the records of the executions, in the order they started */
+  static unsigned int GetNumberOfRecords();
+  static Record GetRecord(unsigned int i);
+
+  /** Write the records as a CSV table with a header line. The times are in
+   * seconds. */
+  static void WriteCSV(std::ostream & os);
+
+  /** Write the records in the Chrome trace event format. The times are in
+   * microseconds. */
+  static void WriteChromeTrace(std::ostream & os);
+
+private:
+  PipelineProfiler();                         // Not implemented.
+  PipelineProfiler(const PipelineProfiler &); // Not implemented.
+  void operator=(const PipelineProfiler &);   // Not implemented.
+};
+}
+
+#endif
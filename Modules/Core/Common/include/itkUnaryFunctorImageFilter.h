@@ -20,6 +20,8 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionSpans.h"
+#include "itkBatchFunctorTraits.h"
 
 namespace itk
 {
@@ -35,7 +37,11 @@ namespace itk
  * UnaryFunctorImageFilter (like the CastImageFilter) can be used
  * to promote a 2D image to a 3D image, etc.
  *
- * \sa BinaryFunctorImageFilter TernaryFunctorImageFilter
+ * When the pixels of the input and output images can be accessed directly in
+ * their buffers, the functor is applied to the spans of pixels contiguous in
+ * the buffers, through BatchFunctorTraits.
+ *
+ * \sa BinaryFunctorImageFilter TernaryFunctorImageFilter BatchFunctorTraits
  *
  * \ingroup   IntensityImageFilters     Multithreaded
  * \ingroup ITK-Common
@@ -126,6 +132,19 @@ private:
   UnaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);          //purposely not implemented
 
+  /** Apply the functor to the spans of pixels of the buffers.  Return false
+   * if the images cannot be walked by spans. */
+  bool ThreadedGenerateDataForSpans(const InputImageRegionType & inputRegionForThread,
+                                    const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId,
+                                    const ImageToImageFilterDetail::BooleanDispatch< true > &);
+
+  bool ThreadedGenerateDataForSpans(const InputImageRegionType &,
+                                    const OutputImageRegionType &,
+                                    ThreadIdType,
+                                    const ImageToImageFilterDetail::BooleanDispatch< false > &)
+  { return false; }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
@@ -161,6 +161,18 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 
   this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
 
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    DirectBufferAccessTraits< TInputImage >::Supported
+    && DirectBufferAccessTraits< TOutputImage >::Supported
+    && (unsigned int)TInputImage::ImageDimension == (unsigned int)TOutputImage::ImageDimension >
+  SpansDispatchType;
+
+  if ( this->ThreadedGenerateDataForSpans( inputRegionForThread, outputRegionForThread,
+                                           threadId, SpansDispatchType() ) )
+    {
+    return;
+    }
+
   // Define the iterators
   ImageRegionConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
   ImageRegionIterator< TOutputImage >     outputIt(outputPtr, outputRegionForThread);
@@ -178,6 +190,44 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
     progress.CompletedPixel();  // potential exception thrown here
     }
 }
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+bool
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::ThreadedGenerateDataForSpans(const InputImageRegionType & inputRegionForThread,
+                               const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId,
+                               const ImageToImageFilterDetail::BooleanDispatch< true > &)
+{
+  // the input region may be moved or reshaped by a subclass
+  if ( !( inputRegionForThread == outputRegionForThread ) )
+    {
+    return false;
+    }
+
+  InputImagePointer  inputPtr = this->GetInput();
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  ImageRegionSpans< TOutputImage::ImageDimension > spans(outputRegionForThread);
+  spans.AddBufferedRegion( inputPtr->GetBufferedRegion() );
+  spans.AddBufferedRegion( outputPtr->GetBufferedRegion() );
+
+  const InputImagePixelType *inputBuffer = inputPtr->GetBufferPointer();
+  OutputImagePixelType *     outputBuffer = outputPtr->GetBufferPointer();
+  const SizeValueType        length = spans.GetSpanLength();
+
+  ProgressReporter progress( this, threadId, spans.GetNumberOfSpans() );
+
+  for ( spans.GoToBegin(); !spans.IsAtEnd(); ++spans )
+    {
+    BatchFunctorTraits< FunctorType >::Apply( m_Functor,
+                                              inputBuffer + inputPtr->ComputeOffset( spans.GetIndex() ),
+                                              outputBuffer + outputPtr->ComputeOffset( spans.GetIndex() ),
+                                              length );
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+  return true;
+}
 } // end namespace itk
 
 #endif
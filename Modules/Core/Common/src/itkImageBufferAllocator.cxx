@@ -0,0 +1,482 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocator.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkMultiThreader.h"
+#include "itkPipelineProfiler.h"
+#include "itksys/SystemTools.hxx"
+#include <cstdlib>
+#include <map>
+
+namespace itk
+{
+namespace
+{
+/** A buffer allocated with malloc, and the number of bytes usable from its
+ * aligned address */
+struct Block
+{
+  void *        Memory;
+  size_t        Size;
+  unsigned long Release;
+};
+
+typedef std::map< const void *, Block > BlockMapType;
+typedef std::multimap< size_t, std::pair< void *, Block > > PoolType;
+
+// The state of the allocator. It is allocated on the first use and never
+// deleted, so that the containers released during the destruction of the
+// static objects still find it.
+struct AllocatorState
+{
+  AllocatorState() :
+    enabled(false),
+    alignment(64),
+    maximumPoolSize(256 * 1024 * 1024),
+    poolSize(0),
+    numberOfReleases(0),
+    numberOfAllocations(0),
+    numberOfRecycledAllocations(0),
+    numberOfDeallocations(0),
+    allocatedSize(0),
+    peakAllocatedSize(0)
+  {
+    std::string value;
+    if ( itksys::SystemTools::GetEnv("ITK_USE_IMAGE_BUFFER_ALLOCATOR", value) )
+      {
+      enabled = ( value == "ON" || value == "on" || value == "1" || value == "TRUE" || value == "true" );
+      }
+    if ( itksys::SystemTools::GetEnv("ITK_IMAGE_BUFFER_POOL_SIZE", value) )
+      {
+      maximumPoolSize = static_cast< size_t >( atol( value.c_str() ) ) * 1024 * 1024;
+      }
+  }
+
+  SimpleFastMutexLock lock;
+
+  // written with the lock held, but read without it by GetEnabled()
+  volatile bool enabled;
+
+  size_t        alignment;
+  size_t        maximumPoolSize;
+  BlockMapType  allocatedBlocks;
+  PoolType      pool;
+  size_t        poolSize;
+  unsigned long numberOfReleases;
+
+  size_t numberOfAllocations;
+  size_t numberOfRecycledAllocations;
+  size_t numberOfDeallocations;
+  size_t allocatedSize;
+  size_t peakAllocatedSize;
+};
+
+AllocatorState & GetState()
+{
+  static AllocatorState *state = new AllocatorState;
+  return *state;
+}
+
+// Create the state while the program is still single threaded
+const AllocatorState & initialState = GetState();
+
+// Thread-Data Structure for Fill()
+struct FillThreadStruct
+{
+  void *                                 Buffer;
+  size_t                                 NumberOfElements;
+  ImageBufferAllocator::FillFunctionType Fill;
+  const void *                           Value;
+};
+
+// Fill the part of the buffer of a thread: the same split as the regions of
+// the threads in most filters, along the slowest varying dimension
+ITK_THREAD_RETURN_TYPE FillThreaderCallback(void *arg)
+{
+  const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const FillThreadStruct *               str = static_cast< FillThreadStruct * >( info->UserData );
+
+  const size_t first = str->NumberOfElements / info->NumberOfThreads * info->ThreadID;
+  const size_t last = ( info->ThreadID + 1 == info->NumberOfThreads ) ? str->NumberOfElements
+                      : str->NumberOfElements / info->NumberOfThreads * ( info->ThreadID + 1 );
+
+  if ( PipelineProfiler::GetEnabled() )
+    {
+    const double start = PipelineProfiler::GetTime();
+    ( *str->Fill )(str->Buffer, first, last, str->Value);
+    PipelineProfiler::AddThreadRecord(info->ThreadID, start, PipelineProfiler::GetTime() - start, last - first);
+    }
+  else
+    {
+    ( *str->Fill )(str->Buffer, first, last, str->Value);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+// The sizes are rounded up so that a released buffer can be given back to
+// requests a little larger than the one it was allocated for: to 64 bytes
+// for the small buffers, and to an eighth of their power of two for the
+// large ones.
+size_t RoundSize(size_t size)
+{
+  size_t granularity = 64;
+  while ( granularity * 16 <= size )
+    {
+    granularity *= 2;
+    }
+  return ( size + granularity - 1 ) / granularity * granularity;
+}
+
+// Must be called with the lock held
+void FreeFromPool(PoolType::iterator it)
+{
+  AllocatorState & state = GetState();
+  state.poolSize -= it->second.second.Size;
+  free(it->second.second.Memory);
+  state.pool.erase(it);
+}
+
+// Make room for size bytes in the pool by freeing the buffers released
+// first. Must be called with the lock held.
+void TrimPool(size_t size)
+{
+  AllocatorState & state = GetState();
+  while ( !state.pool.empty() && state.poolSize + size > state.maximumPoolSize )
+    {
+    PoolType::iterator oldest = state.pool.begin();
+    for ( PoolType::iterator it = state.pool.begin(); it != state.pool.end(); ++it )
+      {
+      if ( it->second.second.Release < oldest->second.second.Release )
+        {
+        oldest = it;
+        }
+      }
+    FreeFromPool(oldest);
+    }
+}
+}
+
+void
+ImageBufferAllocator
+::SetEnabled(bool value)
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  state.enabled = value;
+  state.lock.Unlock();
+}
+
+bool
+ImageBufferAllocator
+::GetEnabled()
+{
+  return GetState().enabled;
+}
+
+void
+ImageBufferAllocator
+::SetAlignment(size_t value)
+{
+  AllocatorState & state = GetState();
+  size_t powerOfTwo = sizeof( void * );
+  while ( powerOfTwo < value )
+    {
+    powerOfTwo *= 2;
+    }
+  state.lock.Lock();
+  state.alignment = powerOfTwo;
+  state.lock.Unlock();
+}
+
+size_t
+ImageBufferAllocator
+::GetAlignment()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.alignment;
+  state.lock.Unlock();
+  return value;
+}
+
+void
+ImageBufferAllocator
+::SetMaximumPoolSize(size_t value)
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  state.maximumPoolSize = value;
+  TrimPool(0);
+  state.lock.Unlock();
+}
+
+size_t
+ImageBufferAllocator
+::GetMaximumPoolSize()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.maximumPoolSize;
+  state.lock.Unlock();
+  return value;
+}
+
+void *
+ImageBufferAllocator
+::Allocate(size_t size)
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  state.numberOfAllocations++;
+
+  if ( size == 0 )
+    {
+    size = 1;
+    }
+  const size_t roundedSize = RoundSize(size);
+  void *       buffer = 0;
+  Block        block;
+
+  // recycle the smallest buffer large enough in the pool, if it has the
+  // current alignment
+  for ( PoolType::iterator it = state.pool.lower_bound(size);
+        it != state.pool.end() && it->first <= roundedSize; ++it )
+    {
+    if ( reinterpret_cast< size_t >( it->second.first ) % state.alignment == 0 )
+      {
+      buffer = it->second.first;
+      block = it->second.second;
+      state.poolSize -= block.Size;
+      state.pool.erase(it);
+      state.numberOfRecycledAllocations++;
+      break;
+      }
+    }
+
+  if ( !buffer )
+    {
+    block.Size = roundedSize;
+    block.Memory = malloc(roundedSize + state.alignment - 1);
+    if ( !block.Memory && !state.pool.empty() )
+      {
+      // give the memory of the pool back to the system and try again
+      while ( !state.pool.empty() )
+        {
+        FreeFromPool( state.pool.begin() );
+        }
+      block.Memory = malloc(roundedSize + state.alignment - 1);
+      }
+    if ( !block.Memory )
+      {
+      state.lock.Unlock();
+      return 0;
+      }
+    const size_t address = reinterpret_cast< size_t >( block.Memory );
+    buffer = reinterpret_cast< void * >( ( address + state.alignment - 1 ) / state.alignment * state.alignment );
+    }
+
+  state.allocatedBlocks[buffer] = block;
+  state.allocatedSize += block.Size;
+  if ( state.allocatedSize > state.peakAllocatedSize )
+    {
+    state.peakAllocatedSize = state.allocatedSize;
+    }
+
+  state.lock.Unlock();
+  return buffer;
+}
+
+void
+ImageBufferAllocator
+::Deallocate(void *buffer)
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  BlockMapType::iterator it = state.allocatedBlocks.find(buffer);
+  if ( it == state.allocatedBlocks.end() )
+    {
+    state.lock.Unlock();
+    return;
+    }
+
+  Block block = it->second;
+  state.allocatedBlocks.erase(it);
+  state.allocatedSize -= block.Size;
+  state.numberOfDeallocations++;
+
+  if ( state.enabled && block.Size <= state.maximumPoolSize )
+    {
+    TrimPool(block.Size);
+    block.Release = state.numberOfReleases++;
+    state.pool.insert( PoolType::value_type( block.Size, std::make_pair(buffer, block) ) );
+    state.poolSize += block.Size;
+    }
+  else
+    {
+    free(block.Memory);
+    }
+  state.lock.Unlock();
+}
+
+bool
+ImageBufferAllocator
+::IsAllocated(const void *buffer)
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const bool allocated = state.allocatedBlocks.find(buffer) != state.allocatedBlocks.end();
+  state.lock.Unlock();
+  return allocated;
+}
+
+void
+ImageBufferAllocator
+::ReleasePool()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  while ( !state.pool.empty() )
+    {
+    FreeFromPool( state.pool.begin() );
+    }
+  state.lock.Unlock();
+}
+
+void
+ImageBufferAllocator
+::Fill(void *buffer, size_t numberOfElements, size_t elementSize,
+       FillFunctionType fill, const void *value)
+{
+  // Only the buffers of several megabytes are worth starting threads
+  const ThreadIdType numberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  if ( numberOfThreads < 2 || numberOfElements * elementSize < 4 * 1024 * 1024 )
+    {
+    ( *fill )(buffer, 0, numberOfElements, value);
+    return;
+    }
+
+  FillThreadStruct str;
+  str.Buffer = buffer;
+  str.NumberOfElements = numberOfElements;
+  str.Fill = fill;
+  str.Value = value;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(FillThreaderCallback, &str);
+  threader->SingleMethodExecute();
+}
+
+size_t
+ImageBufferAllocator
+::GetNumberOfAllocations()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.numberOfAllocations;
+  state.lock.Unlock();
+  return value;
+}
+
+size_t
+ImageBufferAllocator
+::GetNumberOfRecycledAllocations()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.numberOfRecycledAllocations;
+  state.lock.Unlock();
+  return value;
+}
+
+size_t
+ImageBufferAllocator
+::GetNumberOfDeallocations()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.numberOfDeallocations;
+  state.lock.Unlock();
+  return value;
+}
+
+size_t
+ImageBufferAllocator
+::GetAllocatedSize()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.allocatedSize;
+  state.lock.Unlock();
+  return value;
+}
+
+size_t
+ImageBufferAllocator
+::GetPeakAllocatedSize()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.peakAllocatedSize;
+  state.lock.Unlock();
+  return value;
+}
+
+size_t
+ImageBufferAllocator
+::GetPoolSize()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  const size_t value = state.poolSize;
+  state.lock.Unlock();
+  return value;
+}
+
+void
+ImageBufferAllocator
+::ResetStatistics()
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  state.numberOfAllocations = 0;
+  state.numberOfRecycledAllocations = 0;
+  state.numberOfDeallocations = 0;
+  state.peakAllocatedSize = state.allocatedSize;
+  state.lock.Unlock();
+}
+
+void
+ImageBufferAllocator
+::Print(std::ostream & os)
+{
+  AllocatorState & state = GetState();
+  state.lock.Lock();
+  os << "Enabled: " << state.enabled << std::endl;
+  os << "Alignment: " << state.alignment << std::endl;
+  os << "Maximum pool size: " << state.maximumPoolSize << std::endl;
+  os << "Pool size: " << state.poolSize << std::endl;
+  os << "Number of allocations: " << state.numberOfAllocations << std::endl;
+  os << "Number of recycled allocations: " << state.numberOfRecycledAllocations << std::endl;
+  os << "Number of deallocations: " << state.numberOfDeallocations << std::endl;
+  os << "Allocated size: " << state.allocatedSize << std::endl;
+  os << "Peak allocated size: " << state.peakAllocatedSize << std::endl;
+  state.lock.Unlock();
+}
+} // end namespace itk
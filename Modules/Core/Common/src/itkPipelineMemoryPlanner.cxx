@@ -0,0 +1,273 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineMemoryPlanner.h"
+#include "itkImageBufferAllocator.h"
+#include "itkCommand.h"
+
+#include <algorithm>
+
+namespace itk
+{
+PipelineMemoryPlanner
+::PipelineMemoryPlanner()
+{
+  m_ReuseBuffers = false;
+  m_NumberOfDataObjects = 0;
+  m_NumberOfReleasedDataObjects = 0;
+  m_PeakNumberOfDataObjects = 0;
+}
+
+void
+PipelineMemoryPlanner
+::AddOutput(DataObject *output)
+{
+  if ( output && !this->IsOutput(output) )
+    {
+    m_Outputs.push_back(output);
+    this->Modified();
+    }
+}
+
+void
+PipelineMemoryPlanner
+::ClearOutputs()
+{
+  if ( !m_Outputs.empty() )
+    {
+    m_Outputs.clear();
+    this->Modified();
+    }
+}
+
+bool
+PipelineMemoryPlanner
+::IsOutput(const DataObject *data) const
+{
+  for ( unsigned int i = 0; i < m_Outputs.size(); i++ )
+    {
+    if ( m_Outputs[i].GetPointer() == data )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+unsigned int
+PipelineMemoryPlanner
+::FindStep(const ProcessObject *process) const
+{
+  unsigned int step = 0;
+
+  while ( step < m_ProcessObjects.size() && m_ProcessObjects[step].GetPointer() != process )
+    {
+    step++;
+    }
+  return step;
+}
+
+void
+PipelineMemoryPlanner
+::Visit(DataObject *data, DataObjectArrayType & visited)
+{
+  if ( std::find(visited.begin(), visited.end(), data) != visited.end() )
+    {
+    return;
+    }
+  visited.push_back(data);
+
+  ProcessObject::Pointer source = data->GetSource().GetPointer();
+  if ( !source || this->FindStep(source) < m_ProcessObjects.size() )
+    {
+    return;
+    }
+
+  // the inputs are updated in order before the source executes, as in
+  // ProcessObject::UpdateOutputData()
+  ProcessObject::DataObjectPointerArray & inputs = source->GetInputs();
+  for ( unsigned int i = 0; i < inputs.size(); i++ )
+    {
+    if ( inputs[i] )
+      {
+      this->Visit(inputs[i], visited);
+      }
+    }
+  m_ProcessObjects.push_back(source);
+}
+
+void
+PipelineMemoryPlanner
+::Plan()
+{
+  m_ProcessObjects.clear();
+  m_Releases.clear();
+
+  DataObjectArrayType visited;
+  for ( unsigned int i = 0; i < m_Outputs.size(); i++ )
+    {
+    this->Visit(m_Outputs[i], visited);
+    }
+
+  const unsigned int numberOfSteps = this->GetNumberOfProcessObjects();
+  m_Releases.resize(numberOfSteps);
+
+  // the data objects produced by the pipeline and the last step using them
+  DataObjectArrayType         produced;
+  std::vector< unsigned int > lastUse;
+  std::vector< unsigned int > producedAt(numberOfSteps, 0);
+  for ( unsigned int step = 0; step < numberOfSteps; step++ )
+    {
+    ProcessObject::DataObjectPointerArray & outputs = m_ProcessObjects[step]->GetOutputs();
+    for ( unsigned int i = 0; i < outputs.size(); i++ )
+      {
+      if ( outputs[i] )
+        {
+        produced.push_back(outputs[i]);
+        lastUse.push_back(numberOfSteps);
+        producedAt[step]++;
+        }
+      }
+    }
+  for ( unsigned int step = 0; step < numberOfSteps; step++ )
+    {
+    ProcessObject::DataObjectPointerArray & inputs = m_ProcessObjects[step]->GetInputs();
+    for ( unsigned int i = 0; i < inputs.size(); i++ )
+      {
+      const DataObjectArrayType::iterator it = std::find(produced.begin(), produced.end(), inputs[i]);
+      if ( inputs[i] && it != produced.end() )
+        {
+        lastUse[it - produced.begin()] = step;
+        }
+      }
+    }
+
+  // the data objects used in the pipeline, which are not outputs, are
+  // released after their last use
+  for ( unsigned int i = 0; i < produced.size(); i++ )
+    {
+    if ( lastUse[i] < numberOfSteps && !this->IsOutput(produced[i]) )
+      {
+      m_Releases[lastUse[i]].push_back(produced[i]);
+      }
+    }
+
+  m_NumberOfDataObjects = static_cast< unsigned int >( produced.size() );
+  m_PeakNumberOfDataObjects = 0;
+  unsigned int numberInMemory = 0;
+  for ( unsigned int step = 0; step < numberOfSteps; step++ )
+    {
+    numberInMemory += producedAt[step];
+    m_PeakNumberOfDataObjects = std::max(m_PeakNumberOfDataObjects, numberInMemory);
+    numberInMemory -= static_cast< unsigned int >( m_Releases[step].size() );
+    }
+
+  itkDebugMacro(<< numberOfSteps << " process objects, " << m_NumberOfDataObjects
+                << " data objects, at most " << m_PeakNumberOfDataObjects << " in memory");
+}
+
+void
+PipelineMemoryPlanner
+::ReleaseConsumedData(Object *caller, const EventObject & itkNotUsed(event))
+{
+  const unsigned int step = this->FindStep( dynamic_cast< ProcessObject * >( caller ) );
+
+  if ( step < m_Releases.size() )
+    {
+    for ( unsigned int i = 0; i < m_Releases[step].size(); i++ )
+      {
+      m_Releases[step][i]->ReleaseData();
+      m_NumberOfReleasedDataObjects++;
+      }
+    }
+}
+
+void
+PipelineMemoryPlanner
+::Update()
+{
+  this->Plan();
+
+  const bool allocatorEnabled = ImageBufferAllocator::GetEnabled();
+  if ( m_ReuseBuffers )
+    {
+    ImageBufferAllocator::SetEnabled(true);
+    }
+
+  typedef MemberCommand< Self > CommandType;
+  CommandType::Pointer command = CommandType::New();
+  command->SetCallbackFunction(this, &Self::ReleaseConsumedData);
+
+  std::vector< unsigned long > tags( m_ProcessObjects.size() );
+  for ( unsigned int step = 0; step < m_ProcessObjects.size(); step++ )
+    {
+    if ( !m_Releases[step].empty() )
+      {
+      tags[step] = m_ProcessObjects[step]->AddObserver(EndEvent(), command);
+      }
+    }
+
+  m_NumberOfReleasedDataObjects = 0;
+  try
+    {
+    for ( unsigned int i = 0; i < m_Outputs.size(); i++ )
+      {
+      m_Outputs[i]->Update();
+      }
+    }
+  catch ( ... )
+    {
+    for ( unsigned int step = 0; step < m_ProcessObjects.size(); step++ )
+      {
+      if ( !m_Releases[step].empty() )
+        {
+        m_ProcessObjects[step]->RemoveObserver(tags[step]);
+        }
+      }
+    ImageBufferAllocator::SetEnabled(allocatorEnabled);
+    throw;
+    }
+
+  for ( unsigned int step = 0; step < m_ProcessObjects.size(); step++ )
+    {
+    if ( !m_Releases[step].empty() )
+      {
+      m_ProcessObjects[step]->RemoveObserver(tags[step]);
+      }
+    }
+  ImageBufferAllocator::SetEnabled(allocatorEnabled);
+}
+
+void
+PipelineMemoryPlanner
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Outputs: " << m_Outputs.size() << std::endl;
+  os << indent << "ReuseBuffers: " << ( m_ReuseBuffers ? "On" : "Off" ) << std::endl;
+  os << indent << "NumberOfDataObjects: " << m_NumberOfDataObjects << std::endl;
+  os << indent << "NumberOfReleasedDataObjects: " << m_NumberOfReleasedDataObjects << std::endl;
+  os << indent << "PeakNumberOfDataObjects: " << m_PeakNumberOfDataObjects << std::endl;
+  for ( unsigned int step = 0; step < m_ProcessObjects.size(); step++ )
+    {
+    os << indent << "Step " << step << ": " << m_ProcessObjects[step]->GetNameOfClass()
+       << " (" << m_ProcessObjects[step].GetPointer() << "), releases "
+       << m_Releases[step].size() << " data objects" << std::endl;
+    }
+}
+} // end namespace itk
@@ -0,0 +1,378 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineProfiler.h"
+#include "itkProcessObject.h"
+#include "itkImageBase.h"
+#include "itkMemoryUsageObserver.h"
+#include "itkRealTimeClock.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itksys/SystemTools.hxx"
+#include <algorithm>
+
+namespace itk
+{
+namespace
+{
+SimpleFastMutexLock profilerLock;
+
+// Whether ITK_PIPELINE_PROFILER enables the profiler
+bool EnabledByEnvironment()
+{
+  std::string value;
+  if ( itksys::SystemTools::GetEnv("ITK_PIPELINE_PROFILER", value) )
+    {
+    return ( value == "ON" || value == "on" || value == "1" || value == "TRUE" || value == "true" );
+    }
+  return false;
+}
+
+// Written with the lock held, but read without it by GetEnabled(), which
+// is called at each execution of a filter and each allocation of an image
+volatile bool enabled = EnabledByEnvironment();
+
+bool                                    initialized = false;
+RealTimeClock::Pointer                  realTimeClock;
+RealTimeClock::TimeStampType            origin = 0;
+MemoryUsageObserver                     memoryObserver;
+std::vector< PipelineProfiler::Record > records;
+
+// indices in records of the executions not finished, innermost last
+std::vector< unsigned int > active;
+
+// Must be called with the lock held
+void Initialize()
+{
+  if ( initialized )
+    {
+    return;
+    }
+  initialized = true;
+
+  realTimeClock = RealTimeClock::New();
+  origin = realTimeClock->GetTimeInSeconds();
+}
+
+// Add the pixels of the requested and buffered regions of the output, if it
+// is an image of the given dimension
+template< unsigned int VDimension >
+bool AddImageRegions(const DataObject *output, PipelineProfiler::Record & record)
+{
+  const ImageBase< VDimension > *image = dynamic_cast< const ImageBase< VDimension > * >( output );
+
+  if ( !image )
+    {
+    return false;
+    }
+  record.RequestedNumberOfPixels += image->GetRequestedRegion().GetNumberOfPixels();
+  record.BufferedNumberOfPixels += image->GetBufferedRegion().GetNumberOfPixels();
+  return true;
+}
+
+// Must be called with the lock held
+PipelineProfiler::Record * FindActiveRecord(const ProcessObject *process)
+{
+  for ( std::vector< unsigned int >::reverse_iterator it = active.rbegin(); it != active.rend(); ++it )
+    {
+    if ( records[*it].ProcessObject == process )
+      {
+      return &records[*it];
+      }
+    }
+  return 0;
+}
+
+// Quote a field of the CSV table if needed
+std::string CSVField(const std::string & field)
+{
+  if ( field.find_first_of(",\"\n") == std::string::npos )
+    {
+    return field;
+    }
+  std::string quoted = "\"";
+  for ( std::string::size_type i = 0; i < field.size(); i++ )
+    {
+    if ( field[i] == '"' )
+      {
+      quoted += '"';
+      }
+    quoted += field[i];
+    }
+  return quoted + "\"";
+}
+
+// Escape a JSON string
+std::string JSONString(const std::string & value)
+{
+  std::string escaped = "\"";
+  for ( std::string::size_type i = 0; i < value.size(); i++ )
+    {
+    if ( value[i] == '"' || value[i] == '\\' )
+      {
+      escaped += '\\';
+      }
+    escaped += value[i];
+    }
+  return escaped + "\"";
+}
+}
+
+void
+PipelineProfiler
+::SetEnabled(bool value)
+{
+  profilerLock.Lock();
+  Initialize();
+  if ( value && !enabled )
+    {
+    origin = realTimeClock->GetTimeInSeconds();
+    }
+  enabled = value;
+  profilerLock.Unlock();
+}
+
+bool
+PipelineProfiler
+::GetEnabled()
+{
+  return enabled;
+}
+
+void
+PipelineProfiler
+::Clear()
+{
+  profilerLock.Lock();
+  Initialize();
+  records.clear();
+  active.clear();
+  origin = realTimeClock->GetTimeInSeconds();
+  profilerLock.Unlock();
+}
+
+double
+PipelineProfiler
+::GetTime()
+{
+  profilerLock.Lock();
+  Initialize();
+  const double time = realTimeClock->GetTimeInSeconds() - origin;
+  profilerLock.Unlock();
+  return time;
+}
+
+void
+PipelineProfiler
+::StartProcessObject(const ProcessObject *process)
+{
+  profilerLock.Lock();
+  Initialize();
+
+  Record record;
+  record.NameOfClass = process->GetNameOfClass();
+  record.ProcessObject = process;
+  record.Depth = static_cast< unsigned int >( active.size() );
+  record.BytesAllocated = 0;
+  record.MemoryUsageBefore = memoryObserver.GetMemoryUsage();
+  record.MemoryUsageAfter = record.MemoryUsageBefore;
+  record.RequestedNumberOfPixels = 0;
+  record.BufferedNumberOfPixels = 0;
+  record.Time = 0;
+
+  active.push_back( static_cast< unsigned int >( records.size() ) );
+  records.push_back(record);
+
+  // the time starts last, not to count the work of the profiler
+  records.back().Start = realTimeClock->GetTimeInSeconds() - origin;
+  profilerLock.Unlock();
+}
+
+void
+PipelineProfiler
+::StopProcessObject(const ProcessObject *process)
+{
+  const RealTimeClock::TimeStampType stop = realTimeClock->GetTimeInSeconds() - origin;
+
+  profilerLock.Lock();
+  Record *record = FindActiveRecord(process);
+  if ( record )
+    {
+    record->Time = stop - record->Start;
+    record->MemoryUsageAfter = memoryObserver.GetMemoryUsage();
+
+    const ProcessObject::DataObjectPointerArray & outputs =
+      const_cast< ProcessObject * >( process )->GetOutputs();
+    for ( unsigned int i = 0; i < outputs.size(); i++ )
+      {
+      if ( outputs[i] )
+        {
+        AddImageRegions< 1 >(outputs[i], *record)
+        || AddImageRegions< 2 >(outputs[i], *record)
+        || AddImageRegions< 3 >(outputs[i], *record)
+        || AddImageRegions< 4 >(outputs[i], *record);
+        }
+      }
+
+    // the executions started in it are finished
+    while ( &records[active.back()] != record )
+      {
+      active.pop_back();
+      }
+    active.pop_back();
+    }
+  profilerLock.Unlock();
+}
+
+void
+PipelineProfiler
+::AddThreadRecord(const ProcessObject *process, ThreadIdType threadId,
+                  double start, double time, SizeValueType numberOfPixels)
+{
+  ThreadRecord thread;
+
+  thread.ThreadId = threadId;
+  thread.Start = start;
+  thread.Time = time;
+  thread.NumberOfPixels = numberOfPixels;
+
+  profilerLock.Lock();
+  Record *record = FindActiveRecord(process);
+  if ( record )
+    {
+    record->Threads.push_back(thread);
+    }
+  profilerLock.Unlock();
+}
+
+void
+PipelineProfiler
+::AddThreadRecord(ThreadIdType threadId, double start, double time, SizeValueType numberOfPixels)
+{
+  ThreadRecord thread;
+
+  thread.ThreadId = threadId;
+  thread.Start = start;
+  thread.Time = time;
+  thread.NumberOfPixels = numberOfPixels;
+
+  profilerLock.Lock();
+  if ( !active.empty() )
+    {
+    records[active.back()].Threads.push_back(thread);
+    }
+  profilerLock.Unlock();
+}
+
+void
+PipelineProfiler
+::AddAllocation(SizeValueType bytes)
+{
+  profilerLock.Lock();
+  if ( !active.empty() )
+    {
+    records[active.back()].BytesAllocated += bytes;
+    }
+  profilerLock.Unlock();
+}
+
+unsigned int
+PipelineProfiler
+::GetNumberOfRecords()
+{
+  profilerLock.Lock();
+  const unsigned int number = static_cast< unsigned int >( records.size() );
+  profilerLock.Unlock();
+  return number;
+}
+
+PipelineProfiler::Record
+PipelineProfiler
+::GetRecord(unsigned int i)
+{
+  profilerLock.Lock();
+  const Record record = records[i];
+  profilerLock.Unlock();
+  return record;
+}
+
+void
+PipelineProfiler
+::WriteCSV(std::ostream & os)
+{
+  profilerLock.Lock();
+  os << "Filter,Object,Depth,Start,Time,NumberOfThreads,MaximumThreadTime,MeanThreadTime,"
+     << "BytesAllocated,MemoryUsageBefore,MemoryUsageAfter,RequestedNumberOfPixels,BufferedNumberOfPixels"
+     << std::endl;
+  for ( unsigned int i = 0; i < records.size(); i++ )
+    {
+    const Record & record = records[i];
+    double         maximumThreadTime = 0;
+    double         meanThreadTime = 0;
+    for ( unsigned int t = 0; t < record.Threads.size(); t++ )
+      {
+      maximumThreadTime = std::max(maximumThreadTime, record.Threads[t].Time);
+      meanThreadTime += record.Threads[t].Time;
+      }
+    if ( !record.Threads.empty() )
+      {
+      meanThreadTime /= record.Threads.size();
+      }
+    os << CSVField(record.NameOfClass) << ',' << record.ProcessObject << ',' << record.Depth << ','
+       << record.Start << ',' << record.Time << ',' << record.Threads.size() << ','
+       << maximumThreadTime << ',' << meanThreadTime << ',' << record.BytesAllocated << ','
+       << record.MemoryUsageBefore << ',' << record.MemoryUsageAfter << ','
+       << record.RequestedNumberOfPixels << ',' << record.BufferedNumberOfPixels << std::endl;
+    }
+  profilerLock.Unlock();
+}
+
+void
+PipelineProfiler
+::WriteChromeTrace(std::ostream & os)
+{
+  profilerLock.Lock();
+  os << "{\"traceEvents\":[";
+  const char *separator = "\n";
+  for ( unsigned int i = 0; i < records.size(); i++ )
+    {
+    const Record & record = records[i];
+    os << separator << "{\"name\":" << JSONString(record.NameOfClass)
+       << ",\"cat\":\"filter\",\"ph\":\"X\",\"pid\":1,\"tid\":0"
+       << ",\"ts\":" << static_cast< OffsetValueType >( record.Start * 1e6 )
+       << ",\"dur\":" << static_cast< OffsetValueType >( record.Time * 1e6 )
+       << ",\"args\":{\"object\":\"" << record.ProcessObject << "\""
+       << ",\"depth\":" << record.Depth
+       << ",\"bytesAllocated\":" << record.BytesAllocated
+       << ",\"memoryUsageBefore\":" << record.MemoryUsageBefore
+       << ",\"memoryUsageAfter\":" << record.MemoryUsageAfter
+       << ",\"requestedPixels\":" << record.RequestedNumberOfPixels
+       << ",\"bufferedPixels\":" << record.BufferedNumberOfPixels << "}}";
+    separator = ",\n";
+    for ( unsigned int t = 0; t < record.Threads.size(); t++ )
+      {
+      const ThreadRecord & thread = record.Threads[t];
+      os << separator << "{\"name\":" << JSONString(record.NameOfClass)
+         << ",\"cat\":\"thread\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.ThreadId + 1
+         << ",\"ts\":" << static_cast< OffsetValueType >( thread.Start * 1e6 )
+         << ",\"dur\":" << static_cast< OffsetValueType >( thread.Time * 1e6 )
+         << ",\"args\":{\"pixels\":" << thread.NumberOfPixels << "}}";
+      }
+    }
+  os << "\n]}" << std::endl;
+  profilerLock.Unlock();
+}
+} // end namespace itk
@@ -27,6 +27,7 @@
  *=========================================================================*/
 #include "itkProcessObject.h"
 #include "itkCommand.h"
+#include "itkPipelineProfiler.h"
 
 #include <functional>
 #include <algorithm>
@@ -962,6 +963,7 @@ ProcessObject
   m_AbortGenerateData = false;
   m_Progress = 0.0f;
 
+  bool profiling = false;
   try
     {
     /**
@@ -975,10 +977,19 @@ ProcessObject
                         << " are specified.");
       }
 
+    profiling = PipelineProfiler::GetEnabled();
+    if ( profiling )
+      {
+      PipelineProfiler::StartProcessObject(this);
+      }
     this->GenerateData();
     }
   catch ( ProcessAborted & excp )
     {
+    if ( profiling )
+      {
+      PipelineProfiler::StopProcessObject(this);
+      }
     this->InvokeEvent( AbortEvent() );
     this->ResetPipeline();
     this->RestoreInputReleaseDataFlags();
@@ -986,11 +997,20 @@ ProcessObject
     }
   catch (...)
     {
+    if ( profiling )
+      {
+      PipelineProfiler::StopProcessObject(this);
+      }
     this->ResetPipeline();
     this->RestoreInputReleaseDataFlags();
     throw;
     }
 
+  if ( profiling )
+    {
+    PipelineProfiler::StopProcessObject(this);
+    }
+
   /**
    * If we ended due to aborting, push the progress up to 1.0 (since
    * it probably didn't end there)
@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkCompensatedSummation.h"
+#include "vnl/vnl_math.h"
+#include <iostream>
+
+// The compensated sum of many values must be as precise as a single
+// rounding, where the naive sum drifts, and partial sums must combine
+// without losing their compensation.
+
+int itkCompensatedSummationTest(int, char *[])
+{
+  const unsigned int numberOfValues = 10000000;
+
+  // 0.1 is not exact in binary: its naive sum accumulates the rounding
+  // errors of every addition
+  const double value = 0.1;
+  const double expected = numberOfValues * value;
+
+  double                               naiveSum = 0.0;
+  itk::CompensatedSummation< double > sum;
+  itk::CompensatedSummation< double > partialSums[4];
+  for ( unsigned int i = 0; i < numberOfValues; i++ )
+    {
+    naiveSum += value;
+    sum += value;
+    partialSums[i % 4].AddElement(value);
+    }
+
+  itk::CompensatedSummation< double > combinedSum;
+  for ( unsigned int i = 0; i < 4; i++ )
+    {
+    combinedSum += partialSums[i];
+    }
+
+  std::cout.precision(17);
+  std::cout << "Expected:    " << expected << std::endl;
+  std::cout << "Naive:       " << naiveSum << std::endl;
+  std::cout << "Compensated: " << sum.GetSum() << std::endl;
+  std::cout << "Combined:    " << combinedSum.GetSum() << std::endl;
+
+  const double tolerance = 4 * vnl_math::eps * expected;
+  if ( vnl_math_abs(sum.GetSum() - expected) > tolerance )
+    {
+    std::cerr << "The compensated sum is not precise" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( vnl_math_abs(combinedSum.GetSum() - expected) > tolerance )
+    {
+    std::cerr << "The combined partial sums are not precise" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a small value added to a large one is not lost
+  itk::CompensatedSummation< float > floatSum(1.0e8f);
+  for ( unsigned int i = 0; i < 1000; i++ )
+    {
+    floatSum += 1.0f;
+    }
+  floatSum += -1.0e8f;
+  std::cout << "Float: " << floatSum.GetSum() << std::endl;
+  if ( floatSum.GetSum() != 1000.0f )
+    {
+    std::cerr << "The small values were lost in the float sum" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  sum.ResetToZero();
+  if ( sum.GetSum() != 0.0 )
+    {
+    std::cerr << "ResetToZero failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,341 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConstInteriorNeighborhoodIterator.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkNeighborhoodInnerProduct.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVectorImage.h"
+#include "itkTimeProbe.h"
+
+// The interior iterator must visit the same pixels, in the same order, and
+// give the same neighbors as ConstNeighborhoodIterator. The second part
+// compares the time of both iterators on the usual neighborhood operations;
+// the number of repetitions can be given as argument.
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer MakeImage(const typename TImage::RegionType & region)
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, region );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    typename TImage::PixelType::ValueType value = 0;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+      {
+      value = value * 31 + it.GetIndex()[d];
+      }
+    typename TImage::PixelType pixel;
+    pixel.Fill(value);
+    it.Set(pixel);
+    }
+  return image;
+}
+
+template< class TImage >
+bool Compare(const TImage *image, const typename TImage::RegionType & region,
+             const typename TImage::SizeType & radius)
+{
+  typedef itk::ConstNeighborhoodIterator< TImage >         IteratorType;
+  typedef itk::ConstInteriorNeighborhoodIterator< TImage > InteriorIteratorType;
+
+  if ( !InteriorIteratorType::IsInterior(radius, image, region) )
+    {
+    std::cerr << "Region " << region << " not interior" << std::endl;
+    return false;
+    }
+
+  IteratorType         it(radius, image, region);
+  InteriorIteratorType iit(radius, image, region);
+  typename TImage::OffsetType offset;
+  offset.Fill(0);
+  offset[0] = -static_cast< itk::OffsetValueType >( radius[0] );
+
+  if ( iit.Size() != it.Size() || iit.GetCenterNeighborhoodIndex() != it.GetCenterNeighborhoodIndex()
+       || iit.GetNeighborhoodIndex(offset) != it.GetNeighborhoodIndex(offset) )
+    {
+    std::cerr << "Wrong neighborhood size" << std::endl;
+    return false;
+    }
+
+  itk::SizeValueType count = 0;
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++iit, ++count )
+    {
+    if ( iit.IsAtEnd() || iit.GetIndex() != it.GetIndex() || iit.GetCenterPointer() != it.GetCenterPointer()
+         || iit.GetPixel(offset) != it.GetPixel(offset) || iit.GetCenterPixel() != it.GetCenterPixel() )
+      {
+      std::cerr << "Wrong position " << iit.GetIndex() << " instead of " << it.GetIndex() << std::endl;
+      return false;
+      }
+    for ( unsigned int i = 0; i < it.Size(); i++ )
+      {
+      if ( iit.GetPixel(i) != it.GetPixel(i) || iit[i] != it[i] )
+        {
+        std::cerr << "Wrong neighbor " << i << " at " << it.GetIndex() << std::endl;
+        return false;
+        }
+      }
+    }
+  if ( !iit.IsAtEnd() || count != region.GetNumberOfPixels() )
+    {
+    std::cerr << "Wrong number of pixels visited " << count << std::endl;
+    return false;
+    }
+
+  iit.GoToBegin();
+  if ( iit.IsAtEnd() != ( region.GetNumberOfPixels() == 0 )
+       || ( !iit.IsAtEnd() && iit.GetIndex() != region.GetIndex() ) )
+    {
+    std::cerr << "Wrong GoToBegin()" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+// Time the sum of the neighborhoods of the interior of the image with the
+// usual iterator, the interior iterator, and the raw offsets, and the inner
+// product with an operator with both iterators
+template< class TImage >
+bool Benchmark(const TImage *image, const typename TImage::SizeType & radius, unsigned int repetitions)
+{
+  typedef itk::ConstNeighborhoodIterator< TImage >               IteratorType;
+  typedef itk::ConstInteriorNeighborhoodIterator< TImage >       InteriorIteratorType;
+  typedef itk::NeighborhoodInnerProduct< TImage, float, double > InnerProductType;
+  typedef typename InnerProductType::OperatorType                OperatorType;
+  typedef typename TImage::InternalPixelType                     InternalPixelType;
+
+  typename TImage::RegionType region = image->GetBufferedRegion();
+  region.PadByRadius(-1 * static_cast< int >( radius[0] ));
+
+  OperatorType op;
+  op.SetRadius(radius);
+  for ( unsigned int i = 0; i < op.Size(); i++ )
+    {
+    op[i] = 1.0f / ( i + 1 );
+    }
+  InnerProductType innerProduct;
+
+  itk::TimeProbe probes[5];
+  double         sums[5] = { 0, 0, 0, 0, 0 };
+  for ( unsigned int r = 0; r < repetitions; r++ )
+    {
+    probes[0].Start();
+    for ( IteratorType it(radius, image, region); !it.IsAtEnd(); ++it )
+      {
+      float sum = 0;
+      for ( unsigned int i = 0; i < it.Size(); i++ )
+        {
+        sum += it.GetPixel(i);
+        }
+      sums[0] += sum;
+      }
+    probes[0].Stop();
+
+    probes[1].Start();
+    for ( InteriorIteratorType it(radius, image, region); !it.IsAtEnd(); ++it )
+      {
+      float sum = 0;
+      for ( unsigned int i = 0; i < it.Size(); i++ )
+        {
+        sum += it.GetPixel(i);
+        }
+      sums[1] += sum;
+      }
+    probes[1].Stop();
+
+    probes[2].Start();
+    for ( InteriorIteratorType it(radius, image, region); !it.IsAtEnd(); ++it )
+      {
+      const InternalPixelType *                                  center = it.GetCenterPointer();
+      const typename InteriorIteratorType::NeighborOffsetsType & offsets = it.GetNeighborOffsets();
+      float                                                      sum = 0;
+      for ( unsigned int i = 0; i < offsets.size(); i++ )
+        {
+        sum += center[offsets[i]];
+        }
+      sums[2] += sum;
+      }
+    probes[2].Stop();
+
+    probes[3].Start();
+    for ( IteratorType it(radius, image, region); !it.IsAtEnd(); ++it )
+      {
+      sums[3] += innerProduct(it, op);
+      }
+    probes[3].Stop();
+
+    probes[4].Start();
+    for ( InteriorIteratorType it(radius, image, region); !it.IsAtEnd(); ++it )
+      {
+      sums[4] += innerProduct(it, op);
+      }
+    probes[4].Stop();
+    }
+
+  const char *names[5] = { "ConstNeighborhoodIterator sum", "ConstInteriorNeighborhoodIterator sum",
+                           "Raw offsets sum", "ConstNeighborhoodIterator inner product",
+                           "ConstInteriorNeighborhoodIterator inner product" };
+  std::cout << "Image " << image->GetBufferedRegion().GetSize() << ", radius " << radius << std::endl;
+  for ( unsigned int p = 0; p < 5; p++ )
+    {
+    std::cout << "  " << names[p] << ": " << probes[p].GetMean() << " s" << std::endl;
+    }
+
+  if ( sums[1] != sums[0] || sums[2] != sums[0] || sums[4] != sums[3] )
+    {
+    std::cerr << "The iterators give different sums" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkConstInteriorNeighborhoodIteratorTest(int argc, char *argv[])
+{
+  typedef itk::Image< itk::FixedArray< float, 1 >, 3 > ArrayImageType;
+  typedef itk::Image< float, 3 >                       ImageType;
+  typedef itk::Image< itk::FixedArray< short, 1 >, 1 > LineImageType;
+  typedef itk::VectorImage< float, 2 >                 VectorImageType;
+
+  bool pass = true;
+
+  // 3D, not starting at the origin, and regions in the interior
+  ArrayImageType::IndexType start;
+  start[0] = -3;
+  start[1] = 5;
+  start[2] = 2;
+  ArrayImageType::SizeType size;
+  size[0] = 13;
+  size[1] = 9;
+  size[2] = 7;
+  ArrayImageType::Pointer image = MakeImage< ArrayImageType >( ArrayImageType::RegionType(start, size) );
+
+  ArrayImageType::SizeType radius;
+  radius[0] = 2;
+  radius[1] = 1;
+  radius[2] = 0;
+  ArrayImageType::RegionType region = image->GetBufferedRegion();
+  region.SetIndex(0, start[0] + 2);
+  region.SetSize(0, size[0] - 4);
+  region.SetIndex(1, start[1] + 1);
+  region.SetSize(1, size[1] - 3);
+  pass &= Compare< ArrayImageType >(image, region, radius);
+
+  radius.Fill(1);
+  region.SetIndex(2, start[2] + 1);
+  region.SetSize(2, 2);
+  pass &= Compare< ArrayImageType >(image, region, radius);
+
+  // an empty region
+  region.SetSize(1, 0);
+  pass &= Compare< ArrayImageType >(image, region, radius);
+
+  // a region on the boundary is refused
+  region = image->GetBufferedRegion();
+  if ( itk::ConstInteriorNeighborhoodIterator< ArrayImageType >::IsInterior(radius, image, region) )
+    {
+    std::cerr << "Boundary region accepted" << std::endl;
+    pass = false;
+    }
+  bool caught = false;
+  try
+    {
+    itk::ConstInteriorNeighborhoodIterator< ArrayImageType > it(radius, image, region);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "No exception for a boundary region" << std::endl;
+    pass = false;
+    }
+
+  // 1D
+  LineImageType::SizeType lineSize;
+  lineSize[0] = 20;
+  LineImageType::Pointer line = MakeImage< LineImageType >( LineImageType::RegionType(lineSize) );
+  LineImageType::SizeType lineRadius;
+  lineRadius[0] = 3;
+  LineImageType::RegionType lineRegion = line->GetBufferedRegion();
+  lineRegion.PadByRadius(-3);
+  pass &= Compare< LineImageType >(line, lineRegion, lineRadius);
+
+  // the pixels of a vector image go through the accessor
+  VectorImageType::SizeType vectorSize;
+  vectorSize[0] = 8;
+  vectorSize[1] = 6;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(vectorSize);
+  vectorImage->SetVectorLength(3);
+  vectorImage->Allocate();
+  for ( unsigned int i = 0; i < 8 * 6 * 3; i++ )
+    {
+    vectorImage->GetBufferPointer()[i] = i;
+    }
+  VectorImageType::SizeType vectorRadius;
+  vectorRadius.Fill(1);
+  VectorImageType::RegionType vectorRegion = vectorImage->GetBufferedRegion();
+  vectorRegion.PadByRadius(-1);
+  itk::ConstNeighborhoodIterator< VectorImageType >         vit(vectorRadius, vectorImage, vectorRegion);
+  itk::ConstInteriorNeighborhoodIterator< VectorImageType > viit(vectorRadius, vectorImage, vectorRegion);
+  for (; !vit.IsAtEnd(); ++vit, ++viit )
+    {
+    for ( unsigned int i = 0; i < vit.Size(); i++ )
+      {
+      if ( vit.GetPixel(i) != viit.GetPixel(i) )
+        {
+        std::cerr << "Wrong vector neighbor " << i << " at " << vit.GetIndex() << std::endl;
+        pass = false;
+        }
+      }
+    }
+
+  // timings
+  const unsigned int repetitions = argc > 1 ? atoi(argv[1]) : 1;
+  ImageType::SizeType benchmarkSize;
+  benchmarkSize.Fill(64);
+  ImageType::Pointer benchmarkImage = ImageType::New();
+  benchmarkImage->SetRegions(benchmarkSize);
+  benchmarkImage->Allocate();
+  for ( itk::SizeValueType i = 0; i < benchmarkImage->GetBufferedRegion().GetNumberOfPixels(); i++ )
+    {
+    benchmarkImage->GetBufferPointer()[i] = i % 17;
+    }
+  ImageType::SizeType benchmarkRadius;
+  benchmarkRadius.Fill(1);
+  pass &= Benchmark< ImageType >(benchmarkImage, benchmarkRadius, repetitions);
+  benchmarkRadius.Fill(2);
+  pass &= Benchmark< ImageType >(benchmarkImage, benchmarkRadius, repetitions);
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImage.h"
+#include "itkImageBufferAllocator.h"
+#include "itkMultiThreader.h"
+#include "itkVector.h"
+
+// The image buffers must be aligned, recycled when images of the same size
+// are allocated again, and counted in the statistics. A buffer taken over
+// from its container is released with Deallocate(). FillBuffer() must fill
+// the whole of a large buffer.
+
+int itkImageBufferAllocatorTest(int, char *[])
+{
+  typedef itk::Image< float, 3 >                     ImageType;
+  typedef itk::Image< itk::Vector< double, 3 >, 2 > VectorImageType;
+
+  itk::ImageBufferAllocator::SetEnabled(true);
+  itk::ImageBufferAllocator::SetAlignment(64);
+  itk::ImageBufferAllocator::SetMaximumPoolSize(64 * 1024 * 1024);
+  itk::ImageBufferAllocator::ReleasePool();
+  itk::ImageBufferAllocator::ResetStatistics();
+  itk::ImageBufferAllocator::Print(std::cout);
+
+  bool pass = true;
+
+  ImageType::SizeType size;
+  size[0] = 101;
+  size[1] = 67;
+  size[2] = 13;
+
+  // The second and third images reuse the buffer of the first one
+  for ( unsigned int i = 0; i < 3; i++ )
+    {
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(size);
+    image->Allocate();
+    image->FillBuffer(i);
+    if ( reinterpret_cast< size_t >( image->GetBufferPointer() ) % 64 != 0 )
+      {
+      std::cerr << "The buffer " << static_cast< void * >( image->GetBufferPointer() )
+                << " is not aligned" << std::endl;
+      pass = false;
+      }
+    if ( itk::ImageBufferAllocator::GetAllocatedSize() < image->GetBufferedRegion().GetNumberOfPixels() * sizeof( float ) )
+      {
+      std::cerr << "Allocated size " << itk::ImageBufferAllocator::GetAllocatedSize() << " too small" << std::endl;
+      pass = false;
+      }
+    }
+  if ( itk::ImageBufferAllocator::GetNumberOfAllocations() != 3
+       || itk::ImageBufferAllocator::GetNumberOfRecycledAllocations() != 2
+       || itk::ImageBufferAllocator::GetNumberOfDeallocations() != 3
+       || itk::ImageBufferAllocator::GetAllocatedSize() != 0
+       || itk::ImageBufferAllocator::GetPoolSize() == 0 )
+    {
+    std::cerr << "Wrong statistics after allocating images of the same size" << std::endl;
+    itk::ImageBufferAllocator::Print(std::cerr);
+    pass = false;
+    }
+
+  // A slightly smaller image still reuses the buffer
+  ImageType::SizeType smallerSize = size;
+  smallerSize[0] -= 1;
+  ImageType::Pointer smaller = ImageType::New();
+  smaller->SetRegions(smallerSize);
+  smaller->Allocate();
+  if ( itk::ImageBufferAllocator::GetNumberOfRecycledAllocations() != 3 )
+    {
+    std::cerr << "The buffer was not reused for a smaller image" << std::endl;
+    pass = false;
+    }
+
+  // Taking over the buffer: the application releases it
+  smaller->GetPixelContainer()->ContainerManageMemoryOff();
+  float *buffer = smaller->GetBufferPointer();
+  smaller = 0;
+  if ( !itk::ImageBufferAllocator::IsAllocated(buffer) )
+    {
+    std::cerr << "The buffer taken over was released" << std::endl;
+    pass = false;
+    }
+  itk::ImageBufferAllocator::Deallocate(buffer);
+  if ( itk::ImageBufferAllocator::IsAllocated(buffer) )
+    {
+    std::cerr << "The buffer taken over was not released" << std::endl;
+    pass = false;
+    }
+
+  // Pixels with a constructor
+  VectorImageType::SizeType vectorSize;
+  vectorSize[0] = 17;
+  vectorSize[1] = 9;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(vectorSize);
+  vectorImage->Allocate();
+  VectorImageType::PixelType vector;
+  vector.Fill(2.5);
+  vectorImage->FillBuffer(vector);
+  vectorImage = 0;
+
+  // The pool is emptied on request
+  itk::ImageBufferAllocator::ReleasePool();
+  if ( itk::ImageBufferAllocator::GetPoolSize() != 0 )
+    {
+    std::cerr << "The pool was not released" << std::endl;
+    pass = false;
+    }
+
+  // Filling a buffer large enough for several threads
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(3);
+  ImageType::SizeType largeSize;
+  largeSize[0] = 256;
+  largeSize[1] = 256;
+  largeSize[2] = 33;
+  ImageType::Pointer large = ImageType::New();
+  large->SetRegions(largeSize);
+  large->Allocate();
+  large->FillBuffer(7.0f);
+  const float *largeBuffer = large->GetBufferPointer();
+  for ( size_t i = 0; i < large->GetBufferedRegion().GetNumberOfPixels(); i++ )
+    {
+    if ( largeBuffer[i] != 7.0f )
+      {
+      std::cerr << "Pixel " << i << " not filled" << std::endl;
+      pass = false;
+      break;
+      }
+    }
+  large = 0;
+
+  ImageType::Pointer kept = ImageType::New();
+  kept->SetRegions(size);
+  kept->Allocate();
+
+  // Disabled, the buffers are allocated with new[] again
+  itk::ImageBufferAllocator::SetEnabled(false);
+  const size_t allocations = itk::ImageBufferAllocator::GetNumberOfAllocations();
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  if ( itk::ImageBufferAllocator::GetNumberOfAllocations() != allocations
+       || itk::ImageBufferAllocator::IsAllocated( image->GetBufferPointer() ) )
+    {
+    std::cerr << "The allocator was used while disabled" << std::endl;
+    pass = false;
+    }
+
+  // Each buffer is released by the allocator it comes from, whether the
+  // allocator is enabled or not
+  const size_t deallocations = itk::ImageBufferAllocator::GetNumberOfDeallocations();
+  kept = 0;
+  itk::ImageBufferAllocator::SetEnabled(true);
+  image = 0;
+  itk::ImageBufferAllocator::SetEnabled(false);
+  if ( itk::ImageBufferAllocator::GetNumberOfDeallocations() != deallocations + 1 )
+    {
+    std::cerr << "The buffers were not released by the allocator they come from" << std::endl;
+    pass = false;
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -106,6 +106,52 @@ itkMinimumMaximumImageCalculatorTest(int ,char *[] )
     }
 
 
+    // A larger image is split between several threads, which must find the
+    // same extrema, at the first of their positions, as a single thread
+    SizeType largeSize = {{300, 200, 16}};
+    ImageType::RegionType largeRegion;
+    largeRegion.SetSize(largeSize);
+    ImageType::Pointer largeImage = ImageType::New();
+    largeImage->SetRegions(largeRegion);
+    largeImage->Allocate();
+    largeImage->FillBuffer(0);
+
+    itk::Index<3> firstMaximum = {{7, 150, 12}};
+    itk::Index<3> secondMaximum = {{3, 20, 15}};
+    itk::Index<3> firstMinimum = {{250, 10, 2}};
+    itk::Index<3> secondMinimum = {{0, 0, 9}};
+    largeImage->SetPixel(firstMaximum, maximum);
+    largeImage->SetPixel(secondMaximum, maximum);
+    largeImage->SetPixel(firstMinimum, minimum);
+    largeImage->SetPixel(secondMinimum, minimum);
+
+    MinMaxCalculatorType::Pointer threadedCalculator = MinMaxCalculatorType::New();
+    threadedCalculator->SetImage( largeImage );
+    for (unsigned int threads = 1; threads <= 8; threads *= 2)
+    {
+      threadedCalculator->SetNumberOfThreads( threads );
+      threadedCalculator->Compute();
+      if ( threadedCalculator->GetMinimum() != minimum
+           || threadedCalculator->GetIndexOfMinimum() != firstMinimum
+           || threadedCalculator->GetMaximum() != maximum
+           || threadedCalculator->GetIndexOfMaximum() != firstMaximum )
+      {
+        std::cout << "Wrong extrema with " << threads << " threads: "
+                  << threadedCalculator->GetMinimum() << " at "
+                  << threadedCalculator->GetIndexOfMinimum() << ", "
+                  << threadedCalculator->GetMaximum() << " at "
+                  << threadedCalculator->GetIndexOfMaximum() << std::endl;
+        flag = 3;
+      }
+
+      threadedCalculator->ComputeMaximum();
+      if ( threadedCalculator->GetIndexOfMaximum() != firstMaximum )
+      {
+        std::cout << "Wrong maximum position with " << threads << " threads" << std::endl;
+        flag = 4;
+      }
+    }
+
     // Return results of test
     if (flag != 0) {
         std::cout << "*** Some tests failed" << std::endl;
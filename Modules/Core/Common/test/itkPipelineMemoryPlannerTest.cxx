@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineMemoryPlanner.h"
+#include "itkImageBufferAllocator.h"
+#include "itkImageToImageFilter.h"
+#include "itkImageRegionIterator.h"
+
+// A chain of filters with a branch used by two filters: the planner must
+// release each intermediate image after its last use only, keep the
+// outputs, reuse the released buffers, and give the same result as the
+// normal update.
+
+namespace
+{
+typedef itk::Image< float, 3 > ImageType;
+
+// Output = sum of the inputs + 1, counting the executions
+class AddOneFilter:public itk::ImageToImageFilter< ImageType, ImageType >
+{
+public:
+  typedef AddOneFilter                                     Self;
+  typedef itk::ImageToImageFilter< ImageType, ImageType > Superclass;
+  typedef itk::SmartPointer< Self >                        Pointer;
+
+  itkNewMacro(Self);
+
+  void SetInput(unsigned int idx, const ImageType *image)
+  { this->SetNthInput( idx, const_cast< ImageType * >( image ) ); }
+
+  unsigned int m_Executions;
+
+protected:
+  AddOneFilter() { m_Executions = 0; }
+
+  void GenerateData()
+  {
+    this->AllocateOutputs();
+    ImageType *output = this->GetOutput();
+    output->FillBuffer(1);
+    for ( unsigned int i = 0; i < this->GetNumberOfInputs(); i++ )
+      {
+      itk::ImageRegionConstIterator< ImageType > it( this->GetInput(i), output->GetRequestedRegion() );
+      itk::ImageRegionIterator< ImageType >      ot( output, output->GetRequestedRegion() );
+      for (; !ot.IsAtEnd(); ++it, ++ot )
+        {
+        ot.Set( ot.Get() + it.Get() );
+        }
+      }
+    m_Executions++;
+  }
+};
+
+bool CheckImage(const ImageType *image, float value, const char *name)
+{
+  if ( image->GetBufferedRegion().GetNumberOfPixels() == 0 )
+    {
+    std::cerr << name << " was released" << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIterator< ImageType > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != value )
+      {
+      std::cerr << name << " is " << it.Get() << " instead of " << value << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkPipelineMemoryPlannerTest(int, char *[])
+{
+  const unsigned int chainLength = 15;
+  const unsigned int branch = 6;
+
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 32;
+  size[2] = 16;
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions(size);
+  input->Allocate();
+  input->FillBuffer(0);
+
+  // input -> 0 -> 1 -> ... -> 14, the output of filter 6 is also added to
+  // the output of filter 14 by the last filter
+  std::vector< AddOneFilter::Pointer > filters;
+  for ( unsigned int i = 0; i < chainLength; i++ )
+    {
+    filters.push_back( AddOneFilter::New() );
+    filters[i]->SetInput( 0, i == 0 ? input.GetPointer() : filters[i - 1]->GetOutput() );
+    }
+  AddOneFilter::Pointer last = AddOneFilter::New();
+  last->SetInput( 0, filters[chainLength - 1]->GetOutput() );
+  last->SetInput( 1, filters[branch]->GetOutput() );
+  const float expected = chainLength + 1 + branch + 1;
+
+  itk::ImageBufferAllocator::SetEnabled(false);
+  itk::ImageBufferAllocator::ReleasePool();
+  itk::ImageBufferAllocator::ResetStatistics();
+
+  itk::PipelineMemoryPlanner::Pointer planner = itk::PipelineMemoryPlanner::New();
+  planner->AddOutput( last->GetOutput() );
+  if ( planner->GetReuseBuffers() )
+    {
+    std::cerr << "The buffers are reused by default" << std::endl;
+    return EXIT_FAILURE;
+    }
+  planner->ReuseBuffersOn();
+  planner->Plan();
+  planner->Print(std::cout);
+
+  bool pass = true;
+  if ( planner->GetNumberOfProcessObjects() != chainLength + 1
+       || planner->GetProcessObject(0) != filters[0].GetPointer()
+       || planner->GetProcessObject(chainLength) != last.GetPointer()
+       || planner->GetNumberOfDataObjects() != chainLength + 1
+       || planner->GetPeakNumberOfDataObjects() != 3 )
+    {
+    std::cerr << "Wrong plan" << std::endl;
+    pass = false;
+    }
+
+  planner->Update();
+  pass &= CheckImage(last->GetOutput(), expected, "The output");
+  pass &= CheckImage(input, 0, "The input");
+  for ( unsigned int i = 0; i < chainLength; i++ )
+    {
+    if ( filters[i]->m_Executions != 1 || !filters[i]->GetOutput()->GetDataReleased() )
+      {
+      std::cerr << "Filter " << i << " executed " << filters[i]->m_Executions << " times, released "
+                << filters[i]->GetOutput()->GetDataReleased() << std::endl;
+      pass = false;
+      }
+    }
+  if ( planner->GetNumberOfReleasedDataObjects() != chainLength )
+    {
+    std::cerr << planner->GetNumberOfReleasedDataObjects() << " data objects released" << std::endl;
+    pass = false;
+    }
+
+  // the buffers released are taken over by the next outputs, and at most
+  // three buffers are allocated at the same time
+  const size_t bufferSize = input->GetBufferedRegion().GetNumberOfPixels() * sizeof( float );
+  itk::ImageBufferAllocator::Print(std::cout);
+  if ( itk::ImageBufferAllocator::GetNumberOfRecycledAllocations() < chainLength - 3
+       || itk::ImageBufferAllocator::GetPeakAllocatedSize() > 4 * bufferSize
+       || itk::ImageBufferAllocator::GetEnabled() )
+    {
+    std::cerr << "The buffers were not reused" << std::endl;
+    pass = false;
+    }
+
+  // nothing executes when the pipeline is up to date
+  planner->Update();
+  if ( last->m_Executions != 1 || filters[0]->m_Executions != 1 )
+    {
+    std::cerr << "The pipeline executed again" << std::endl;
+    pass = false;
+    }
+
+  // an intermediate image added as an output is kept, and the same result
+  // is computed without the allocator
+  filters[0]->Modified();
+  planner->AddOutput( filters[branch]->GetOutput() );
+  planner->ReuseBuffersOff();
+  planner->Update();
+  pass &= CheckImage(last->GetOutput(), expected, "The output");
+  pass &= CheckImage(filters[branch]->GetOutput(), branch + 1, "The intermediate output");
+  if ( planner->GetNumberOfReleasedDataObjects() != chainLength - 1
+       || filters[branch]->m_Executions != 2 || last->m_Executions != 2 )
+    {
+    std::cerr << "Wrong update with two outputs" << std::endl;
+    pass = false;
+    }
+
+  // the normal update gives the same result
+  planner = 0;
+  filters[0]->Modified();
+  last->Update();
+  pass &= CheckImage(last->GetOutput(), expected, "The output of the normal update");
+
+  itk::ImageBufferAllocator::ReleasePool();
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
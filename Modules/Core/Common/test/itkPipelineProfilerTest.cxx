@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineProfiler.h"
+#include "itkImageToImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMinimumMaximumImageCalculator.h"
+#include <sstream>
+
+// Each execution of the filters of a pipeline must be recorded with the
+// threads it used, the pixels they processed, and the bytes allocated, and
+// the records must be written as CSV and as a Chrome trace. The threads
+// started by the helpers of a filter are recorded in its execution.
+
+namespace
+{
+typedef itk::Image< short, 2 > ImageType;
+
+// Output = input * 2, with threads
+class DoubleFilter:public itk::ImageToImageFilter< ImageType, ImageType >
+{
+public:
+  typedef DoubleFilter                                     Self;
+  typedef itk::ImageToImageFilter< ImageType, ImageType > Superclass;
+  typedef itk::SmartPointer< Self >                        Pointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(DoubleFilter, ImageToImageFilter);
+
+protected:
+  DoubleFilter() {}
+
+  void ThreadedGenerateData(const OutputImageRegionType & region, itk::ThreadIdType)
+  {
+    itk::ImageRegionConstIterator< ImageType > it(this->GetInput(), region);
+    itk::ImageRegionIterator< ImageType >      ot(this->GetOutput(), region);
+    for (; !ot.IsAtEnd(); ++it, ++ot )
+      {
+      ot.Set( it.Get() * 2 );
+      }
+  }
+};
+
+// Computes the extrema of the input with two threads, output = input
+class ExtremaFilter:public itk::ImageToImageFilter< ImageType, ImageType >
+{
+public:
+  typedef ExtremaFilter                                    Self;
+  typedef itk::ImageToImageFilter< ImageType, ImageType > Superclass;
+  typedef itk::SmartPointer< Self >                        Pointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ExtremaFilter, ImageToImageFilter);
+
+protected:
+  ExtremaFilter() {}
+
+  void GenerateData()
+  {
+    typedef itk::MinimumMaximumImageCalculator< ImageType > CalculatorType;
+    CalculatorType::Pointer calculator = CalculatorType::New();
+    calculator->SetImage( this->GetInput() );
+    calculator->SetNumberOfThreads(2);
+    calculator->Compute();
+    this->GraftOutput( const_cast< ImageType * >( this->GetInput() ) );
+  }
+};
+
+unsigned int CountLines(const std::string & text)
+{
+  unsigned int lines = 0;
+
+  for ( std::string::size_type i = 0; i < text.size(); i++ )
+    {
+    lines += ( text[i] == '\n' );
+    }
+  return lines;
+}
+}
+
+int itkPipelineProfilerTest(int, char *[])
+{
+  ImageType::SizeType size;
+  size[0] = 200;
+  size[1] = 150;
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions(size);
+  input->Allocate();
+  input->FillBuffer(1);
+
+  // nothing is recorded while disabled
+  itk::PipelineProfiler::SetEnabled(false);
+  itk::PipelineProfiler::Clear();
+  DoubleFilter::Pointer unprofiled = DoubleFilter::New();
+  unprofiled->SetInput(input);
+  unprofiled->Update();
+  bool pass = true;
+  if ( itk::PipelineProfiler::GetNumberOfRecords() != 0 )
+    {
+    std::cerr << "Executions recorded while disabled" << std::endl;
+    pass = false;
+    }
+
+  // one record for each filter, in the order of execution
+  DoubleFilter::Pointer first = DoubleFilter::New();
+  first->SetInput(input);
+  first->SetNumberOfThreads(3);
+  DoubleFilter::Pointer second = DoubleFilter::New();
+  second->SetInput( first->GetOutput() );
+  second->SetNumberOfThreads(4);
+
+  itk::PipelineProfiler::SetEnabled(true);
+  ImageType::RegionType requested = input->GetLargestPossibleRegion();
+  requested.PadByRadius(-10);
+  second->GetOutput()->SetRequestedRegion(requested);
+  second->Update();
+  itk::PipelineProfiler::SetEnabled(false);
+
+  if ( itk::PipelineProfiler::GetNumberOfRecords() != 2 )
+    {
+    std::cerr << itk::PipelineProfiler::GetNumberOfRecords() << " executions recorded" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const unsigned int threads[2] = { 3, 4 };
+  for ( unsigned int i = 0; i < 2; i++ )
+    {
+    const itk::PipelineProfiler::Record record = itk::PipelineProfiler::GetRecord(i);
+    const DoubleFilter *                 filter = ( i == 0 ? first : second );
+
+    itk::SizeValueType threadPixels = 0;
+    for ( unsigned int t = 0; t < record.Threads.size(); t++ )
+      {
+      threadPixels += record.Threads[t].NumberOfPixels;
+      if ( record.Threads[t].Start < record.Start || record.Threads[t].Time > record.Time )
+        {
+        std::cerr << "Thread " << t << " of record " << i << " outside of the execution" << std::endl;
+        pass = false;
+        }
+      }
+
+    const itk::SizeValueType pixels = requested.GetNumberOfPixels();
+    if ( record.NameOfClass != "DoubleFilter" || record.ProcessObject != filter || record.Depth != 0
+         || record.Threads.size() != threads[i] || threadPixels != pixels
+         || record.RequestedNumberOfPixels != pixels || record.BufferedNumberOfPixels != pixels
+         || record.BytesAllocated != pixels * sizeof( short ) || record.Time < 0 )
+      {
+      std::cerr << "Wrong record " << i << ": " << record.NameOfClass << ", " << record.Threads.size()
+                << " threads for " << threadPixels << " pixels, " << record.RequestedNumberOfPixels
+                << " pixels requested, " << record.BufferedNumberOfPixels << " buffered, "
+                << record.BytesAllocated << " bytes allocated" << std::endl;
+      pass = false;
+      }
+    }
+  if ( itk::PipelineProfiler::GetRecord(1).Start < itk::PipelineProfiler::GetRecord(0).Start )
+    {
+    std::cerr << "The records are not in the order of execution" << std::endl;
+    pass = false;
+    }
+
+  // the exports: a header and a line for each execution, and an event for
+  // each execution and each thread
+  std::ostringstream csv;
+  itk::PipelineProfiler::WriteCSV(csv);
+  std::cout << csv.str();
+  if ( CountLines( csv.str() ) != 3 || csv.str().find("Filter,Object,Depth,Start,Time") != 0 )
+    {
+    std::cerr << "Wrong CSV table" << std::endl;
+    pass = false;
+    }
+
+  std::ostringstream trace;
+  itk::PipelineProfiler::WriteChromeTrace(trace);
+  std::cout << trace.str();
+  std::string::size_type events = 0;
+  for ( std::string::size_type p = trace.str().find("\"ph\":\"X\""); p != std::string::npos;
+        p = trace.str().find("\"ph\":\"X\"", p + 1) )
+    {
+    events++;
+    }
+  if ( trace.str().find("{\"traceEvents\":[") != 0 || events != 2 + threads[0] + threads[1] )
+    {
+    std::cerr << "Wrong Chrome trace with " << events << " events" << std::endl;
+    pass = false;
+    }
+
+  // the threads of a MinimumMaximumImageCalculator
+  itk::PipelineProfiler::Clear();
+  ImageType::SizeType largeSize;
+  largeSize[0] = 512;
+  largeSize[1] = 300;
+  ImageType::Pointer large = ImageType::New();
+  large->SetRegions(largeSize);
+  large->Allocate();
+  large->FillBuffer(3);
+  ExtremaFilter::Pointer extrema = ExtremaFilter::New();
+  extrema->SetInput(large);
+  itk::PipelineProfiler::SetEnabled(true);
+  extrema->Update();
+  itk::PipelineProfiler::SetEnabled(false);
+  if ( itk::PipelineProfiler::GetNumberOfRecords() != 1
+       || itk::PipelineProfiler::GetRecord(0).Threads.size() != 2
+       || itk::PipelineProfiler::GetRecord(0).Threads[0].NumberOfPixels
+          + itk::PipelineProfiler::GetRecord(0).Threads[1].NumberOfPixels != 512 * 300 )
+    {
+    std::cerr << "The threads of the calculator were not recorded" << std::endl;
+    pass = false;
+    }
+
+  itk::PipelineProfiler::Clear();
+  if ( itk::PipelineProfiler::GetNumberOfRecords() != 0 )
+    {
+    std::cerr << "The records were not cleared" << std::endl;
+    pass = false;
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkTimeProbe.h"
+#include <algorithm>
+#include <vector>
+
+// All the threads copy smart pointers to the same object and modify their
+// own time stamps at the same time.  The reference count of the object must
+// be back to its initial value, and the modified times must all be
+// different.  The time taken is compared with the same number of increments
+// of a counter protected by a lock.
+
+namespace
+{
+const unsigned int NumberOfIterations = 200000;
+
+struct ReferenceCountTestHelper
+{
+  itk::LightObject::Pointer                  object;
+  std::vector< std::vector< unsigned long > > modifiedTimes;
+  itk::SimpleFastMutexLock                   lock;
+  unsigned long                              lockedCounter;
+};
+
+ITK_THREAD_RETURN_TYPE CopySmartPointers(void *ptr)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+
+  ThreadInfoType *infoStruct = static_cast< ThreadInfoType * >( ptr );
+  ReferenceCountTestHelper *helper = static_cast< ReferenceCountTestHelper * >( infoStruct->UserData );
+
+  std::vector< unsigned long > & modifiedTimes = helper->modifiedTimes[infoStruct->ThreadID];
+  itk::TimeStamp                 timeStamp;
+
+  for ( unsigned int i = 0; i < NumberOfIterations; i++ )
+    {
+    itk::LightObject::Pointer copy = helper->object;
+    if ( i % 64 == 0 )
+      {
+      timeStamp.Modified();
+      modifiedTimes.push_back( timeStamp.GetMTime() );
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE IncrementLockedCounter(void *ptr)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+
+  ThreadInfoType *infoStruct = static_cast< ThreadInfoType * >( ptr );
+  ReferenceCountTestHelper *helper = static_cast< ReferenceCountTestHelper * >( infoStruct->UserData );
+
+  // the same number of operations as a copy of a smart pointer
+  for ( unsigned int i = 0; i < 2 * NumberOfIterations; i++ )
+    {
+    helper->lock.Lock();
+    helper->lockedCounter++;
+    helper->lock.Unlock();
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+int itkReferenceCountThreadingTest(int, char *[])
+{
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(8);
+
+  const itk::ThreadIdType numberOfThreads = threader->GetNumberOfThreads();
+  std::cout << "Threads: " << numberOfThreads << std::endl;
+
+  ReferenceCountTestHelper helper;
+  helper.object = itk::LightObject::New();
+  helper.modifiedTimes.resize(numberOfThreads);
+  helper.lockedCounter = 0;
+
+  const int initialCount = helper.object->GetReferenceCount();
+
+  itk::TimeProbe atomicTime;
+  threader->SetSingleMethod(CopySmartPointers, &helper);
+  atomicTime.Start();
+  threader->SingleMethodExecute();
+  atomicTime.Stop();
+
+  itk::TimeProbe lockTime;
+  threader->SetSingleMethod(IncrementLockedCounter, &helper);
+  lockTime.Start();
+  threader->SingleMethodExecute();
+  lockTime.Stop();
+
+  std::cout << "Smart pointer copies: " << atomicTime.GetMeanTime() << " s" << std::endl;
+  std::cout << "Locked increments:    " << lockTime.GetMeanTime() << " s" << std::endl;
+
+  if ( helper.object->GetReferenceCount() != initialCount )
+    {
+    std::cerr << "Reference count " << helper.object->GetReferenceCount()
+              << " instead of " << initialCount << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( helper.lockedCounter != 2 * NumberOfIterations * numberOfThreads )
+    {
+    std::cerr << "Locked counter " << helper.lockedCounter << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // every Modified() call got its own time
+  std::vector< unsigned long > allTimes;
+  for ( itk::ThreadIdType t = 0; t < numberOfThreads; t++ )
+    {
+    allTimes.insert( allTimes.end(), helper.modifiedTimes[t].begin(), helper.modifiedTimes[t].end() );
+    }
+  std::sort( allTimes.begin(), allTimes.end() );
+  if ( std::adjacent_find( allTimes.begin(), allTimes.end() ) != allTimes.end() )
+    {
+    std::cerr << "A modified time was given twice" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -110,6 +110,23 @@ public:
   virtual OutputType EvaluateAtContinuousIndex(
     const ContinuousIndexType & index) const = 0;
 
+  /** Interpolate the image at a sequence of continuous index positions,
+   * e.g. the positions of an output scanline. values must have room for
+   * numberOfIndices values. No bounds checking is done.
+   *
+   * The default implementation calls EvaluateAtContinuousIndex() for each
+   * position. Subclasses can override it to evaluate the whole sequence
+   * at once. */
+  virtual void EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                                           OutputType *values,
+                                           SizeValueType numberOfIndices) const
+  {
+    for ( SizeValueType i = 0; i < numberOfIndices; i++ )
+      {
+      values[i] = this->EvaluateAtContinuousIndex(indices[i]);
+      }
+  }
+
   /** Interpolate the image at an index position.
    *
    * Simply returns the image value at the
@@ -63,7 +63,21 @@ public:
 /** \class TriangleMeshToBinaryImageFilter
  *
  * \brief 3D Rasterization algorithm Courtesy of Dr David Gobbi of Atamai Inc.
-
+ *
+ * The mesh is first converted to index space. Every output scanline
+ * parallel to the x axis is then intersected with the polygons, and the
+ * crossings are turned into inside/outside runs. The rasterization is
+ * done independently for each region assigned to a thread (slabs along
+ * the last dimension by default), so the filter is multi-threaded and
+ * honors the requested region of its output, which allows it to be
+ * streamed.
+ *
+ * When ComputePartialVolume is on, each pixel is instead assigned the
+ * fraction of its volume that lies inside the surface, mapped linearly
+ * between OutsideValue and InsideValue. The fraction is exact along x
+ * and estimated from PartialVolumeSubdivisions sub-scanlines along y and z.
+ * A floating point output pixel type is recommended in this mode.
+ *
  * \author Leila Baghdadi, MICe, Hospital for Sick Childern, Toronto, Canada,
  * \ingroup ITK-Mesh
  */
@@ -125,7 +139,6 @@ public:
   typedef std::vector< PointType >                PointVector;
   typedef std::vector< std::vector< PointType > > PointArray;
 
-  typedef std::vector< int > StencilIndexVector;
   /** Spacing (size of a pixel) of the output image. The
    * spacing is the geometric distance between image samples.
    * It is stored internally as double, but may be set from
@@ -198,16 +211,39 @@ public:
   /* Set the tolerance for doing spatial searches of the polydata. */
   itkSetMacro(Tolerance, double);
   itkGetConstMacro(Tolerance, double);
+
+  /** Set/Get whether the output holds the fraction of each pixel inside
+   * the surface instead of a binary mask. Off by default. */
+  itkSetMacro(ComputePartialVolume, bool);
+  itkGetConstMacro(ComputePartialVolume, bool);
+  itkBooleanMacro(ComputePartialVolume);
+
+  /** Set/Get the number of sub-scanlines per pixel along y and along z
+   * used to estimate the partial volume. Defaults to 4. */
+  itkSetClampMacro( PartialVolumeSubdivisions, unsigned int, 1,
+                    NumericTraits< unsigned int >::max() );
+  itkGetConstMacro(PartialVolumeSubdivisions, unsigned int);
 protected:
   TriangleMeshToBinaryImageFilter();
   ~TriangleMeshToBinaryImageFilter();
 
-  virtual void GenerateOutputInformation(){}  // do nothing
-  virtual void GenerateData();
+  virtual void GenerateOutputInformation();
+
+  virtual void BeforeThreadedGenerateData();
 
+  virtual void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId);
+
+  virtual void AfterThreadedGenerateData();
+
+  /** Convert the polygons of the input mesh to index space. */
   virtual void RasterizeTriangles();
 
-  static int PolygonToImageRaster(PointVector coords, Point1DArray & zymatrix, int extent[6]);
+  static int PolygonToImageRaster(const PointVector & coords, Point1DArray & zymatrix, int extent[6]);
+
+  /** Reduce the sorted crossings of one scanline to the x positions
+   * where the scanline enters or leaves the surface. */
+  void ComputeScanlineCrossings(Point1DVector & xlist, std::vector< double > & nlist) const;
 
   OutputImageType *m_InfoImage;
 
@@ -226,7 +262,13 @@ protected:
 
   DirectionType m_Direction;
 
-  StencilIndexVector m_StencilIndex;
+  bool m_ComputePartialVolume;
+
+  unsigned int m_PartialVolumeSubdivisions;
+
+  /** Polygons of the input mesh in index space (scaled along y and z by
+   * the number of subdivisions in partial volume mode). */
+  PointArray m_Polygons;
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
@@ -19,8 +19,11 @@
 #define __itkTriangleMeshToBinaryImageFilter_txx
 
 #include "itkTriangleMeshToBinaryImageFilter.h"
-#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
 #include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -46,6 +49,9 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
 
   m_Tolerance = 1e-5;
   m_InfoImage = NULL;
+
+  m_ComputePartialVolume = false;
+  m_PartialVolumeSubdivisions = 4;
 }
 
 /** Destructor */
@@ -160,16 +166,14 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
 
 //----------------------------------------------------------------------------
 
-/** Update */
+/** Set the output image information */
 template< class TInputMesh, class TOutputImage >
 void
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
-::GenerateData(void)
+::GenerateOutputInformation()
 {
-  itkDebugMacro(<< "TriangleMeshToBinaryImageFilter::Update() called");
-
-  // Get the input and output pointers
   OutputImagePointer OutputImage = this->GetOutput();
+
   if ( m_InfoImage == NULL )
     {
     if ( m_Size[0] == 0 ||  m_Size[1] == 0 ||  m_Size[2] == 0 )
@@ -182,90 +186,232 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
     region.SetSize (m_Size);
     region.SetIndex(m_Index);
 
-    OutputImage->SetLargestPossibleRegion(region); //
-    OutputImage->SetBufferedRegion(region);        // set the region
-    OutputImage->SetRequestedRegion(region);       //
+    OutputImage->SetLargestPossibleRegion(region);
     OutputImage->SetSpacing(m_Spacing);            // set spacing
     OutputImage->SetOrigin(m_Origin);              //   and origin
     OutputImage->SetDirection(m_Direction);        // direction cosines
     }
   else
     {
-    std::cout << "Using info image" << std::endl;
-    m_InfoImage->Update();
+    m_InfoImage->UpdateOutputInformation();
     OutputImage->CopyInformation(m_InfoImage);
-    OutputImage->SetRegions( m_InfoImage->GetLargestPossibleRegion() );
-    m_Size = m_InfoImage->GetLargestPossibleRegion().GetSize();
-    m_Index = m_InfoImage->GetLargestPossibleRegion().GetIndex();
-    m_Spacing = m_InfoImage->GetSpacing();
-    m_Origin = m_InfoImage->GetOrigin();
-    m_Direction = m_InfoImage->GetDirection();
+    OutputImage->SetLargestPossibleRegion( m_InfoImage->GetLargestPossibleRegion() );
     }
+}
 
-  OutputImage->Allocate();   // allocate the image
+template< class TInputMesh, class TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  itkDebugMacro(<< "TriangleMeshToBinaryImageFilter::Update() called");
 
-  RasterizeTriangles();
+  this->RasterizeTriangles();
+}
 
-  typedef itk::ImageRegionIteratorWithIndex< OutputImageType > myIteratorType;
+template< class TInputMesh, class TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  // release the index space copy of the mesh
+  PointArray().swap(m_Polygons);
 
-  myIteratorType it( OutputImage, OutputImage->GetLargestPossibleRegion() );
+  itkDebugMacro(<< "TriangleMeshToBinaryImageFilter::Update() finished");
+}
 
-  int DataIndex = 0;
-  int StencilId = 0;
-  it.GoToBegin();
+/** Rasterize the polygons into the region of one thread */
+template< class TInputMesh, class TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  const IndexType & start = outputRegionForThread.GetIndex();
+  const SizeType &  size = outputRegionForThread.GetSize();
 
-  int n = m_StencilIndex.size();
-  if ( n == 0 )
+  if ( size[0] == 0 || size[1] == 0 || size[2] == 0 )
     {
-    itkWarningMacro(<< "No Image Indices Found.");
+    return;
     }
-  else
+
+  // in partial volume mode every pixel row is sampled by
+  // subdivisions x subdivisions scanlines
+  const int subdivisions = m_ComputePartialVolume ? (int)m_PartialVolumeSubdivisions : 1;
+
+  // create a similar extent like vtk, in the (sub)sampled grid
+  int extent[6];
+
+  extent[0] = start[0];
+  extent[1] = start[0] + (int)size[0] - 1;
+  extent[2] = subdivisions * start[1];
+  extent[3] = subdivisions * ( start[1] + (int)size[1] ) - 1;
+  extent[4] = subdivisions * start[2];
+  extent[5] = subdivisions * ( start[2] + (int)size[2] ) - 1;
+
+  // the stencil is kept in 'zymatrix' that provides
+  // the x extents for each (y,z) coordinate for which a ray
+  // parallel to the x axis intersects the polydata
+  int          zInc = extent[3] - extent[2] + 1;
+  int          zSize = extent[5] - extent[4] + 1;
+  Point1DArray zymatrix(zInc * zSize);
+
+  for ( typename PointArray::const_iterator polyIt = m_Polygons.begin();
+        polyIt != m_Polygons.end(); ++polyIt )
+    {
+    PolygonToImageRaster(*polyIt, zymatrix, extent);
+    }
+
+  ProgressReporter progress( this, threadId, size[1] * size[2] );
+
+  typedef ImageRegionIterator< OutputImageType > IteratorType;
+  IteratorType it(this->GetOutput(), outputRegionForThread);
+
+  const int xSize = size[0];
+  const int xEnd = extent[1];
+
+  std::vector< double > nlist;
+  std::vector< double > coverage;
+  if ( m_ComputePartialVolume )
     {
-    int StencilMin = m_StencilIndex[0];
-    int StencilMax = m_StencilIndex[n - 1];
+    coverage.resize(xSize);
+    }
+  const double normalization = 1.0 / ( subdivisions * subdivisions );
+  const double range = static_cast< double >( m_InsideValue )
+                       - static_cast< double >( m_OutsideValue );
 
-    while ( !it.IsAtEnd() )
+  // the output iterator walks the region in the same order as the
+  // scanlines, one row at a time
+  for ( int z = start[2]; z < start[2] + (int)size[2]; z++ )
+    {
+    for ( int y = start[1]; y < start[1] + (int)size[1]; y++ )
       {
-      if ( DataIndex >= StencilMin && DataIndex <= StencilMax )
+      if ( !m_ComputePartialVolume )
         {
-        if ( DataIndex == m_StencilIndex[StencilId] )
+        int zyidx = ( z - start[2] ) * zInc + ( y - start[1] );
+        this->ComputeScanlineCrossings(zymatrix[zyidx], nlist);
+
+        // fill the row with the stencil extents
+        int x = extent[0];
+        int minx1 = extent[0]; // minimum allowable x1 value
+        int n = (int)( nlist.size() ) / 2;
+
+        for ( int i = 0; i < n; i++ )
           {
-          it.Set(m_InsideValue);
-          StencilId++;
+          int x1 = (int)( vcl_ceil(nlist[2 * i]) );
+          int x2 = (int)( vcl_floor(nlist[2 * i + 1]) );
+
+          if ( x2 < extent[0] || x1 > xEnd )
+            {
+            continue;
+            }
+          x1 = ( x1 > minx1 ) ? ( x1 ) : ( minx1 ); // max(x1,minx1)
+          x2 = ( x2 < xEnd ) ? ( x2 ) : ( xEnd );   // min(x2,extent[1])
+
+          if ( x2 >= x1 )
+            {
+            for (; x < x1; x++, ++it )
+              {
+              it.Set(m_OutsideValue);
+              }
+            for (; x <= x2; x++, ++it )
+              {
+              it.Set(m_InsideValue);
+              }
+            }
+          // next x1 value must be at least x2+1
+          minx1 = x2 + 1;
           }
-        else
+        for (; x <= xEnd; x++, ++it )
           {
           it.Set(m_OutsideValue);
           }
         }
       else
         {
-        it.Set(m_OutsideValue);
+        std::fill(coverage.begin(), coverage.end(), 0.0);
+
+        for ( int sz = 0; sz < subdivisions; sz++ )
+          {
+          for ( int sy = 0; sy < subdivisions; sy++ )
+            {
+            int zyidx = ( ( z - start[2] ) * subdivisions + sz ) * zInc
+                        + ( y - start[1] ) * subdivisions + sy;
+            this->ComputeScanlineCrossings(zymatrix[zyidx], nlist);
+
+            // accumulate the length of each inside segment that
+            // falls within every pixel of the row
+            int n = (int)( nlist.size() ) / 2;
+            for ( int i = 0; i < n; i++ )
+              {
+              double x1 = nlist[2 * i];
+              double x2 = nlist[2 * i + 1];
+              int    first = (int)( vcl_ceil(x1 - 0.5) );
+              int    last = (int)( vcl_floor(x2 + 0.5) );
+              first = ( first > extent[0] ) ? first : extent[0];
+              last = ( last < xEnd ) ? last : xEnd;
+              for ( int x = first; x <= last; x++ )
+                {
+                double lower = ( x1 > x - 0.5 ) ? x1 : x - 0.5;
+                double upper = ( x2 < x + 0.5 ) ? x2 : x + 0.5;
+                if ( upper > lower )
+                  {
+                  coverage[x - extent[0]] += upper - lower;
+                  }
+                }
+              }
+            }
+          }
+
+        for ( int x = 0; x < xSize; x++, ++it )
+          {
+          double fraction = coverage[x] * normalization;
+          fraction = ( fraction < 1.0 ) ? fraction : 1.0;
+          it.Set( static_cast< ValueType >( static_cast< double >( m_OutsideValue )
+                                            + fraction * range ) );
+          }
         }
-      DataIndex++;
-      ++it;
+      progress.CompletedPixel();
       }
     }
-  itkDebugMacro(<< "TriangleMeshToBinaryImageFilter::Update() finished");
-} // end update function
+}
 
 //----------------------------------------------------------------------------
 /** convert a single polygon/triangle to raster format */
 template< class TInputMesh, class TOutputImage >
 int
 TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
-::PolygonToImageRaster(PointVector coords, Point1DArray & zymatrix, int extent[6])
+::PolygonToImageRaster(const PointVector & coords, Point1DArray & zymatrix, int extent[6])
 {
+  int n = (int)( coords.size() );
+
+  // skip the polygons that do not cross the z range of the extent,
+  // and restrict the work to the z planes that the polygon spans
+  double zlow = coords[0][2];
+  double zhigh = coords[0][2];
+  for ( int i = 1; i < n; i++ )
+    {
+    zlow = ( coords[i][2] < zlow ) ? coords[i][2] : zlow;
+    zhigh = ( coords[i][2] > zhigh ) ? coords[i][2] : zhigh;
+    }
+  int zfirst = (int)( vcl_ceil(zlow) );
+  int zlast = (int)( vcl_ceil(zhigh) ) - 1;
+  if ( zfirst > extent[5] || zlast < extent[4] )
+    {
+    return 0;
+    }
+  zfirst = ( zfirst > extent[4] ) ? zfirst : extent[4];
+  zlast = ( zlast < extent[5] ) ? zlast : extent[5];
+
   // convert the polgon into a rasterizable form by finding its
   // intersection with each z plane, and store the (x,y) coords
   // of each intersection in a vector called "matrix"
-  int          zSize = extent[5] - extent[4] + 1;
+  int          zSize = zlast - zfirst + 1;
   int          zInc = extent[3] - extent[2] + 1;
   Point2DArray matrix(zSize);
 
   // each iteration of the following loop examines one edge of the
   // polygon, where the endpoints of the edge are p1 and p2
-  int       n = (int)( coords.size() );
   PointType p0 = coords[0];
   PointType p1 = coords[n - 1];
   double    area = 0.0;
@@ -298,19 +444,20 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
     int zmin = (int)( vcl_ceil(p1[2]) );
     int zmax = (int)( vcl_ceil(p2[2]) );
 
-    if ( zmin > extent[5] || zmax < extent[4] )
+    if ( zmin > zlast || zmax < zfirst )
       {
+      p1 = coords[i];
       continue;
       }
 
     // cap to the volume extents
-    if ( zmin < extent[4] )
+    if ( zmin < zfirst )
       {
-      zmin = extent[4];
+      zmin = zfirst;
       }
-    if ( zmax > extent[5] )
+    if ( zmax > zlast )
       {
-      zmax = extent[5] + 1;
+      zmax = zlast + 1;
       }
     double temp = 1.0 / ( p2[2] - p1[2] );
     for ( int z = zmin; z < zmax; z++ )
@@ -320,7 +467,7 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
       Point2DType XY;
       XY[0] = r * p1[0] + f * p2[0];
       XY[1] = r * p1[1] + f * p2[1];
-      matrix[z - extent[4]].push_back(XY);
+      matrix[z - zfirst].push_back(XY);
       }
 
     p1 = coords[i];
@@ -346,9 +493,9 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
   // except that 'x' is our depth value and we can store multiple
   // 'x' values per (y,z) value.
 
-  for ( int z = extent[4]; z <= extent[5]; z++ )
+  for ( int z = zfirst; z <= zlast; z++ )
     {
-    Point2DVector & xylist = matrix[z - extent[4]];
+    Point2DVector & xylist = matrix[z - zfirst];
 
     if ( xylist.empty() )
       {
@@ -403,16 +550,6 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
   InputPointsContainerPointer  myPoints = input->GetPoints();
   InputPointsContainerIterator points = myPoints->Begin();
 
-  int extent[6];
-
-  // create a similar extent like vtk
-  extent[0] = m_Index[0];
-  extent[1] = m_Size[0] - 1;
-  extent[2] = m_Index[1];
-  extent[3] = m_Size[1] - 1;
-  extent[4] = m_Index[2];
-  extent[5] = m_Size[2] - 1;
-
   OutputImagePointer OutputImage = this->GetOutput();
 
   // need to transform points from physical to index coordinates
@@ -422,29 +559,30 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
 
   // the index value type must match the point value type
   ContinuousIndex< PointType::ValueType, 3 > ind;
-  unsigned int                               pointId = 0;
+
+  // in partial volume mode, y and z are scaled so that the integer
+  // coordinates fall on the centers of the sub-scanlines
+  const double subdivisions = m_ComputePartialVolume ? m_PartialVolumeSubdivisions : 1;
+  const double shift = 0.5 * ( subdivisions - 1.0 );
 
   while ( points != myPoints->End() )
     {
     PointType p = points.Value();
     OutputImage->TransformPhysicalPointToContinuousIndex(p, ind);
-    NewPoints->InsertElement(pointId++, ind);
+    ind[1] = subdivisions * ind[1] + shift;
+    ind[2] = subdivisions * ind[2] + shift;
+    NewPoints->InsertElement(points.Index(), ind);
 
     points++;
     }
   NewPointSet->SetPoints(NewPoints);
 
-  // the stencil is kept in 'zymatrix' that provides
-  // the x extents for each (y,z) coordinate for which a ray
-  // parallel to the x axis intersects the polydata
-  int          zInc = extent[3] - extent[2] + 1;
-  int          zSize = extent[5] - extent[4] + 1;
-  Point1DArray zymatrix(zInc * zSize);
-  PointVector  coords;
-
   CellsContainerPointer  cells = input->GetCells();
   CellsContainerIterator cellIt = cells->Begin();
 
+  m_Polygons.clear();
+  m_Polygons.reserve( cells->Size() );
+
   while ( cellIt != cells->End() )
     {
     CellType *nextCell = cellIt->Value();
@@ -459,7 +597,9 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
       case CellType::TRIANGLE_CELL:
       case CellType::POLYGON_CELL:
         {
-        coords.clear();
+        m_Polygons.push_back( PointVector() );
+        PointVector & coords = m_Polygons.back();
+        coords.reserve( nextCell->GetNumberOfPoints() );
         while ( pointIt != nextCell->PointIdsEnd() )
           {
           if ( !NewPointSet->GetPoint(*pointIt++, &newpoint) )
@@ -472,7 +612,6 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
           p[2] = newpoint[2];
           coords.push_back(p);
           }
-        this->PolygonToImageRaster(coords, zymatrix, extent);
         }
         break;
       default:
@@ -480,99 +619,61 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
       }
     cellIt++;
     }
+}
 
-  // we only want to generate a max of 1 warning per execute
-  int alreadywarned = 1;
+template< class TInputMesh, class TOutputImage >
+void
+TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
+::ComputeScanlineCrossings(Point1DVector & xlist, std::vector< double > & nlist) const
+{
+  nlist.clear();
 
-  //create the equivalent of vtkStencilData from our zymatrix
-  for ( int z = extent[4]; z <= extent[5]; z++ )
+  if ( xlist.empty() )
     {
-    for ( int y = extent[2]; y <= extent[3]; y++ )
-      {
-      int           zyidx = ( z - extent[4] ) * zInc + ( y - extent[2] );
-      Point1DVector xlist = zymatrix[zyidx];
-
-      if ( xlist.empty() )
-        {
-        continue;
-        }
-      if ( xlist.size() > 1 )
-        {
-        std::sort(xlist.begin(), xlist.end(), ComparePoints1D);
-        }
-      //get the first entry
-      double lastx = xlist[0].m_X;
-      int    signproduct = 1;
-
-      // if adjacent x values are within tolerance of each
-      // other, check whether the number of 'exits' and
-      // 'entrances' are equal (via signproduct) and if so,
-      // ignore all x values, but if not, then count
-      // them as a single intersection of the ray with the
-      // surface
-
-      std::vector< double > nlist;
-      int                   m = xlist.size();
-      for ( int j = 1; j < m; j++ )
-        {
-        Point1D p1D = xlist[j];
-        double  x = p1D.m_X;
-        int     sign = p1D.m_Sign;
+    return;
+    }
+  if ( xlist.size() > 1 )
+    {
+    std::sort(xlist.begin(), xlist.end(), ComparePoints1D);
+    }
+  //get the first entry
+  double lastx = xlist[0].m_X;
+  int    signproduct = 1;
+
+  // if adjacent x values are within tolerance of each
+  // other, check whether the number of 'exits' and
+  // 'entrances' are equal (via signproduct) and if so,
+  // ignore all x values, but if not, then count
+  // them as a single intersection of the ray with the
+  // surface
+  int m = xlist.size();
+  for ( int j = 1; j < m; j++ )
+    {
+    const Point1D & p1D = xlist[j];
+    double          x = p1D.m_X;
+    int             sign = p1D.m_Sign;
 
-        //check absolute distance from lastx to x
-        if ( ( ( x < lastx ) ? ( lastx - x ) : ( x - lastx ) ) > m_Tolerance )
-          {
-          if ( signproduct > 0 )
-            {
-            nlist.push_back(lastx);
-            }
-          signproduct = 1;
-          }
-        else
-          {
-          signproduct *= sign;
-          }
-        lastx = x;
-        }
+    //check absolute distance from lastx to x
+    if ( ( ( x < lastx ) ? ( lastx - x ) : ( x - lastx ) ) > m_Tolerance )
+      {
       if ( signproduct > 0 )
         {
         nlist.push_back(lastx);
         }
-      // if xlist length is not divisible by two, then
-      // the polydata isn't a closed surface
-      if ( (int)( nlist.size() ) % 2 != 0 && !alreadywarned )
-        {
-        alreadywarned = 1;
-        itkWarningMacro(<< "RequestInformation: PolyData does not form a closed surface");
-        }
-      // create the stencil extents
-      int minx1 = extent[0]; // minimum allowable x1 value
-      int n = (int)( nlist.size() ) / 2;
-
-      for ( int i = 0; i < n; i++ )
-        {
-        int x1 = (int)( vcl_ceil(nlist[2 * i]) );
-        int x2 = (int)( vcl_floor(nlist[2 * i + 1]) );
-
-        if ( x2 < extent[0] || x1 > ( extent[1] ) )
-          {
-          continue;
-          }
-        x1 = ( x1 > minx1 ) ? ( x1 ) : ( minx1 );         // max(x1,minx1)
-        x2 = ( x2 < extent[1] ) ? ( x2 ) : ( extent[1] ); //min(x2,extent[1])
-
-        if ( x2 >= x1 )
-          {
-          for ( int idX = x1; idX <= x2; idX++ )
-            {
-            m_StencilIndex.push_back(idX + y * m_Size[0] + z * m_Size[0] * m_Size[1]);
-            }
-          }
-        // next x1 value must be at least x2+1
-        minx1 = x2 + 1;
-        }
+      signproduct = 1;
       }
+    else
+      {
+      signproduct *= sign;
+      }
+    lastx = x;
+    }
+  if ( signproduct > 0 )
+    {
+    nlist.push_back(lastx);
     }
+  // if nlist length is not divisible by two, then the polydata
+  // isn't a closed surface and the last crossing is ignored
 }
 
 template< class TInputMesh, class TOutputImage >
@@ -591,6 +692,8 @@ TriangleMeshToBinaryImageFilter< TInputMesh, TOutputImage >
   os << indent << "Spacing: " << m_Spacing << std::endl;
   os << indent << "Direction: " << std::endl << m_Direction << std::endl;
   os << indent << "Index: " << m_Index << std::endl;
+  os << indent << "ComputePartialVolume: " << m_ComputePartialVolume << std::endl;
+  os << indent << "PartialVolumeSubdivisions: " << m_PartialVolumeSubdivisions << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+
+/**
+ *
+ *  This program checks that the rasterization of a sphere of center
+ *  (50,50,50) and radius 20 does not depend on the number of threads
+ *  or on streaming, and that the partial volume output agrees with
+ *  the binary output.
+ *
+ */
+
+#include "itkRegularSphereMeshSource.h"
+#include "itkDefaultDynamicMeshTraits.h"
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTriangleMeshToBinaryImageFilter.h"
+
+template< class TImage >
+static bool itkTriangleMeshToBinaryImageFilterTest4Compare(const TImage *image1, const TImage *image2)
+{
+  if ( image1->GetBufferedRegion() != image2->GetBufferedRegion() )
+    {
+    return false;
+    }
+  itk::ImageRegionConstIterator< TImage > it1( image1, image1->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< TImage > it2( image2, image2->GetBufferedRegion() );
+  while ( !it1.IsAtEnd() )
+    {
+    if ( it1.Get() != it2.Get() )
+      {
+      return false;
+      }
+    ++it1;
+    ++it2;
+    }
+  return true;
+}
+
+int itkTriangleMeshToBinaryImageFilterTest4(int, char * [] )
+{
+  typedef itk::DefaultDynamicMeshTraits<double, 3, 3> TriangleMeshTraits;
+  typedef itk::Mesh<double,3, TriangleMeshTraits>     TriangleMeshType;
+
+  typedef itk::RegularSphereMeshSource<TriangleMeshType> SphereMeshSourceType;
+  typedef SphereMeshSourceType::PointType                PointType;
+  typedef SphereMeshSourceType::VectorType               VectorType;
+
+  SphereMeshSourceType::Pointer  mySphereMeshSource = SphereMeshSourceType::New();
+  PointType center;
+  center.Fill(50);
+  VectorType scale;
+  scale.Fill(20);
+
+  mySphereMeshSource->SetCenter(center);
+  mySphereMeshSource->SetResolution(3);
+  mySphereMeshSource->SetScale(scale);
+  mySphereMeshSource->Update();
+
+  typedef itk::Image<unsigned char,3> ImageType;
+  typedef itk::TriangleMeshToBinaryImageFilter<TriangleMeshType,ImageType> FilterType;
+
+  ImageType::SizeType size;
+  size.Fill(100);
+
+  // single threaded reference
+  FilterType::Pointer reference = FilterType::New();
+  reference->SetInput(mySphereMeshSource->GetOutput());
+  reference->SetSize(size);
+  reference->SetNumberOfThreads(1);
+  reference->Update();
+
+  unsigned long count = 0;
+  itk::ImageRegionConstIterator< ImageType > it( reference->GetOutput(),
+                                                 reference->GetOutput()->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() == reference->GetInsideValue() )
+      {
+      ++count;
+      }
+    }
+  std::cout << "Number of inside pixels: " << count << std::endl;
+  if ( count == 0 )
+    {
+    std::cerr << "No pixel inside the sphere" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // multi-threaded
+  FilterType::Pointer threaded = FilterType::New();
+  threaded->SetInput(mySphereMeshSource->GetOutput());
+  threaded->SetSize(size);
+  threaded->SetNumberOfThreads(4);
+  threaded->Update();
+
+  if ( !itkTriangleMeshToBinaryImageFilterTest4Compare( reference->GetOutput(), threaded->GetOutput() ) )
+    {
+    std::cerr << "Multi-threaded output differs from single-threaded output" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // streamed
+  FilterType::Pointer streamed = FilterType::New();
+  streamed->SetInput(mySphereMeshSource->GetOutput());
+  streamed->SetSize(size);
+
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( streamed->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(7);
+  streamer->Update();
+
+  if ( !itkTriangleMeshToBinaryImageFilterTest4Compare( reference->GetOutput(), streamer->GetOutput() ) )
+    {
+    std::cerr << "Streamed output differs from non-streamed output" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // partial volume
+  typedef itk::Image<float,3> FloatImageType;
+  typedef itk::TriangleMeshToBinaryImageFilter<TriangleMeshType,FloatImageType> PartialVolumeFilterType;
+
+  PartialVolumeFilterType::Pointer partial = PartialVolumeFilterType::New();
+  partial->SetInput(mySphereMeshSource->GetOutput());
+  partial->SetSize(size);
+  partial->ComputePartialVolumeOn();
+  partial->SetPartialVolumeSubdivisions(4);
+  partial->Update();
+
+  double volume = 0.0;
+  itk::ImageRegionConstIterator< FloatImageType > pit( partial->GetOutput(),
+                                                       partial->GetOutput()->GetBufferedRegion() );
+  for ( pit.GoToBegin(), it.GoToBegin(); !pit.IsAtEnd(); ++pit, ++it )
+    {
+    const float value = pit.Get();
+    if ( value < 0.0f || value > 1.0f )
+      {
+      std::cerr << "Partial volume out of range: " << value << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( ( value == 1.0f && it.Get() != reference->GetInsideValue() )
+         || ( value == 0.0f && it.Get() == reference->GetInsideValue() ) )
+      {
+      std::cerr << "Partial volume inconsistent with the binary output at "
+                << pit.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    volume += value;
+    }
+  std::cout << "Partial volume: " << volume << std::endl;
+  if ( vcl_fabs( volume - count ) > 0.02 * count )
+    {
+    std::cerr << "Partial volume " << volume << " too far from binary volume "
+              << count << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test [PASSED]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkQuadEdgeMeshOneRingAdjacency_h
+#define __itkQuadEdgeMeshOneRingAdjacency_h
+
+#include "itkMultiThreader.h"
+
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class QuadEdgeMeshOneRingAdjacency
+ * \brief One-ring adjacency of a QuadEdgeMesh flattened in compressed
+ * sparse row arrays.
+ *
+ * Build() walks the Onext ring of every vertex once, starting from the
+ * edge stored in the point, and stores for every vertex the range
+ * [GetRingBegin(), GetRingEnd()) of its ring entries. Each entry holds
+ * the edge and the index of its destination vertex. Vertices are
+ * indexed in the order of the points container, so that per-vertex
+ * values can be kept in plain arrays.
+ *
+ * The arrays do not follow later changes of the mesh topology; Build()
+ * has to be called again after the mesh connectivity is modified.
+ *
+ * ParallelForEachVertexRange() splits the vertices in contiguous ranges
+ * processed by the threads of a MultiThreader.
+ *
+ * \ingroup ITK-QuadEdgeMesh
+ */
+template< class TMesh >
+class QuadEdgeMeshOneRingAdjacency
+{
+public:
+  typedef QuadEdgeMeshOneRingAdjacency      Self;
+  typedef TMesh                             MeshType;
+  typedef typename MeshType::PointIdentifier PointIdentifier;
+  typedef typename MeshType::PointType       PointType;
+  typedef typename MeshType::QEType          QEType;
+  typedef typename MeshType::PointsContainer PointsContainer;
+
+  QuadEdgeMeshOneRingAdjacency() {}
+
+  /** Flatten the one-ring adjacency of the given mesh. */
+  void Build(const MeshType *mesh);
+
+  /** Number of vertices, i.e. of points in the mesh. */
+  SizeValueType GetNumberOfVertices() const
+  { return static_cast< SizeValueType >( m_PointIdentifiers.size() ); }
+
+  /** Point identifier of a vertex. */
+  const PointIdentifier & GetPointIdentifier(SizeValueType vertex) const
+  { return m_PointIdentifiers[vertex]; }
+
+  /** Range of the ring entries of a vertex; empty for isolated points. */
+  SizeValueType GetRingBegin(SizeValueType vertex) const
+  { return m_Offsets[vertex]; }
+  SizeValueType GetRingEnd(SizeValueType vertex) const
+  { return m_Offsets[vertex + 1]; }
+
+  /** Edge of a ring entry, with the vertex as origin. */
+  QEType * GetEdge(SizeValueType entry) const
+  { return m_Edges[entry]; }
+
+  /** Vertex index of the destination of a ring entry. */
+  SizeValueType GetNeighbor(SizeValueType entry) const
+  { return m_Neighbors[entry]; }
+
+  /** Call functor(firstVertex, lastVertex) on contiguous ranges of
+   * vertices, one per thread of the threader. The functor is called
+   * concurrently and must only write to data owned by its range. */
+  template< class TFunctor >
+  void ParallelForEachVertexRange(MultiThreader *threader, TFunctor & functor) const;
+
+private:
+  template< class TFunctor >
+  struct ThreadStruct {
+    const Self *Adjacency;
+    TFunctor   *Functor;
+  };
+
+  template< class TFunctor >
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
+
+  std::vector< PointIdentifier > m_PointIdentifiers;
+  std::vector< SizeValueType >   m_Offsets;
+  std::vector< QEType * >        m_Edges;
+  std::vector< SizeValueType >   m_Neighbors;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkQuadEdgeMeshOneRingAdjacency.txx"
+#endif
+
+#endif
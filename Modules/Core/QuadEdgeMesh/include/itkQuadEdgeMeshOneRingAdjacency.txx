@@ -0,0 +1,126 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkQuadEdgeMeshOneRingAdjacency_txx
+#define __itkQuadEdgeMeshOneRingAdjacency_txx
+
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+template< class TMesh >
+void
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::Build(const MeshType *mesh)
+{
+  const PointsContainer *points = mesh->GetPoints();
+
+  m_PointIdentifiers.clear();
+  m_Offsets.clear();
+  m_Edges.clear();
+  m_Neighbors.clear();
+
+  if ( !points )
+    {
+    m_Offsets.push_back(0);
+    return;
+    }
+
+  m_PointIdentifiers.reserve( points->Size() );
+  m_Offsets.reserve( points->Size() + 1 );
+
+  // vertex index of every point identifier
+  PointIdentifier maximumIdentifier = NumericTraits< PointIdentifier >::Zero;
+  typename PointsContainer::ConstIterator it;
+  for ( it = points->Begin(); it != points->End(); ++it )
+    {
+    m_PointIdentifiers.push_back( it.Index() );
+    if ( it.Index() > maximumIdentifier )
+      {
+      maximumIdentifier = it.Index();
+      }
+    }
+  const SizeValueType invalid = NumericTraits< SizeValueType >::max();
+  std::vector< SizeValueType > vertexOfIdentifier( m_PointIdentifiers.empty() ?
+                                                   0 : maximumIdentifier + 1, invalid );
+  for ( SizeValueType v = 0; v < m_PointIdentifiers.size(); v++ )
+    {
+    vertexOfIdentifier[m_PointIdentifiers[v]] = v;
+    }
+
+  // Onext ring of every vertex
+  for ( it = points->Begin(); it != points->End(); ++it )
+    {
+    m_Offsets.push_back( m_Edges.size() );
+
+    QEType *qe = it.Value().GetEdge();
+    if ( qe != 0 )
+      {
+      QEType *qe_it = qe;
+      do
+        {
+        m_Edges.push_back(qe_it);
+        m_Neighbors.push_back( vertexOfIdentifier[qe_it->GetDestination()] );
+        qe_it = qe_it->GetOnext();
+        }
+      while ( qe_it != qe );
+      }
+    }
+  m_Offsets.push_back( m_Edges.size() );
+}
+
+template< class TMesh >
+template< class TFunctor >
+void
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::ParallelForEachVertexRange(MultiThreader *threader, TFunctor & functor) const
+{
+  ThreadStruct< TFunctor > str;
+  str.Adjacency = this;
+  str.Functor = &functor;
+
+  threader->SetSingleMethod(&Self::template ThreaderCallback< TFunctor >, &str);
+  threader->SingleMethodExecute();
+}
+
+template< class TMesh >
+template< class TFunctor >
+ITK_THREAD_RETURN_TYPE
+QuadEdgeMeshOneRingAdjacency< TMesh >
+::ThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadStruct< TFunctor > *       str = static_cast< ThreadStruct< TFunctor > * >( info->UserData );
+
+  const SizeValueType numberOfVertices = str->Adjacency->GetNumberOfVertices();
+  const SizeValueType threadId = info->ThreadID;
+  const SizeValueType numberOfThreads = info->NumberOfThreads;
+
+  const SizeValueType first = ( numberOfVertices * threadId ) / numberOfThreads;
+  const SizeValueType last = ( numberOfVertices * ( threadId + 1 ) ) / numberOfThreads;
+
+  if ( first < last )
+    {
+    ( *str->Functor )(first, last);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+} // end namespace itk
+
+#endif
@@ -40,6 +40,7 @@
 #include "itkQuadEdgeMeshFunctionBase.h"
 #include "itkQuadEdgeMeshLineCell.txx"
 #include "itkQuadEdgeMeshMacro.h"
+#include "itkQuadEdgeMeshOneRingAdjacency.txx"
 #include "itkQuadEdgeMeshPoint.txx"
 #include "itkQuadEdgeMeshPolygonCell.txx"
 #include "itkQuadEdgeMeshScalarDataVTKPolyDataWriter.txx"
@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBoundingVolumeHierarchy_h
+#define __itkBoundingVolumeHierarchy_h
+
+#include "itkPoint.h"
+#include "itkIntTypes.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class BoundingVolumeHierarchy
+ * \brief Static tree of axis aligned boxes used to accelerate point
+ * queries on objects made of many primitives.
+ *
+ * The boxes of the primitives (points, segments, ...) are added with
+ * AddBox(), the box identifiers being consecutive from zero, and the tree
+ * is built once with Build(). The tree is then queried with a functor
+ * that evaluates the exact test on a primitive, so that the result of a
+ * query is the same as the one of a linear scan over the primitives.
+ * Queries do not modify the tree and can be run concurrently.
+ *
+ * \sa TubeSpatialObject
+ * \ingroup ITK-SpatialObjects
+ */
+template< unsigned int VDimension >
+class BoundingVolumeHierarchy
+{
+public:
+  typedef BoundingVolumeHierarchy    Self;
+  typedef Point< double, VDimension > PointType;
+  typedef SizeValueType              IdentifierType;
+
+  BoundingVolumeHierarchy();
+
+  /** Remove all the boxes and the tree. */
+  void Initialize();
+
+  /** Add the box of the next primitive. */
+  void AddBox(const PointType & minimum, const PointType & maximum);
+
+  /** Build the tree over the boxes added so far. */
+  void Build();
+
+  /** Number of boxes in the tree. */
+  IdentifierType GetNumberOfBoxes() const
+  { return static_cast< IdentifierType >( m_BoxMinimum.size() ); }
+
+  /** Call predicate(id) for the primitives whose box contains the point,
+   * until the predicate returns true. Returns true if it did. */
+  template< class TPredicate >
+  bool AnyBoxContaining(const PointType & point, TPredicate & predicate) const;
+
+  /** Find the primitive that minimizes squaredDistance(id), where
+   * squaredDistance(id) is never smaller than the squared distance from
+   * the point to the box of the primitive. Ties are resolved in favor
+   * of the largest identifier. Returns false if the tree is empty. */
+  template< class TDistance >
+  bool FindNearest(const PointType & point, TDistance & squaredDistance,
+                   IdentifierType & nearest, double & minimumSquaredDistance) const;
+
+private:
+  struct Node {
+    PointType m_Minimum;
+    PointType m_Maximum;
+    /** Children for inner nodes, range of m_Ids for leaves. */
+    IdentifierType m_Left;
+    IdentifierType m_Right;
+    bool m_Leaf;
+  };
+
+  /** Orders the boxes along one axis by the position of their center. */
+  struct CenterCompare {
+    const std::vector< PointType > *m_Minimum;
+    const std::vector< PointType > *m_Maximum;
+    unsigned int                    m_Axis;
+
+    bool operator()(IdentifierType a, IdentifierType b) const
+    {
+      return ( ( *m_Minimum )[a][m_Axis] + ( *m_Maximum )[a][m_Axis] )
+             < ( ( *m_Minimum )[b][m_Axis] + ( *m_Maximum )[b][m_Axis] );
+    }
+  };
+
+  IdentifierType BuildNode(IdentifierType first, IdentifierType last);
+
+  bool Contains(const Node & node, const PointType & point) const;
+
+  double SquaredDistance(const Node & node, const PointType & point) const;
+
+  /** The queries use a fixed size stack; the median split bounds the
+   * depth of the tree to about log2 of the number of boxes. */
+  itkStaticConstMacro(StackSize, unsigned int, 128);
+
+  std::vector< PointType >      m_BoxMinimum;
+  std::vector< PointType >      m_BoxMaximum;
+  std::vector< IdentifierType > m_Ids;
+  std::vector< Node >           m_Nodes;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBoundingVolumeHierarchy.txx"
+#endif
+
+#endif
@@ -0,0 +1,301 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBoundingVolumeHierarchy_txx
+#define __itkBoundingVolumeHierarchy_txx
+
+#include "itkBoundingVolumeHierarchy.h"
+#include "itkNumericTraits.h"
+
+#include <algorithm>
+
+namespace itk
+{
+template< unsigned int VDimension >
+BoundingVolumeHierarchy< VDimension >
+::BoundingVolumeHierarchy()
+{}
+
+template< unsigned int VDimension >
+void
+BoundingVolumeHierarchy< VDimension >
+::Initialize()
+{
+  m_BoxMinimum.clear();
+  m_BoxMaximum.clear();
+  m_Ids.clear();
+  m_Nodes.clear();
+}
+
+template< unsigned int VDimension >
+void
+BoundingVolumeHierarchy< VDimension >
+::AddBox(const PointType & minimum, const PointType & maximum)
+{
+  m_BoxMinimum.push_back(minimum);
+  m_BoxMaximum.push_back(maximum);
+}
+
+template< unsigned int VDimension >
+void
+BoundingVolumeHierarchy< VDimension >
+::Build()
+{
+  const IdentifierType numberOfBoxes = this->GetNumberOfBoxes();
+
+  m_Nodes.clear();
+  m_Ids.resize(numberOfBoxes);
+  for ( IdentifierType i = 0; i < numberOfBoxes; i++ )
+    {
+    m_Ids[i] = i;
+    }
+  if ( numberOfBoxes == 0 )
+    {
+    return;
+    }
+  // a binary tree with leaves of at most 4 boxes
+  m_Nodes.reserve(numberOfBoxes);
+  this->BuildNode(0, numberOfBoxes);
+}
+
+template< unsigned int VDimension >
+typename BoundingVolumeHierarchy< VDimension >::IdentifierType
+BoundingVolumeHierarchy< VDimension >
+::BuildNode(IdentifierType first, IdentifierType last)
+{
+  const IdentifierType nodeId = static_cast< IdentifierType >( m_Nodes.size() );
+
+  m_Nodes.push_back( Node() );
+
+  // bounds of the boxes and of their centers
+  Node      node;
+  PointType centerMinimum;
+  PointType centerMaximum;
+  node.m_Minimum = m_BoxMinimum[m_Ids[first]];
+  node.m_Maximum = m_BoxMaximum[m_Ids[first]];
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    centerMinimum[d] = node.m_Minimum[d] + node.m_Maximum[d];
+    centerMaximum[d] = centerMinimum[d];
+    }
+  for ( IdentifierType i = first + 1; i < last; i++ )
+    {
+    const PointType & minimum = m_BoxMinimum[m_Ids[i]];
+    const PointType & maximum = m_BoxMaximum[m_Ids[i]];
+    for ( unsigned int d = 0; d < VDimension; d++ )
+      {
+      node.m_Minimum[d] = std::min(node.m_Minimum[d], minimum[d]);
+      node.m_Maximum[d] = std::max(node.m_Maximum[d], maximum[d]);
+      const double center = minimum[d] + maximum[d];
+      centerMinimum[d] = std::min(centerMinimum[d], center);
+      centerMaximum[d] = std::max(centerMaximum[d], center);
+      }
+    }
+
+  if ( last - first <= 4 )
+    {
+    node.m_Leaf = true;
+    node.m_Left = first;
+    node.m_Right = last;
+    }
+  else
+    {
+    // median split along the axis where the centers spread the most
+    CenterCompare compare;
+    compare.m_Minimum = &m_BoxMinimum;
+    compare.m_Maximum = &m_BoxMaximum;
+    compare.m_Axis = 0;
+    for ( unsigned int d = 1; d < VDimension; d++ )
+      {
+      if ( centerMaximum[d] - centerMinimum[d]
+           > centerMaximum[compare.m_Axis] - centerMinimum[compare.m_Axis] )
+        {
+        compare.m_Axis = d;
+        }
+      }
+    const IdentifierType middle = first + ( last - first ) / 2;
+    std::nth_element(m_Ids.begin() + first, m_Ids.begin() + middle,
+                     m_Ids.begin() + last, compare);
+
+    node.m_Leaf = false;
+    node.m_Left = this->BuildNode(first, middle);
+    node.m_Right = this->BuildNode(middle, last);
+    }
+
+  m_Nodes[nodeId] = node;
+  return nodeId;
+}
+
+template< unsigned int VDimension >
+bool
+BoundingVolumeHierarchy< VDimension >
+::Contains(const Node & node, const PointType & point) const
+{
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    if ( point[d] < node.m_Minimum[d] || point[d] > node.m_Maximum[d] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< unsigned int VDimension >
+double
+BoundingVolumeHierarchy< VDimension >
+::SquaredDistance(const Node & node, const PointType & point) const
+{
+  double distance = 0.0;
+
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    double delta = 0.0;
+    if ( point[d] < node.m_Minimum[d] )
+      {
+      delta = node.m_Minimum[d] - point[d];
+      }
+    else if ( point[d] > node.m_Maximum[d] )
+      {
+      delta = point[d] - node.m_Maximum[d];
+      }
+    distance += delta * delta;
+    }
+  return distance;
+}
+
+template< unsigned int VDimension >
+template< class TPredicate >
+bool
+BoundingVolumeHierarchy< VDimension >
+::AnyBoxContaining(const PointType & point, TPredicate & predicate) const
+{
+  if ( m_Nodes.empty() )
+    {
+    return false;
+    }
+
+  IdentifierType stack[StackSize];
+  unsigned int   top = 0;
+  stack[top++] = 0;
+
+  while ( top > 0 )
+    {
+    const Node & node = m_Nodes[stack[--top]];
+    if ( !this->Contains(node, point) )
+      {
+      continue;
+      }
+    if ( node.m_Leaf )
+      {
+      for ( IdentifierType i = node.m_Left; i < node.m_Right; i++ )
+        {
+        const IdentifierType id = m_Ids[i];
+        bool                 inside = true;
+        for ( unsigned int d = 0; d < VDimension; d++ )
+          {
+          if ( point[d] < m_BoxMinimum[id][d] || point[d] > m_BoxMaximum[id][d] )
+            {
+            inside = false;
+            break;
+            }
+          }
+        if ( inside && predicate(id) )
+          {
+          return true;
+          }
+        }
+      }
+    else
+      {
+      stack[top++] = node.m_Right;
+      stack[top++] = node.m_Left;
+      }
+    }
+  return false;
+}
+
+template< unsigned int VDimension >
+template< class TDistance >
+bool
+BoundingVolumeHierarchy< VDimension >
+::FindNearest(const PointType & point, TDistance & squaredDistance,
+              IdentifierType & nearest, double & minimumSquaredDistance) const
+{
+  if ( m_Nodes.empty() )
+    {
+    return false;
+    }
+
+  IdentifierType stack[StackSize];
+  double         stackDistance[StackSize];
+  unsigned int   top = 0;
+
+  minimumSquaredDistance = NumericTraits< double >::max();
+  nearest = 0;
+  stack[top] = 0;
+  stackDistance[top++] = this->SquaredDistance(m_Nodes[0], point);
+
+  while ( top > 0 )
+    {
+    --top;
+    // nodes at the same distance are still visited to resolve the ties
+    if ( stackDistance[top] > minimumSquaredDistance )
+      {
+      continue;
+      }
+    const Node & node = m_Nodes[stack[top]];
+    if ( node.m_Leaf )
+      {
+      for ( IdentifierType i = node.m_Left; i < node.m_Right; i++ )
+        {
+        const IdentifierType id = m_Ids[i];
+        const double         distance = squaredDistance(id);
+        if ( distance < minimumSquaredDistance
+             || ( distance == minimumSquaredDistance && id > nearest ) )
+          {
+          minimumSquaredDistance = distance;
+          nearest = id;
+          }
+        }
+      }
+    else
+      {
+      // visit the closest child first
+      const double leftDistance = this->SquaredDistance(m_Nodes[node.m_Left], point);
+      const double rightDistance = this->SquaredDistance(m_Nodes[node.m_Right], point);
+      if ( leftDistance <= rightDistance )
+        {
+        stack[top] = node.m_Right;
+        stackDistance[top++] = rightDistance;
+        stack[top] = node.m_Left;
+        stackDistance[top++] = leftDistance;
+        }
+      else
+        {
+        stack[top] = node.m_Left;
+        stackDistance[top++] = leftDistance;
+        stack[top] = node.m_Right;
+        stackDistance[top++] = rightDistance;
+        }
+      }
+    }
+  return true;
+}
+} // end namespace itk
+
+#endif
@@ -57,6 +57,13 @@ public:
 
   /**  */
   bool ComputeLocalBoundingBox() const { return false; }
+
+  /** A group is only evaluated through its children. */
+  bool IsEvaluationThreadSafe(unsigned int depth = 0) const
+  {
+    return this->AreChildrenEvaluationThreadSafe(depth);
+  }
+
 protected:
   GroupSpatialObject(const Self &); //purposely not implemented
   void operator=(const Self &);     //purposely not implemented
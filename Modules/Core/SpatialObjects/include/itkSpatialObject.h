@@ -485,6 +485,16 @@ public:
     return false;
   }
 
+  /** Returns true if IsInside(), IsEvaluableAt() and ValueAt() may be
+   *  called by several threads at once on the object and its children
+   *  down to the given depth, once their bounding boxes are computed.
+   *  Most objects update their bounds and their internal inverse
+   *  transform at each evaluation, so the default is false. */
+  virtual bool IsEvaluationThreadSafe( unsigned int itkNotUsed(depth) = 0 ) const
+  {
+    return false;
+  }
+
   /** Get the bounding box of the object.
    *  This function calls ComputeBoundingBox() */
   virtual BoundingBoxType * GetBoundingBox() const;
@@ -553,6 +563,11 @@ protected:
    * by derived classes. */
   bool SetInternalInverseTransformToWorldToIndexTransform() const;
 
+  /** Returns true if the children of the object, down to the given depth,
+   *  are all thread safe for evaluation.  Used by the implementations of
+   *  IsEvaluationThreadSafe(). */
+  bool AreChildrenEvaluationThreadSafe(unsigned int depth) const;
+
 private:
 
   SpatialObject(const Self &);  //purposely not implemented
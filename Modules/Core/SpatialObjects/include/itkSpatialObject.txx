@@ -924,6 +924,35 @@ SpatialObject< TDimension >
   return true;
 }
 
+template< unsigned int TDimension >
+bool
+SpatialObject< TDimension >
+::AreChildrenEvaluationThreadSafe(unsigned int depth) const
+{
+  bool threadSafe = true;
+
+  if ( depth > 0 )
+    {
+    typedef typename TreeNodeType::ChildrenListType TreeChildrenListType;
+    TreeChildrenListType *children = m_TreeNode->GetChildren();
+    typename TreeChildrenListType::const_iterator it = children->begin();
+    typename TreeChildrenListType::const_iterator itEnd = children->end();
+
+    while ( it != itEnd )
+      {
+      if ( !( *it )->Get()->IsEvaluationThreadSafe(depth - 1) )
+        {
+        threadSafe = false;
+        break;
+        }
+      it++;
+      }
+    delete children;
+    }
+
+  return threadSafe;
+}
+
 template< unsigned int TDimension >
 void
 SpatialObject< TDimension >
@@ -30,6 +30,12 @@ namespace itk
  *  the maximum size of the object's bounding box is used.
  *  The spacing of the image is given by the spacing of the input
  *  Spatial object.
+ *
+ *  Only the requested region of the output is generated.  It is
+ *  computed by several threads, each one evaluating the spatial object
+ *  over its own region of the output, if the object and its children are
+ *  thread safe for evaluation (see SpatialObject::IsEvaluationThreadSafe()),
+ *  and by a single thread otherwise.
  * \ingroup ITK-SpatialObjects
  *
  * \wiki
@@ -152,9 +158,16 @@ protected:
   SpatialObjectToImageFilter();
   ~SpatialObjectToImageFilter();
 
-  virtual void GenerateOutputInformation(){}  // do nothing
+  virtual void GenerateOutputInformation();
+
+  /** Evaluate the object with a single thread if it is not thread safe */
   virtual void GenerateData();
 
+  virtual void BeforeThreadedGenerateData();
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId);
+
   SizeType m_Size;
   double m_Spacing[OutputImageDimension];
   double m_Origin[OutputImageDimension];
@@ -283,16 +283,14 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
 
 //----------------------------------------------------------------------------
 
-/** Update */
+/** Set the output image information */
 template< class TInputSpatialObject, class TOutputImage >
 void
 SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
-::GenerateData(void)
+::GenerateOutputInformation(void)
 {
   unsigned int i;
 
-  itkDebugMacro(<< "SpatialObjectToImageFilter::Update() called");
-
   // Get the input and output pointers
   const InputSpatialObjectType *InputObject  = this->GetInput();
   OutputImagePointer            OutputImage = this->GetOutput();
@@ -336,9 +334,7 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
     }
   region.SetIndex(index);
 
-  OutputImage->SetLargestPossibleRegion(region);      //
-  OutputImage->SetBufferedRegion(region);             // set the region
-  OutputImage->SetRequestedRegion(region);            //
+  OutputImage->SetLargestPossibleRegion(region);
   // If the spacing has been explicitly specified, the filter
   // will set the output spacing to that explicit spacing, otherwise the spacing
   // from
@@ -365,17 +361,72 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
     }
   OutputImage->SetOrigin(m_Origin);     //   and origin
   OutputImage->SetDirection(m_Direction);
-  OutputImage->Allocate();   // allocate the image
+}
+
+template< class TInputSpatialObject, class TOutputImage >
+void
+SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
+::GenerateData(void)
+{
+  if ( this->GetInput()->IsEvaluationThreadSafe(m_ChildrenDepth) )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  // most objects update their bounds and their inverse transform in
+  // IsInside(): evaluate them in the calling thread only
+  this->AllocateOutputs();
+  this->BeforeThreadedGenerateData();
+  this->ThreadedGenerateData(this->GetOutput()->GetRequestedRegion(), 0);
+  this->AfterThreadedGenerateData();
+}
+
+template< class TInputSpatialObject, class TOutputImage >
+void
+SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
+::BeforeThreadedGenerateData(void)
+{
+  itkDebugMacro(<< "SpatialObjectToImageFilter::Update() called");
+
+  // The objects compute their bounds and search structures lazily in
+  // IsInside(); compute them here so that the threads only read them.
+  const InputSpatialObjectType *InputObject  = this->GetInput();
+
+  InputObject->ComputeBoundingBox();
+  InputObject->ComputeLocalBoundingBox();
+
+  ChildrenListType *children = InputObject->GetChildren(m_ChildrenDepth);
+  typename ChildrenListType::const_iterator it = children->begin();
+  while ( it != children->end() )
+    {
+    ( *it )->ComputeLocalBoundingBox();
+    ++it;
+    }
+  delete children;
+}
+
+/** Evaluate the spatial object over the region of one thread */
+template< class TInputSpatialObject, class TOutputImage >
+void
+SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  unsigned int i;
+
+  const InputSpatialObjectType *InputObject  = this->GetInput();
+  OutputImagePointer            OutputImage = this->GetOutput();
 
   typedef itk::ImageRegionIteratorWithIndex< OutputImageType > myIteratorType;
 
-  myIteratorType it(OutputImage, region);
+  myIteratorType it(OutputImage, outputRegionForThread);
 
   itk::Point< double, ObjectDimension >      objectPoint;
   itk::Point< double, OutputImageDimension > imagePoint;
 
   ProgressReporter
-    progress(this,0,OutputImage->GetRequestedRegion().GetNumberOfPixels());
+    progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
   while( !it.IsAtEnd() )
     {
@@ -414,9 +465,7 @@ SpatialObjectToImageFilter< TInputSpatialObject, TOutputImage >
     ++it;
     progress.CompletedPixel();
     }
-
-  itkDebugMacro(<< "SpatialObjectToImageFilter::Update() finished");
-} // end update function
+}
 
 template< class TInputSpatialObject, class TOutputImage >
 void
@@ -22,6 +22,7 @@
 
 #include "itkPointBasedSpatialObject.h"
 #include "itkTubeSpatialObjectPoint.h"
+#include "itkBoundingVolumeHierarchy.h"
 
 namespace itk
 {
@@ -34,6 +35,11 @@ namespace itk
  * of a TubeSpatialObject Object.
  * A tube is also identified by an id number when connected to a network.
  *
+ * IsInside() is accelerated by a bounding volume hierarchy over the tube
+ * segments (or over the tube points for rounded ends), built with the
+ * bounding box. If the points are edited in place through GetPoints(),
+ * Modified() must be called for the hierarchy to be rebuilt.
+ *
  * \sa TubeSpatialObjectPoint
  * \ingroup ITK-SpatialObjects
  */
@@ -87,11 +93,11 @@ public:
 
   /** Set a point in the list at the specified index */
   virtual void SetPoint(IdentifierType ind, const TubePointType & pnt)
-  { m_Points[ind] = pnt; }
+  { m_Points[ind] = pnt; this->Modified(); }
 
   /** Remove a point in the list given the index */
   virtual void RemovePoint(IdentifierType ind)
-  { m_Points.erase(m_Points.begin() + ind); }
+  { m_Points.erase(m_Points.begin() + ind); this->Modified(); }
 
   /** Return the number of points in the list */
   virtual SizeValueType GetNumberOfPoints(void) const
@@ -134,6 +140,10 @@ public:
   /** Compute the boundaries of the tube. */
   bool ComputeLocalBoundingBox() const;
 
+  /** IsInside() only reads the bounds, the inverse transform and the
+   *  hierarchy computed by ComputeLocalBoundingBox(). */
+  bool IsEvaluationThreadSafe(unsigned int depth = 0) const;
+
   /** Set/Get the parent point which corresponds to the
    *  position of the point in the parent's points list */
   itkSetMacro(ParentPoint, int);
@@ -170,7 +180,41 @@ protected:
   /** TimeStamps */
   mutable unsigned long m_OldMTime;
   mutable unsigned long m_IndexToWorldTransformMTime;
+
+  /** Whether the IndexToWorldTransform was inverted by
+   * ComputeLocalBoundingBox() */
+  mutable bool m_InverseTransformIsValid;
+
+  /** Hierarchy of the segments (flat ends) or of the points (rounded
+   * ends) of the tube, in index space. */
+  typedef BoundingVolumeHierarchy< TDimension > SearchTreeType;
+  mutable SearchTreeType m_SearchTree;
+  mutable SizeValueType  m_SearchTreeNumberOfPoints;
+  mutable unsigned int   m_SearchTreeEndType;
+
+  /** Build the hierarchy used by IsInside(). */
+  void BuildSearchTree() const;
+
+  /** Test a point in index space against the segment starting at the
+   * given point, with flat ends. */
+  bool IsInsideSegment(SizeValueType segment, const PointType & point) const;
 private:
+  struct InsideSegmentPredicate {
+    const Self *m_Tube;
+    PointType   m_Point;
+    bool operator()(SizeValueType segment) const
+    { return m_Tube->IsInsideSegment(segment, m_Point); }
+  };
+
+  struct SquaredDistanceToPoint {
+    const PointListType *m_Points;
+    PointType            m_Point;
+    double operator()(SizeValueType id) const
+    { return m_Point.SquaredEuclideanDistanceTo( ( *m_Points )[id].GetPosition() ); }
+  };
+
+  friend struct InsideSegmentPredicate;
+
   TubeSpatialObject(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
 };
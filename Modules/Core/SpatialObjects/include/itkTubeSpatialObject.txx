@@ -24,6 +24,8 @@
 
 #include "itkTubeSpatialObject.h"
 
+#include <algorithm>
+
 namespace itk
 {
 /** Constructor */
@@ -42,7 +44,10 @@ TubeSpatialObject< TDimension, TTubePointType >
   this->GetProperty()->SetAlpha(1);
   m_OldMTime = 0;
   m_IndexToWorldTransformMTime = 0;
+  m_InverseTransformIsValid = false;
   m_EndType = 0; // default end-type is flat
+  m_SearchTreeNumberOfPoints = NumericTraits< SizeValueType >::max();
+  m_SearchTreeEndType = 0;
 }
 
 /** Destructor */
@@ -141,6 +146,9 @@ TubeSpatialObject< TDimension, TTubePointType >
   m_OldMTime = this->GetMTime();
   m_IndexToWorldTransformMTime = this->GetIndexToWorldTransform()->GetMTime();
 
+  m_InverseTransformIsValid = this->SetInternalInverseTransformToWorldToIndexTransform();
+  this->BuildSearchTree();
+
   if ( this->GetBoundingBoxChildrenName().empty()
        || strstr( typeid( Self ).name(), this->GetBoundingBoxChildrenName().c_str() ) )
     {
@@ -210,11 +218,11 @@ TubeSpatialObject< TDimension, TTubePointType >
   double minSquareDist = 999999.0;
   double tempSquareDist;
   typename PointListType::const_iterator it = m_Points.begin();
-  typename PointListType::const_iterator it2 = m_Points.begin();
   typename PointListType::const_iterator end = m_Points.end();
   typename PointListType::const_iterator min;
 
-  if ( !this->SetInternalInverseTransformToWorldToIndexTransform() )
+  // the inverse transform is up to date with the bounds
+  if ( !m_InverseTransformIsValid )
     {
     return false;
     }
@@ -222,86 +230,135 @@ TubeSpatialObject< TDimension, TTubePointType >
   PointType transformedPoint =
     this->GetInternalInverseTransform()->TransformPoint(point);
 
+  // use the hierarchy unless the points changed without Modified()
+  const bool useSearchTree = ( m_SearchTreeNumberOfPoints == m_Points.size()
+                               && m_SearchTreeEndType == m_EndType );
+
   if ( m_EndType == 0 ) // flat end-type
     {
-    it2++; // next point
-    while ( it2 != end )
+    if ( useSearchTree )
       {
-      // Check if the point is on the normal plane
-      PointType a = ( *it ).GetPosition();
-      PointType b = ( *it2 ).GetPosition();
-
-      double A = 0;
-      double B = 0;
+      InsideSegmentPredicate predicate;
+      predicate.m_Tube = this;
+      predicate.m_Point = transformedPoint;
+      return m_SearchTree.AnyBoxContaining(transformedPoint, predicate);
+      }
 
-      for ( unsigned int i = 0; i < TDimension; i++ )
+    const SizeValueType numberOfPoints = m_Points.size();
+    for ( SizeValueType i = 0; i + 1 < numberOfPoints; i++ )
+      {
+      if ( this->IsInsideSegment(i, transformedPoint) )
         {
-        A += ( b[i] - a[i] ) * ( transformedPoint[i] - a[i] );
-        B += ( b[i] - a[i] ) * ( b[i] - a[i] );
+        return true;
         }
-
-      double lambda = A / B;
-
-      if ( ( ( it != m_Points.begin() )
-             && ( lambda > -( ( *it ).GetRadius() / ( 2 * vcl_sqrt(B) ) ) )
-             && ( lambda < 0 ) )
-           || ( ( lambda <= 1.0 ) && ( lambda >= 0.0 ) )
-            )
+      }
+    }
+  else if ( m_EndType == 1 ) // rounded end-type
+    {
+    if ( useSearchTree )
+      {
+      SquaredDistanceToPoint distance;
+      distance.m_Points = &m_Points;
+      distance.m_Point = transformedPoint;
+      SizeValueType nearest;
+      if ( !m_SearchTree.FindNearest(transformedPoint, distance, nearest, tempSquareDist)
+           || tempSquareDist > minSquareDist )
         {
-        PointType p;
-
-        if ( lambda >= 0 )
-          {
-          for ( unsigned int i = 0; i < TDimension; i++ )
-            {
-            p[i] = a[i] + lambda * ( b[i] - a[i] );
-            }
-          }
-        else
+        return false;
+        }
+      min = m_Points.begin() + nearest;
+      minSquareDist = tempSquareDist;
+      }
+    else
+      {
+      bool found = false;
+      while ( it != end )
+        {
+        tempSquareDist = transformedPoint.SquaredEuclideanDistanceTo(
+          ( *it ).GetPosition() );
+        if ( tempSquareDist <= minSquareDist )
           {
-          for ( unsigned int i = 0; i < TDimension; i++ )
-            {
-            p[i] = b[i] + lambda * ( b[i] - a[i] );
-            }
+          minSquareDist = tempSquareDist;
+          min = it;
+          found = true;
           }
+        it++;
+        }
+      if ( !found )
+        {
+        return false;
+        }
+      }
 
-        tempSquareDist = transformedPoint.EuclideanDistanceTo(p);
+    double dist = vcl_sqrt(minSquareDist);
+    if ( dist <= ( ( *min ).GetRadius() ) )
+      {
+      return true;
+      }
+    }
+  return false;
+}
 
-        double R;
-        if ( lambda >= 0 )
-          {
-          R = ( *it ).GetRadius() + lambda * ( ( *it2 ).GetRadius() - ( *it ).GetRadius() );
-          }
-        else
-          {
-          R = ( *it2 ).GetRadius() + lambda * ( ( *it2 ).GetRadius() - ( *it ).GetRadius() );
-          }
+/** Test a point in index space against one segment of the tube */
+template< unsigned int TDimension, typename TTubePointType >
+bool
+TubeSpatialObject< TDimension, TTubePointType >
+::IsInsideSegment(SizeValueType segment, const PointType & transformedPoint) const
+{
+  const TubePointType & pointA = m_Points[segment];
+  const TubePointType & pointB = m_Points[segment + 1];
 
-        if ( tempSquareDist <= R )
-          {
-          return true;
-          }
-        }
-      it++;
-      it2++;
-      }
+  // Check if the point is on the normal plane
+  PointType a = pointA.GetPosition();
+  PointType b = pointB.GetPosition();
+
+  double A = 0;
+  double B = 0;
+
+  for ( unsigned int i = 0; i < TDimension; i++ )
+    {
+    A += ( b[i] - a[i] ) * ( transformedPoint[i] - a[i] );
+    B += ( b[i] - a[i] ) * ( b[i] - a[i] );
     }
-  else if ( m_EndType == 1 ) // rounded end-type
+
+  double lambda = A / B;
+
+  if ( ( ( segment != 0 )
+         && ( lambda > -( pointA.GetRadius() / ( 2 * vcl_sqrt(B) ) ) )
+         && ( lambda < 0 ) )
+       || ( ( lambda <= 1.0 ) && ( lambda >= 0.0 ) )
+        )
     {
-    while ( it != end )
+    PointType p;
+
+    if ( lambda >= 0 )
       {
-      tempSquareDist = transformedPoint.SquaredEuclideanDistanceTo(
-        ( *it ).GetPosition() );
-      if ( tempSquareDist <= minSquareDist )
+      for ( unsigned int i = 0; i < TDimension; i++ )
         {
-        minSquareDist = tempSquareDist;
-        min = it;
+        p[i] = a[i] + lambda * ( b[i] - a[i] );
+        }
+      }
+    else
+      {
+      for ( unsigned int i = 0; i < TDimension; i++ )
+        {
+        p[i] = b[i] + lambda * ( b[i] - a[i] );
         }
-      it++;
       }
 
-    double dist = vcl_sqrt(minSquareDist);
-    if ( dist <= ( ( *min ).GetRadius() ) )
+    double tempSquareDist = transformedPoint.EuclideanDistanceTo(p);
+
+    double R;
+    if ( lambda >= 0 )
+      {
+      R = pointA.GetRadius() + lambda * ( pointB.GetRadius() - pointA.GetRadius() );
+      }
+    else
+      {
+      R = pointB.GetRadius() + lambda * ( pointB.GetRadius() - pointA.GetRadius() );
+      }
+
+    if ( tempSquareDist <= R )
       {
       return true;
       }
@@ -309,6 +366,63 @@ TubeSpatialObject< TDimension, TTubePointType >
   return false;
 }
 
+/** Build the hierarchy of the segments or of the points of the tube */
+template< unsigned int TDimension, typename TTubePointType >
+void
+TubeSpatialObject< TDimension, TTubePointType >
+::BuildSearchTree() const
+{
+  m_SearchTree.Initialize();
+
+  const SizeValueType numberOfPoints = m_Points.size();
+
+  if ( m_EndType == 0 )
+    {
+    // bound the region where IsInsideSegment() can succeed: the
+    // projection lies between a and b, or before b by half the radius
+    // of a, and the distance is at most the largest interpolated radius
+    for ( SizeValueType i = 0; i + 1 < numberOfPoints; i++ )
+      {
+      const PointType a = m_Points[i].GetPosition();
+      const PointType b = m_Points[i + 1].GetPosition();
+      const double    ra = m_Points[i].GetRadius();
+      const double    rb = m_Points[i + 1].GetRadius();
+      const double    length = a.EuclideanDistanceTo(b);
+
+      double lambdaMin = 0.0;
+      if ( i != 0 && length > 0.0 )
+        {
+        lambdaMin = -ra / ( 2 * length );
+        }
+      double radius = std::max( ra, std::max( rb, rb + lambdaMin * ( rb - ra ) ) );
+      radius = std::max(radius, 0.0);
+      // guard against round-off in the exact test
+      const double margin = radius + 1e-6 * ( radius + length + 1.0 );
+
+      PointType minimum;
+      PointType maximum;
+      for ( unsigned int d = 0; d < TDimension; d++ )
+        {
+        const double c = b[d] + lambdaMin * ( b[d] - a[d] );
+        minimum[d] = std::min( std::min(a[d], b[d]), c ) - margin;
+        maximum[d] = std::max( std::max(a[d], b[d]), c ) + margin;
+        }
+      m_SearchTree.AddBox(minimum, maximum);
+      }
+    }
+  else
+    {
+    for ( SizeValueType i = 0; i < numberOfPoints; i++ )
+      {
+      m_SearchTree.AddBox( m_Points[i].GetPosition(), m_Points[i].GetPosition() );
+      }
+    }
+
+  m_SearchTree.Build();
+  m_SearchTreeNumberOfPoints = numberOfPoints;
+  m_SearchTreeEndType = m_EndType;
+}
+
 /** Return true if the given point is inside the tube */
 template< unsigned int TDimension, typename TTubePointType >
 bool
@@ -335,6 +449,15 @@ TubeSpatialObject< TDimension, TTubePointType >
   return Superclass::IsInside(point, depth, name);
 }
 
+/** The tube itself is thread safe for evaluation */
+template< unsigned int TDimension, typename TTubePointType >
+bool
+TubeSpatialObject< TDimension, TTubePointType >
+::IsEvaluationThreadSafe(unsigned int depth) const
+{
+  return this->AreChildrenEvaluationThreadSafe(depth);
+}
+
 /** Remove duplicate points */
 template< unsigned int TDimension, typename TTubePointType >
 unsigned int
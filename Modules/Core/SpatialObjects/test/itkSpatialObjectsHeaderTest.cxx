@@ -89,6 +89,7 @@
 #include "itkSpatialObjectPoint.txx"
 #include "itkMetaLineConverter.txx"
 #include "itkAffineGeometryFrame.txx"
+#include "itkBoundingVolumeHierarchy.txx"
 #include "itkVesselTubeSpatialObjectPoint.txx"
 
 
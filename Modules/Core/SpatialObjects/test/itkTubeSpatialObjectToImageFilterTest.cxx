@@ -0,0 +1,320 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#if defined(_MSC_VER)
+#pragma warning ( disable : 4786 )
+#endif
+
+/**
+ *  Rasterize a set of random tubes, with flat and rounded ends, and
+ *  compare the threaded and streamed outputs of SpatialObjectToImageFilter
+ *  to a brute force evaluation of the tube model.  Then rasterize an
+ *  ellipse and a box, which are not thread safe for evaluation, with a
+ *  tube, and compare the output to their equations.
+ */
+
+#include "itkTubeSpatialObject.h"
+#include "itkGroupSpatialObject.h"
+#include "itkEllipseSpatialObject.h"
+#include "itkBoxSpatialObject.h"
+#include "itkSpatialObjectToImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+typedef itk::TubeSpatialObject<3> TubeType;
+
+// Linear scan over the tube points, with the tube in index space
+static bool TubeBruteForceIsInside(const TubeType * tube, const TubeType::PointType & x)
+{
+  const TubeType::PointListType & points = tube->GetPoints();
+  const unsigned int              n = points.size();
+
+  // the tube is clipped to the bounding box of its points and radii
+  for ( unsigned int i = 0; i < 3; i++ )
+    {
+    double minimum = points[0].GetPosition()[i] - points[0].GetRadius();
+    double maximum = points[0].GetPosition()[i] + points[0].GetRadius();
+    for ( unsigned int s = 1; s < n; s++ )
+      {
+      minimum = std::min( minimum, points[s].GetPosition()[i] - points[s].GetRadius() );
+      maximum = std::max( maximum, points[s].GetPosition()[i] + points[s].GetRadius() );
+      }
+    if ( x[i] < minimum || x[i] > maximum )
+      {
+      return false;
+      }
+    }
+
+  if ( tube->GetEndType() == 0 )
+    {
+    for ( unsigned int s = 0; s + 1 < n; s++ )
+      {
+      TubeType::PointType a = points[s].GetPosition();
+      TubeType::PointType b = points[s + 1].GetPosition();
+      double ra = points[s].GetRadius();
+      double rb = points[s + 1].GetRadius();
+      double A = 0;
+      double B = 0;
+      for ( unsigned int i = 0; i < 3; i++ )
+        {
+        A += ( b[i] - a[i] ) * ( x[i] - a[i] );
+        B += ( b[i] - a[i] ) * ( b[i] - a[i] );
+        }
+      double lambda = A / B;
+      if ( ( s != 0 && lambda > -( ra / ( 2 * vcl_sqrt(B) ) ) && lambda < 0 )
+           || ( lambda <= 1.0 && lambda >= 0.0 ) )
+        {
+        TubeType::PointType p;
+        for ( unsigned int i = 0; i < 3; i++ )
+          {
+          p[i] = ( lambda >= 0 ? a[i] : b[i] ) + lambda * ( b[i] - a[i] );
+          }
+        double R = ( lambda >= 0 ? ra : rb ) + lambda * ( rb - ra );
+        if ( x.EuclideanDistanceTo(p) <= R )
+          {
+          return true;
+          }
+        }
+      }
+    return false;
+    }
+
+  double       minSquareDist = 999999.0;
+  unsigned int nearest = n;
+  for ( unsigned int s = 0; s < n; s++ )
+    {
+    double d = x.SquaredEuclideanDistanceTo( points[s].GetPosition() );
+    if ( d <= minSquareDist )
+      {
+      minSquareDist = d;
+      nearest = s;
+      }
+    }
+  return nearest < n && vcl_sqrt(minSquareDist) <= points[nearest].GetRadius();
+}
+
+int itkTubeSpatialObjectToImageFilterTest(int, char* [] )
+{
+  typedef itk::GroupSpatialObject<3> GroupType;
+  typedef itk::Image<unsigned char,3> ImageType;
+
+  typedef itk::SpatialObjectToImageFilter<GroupType,ImageType> SpatialObjectToImageFilterType;
+  typedef itk::StreamingImageFilter<ImageType,ImageType>       StreamingFilterType;
+
+  srand(1031);
+
+  for ( unsigned int endType = 0; endType < 2; endType++ )
+    {
+    GroupType::Pointer group = GroupType::New();
+    std::vector< TubeType::Pointer > tubes;
+
+    for ( unsigned int t = 0; t < 4; t++ )
+      {
+      TubeType::Pointer       tube = TubeType::New();
+      TubeType::PointListType list;
+      double p[3];
+      for ( unsigned int i = 0; i < 3; i++ )
+        {
+        p[i] = 10 + rand() % 20;
+        }
+      for ( unsigned int j = 0; j < 100; j++ )
+        {
+        TubeType::TubePointType pt;
+        for ( unsigned int i = 0; i < 3; i++ )
+          {
+          p[i] += ( rand() % 2001 - 1000 ) / 800.0;
+          }
+        pt.SetPosition(p[0], p[1], p[2]);
+        pt.SetRadius( 0.5 + ( rand() % 1000 ) / 500.0 );
+        list.push_back(pt);
+        }
+      tube->SetPoints(list);
+      tube->SetEndType(endType);
+      group->AddSpatialObject(tube);
+      tubes.push_back(tube);
+      }
+
+    ImageType::SizeType size;
+    size.Fill(40);
+
+    SpatialObjectToImageFilterType::Pointer imageFilter = SpatialObjectToImageFilterType::New();
+    imageFilter->SetInput(group);
+    imageFilter->SetSize(size);
+    imageFilter->SetInsideValue(255);
+    imageFilter->SetOutsideValue(1);
+    imageFilter->SetNumberOfThreads(4);
+
+    StreamingFilterType::Pointer streamer = StreamingFilterType::New();
+    streamer->SetInput( imageFilter->GetOutput() );
+    streamer->SetNumberOfStreamDivisions(3);
+
+    try
+      {
+      imageFilter->Update();
+      streamer->Update();
+      }
+    catch( itk::ExceptionObject & err )
+      {
+      std::cerr << err << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    unsigned int numberOfInsidePixels = 0;
+    itk::ImageRegionConstIteratorWithIndex< ImageType >
+      it( streamer->GetOutput(), streamer->GetOutput()->GetLargestPossibleRegion() );
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      ImageType::PointType point;
+      streamer->GetOutput()->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+
+      bool inside = false;
+      for ( unsigned int t = 0; t < tubes.size() && !inside; t++ )
+        {
+        inside = TubeBruteForceIsInside(tubes[t], point);
+        }
+      if ( inside != ( it.Get() == 255 ) )
+        {
+        std::cerr << "Mismatch at " << it.GetIndex() << " for end type "
+                  << endType << std::endl;
+        return EXIT_FAILURE;
+        }
+      numberOfInsidePixels += inside;
+      }
+    std::cout << "End type " << endType << ": "
+              << numberOfInsidePixels << " pixels inside" << std::endl;
+    if ( numberOfInsidePixels == 0 )
+      {
+      std::cerr << "No pixel inside the tubes" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // an ellipse and a box, with a tube
+  typedef itk::EllipseSpatialObject<3> EllipseType;
+  typedef itk::BoxSpatialObject<3>     BoxType;
+
+  EllipseType::Pointer ellipse = EllipseType::New();
+  EllipseType::ArrayType radius;
+  radius[0] = 8.3;
+  radius[1] = 5.7;
+  radius[2] = 6.2;
+  ellipse->SetRadius(radius);
+  EllipseType::TransformType::OffsetType ellipseOffset;
+  ellipseOffset[0] = 12.4;
+  ellipseOffset[1] = 14.6;
+  ellipseOffset[2] = 20.1;
+  ellipse->GetObjectToParentTransform()->SetOffset(ellipseOffset);
+  ellipse->ComputeObjectToWorldTransform();
+
+  BoxType::Pointer box = BoxType::New();
+  BoxType::SizeType boxSize;
+  boxSize[0] = 10.5;
+  boxSize[1] = 6.5;
+  boxSize[2] = 12.5;
+  box->SetSize(boxSize);
+  BoxType::TransformType::OffsetType boxOffset;
+  boxOffset[0] = 24.2;
+  boxOffset[1] = 26.2;
+  boxOffset[2] = 8.2;
+  box->GetObjectToParentTransform()->SetOffset(boxOffset);
+  box->ComputeObjectToWorldTransform();
+
+  TubeType::Pointer       tube = TubeType::New();
+  TubeType::PointListType list;
+  for ( unsigned int j = 0; j < 20; j++ )
+    {
+    TubeType::TubePointType pt;
+    pt.SetPosition(5 + j, 32, 5 + j);
+    pt.SetRadius(2.3);
+    list.push_back(pt);
+    }
+  tube->SetPoints(list);
+
+  GroupType::Pointer group = GroupType::New();
+  group->AddSpatialObject(ellipse);
+  group->AddSpatialObject(box);
+  group->AddSpatialObject(tube);
+
+  if ( !tube->IsEvaluationThreadSafe() || group->IsEvaluationThreadSafe(1) )
+    {
+    std::cerr << "Wrong thread safety of the tube or of the group" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  ImageType::SizeType size;
+  size.Fill(40);
+
+  SpatialObjectToImageFilterType::Pointer imageFilter = SpatialObjectToImageFilterType::New();
+  imageFilter->SetInput(group);
+  imageFilter->SetSize(size);
+  imageFilter->SetInsideValue(255);
+  imageFilter->SetOutsideValue(1);
+  imageFilter->SetNumberOfThreads(4);
+
+  try
+    {
+    imageFilter->Update();
+    }
+  catch( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  unsigned int numberOfInsidePixels[3] = { 0, 0, 0 };
+  itk::ImageRegionConstIteratorWithIndex< ImageType >
+    it( imageFilter->GetOutput(), imageFilter->GetOutput()->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    ImageType::PointType point;
+    imageFilter->GetOutput()->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+
+    double r = 0;
+    bool   insideBox = true;
+    for ( unsigned int i = 0; i < 3; i++ )
+      {
+      const double x = ( point[i] - ellipseOffset[i] ) / radius[i];
+      r += x * x;
+      insideBox = insideBox && point[i] >= boxOffset[i]
+                  && point[i] <= boxOffset[i] + boxSize[i];
+      }
+    const bool insideEllipse = r < 1;
+    const bool insideTube = TubeBruteForceIsInside(tube, point);
+    if ( ( insideEllipse || insideBox || insideTube ) != ( it.Get() == 255 ) )
+      {
+      std::cerr << "Mismatch at " << it.GetIndex() << " for the ellipse and the box" << std::endl;
+      return EXIT_FAILURE;
+      }
+    numberOfInsidePixels[0] += insideEllipse;
+    numberOfInsidePixels[1] += insideBox;
+    numberOfInsidePixels[2] += insideTube;
+    }
+  std::cout << "Ellipse, box and tube: " << numberOfInsidePixels[0] << ", "
+            << numberOfInsidePixels[1] << " and " << numberOfInsidePixels[2]
+            << " pixels inside" << std::endl;
+  if ( !numberOfInsidePixels[0] || !numberOfInsidePixels[1] || !numberOfInsidePixels[2] )
+    {
+    std::cerr << "No pixel inside the ellipse, the box or the tube" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
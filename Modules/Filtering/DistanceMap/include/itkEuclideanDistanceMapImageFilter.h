@@ -0,0 +1,254 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkEuclideanDistanceMapImageFilter_h
+#define __itkEuclideanDistanceMapImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+namespace itk
+{
+/** \class EuclideanDistanceMapImageFilter
+ *
+ * \tparam TInputImage Input Image Type
+ * \tparam TOutputImage Output Image Type
+ *
+ * \brief Computes the exact Euclidean distance map of the objects in an
+ * image, with the same outputs as DanielssonDistanceMapImageFilter.
+ *
+ * The input is assumed to contain numeric codes defining objects: every
+ * non-zero pixel is an object pixel. The filter produces
+ *
+ * \li A <b>distance map</b> with the Euclidean distance from each pixel to
+ *   the closest object pixel (output 0).
+ * \li A <b>Voronoi partition</b> using the same numeric codes as the input
+ *   (output 1).
+ * \li A <b>vector map</b> holding, as an itk::Offset in pixels, the vector
+ *   from each pixel to its closest object pixel (output 2).
+ *
+ * The parameters and outputs are the ones of
+ * DanielssonDistanceMapImageFilter, so that an existing pipeline can use
+ * this filter by changing the filter type only. The distances are exact
+ * rather than approximated; where two object pixels are at the same distance
+ * of a pixel, the Voronoi and vector maps may select a different one than
+ * DanielssonDistanceMapImageFilter.
+ *
+ * The transform is separable: for each dimension in turn, every image line
+ * along that dimension is processed independently by computing the lower
+ * envelope of the parabolas rooted at its pixels, as described in
+ *
+ * P. F. Felzenszwalb and D. P. Huttenlocher, "Distance Transforms of
+ * Sampled Functions", Cornell Computing and Information Science TR2004-1963,
+ * 2004.
+ *
+ * The lines are distributed over the threads, so all the passes are
+ * multithreaded and the cost is linear in the number of pixels. The only
+ * intermediate storage is the index of the closest object pixel, one
+ * OffsetValueType per pixel.
+ *
+ * When only the distance map is needed, ComputeVoronoiMapOff() avoids
+ * allocating the Voronoi and vector maps. Together with a float output
+ * image, this takes less than half the memory used by
+ * DanielssonDistanceMapImageFilter.
+ *
+ * \sa DanielssonDistanceMapImageFilter SignedMaurerDistanceMapImageFilter
+ *
+ * \ingroup ImageFeatureExtraction
+ * \ingroup MultiThreaded
+ *
+ * \ingroup ITK-DistanceMap
+ */
+template< class TInputImage, class TOutputImage >
+class ITK_EXPORT EuclideanDistanceMapImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef EuclideanDistanceMapImageFilter                 Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(EuclideanDistanceMapImageFilter, ImageToImageFilter);
+
+  /** Type for input image. */
+  typedef TInputImage                        InputImageType;
+  typedef typename InputImageType::PixelType InputPixelType;
+
+  /** Types for the region, index, offset, spacing and size of the images. */
+  typedef typename InputImageType::RegionType       RegionType;
+  typedef typename RegionType::IndexType            IndexType;
+  typedef typename InputImageType::OffsetType       OffsetType;
+  typedef typename OffsetType::OffsetValueType      OffsetValueType;
+  typedef typename InputImageType::SpacingType      SpacingType;
+  typedef typename RegionType::SizeType             SizeType;
+  typedef typename SizeType::SizeValueType          SizeValueType;
+
+  /** Type for the distance map and the Voronoi map. */
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+
+  /** The dimension of the input and output images. */
+  itkStaticConstMacro(InputImageDimension, unsigned int,
+                      InputImageType::ImageDimension);
+  itkStaticConstMacro(OutputImageDimension, unsigned int,
+                      TOutputImage::ImageDimension);
+
+  /** Type for the vector distance image */
+  typedef Image< OffsetType,
+                 itkGetStaticConstMacro(InputImageDimension) > VectorImageType;
+
+  /** Type for the image holding the offset in the buffer of the closest
+   * object pixel. */
+  typedef Image< OffsetValueType,
+                 itkGetStaticConstMacro(InputImageDimension) > FeatureImageType;
+
+  /** Pointer types. */
+  typedef typename InputImageType::ConstPointer   InputImagePointer;
+  typedef typename OutputImageType::Pointer       OutputImagePointer;
+  typedef typename VectorImageType::Pointer       VectorImagePointer;
+  typedef typename FeatureImageType::Pointer      FeatureImagePointer;
+  typedef typename Superclass::DataObjectPointer  DataObjectPointer;
+
+  /** Set if the distance should be squared. */
+  itkSetMacro(SquaredDistance, bool);
+
+  /** Get the distance squared. */
+  itkGetConstReferenceMacro(SquaredDistance, bool);
+
+  /** Set On/Off if the distance is squared. */
+  itkBooleanMacro(SquaredDistance);
+
+  /** Set if the input is binary. If this variable is set, each
+   * nonzero pixel in the input image will be given a unique numeric
+   * code to be used by the Voronoi partition. */
+  itkSetMacro(InputIsBinary, bool);
+
+  /** Get if the input is binary.  See SetInputIsBinary(). */
+  itkGetConstReferenceMacro(InputIsBinary, bool);
+
+  /** Set On/Off if the input is binary.  See SetInputIsBinary(). */
+  itkBooleanMacro(InputIsBinary);
+
+  /** Set if image spacing should be used in computing distances. */
+  itkSetMacro(UseImageSpacing, bool);
+
+  /** Get whether spacing is used. */
+  itkGetConstReferenceMacro(UseImageSpacing, bool);
+
+  /** Set On/Off whether spacing is used. */
+  itkBooleanMacro(UseImageSpacing);
+
+  /** Set if the Voronoi map and the vector map should be computed.
+   * When off, these outputs are not allocated. Default is on. */
+  itkSetMacro(ComputeVoronoiMap, bool);
+
+  /** Get if the Voronoi map and the vector map are computed. */
+  itkGetConstReferenceMacro(ComputeVoronoiMap, bool);
+
+  /** Set On/Off if the Voronoi map and the vector map are computed. */
+  itkBooleanMacro(ComputeVoronoiMap);
+
+  /** Get the Voronoi map. Each pixel holds the code of the closest
+   * object. */
+  OutputImageType * GetVoronoiMap(void);
+
+  /** Get the distance map. */
+  OutputImageType * GetDistanceMap(void);
+
+  /** Get the vector field from each pixel to its closest object pixel. */
+  VectorImageType * GetVectorDistanceMap(void);
+
+  /** This is overloaded to create the VectorDistanceMap output image */
+  virtual DataObjectPointer MakeOutput(unsigned int idx);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< InputImageDimension, OutputImageDimension > ) );
+  itkConceptMacro( IdentifierTypeConvertibleToOutputCheck,
+                   ( Concept::Convertible< IdentifierType, OutputPixelType > ) );
+  itkConceptMacro( DoubleConvertibleToOutputCheck,
+                   ( Concept::Convertible< double, OutputPixelType > ) );
+  itkConceptMacro( InputConvertibleToOutputCheck,
+                   ( Concept::Convertible< InputPixelType,
+                                           OutputPixelType > ) );
+  /** End concept checking */
+#endif
+protected:
+  EuclideanDistanceMapImageFilter();
+  virtual ~EuclideanDistanceMapImageFilter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Allocate the outputs, then run one multithreaded pass per dimension
+   * and a last one computing the outputs. */
+  void GenerateData();
+
+  /** Split the requested region along any dimension but the one being
+   * processed, so that each thread gets complete lines. */
+  unsigned int SplitRequestedRegion(unsigned int i, unsigned int num,
+                                    OutputImageRegionType & splitRegion);
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  /** Number the object pixels in the Voronoi map when the input is
+   * binary. */
+  void PrepareVoronoiMap();
+
+  /** Find the closest object pixel along the lines of the current
+   * dimension. */
+  void ThreadedPropagateFeatures(const OutputImageRegionType & region,
+                                 ThreadIdType threadId);
+
+  /** Compute the outputs from the closest object pixels. */
+  void ThreadedComputeOutputs(const OutputImageRegionType & region,
+                              ThreadIdType threadId);
+
+private:
+  EuclideanDistanceMapImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);                  //purposely not implemented
+
+  bool IsObject(const InputPixelType & value) const;
+
+  bool m_SquaredDistance;
+  bool m_InputIsBinary;
+  bool m_UseImageSpacing;
+  bool m_ComputeVoronoiMap;
+
+  /** Offset in the buffer of the closest object pixel, or -1. */
+  FeatureImagePointer m_FeatureImage;
+
+  /** The dimension processed by the current pass. Equal to the image
+   * dimension for the pass computing the outputs. */
+  unsigned int m_CurrentDimension;
+
+  /** Weight of each dimension in the distance: the spacing or one. */
+  SpacingType m_Weights;
+}; // end of EuclideanDistanceMapImageFilter class
+} //end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkEuclideanDistanceMapImageFilter.txx"
+#endif
+
+#endif
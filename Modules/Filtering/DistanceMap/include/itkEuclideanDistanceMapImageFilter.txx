@@ -0,0 +1,540 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkEuclideanDistanceMapImageFilter_txx
+#define __itkEuclideanDistanceMapImageFilter_txx
+
+#include "itkEuclideanDistanceMapImageFilter.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressReporter.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ *    Constructor
+ */
+template< class TInputImage, class TOutputImage >
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::EuclideanDistanceMapImageFilter()
+{
+  this->SetNumberOfRequiredOutputs(3);
+
+  OutputImagePointer voronoiMap = OutputImageType::New();
+  this->SetNthOutput( 1, voronoiMap.GetPointer() );
+
+  VectorImagePointer distanceVectors = VectorImageType::New();
+  this->SetNthOutput( 2, distanceVectors.GetPointer() );
+
+  m_SquaredDistance     = false;
+  m_InputIsBinary       = false;
+  m_UseImageSpacing     = false;
+  m_ComputeVoronoiMap   = true;
+  m_CurrentDimension    = 0;
+  m_Weights.Fill(1.0);
+}
+
+/** This is overloaded to create the VectorDistanceMap output image */
+template< class TInputImage, class TOutputImage >
+typename EuclideanDistanceMapImageFilter<
+  TInputImage, TOutputImage >::DataObjectPointer
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::MakeOutput(unsigned int idx)
+{
+  if  ( idx == 2 )
+    {
+    return static_cast< DataObject * >( VectorImageType::New().GetPointer() );
+    }
+  return Superclass::MakeOutput(idx);
+}
+
+/**
+ *  Return the distance map Image pointer
+ */
+template< class TInputImage, class TOutputImage >
+typename EuclideanDistanceMapImageFilter<
+  TInputImage, TOutputImage >::OutputImageType *
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::GetDistanceMap(void)
+{
+  return dynamic_cast< OutputImageType * >(
+           this->ProcessObject::GetOutput(0) );
+}
+
+/**
+ *  Return Closest Points Map
+ */
+template< class TInputImage, class TOutputImage >
+typename
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >::OutputImageType *
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::GetVoronoiMap(void)
+{
+  return dynamic_cast< OutputImageType * >(
+           this->ProcessObject::GetOutput(1) );
+}
+
+/**
+ *  Return the distance vectors
+ */
+template< class TInputImage, class TOutputImage >
+typename EuclideanDistanceMapImageFilter<
+  TInputImage, TOutputImage >::VectorImageType *
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::GetVectorDistanceMap(void)
+{
+  return dynamic_cast< VectorImageType * >(
+           this->ProcessObject::GetOutput(2) );
+}
+
+/**
+ *  Object pixels are the ones that are non zero in the Voronoi map
+ *  of DanielssonDistanceMapImageFilter.
+ */
+template< class TInputImage, class TOutputImage >
+bool
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::IsObject(const InputPixelType & value) const
+{
+  if ( m_InputIsBinary )
+    {
+    return value != NumericTraits< InputPixelType >::Zero;
+    }
+  return static_cast< OutputPixelType >( value ) != NumericTraits< OutputPixelType >::Zero;
+}
+
+/**
+ *  Number the object pixels of a binary input
+ */
+template< class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::PrepareVoronoiMap()
+{
+  OutputImageType *voronoiMap = this->GetVoronoiMap();
+  const RegionType region = voronoiMap->GetRequestedRegion();
+
+  ImageRegionConstIterator< InputImageType > it(this->GetInput(), region);
+  ImageRegionIterator< OutputImageType >     ot(voronoiMap,  region);
+
+  IdentifierType npt = 1;
+  while ( !ot.IsAtEnd() )
+    {
+    if ( it.Get() )
+      {
+      ot.Set(npt++);
+      }
+    ++it;
+    ++ot;
+    }
+}
+
+/**
+ *  Split on the outermost dimension that is not processed by the
+ *  current pass
+ */
+template< class TInputImage, class TOutputImage >
+unsigned int
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::SplitRequestedRegion(unsigned int i, unsigned int num,
+                       OutputImageRegionType & splitRegion)
+{
+  splitRegion = this->GetOutput()->GetRequestedRegion();
+
+  const SizeType & requestedRegionSize = splitRegion.GetSize();
+
+  IndexType splitIndex = splitRegion.GetIndex();
+  SizeType  splitSize  = splitRegion.GetSize();
+
+  int splitAxis = static_cast< int >( InputImageDimension ) - 1;
+  while ( ( requestedRegionSize[splitAxis] == 1 )
+          || ( splitAxis == static_cast< int >( m_CurrentDimension ) ) )
+    {
+    --splitAxis;
+    if ( splitAxis < 0 )
+      { // cannot split
+      itkDebugMacro("Cannot Split");
+      return 1;
+      }
+    }
+
+  // determine the actual number of pieces that will be generated
+  const SizeValueType range = requestedRegionSize[splitAxis];
+  const SizeValueType valuesPerThread = ( range + num - 1 ) / num;
+  const unsigned int  maxThreadIdUsed =
+    static_cast< unsigned int >( ( range + valuesPerThread - 1 ) / valuesPerThread ) - 1;
+
+  // Split the region
+  if ( i < maxThreadIdUsed )
+    {
+    splitIndex[splitAxis] += i * valuesPerThread;
+    splitSize[splitAxis] = valuesPerThread;
+    }
+  if ( i == maxThreadIdUsed )
+    {
+    splitIndex[splitAxis] += i * valuesPerThread;
+    // last thread needs to process the "rest" dimension being split
+    splitSize[splitAxis] = splitSize[splitAxis] - i * valuesPerThread;
+    }
+
+  splitRegion.SetIndex(splitIndex);
+  splitRegion.SetSize(splitSize);
+
+  itkDebugMacro("Split Piece: " << splitRegion);
+
+  return maxThreadIdUsed + 1;
+}
+
+/**
+ *  Compute Distance and Voronoi maps
+ */
+template< class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  OutputImagePointer distanceMap = this->GetDistanceMap();
+  const RegionType   region = distanceMap->GetRequestedRegion();
+
+  distanceMap->SetBufferedRegion(region);
+  distanceMap->Allocate();
+
+  if ( m_ComputeVoronoiMap )
+    {
+    OutputImagePointer voronoiMap = this->GetVoronoiMap();
+    voronoiMap->SetBufferedRegion(region);
+    voronoiMap->Allocate();
+
+    VectorImagePointer distanceComponents = this->GetVectorDistanceMap();
+    distanceComponents->SetBufferedRegion(region);
+    distanceComponents->Allocate();
+
+    if ( m_InputIsBinary )
+      {
+      this->PrepareVoronoiMap();
+      }
+    }
+
+  const SpacingType & spacing = this->GetInput()->GetSpacing();
+  for ( unsigned int dim = 0; dim < InputImageDimension; dim++ )
+    {
+    m_Weights[dim] = m_UseImageSpacing ? spacing[dim] : 1.0;
+    }
+
+  m_FeatureImage = FeatureImageType::New();
+  m_FeatureImage->SetRegions(region);
+  m_FeatureImage->Allocate();
+
+  typename Superclass::ThreadStruct str;
+  str.Filter = this;
+
+  MultiThreader *multithreader = this->GetMultiThreader();
+  multithreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  multithreader->SetSingleMethod(this->ThreaderCallback, &str);
+
+  // one pass per dimension, then one pass for the outputs
+  for ( m_CurrentDimension = 0; m_CurrentDimension <= InputImageDimension; m_CurrentDimension++ )
+    {
+    multithreader->SingleMethodExecute();
+    }
+
+  m_FeatureImage = 0;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  if ( m_CurrentDimension < InputImageDimension )
+    {
+    this->ThreadedPropagateFeatures(outputRegionForThread, threadId);
+    }
+  else
+    {
+    this->ThreadedComputeOutputs(outputRegionForThread, threadId);
+    }
+}
+
+/**
+ *  Along each line of the current dimension, every pixel with a closest
+ *  object pixel defines a parabola rising from its squared distance to
+ *  that object pixel. The lower envelope of the parabolas gives the new
+ *  closest object pixel of each pixel of the line.
+ */
+template< class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::ThreadedPropagateFeatures(const OutputImageRegionType & region,
+                            ThreadIdType threadId)
+{
+  const unsigned int  d = m_CurrentDimension;
+  const SizeValueType n = region.GetSize()[d];
+
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  FeatureImageType     *features = m_FeatureImage;
+  OffsetValueType      *buffer = features->GetBufferPointer();
+  const OffsetValueType stride = features->GetOffsetTable()[d];
+  const double          weight = m_Weights[d];
+  const double          infinity = NumericTraits< double >::max();
+
+  // heights and closest object pixels along the line, and the lower
+  // envelope: the parabolas and the boundaries between them
+  std::vector< double >          height(n);
+  std::vector< OffsetValueType > feature(n);
+  std::vector< SizeValueType >   parabola(n);
+  std::vector< double >          boundary(n + 1);
+
+  const float progressPerPass = 1.0f / static_cast< float >( InputImageDimension + 1 );
+  ProgressReporter progress(this, threadId, region.GetNumberOfPixels() / n, 100,
+                            d * progressPerPass, progressPerPass);
+
+  typedef ImageLinearConstIteratorWithIndex< FeatureImageType > LineIteratorType;
+  typedef ImageLinearConstIteratorWithIndex< InputImageType >   InputLineIteratorType;
+
+  LineIteratorType lineIt(features, region);
+  lineIt.SetDirection(d);
+  lineIt.GoToBegin();
+
+  InputLineIteratorType inputIt(this->GetInput(), region);
+  inputIt.SetDirection(d);
+  inputIt.GoToBegin();
+
+  while ( !lineIt.IsAtEnd() )
+    {
+    const IndexType       start = lineIt.GetIndex();
+    const OffsetValueType startOffset = features->ComputeOffset(start);
+    OffsetValueType      *line = buffer + startOffset;
+
+    if ( d == 0 )
+      {
+      for ( SizeValueType i = 0; i < n; i++ )
+        {
+        feature[i] = this->IsObject( inputIt.Get() ) ? startOffset + i * stride : -1;
+        height[i] = 0.0;
+        ++inputIt;
+        }
+      inputIt.NextLine();
+      }
+    else
+      {
+      for ( SizeValueType i = 0; i < n; i++ )
+        {
+        feature[i] = line[i * stride];
+        if ( feature[i] >= 0 )
+          {
+          // the closest object pixel only differs from the pixel in the
+          // dimensions already processed
+          const IndexType closest = features->ComputeIndex(feature[i]);
+          double          h = 0.0;
+          for ( unsigned int k = 0; k < d; k++ )
+            {
+            const double component = ( closest[k] - start[k] ) * m_Weights[k];
+            h += component * component;
+            }
+          height[i] = h;
+          }
+        }
+      }
+
+    // lower envelope of the parabolas
+    SizeValueType k = 0;
+    bool          found = false;
+    for ( SizeValueType q = 0; q < n; q++ )
+      {
+      if ( feature[q] < 0 )
+        {
+        continue;
+        }
+      const double xq = q * weight;
+      const double hq = height[q] + xq * xq;
+      if ( !found )
+        {
+        found = true;
+        parabola[0] = q;
+        boundary[0] = -infinity;
+        boundary[1] = infinity;
+        continue;
+        }
+      double s;
+      while ( true )
+        {
+        const SizeValueType p = parabola[k];
+        const double        xp = p * weight;
+        s = ( hq - ( height[p] + xp * xp ) ) / ( 2.0 * ( xq - xp ) );
+        if ( s > boundary[k] )
+          {
+          break;
+          }
+        --k;
+        }
+      ++k;
+      parabola[k] = q;
+      boundary[k] = s;
+      boundary[k + 1] = infinity;
+      }
+
+    if ( !found )
+      {
+      for ( SizeValueType i = 0; i < n; i++ )
+        {
+        line[i * stride] = -1;
+        }
+      }
+    else
+      {
+      k = 0;
+      for ( SizeValueType i = 0; i < n; i++ )
+        {
+        const double x = i * weight;
+        while ( boundary[k + 1] < x )
+          {
+          ++k;
+          }
+        line[i * stride] = feature[parabola[k]];
+        }
+      }
+
+    lineIt.NextLine();
+    progress.CompletedPixel();
+    }
+}
+
+/**
+ *  Compute the distance, the vector and the code of the closest object
+ */
+template< class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::ThreadedComputeOutputs(const OutputImageRegionType & region,
+                         ThreadIdType threadId)
+{
+  const FeatureImageType *features = m_FeatureImage;
+  const InputImageType   *input = this->GetInput();
+  OutputImageType        *voronoiMap = this->GetVoronoiMap();
+
+  const float progressPerPass = 1.0f / static_cast< float >( InputImageDimension + 1 );
+  ProgressReporter progress(this, threadId, region.GetNumberOfPixels(), 100,
+                            InputImageDimension * progressPerPass, progressPerPass);
+
+  // without any object, the vectors point out of the image, like the
+  // initial vectors of DanielssonDistanceMapImageFilter
+  const SizeType & size = features->GetBufferedRegion().GetSize();
+  SizeValueType    maxLength = 0;
+  for ( unsigned int dim = 0; dim < InputImageDimension; dim++ )
+    {
+    maxLength = vnl_math_max(maxLength, size[dim]);
+    }
+  OffsetType noObject;
+  noObject.Fill( 2 * maxLength );
+
+  OffsetType zero;
+  zero.Fill(0);
+
+  ImageRegionConstIteratorWithIndex< FeatureImageType > ft(features, region);
+  ImageRegionIterator< OutputImageType >                dt(this->GetDistanceMap(), region);
+  ImageRegionIterator< OutputImageType >                ot;
+  ImageRegionIterator< VectorImageType >                ct;
+  if ( m_ComputeVoronoiMap )
+    {
+    ot = ImageRegionIterator< OutputImageType >(voronoiMap, region);
+    ct = ImageRegionIterator< VectorImageType >(this->GetVectorDistanceMap(), region);
+    }
+
+  while ( !ft.IsAtEnd() )
+    {
+    const OffsetValueType feature = ft.Get();
+    IndexType             closest;
+    OffsetType            distanceVector;
+    if ( feature >= 0 )
+      {
+      closest = features->ComputeIndex(feature);
+      distanceVector = closest - ft.GetIndex();
+      }
+    else
+      {
+      distanceVector = noObject;
+      }
+
+    double distance = 0.0;
+    for ( unsigned int i = 0; i < InputImageDimension; i++ )
+      {
+      const double component = distanceVector[i] * m_Weights[i];
+      distance += component * component;
+      }
+
+    if ( m_SquaredDistance )
+      {
+      dt.Set( static_cast< OutputPixelType >( distance ) );
+      }
+    else
+      {
+      dt.Set( static_cast< OutputPixelType >( vcl_sqrt(distance) ) );
+      }
+
+    if ( m_ComputeVoronoiMap )
+      {
+      ct.Set(distanceVector);
+      if ( feature < 0 )
+        {
+        ot.Set(NumericTraits< OutputPixelType >::Zero);
+        }
+      else if ( !m_InputIsBinary )
+        {
+        ot.Set( static_cast< OutputPixelType >( input->GetPixel(closest) ) );
+        }
+      else if ( distanceVector != zero )
+        {
+        // the object pixels keep their code, so they can be read while
+        // the other threads write
+        ot.Set( voronoiMap->GetPixel(closest) );
+        }
+      ++ot;
+      ++ct;
+      }
+
+    ++ft;
+    ++dt;
+    progress.CompletedPixel();
+    }
+}
+
+/**
+ *  Print Self
+ */
+template< class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Input Is Binary     : " << m_InputIsBinary << std::endl;
+  os << indent << "Use Image Spacing   : " << m_UseImageSpacing << std::endl;
+  os << indent << "Squared Distance    : " << m_SquaredDistance << std::endl;
+  os << indent << "Compute Voronoi Map : " << m_ComputeVoronoiMap << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -27,6 +27,7 @@
 #include "itkHausdorffDistanceImageFilter.txx"
 #include "itkSignedDanielssonDistanceMapImageFilter.txx"
 #include "itkDanielssonDistanceMapImageFilter.txx"
+#include "itkEuclideanDistanceMapImageFilter.txx"
 #include "itkContourMeanDistanceImageFilter.txx"
 #include "itkDirectedHausdorffDistanceImageFilter.txx"
 #include "itkContourDirectedMeanDistanceImageFilter.txx"
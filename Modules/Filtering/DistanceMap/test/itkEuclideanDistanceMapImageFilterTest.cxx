@@ -0,0 +1,262 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkEuclideanDistanceMapImageFilter.h"
+#include "itkDanielssonDistanceMapImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "vnl/vnl_sample.h"
+
+// Compare the distance map with a brute force search of the closest object
+// pixel, check that the Voronoi and vector maps point to an object pixel at
+// that distance, and compare the outputs with the ones of
+// DanielssonDistanceMapImageFilter.
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer
+MakeObjects(const typename TImage::SizeType & size, double fraction)
+{
+  typename TImage::IndexType start;
+  start.Fill(-3);
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( typename TImage::RegionType(start, size) );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( vnl_sample_uniform(0.0, 1.0) < fraction )
+      {
+      it.Set( static_cast< typename TImage::PixelType >( vnl_sample_uniform(1.0, 6.0) ) );
+      }
+    else
+      {
+      it.Set(0);
+      }
+    }
+  return image;
+}
+
+template< class TImage >
+bool CheckAgainstBruteForce(TImage *input, bool useImageSpacing, bool squared,
+                            bool binary, unsigned int numberOfThreads)
+{
+  typedef itk::EuclideanDistanceMapImageFilter< TImage, TImage > FilterType;
+  typedef typename FilterType::VectorImageType                   VectorImageType;
+  typedef typename TImage::IndexType                             IndexType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetUseImageSpacing(useImageSpacing);
+  filter->SetSquaredDistance(squared);
+  filter->SetInputIsBinary(binary);
+  filter->SetNumberOfThreads(numberOfThreads);
+  filter->Update();
+
+  const typename TImage::RegionType region = input->GetBufferedRegion();
+  const typename TImage::SpacingType spacing = input->GetSpacing();
+
+  std::vector< IndexType > objects;
+  itk::ImageRegionIteratorWithIndex< TImage > it(input, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 0 )
+      {
+      objects.push_back( it.GetIndex() );
+      }
+    }
+
+  itk::ImageRegionIteratorWithIndex< TImage >          dt(filter->GetDistanceMap(), region);
+  itk::ImageRegionIteratorWithIndex< TImage >          ot(filter->GetVoronoiMap(), region);
+  itk::ImageRegionIteratorWithIndex< VectorImageType > ct(filter->GetVectorDistanceMap(), region);
+  for (; !dt.IsAtEnd(); ++dt, ++ot, ++ct )
+    {
+    const IndexType index = dt.GetIndex();
+
+    double minimum = itk::NumericTraits< double >::max();
+    for ( unsigned int o = 0; o < objects.size(); o++ )
+      {
+      double distance = 0.0;
+      for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+        {
+        const double component = ( objects[o][d] - index[d] ) * ( useImageSpacing ? spacing[d] : 1.0 );
+        distance += component * component;
+        }
+      minimum = vnl_math_min(minimum, distance);
+      }
+    const double expected = squared ? minimum : vcl_sqrt(minimum);
+
+    const IndexType closest = index + ct.Get();
+    double          vectorDistance = 0.0;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+      {
+      const double component = ct.Get()[d] * ( useImageSpacing ? spacing[d] : 1.0 );
+      vectorDistance += component * component;
+      }
+
+    if ( vnl_math_abs(dt.Get() - expected) > 1e-4 * ( 1.0 + expected )
+         || vnl_math_abs(vectorDistance - minimum) > 1e-4 * ( 1.0 + minimum )
+         || !region.IsInside(closest) || input->GetPixel(closest) == 0 )
+      {
+      std::cerr << "Wrong closest object at " << index << ": distance " << dt.Get()
+                << " instead of " << expected << ", vector " << ct.Get() << std::endl;
+      return false;
+      }
+
+    const double code = binary ? filter->GetVoronoiMap()->GetPixel(closest) : input->GetPixel(closest);
+    if ( ot.Get() != code )
+      {
+      std::cerr << "Wrong Voronoi code at " << index << ": " << ot.Get()
+                << " instead of " << code << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< class TImage >
+bool CompareWithDanielsson(TImage *input, bool binary)
+{
+  typedef itk::EuclideanDistanceMapImageFilter< TImage, TImage >  FilterType;
+  typedef itk::DanielssonDistanceMapImageFilter< TImage, TImage > DanielssonType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetInputIsBinary(binary);
+  filter->Update();
+
+  typename DanielssonType::Pointer danielsson = DanielssonType::New();
+  danielsson->SetInput(input);
+  danielsson->SetInputIsBinary(binary);
+  danielsson->Update();
+
+  // The distances are at most the ones of the approximation, and the
+  // object pixels get the same codes
+  const typename TImage::RegionType region = input->GetBufferedRegion();
+  itk::ImageRegionIteratorWithIndex< TImage > it(input, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    if ( filter->GetDistanceMap()->GetPixel(index) > danielsson->GetDistanceMap()->GetPixel(index) + 1e-5 )
+      {
+      std::cerr << "Distance larger than Danielsson's at " << index << std::endl;
+      return false;
+      }
+    if ( it.Get() != 0
+         && filter->GetVoronoiMap()->GetPixel(index) != danielsson->GetVoronoiMap()->GetPixel(index) )
+      {
+      std::cerr << "Object code differs from Danielsson's at " << index << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkEuclideanDistanceMapImageFilterTest(int, char *[])
+{
+  typedef itk::Image< float, 2 > Image2DType;
+  typedef itk::Image< float, 3 > Image3DType;
+
+  bool pass = true;
+
+  Image2DType::SizeType size2D;
+  size2D[0] = 37;
+  size2D[1] = 29;
+  Image2DType::Pointer image2D = MakeObjects< Image2DType >(size2D, 0.02);
+  Image2DType::SpacingType spacing2D;
+  spacing2D[0] = 1.0;
+  spacing2D[1] = 1.7;
+  image2D->SetSpacing(spacing2D);
+
+  pass &= CheckAgainstBruteForce< Image2DType >(image2D, false, false, false, 1);
+  pass &= CheckAgainstBruteForce< Image2DType >(image2D, true, false, false, 3);
+  pass &= CheckAgainstBruteForce< Image2DType >(image2D, true, true, true, 4);
+  pass &= CompareWithDanielsson< Image2DType >(image2D, false);
+  pass &= CompareWithDanielsson< Image2DType >(image2D, true);
+
+  Image3DType::SizeType size3D;
+  size3D[0] = 17;
+  size3D[1] = 13;
+  size3D[2] = 11;
+  Image3DType::Pointer image3D = MakeObjects< Image3DType >(size3D, 0.005);
+  Image3DType::SpacingType spacing3D;
+  spacing3D[0] = 0.8;
+  spacing3D[1] = 1.1;
+  spacing3D[2] = 2.5;
+  image3D->SetSpacing(spacing3D);
+
+  pass &= CheckAgainstBruteForce< Image3DType >(image3D, false, true, true, 2);
+  pass &= CheckAgainstBruteForce< Image3DType >(image3D, true, false, false, 4);
+  pass &= CompareWithDanielsson< Image3DType >(image3D, true);
+
+  // Without any object, the Voronoi map is zero and the distance is larger
+  // than the image diagonal
+  Image2DType::Pointer empty = MakeObjects< Image2DType >(size2D, 0.0);
+  typedef itk::EuclideanDistanceMapImageFilter< Image2DType, Image2DType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(empty);
+  filter->Update();
+  const double diagonal = vcl_sqrt( static_cast< double >( size2D[0] * size2D[0] + size2D[1] * size2D[1] ) );
+  itk::ImageRegionIteratorWithIndex< Image2DType > et( filter->GetDistanceMap(), empty->GetBufferedRegion() );
+  for (; !et.IsAtEnd(); ++et )
+    {
+    if ( et.Get() <= diagonal || filter->GetVoronoiMap()->GetPixel( et.GetIndex() ) != 0 )
+      {
+      std::cerr << "Wrong output without object at " << et.GetIndex() << std::endl;
+      pass = false;
+      break;
+      }
+    }
+
+  // Only the distance map is computed on request
+  typedef itk::EuclideanDistanceMapImageFilter< Image3DType, Image3DType > Filter3DType;
+  Filter3DType::Pointer distanceOnly = Filter3DType::New();
+  distanceOnly->SetInput(image3D);
+  distanceOnly->ComputeVoronoiMapOff();
+  distanceOnly->Update();
+  if ( distanceOnly->GetVoronoiMap()->GetBufferPointer() != 0
+       || distanceOnly->GetVectorDistanceMap()->GetBufferPointer() != 0 )
+    {
+    std::cerr << "The Voronoi map was computed" << std::endl;
+    pass = false;
+    }
+  Filter3DType::Pointer all = Filter3DType::New();
+  all->SetInput(image3D);
+  all->Update();
+  itk::ImageRegionIteratorWithIndex< Image3DType > at( all->GetDistanceMap(), image3D->GetBufferedRegion() );
+  for (; !at.IsAtEnd(); ++at )
+    {
+    if ( at.Get() != distanceOnly->GetDistanceMap()->GetPixel( at.GetIndex() ) )
+      {
+      std::cerr << "Distance map changed without the Voronoi map at " << at.GetIndex() << std::endl;
+      pass = false;
+      break;
+      }
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
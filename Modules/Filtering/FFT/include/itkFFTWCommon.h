@@ -22,6 +22,7 @@
 #if defined( USE_FFTWF ) || defined( USE_FFTWD )
 #include "fftw3.h"
 #endif
+#include <sstream>
 
 #if !defined(FFTW_WISDOM_ONLY)
 // FFTW_WISDOM_ONLY is a "beyond guru" option that is only available in fftw 3.2.2
@@ -33,6 +34,29 @@ namespace itk
 {
 namespace fftw
 {
+/** Build the key identifying a plan in the FFTWGlobalConfiguration plan
+ * cache: the kind of transform, its size, the planner flags, the number
+ * of threads and the alignment of the buffers. */
+inline std::string PlanKey(const char *kind,
+                           int rank,
+                           const int *n,
+                           int howmany,
+                           unsigned flags,
+                           int threads,
+                           int inputAlignment,
+                           int outputAlignment)
+{
+  std::ostringstream key;
+  key << kind;
+  for( int i=0; i<rank; i++ )
+    {
+    key << " " << n[i];
+    }
+  key << " x" << howmany << " flags " << flags << " threads " << threads
+      << " alignment " << inputAlignment << " " << outputAlignment;
+  return key.str();
+}
+
 /**
  * \class Interface
  * \brief Wrapper for FFTW API
@@ -344,6 +368,159 @@ public:
   }
 
 
+  /**
+   * Plan howmany real to complex transforms of size n, the images being
+   * stored one after the other in in and out. The input is never destroyed,
+   * even when the plan is created.
+   * When usePlanCache is true, the plan is taken from or added to the
+   * FFTWGlobalConfiguration plan cache, and must be released with
+   * ReleaseCachedPlan() instead of being destroyed.
+   * The plan can be run with Execute_dft_r2c() on any other buffers
+   * with the same alignment.
+   */
+  static PlanType Plan_many_dft_r2c(int rank,
+                                    const int *n,
+                                    int howmany,
+                                    PixelType *in,
+                                    ComplexType *out,
+                                    unsigned flags,
+                                    int threads=1,
+                                    bool usePlanCache=false)
+  {
+    int inputDistance = 1;
+    int outputDistance = 1;
+    for( int i=0; i<rank; i++ )
+      {
+      inputDistance *= n[i];
+      outputDistance *= ( i == rank - 1 ) ? n[i] / 2 + 1 : n[i];
+      }
+    const int inputAlignment = fftwf_alignment_of(in);
+    const std::string key = PlanKey("r2c", rank, n, howmany, flags, threads,
+                                    inputAlignment, fftwf_alignment_of((PixelType*)out));
+    FFTWGlobalConfiguration::Lock();
+    PlanType plan = NULL;
+    if( usePlanCache )
+      {
+      plan = FFTWGlobalConfiguration::GetCachedPlanFloat(key);
+      }
+    if( plan == NULL )
+      {
+      fftwf_plan_with_nthreads(threads);
+      // don't add FFTW_WISDOM_ONLY if the plan rigor is FFTW_ESTIMATE
+      // because FFTW_ESTIMATE guarantee to not destroy the input
+      unsigned roflags = flags;
+      if( ! (flags & FFTW_ESTIMATE) )
+        {
+        roflags = flags | FFTW_WISDOM_ONLY;
+        }
+      plan = fftwf_plan_many_dft_r2c(rank,n,howmany,in,NULL,1,inputDistance,
+                                     out,NULL,1,outputDistance,roflags);
+      if( plan == NULL )
+        {
+        // no wisdom available for that plan - lets create a plan with a fake
+        // input with the same alignment to generate the wisdom
+        char * buffer = (char*)fftwf_malloc(sizeof(PixelType)*inputDistance*howmany + inputAlignment);
+        PixelType * din = (PixelType*)(buffer + inputAlignment);
+        fftwf_destroy_plan(fftwf_plan_many_dft_r2c(rank,n,howmany,din,NULL,1,inputDistance,
+                                                   out,NULL,1,outputDistance,flags));
+        fftwf_free(buffer);
+        // and then create the final plan - this time it shouldn't fail
+        plan = fftwf_plan_many_dft_r2c(rank,n,howmany,in,NULL,1,inputDistance,
+                                       out,NULL,1,outputDistance,roflags);
+        FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+        }
+      if( usePlanCache && plan != NULL )
+        {
+        FFTWGlobalConfiguration::SetCachedPlanFloat(key, plan);
+        }
+      }
+    FFTWGlobalConfiguration::Unlock();
+    assert( plan != NULL );
+    return plan;
+  }
+
+  /**
+   * Plan howmany complex conjugate to real transforms of size n, the images
+   * being stored one after the other in in and out. The input is destroyed
+   * by the execution of the plan, but not by its creation.
+   * When usePlanCache is true, the plan is taken from or added to the
+   * FFTWGlobalConfiguration plan cache, and must be released with
+   * ReleaseCachedPlan() instead of being destroyed.
+   * The plan can be run with Execute_dft_c2r() on any other buffers
+   * with the same alignment.
+   */
+  static PlanType Plan_many_dft_c2r(int rank,
+                                    const int *n,
+                                    int howmany,
+                                    ComplexType *in,
+                                    PixelType *out,
+                                    unsigned flags,
+                                    int threads=1,
+                                    bool usePlanCache=false)
+  {
+    int inputDistance = 1;
+    int outputDistance = 1;
+    for( int i=0; i<rank; i++ )
+      {
+      inputDistance *= ( i == rank - 1 ) ? n[i] / 2 + 1 : n[i];
+      outputDistance *= n[i];
+      }
+    const int inputAlignment = fftwf_alignment_of((PixelType*)in);
+    const std::string key = PlanKey("c2r", rank, n, howmany, flags, threads,
+                                    inputAlignment, fftwf_alignment_of(out));
+    FFTWGlobalConfiguration::Lock();
+    PlanType plan = NULL;
+    if( usePlanCache )
+      {
+      plan = FFTWGlobalConfiguration::GetCachedPlanFloat(key);
+      }
+    if( plan == NULL )
+      {
+      fftwf_plan_with_nthreads(threads);
+      // don't add FFTW_WISDOM_ONLY if the plan rigor is FFTW_ESTIMATE
+      // because FFTW_ESTIMATE guarantee to not destroy the input
+      unsigned roflags = flags;
+      if( ! (flags & FFTW_ESTIMATE) )
+        {
+        roflags = flags | FFTW_WISDOM_ONLY;
+        }
+      plan = fftwf_plan_many_dft_c2r(rank,n,howmany,in,NULL,1,inputDistance,
+                                     out,NULL,1,outputDistance,roflags);
+      if( plan == NULL )
+        {
+        // no wisdom available for that plan - lets create a plan with a fake
+        // input with the same alignment to generate the wisdom
+        char * buffer = (char*)fftwf_malloc(sizeof(ComplexType)*inputDistance*howmany + inputAlignment);
+        ComplexType * din = (ComplexType*)(buffer + inputAlignment);
+        fftwf_destroy_plan(fftwf_plan_many_dft_c2r(rank,n,howmany,din,NULL,1,inputDistance,
+                                                   out,NULL,1,outputDistance,flags));
+        fftwf_free(buffer);
+        // and then create the final plan - this time it shouldn't fail
+        plan = fftwf_plan_many_dft_c2r(rank,n,howmany,in,NULL,1,inputDistance,
+                                       out,NULL,1,outputDistance,roflags);
+        FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+        }
+      if( usePlanCache && plan != NULL )
+        {
+        FFTWGlobalConfiguration::SetCachedPlanFloat(key, plan);
+        }
+      }
+    FFTWGlobalConfiguration::Unlock();
+    assert( plan != NULL );
+    return plan;
+  }
+
+  /** Run a plan on other buffers than the ones it was created with. These
+   * methods are thread safe. */
+  static void Execute_dft_r2c(PlanType p, PixelType *in, ComplexType *out)
+  {
+    fftwf_execute_dft_r2c(p, in, out);
+  }
+  static void Execute_dft_c2r(PlanType p, ComplexType *in, PixelType *out)
+  {
+    fftwf_execute_dft_c2r(p, in, out);
+  }
+
   static void Execute(PlanType p)
   {
     fftwf_execute(p);
@@ -352,6 +529,14 @@ public:
   {
     fftwf_destroy_plan(p);
   }
+
+  /** Release a plan got from the plan cache, which may then be evicted */
+  static void ReleaseCachedPlan(PlanType p)
+  {
+    FFTWGlobalConfiguration::Lock();
+    FFTWGlobalConfiguration::ReleaseCachedPlanFloat(p);
+    FFTWGlobalConfiguration::Unlock();
+  }
 };
 
 #endif // USE_FFTWF
@@ -646,6 +831,159 @@ public:
   }
 
 
+  /**
+   * Plan howmany real to complex transforms of size n, the images being
+   * stored one after the other in in and out. The input is never destroyed,
+   * even when the plan is created.
+   * When usePlanCache is true, the plan is taken from or added to the
+   * FFTWGlobalConfiguration plan cache, and must be released with
+   * ReleaseCachedPlan() instead of being destroyed.
+   * The plan can be run with Execute_dft_r2c() on any other buffers
+   * with the same alignment.
+   */
+  static PlanType Plan_many_dft_r2c(int rank,
+                                    const int *n,
+                                    int howmany,
+                                    PixelType *in,
+                                    ComplexType *out,
+                                    unsigned flags,
+                                    int threads=1,
+                                    bool usePlanCache=false)
+  {
+    int inputDistance = 1;
+    int outputDistance = 1;
+    for( int i=0; i<rank; i++ )
+      {
+      inputDistance *= n[i];
+      outputDistance *= ( i == rank - 1 ) ? n[i] / 2 + 1 : n[i];
+      }
+    const int inputAlignment = fftw_alignment_of(in);
+    const std::string key = PlanKey("r2c", rank, n, howmany, flags, threads,
+                                    inputAlignment, fftw_alignment_of((PixelType*)out));
+    FFTWGlobalConfiguration::Lock();
+    PlanType plan = NULL;
+    if( usePlanCache )
+      {
+      plan = FFTWGlobalConfiguration::GetCachedPlanDouble(key);
+      }
+    if( plan == NULL )
+      {
+      fftw_plan_with_nthreads(threads);
+      // don't add FFTW_WISDOM_ONLY if the plan rigor is FFTW_ESTIMATE
+      // because FFTW_ESTIMATE guarantee to not destroy the input
+      unsigned roflags = flags;
+      if( ! (flags & FFTW_ESTIMATE) )
+        {
+        roflags = flags | FFTW_WISDOM_ONLY;
+        }
+      plan = fftw_plan_many_dft_r2c(rank,n,howmany,in,NULL,1,inputDistance,
+                                     out,NULL,1,outputDistance,roflags);
+      if( plan == NULL )
+        {
+        // no wisdom available for that plan - lets create a plan with a fake
+        // input with the same alignment to generate the wisdom
+        char * buffer = (char*)fftw_malloc(sizeof(PixelType)*inputDistance*howmany + inputAlignment);
+        PixelType * din = (PixelType*)(buffer + inputAlignment);
+        fftw_destroy_plan(fftw_plan_many_dft_r2c(rank,n,howmany,din,NULL,1,inputDistance,
+                                                   out,NULL,1,outputDistance,flags));
+        fftw_free(buffer);
+        // and then create the final plan - this time it shouldn't fail
+        plan = fftw_plan_many_dft_r2c(rank,n,howmany,in,NULL,1,inputDistance,
+                                       out,NULL,1,outputDistance,roflags);
+        FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+        }
+      if( usePlanCache && plan != NULL )
+        {
+        FFTWGlobalConfiguration::SetCachedPlanDouble(key, plan);
+        }
+      }
+    FFTWGlobalConfiguration::Unlock();
+    assert( plan != NULL );
+    return plan;
+  }
+
+  /**
+   * Plan howmany complex conjugate to real transforms of size n, the images
+   * being stored one after the other in in and out. The input is destroyed
+   * by the execution of the plan, but not by its creation.
+   * When usePlanCache is true, the plan is taken from or added to the
+   * FFTWGlobalConfiguration plan cache, and must be released with
+   * ReleaseCachedPlan() instead of being destroyed.
+   * The plan can be run with Execute_dft_c2r() on any other buffers
+   * with the same alignment.
+   */
+  static PlanType Plan_many_dft_c2r(int rank,
+                                    const int *n,
+                                    int howmany,
+                                    ComplexType *in,
+                                    PixelType *out,
+                                    unsigned flags,
+                                    int threads=1,
+                                    bool usePlanCache=false)
+  {
+    int inputDistance = 1;
+    int outputDistance = 1;
+    for( int i=0; i<rank; i++ )
+      {
+      inputDistance *= ( i == rank - 1 ) ? n[i] / 2 + 1 : n[i];
+      outputDistance *= n[i];
+      }
+    const int inputAlignment = fftw_alignment_of((PixelType*)in);
+    const std::string key = PlanKey("c2r", rank, n, howmany, flags, threads,
+                                    inputAlignment, fftw_alignment_of(out));
+    FFTWGlobalConfiguration::Lock();
+    PlanType plan = NULL;
+    if( usePlanCache )
+      {
+      plan = FFTWGlobalConfiguration::GetCachedPlanDouble(key);
+      }
+    if( plan == NULL )
+      {
+      fftw_plan_with_nthreads(threads);
+      // don't add FFTW_WISDOM_ONLY if the plan rigor is FFTW_ESTIMATE
+      // because FFTW_ESTIMATE guarantee to not destroy the input
+      unsigned roflags = flags;
+      if( ! (flags & FFTW_ESTIMATE) )
+        {
+        roflags = flags | FFTW_WISDOM_ONLY;
+        }
+      plan = fftw_plan_many_dft_c2r(rank,n,howmany,in,NULL,1,inputDistance,
+                                     out,NULL,1,outputDistance,roflags);
+      if( plan == NULL )
+        {
+        // no wisdom available for that plan - lets create a plan with a fake
+        // input with the same alignment to generate the wisdom
+        char * buffer = (char*)fftw_malloc(sizeof(ComplexType)*inputDistance*howmany + inputAlignment);
+        ComplexType * din = (ComplexType*)(buffer + inputAlignment);
+        fftw_destroy_plan(fftw_plan_many_dft_c2r(rank,n,howmany,din,NULL,1,inputDistance,
+                                                   out,NULL,1,outputDistance,flags));
+        fftw_free(buffer);
+        // and then create the final plan - this time it shouldn't fail
+        plan = fftw_plan_many_dft_c2r(rank,n,howmany,in,NULL,1,inputDistance,
+                                       out,NULL,1,outputDistance,roflags);
+        FFTWGlobalConfiguration::SetNewWisdomAvailable(true);
+        }
+      if( usePlanCache && plan != NULL )
+        {
+        FFTWGlobalConfiguration::SetCachedPlanDouble(key, plan);
+        }
+      }
+    FFTWGlobalConfiguration::Unlock();
+    assert( plan != NULL );
+    return plan;
+  }
+
+  /** Run a plan on other buffers than the ones it was created with. These
+   * methods are thread safe. */
+  static void Execute_dft_r2c(PlanType p, PixelType *in, ComplexType *out)
+  {
+    fftw_execute_dft_r2c(p, in, out);
+  }
+  static void Execute_dft_c2r(PlanType p, ComplexType *in, PixelType *out)
+  {
+    fftw_execute_dft_c2r(p, in, out);
+  }
+
   static void Execute(PlanType p)
   {
     fftw_execute(p);
@@ -654,6 +992,14 @@ public:
   {
     fftw_destroy_plan(p);
   }
+
+  /** Release a plan got from the plan cache, which may then be evicted */
+  static void ReleaseCachedPlan(PlanType p)
+  {
+    FFTWGlobalConfiguration::Lock();
+    FFTWGlobalConfiguration::ReleaseCachedPlanDouble(p);
+    FFTWGlobalConfiguration::Unlock();
+  }
 };
 
 #endif
@@ -33,6 +33,12 @@ namespace itk
  * This filter is multithreaded and supports input images with sizes which are not
  * a power of two.
  *
+ * The plans are kept in the FFTWGlobalConfiguration plan cache, so that
+ * transforming many images of the same size only creates the plan once.
+ * With SetNumberOfTransformedDimensions(), the image is seen as a series of
+ * images of lower dimension which are all transformed by a single batched
+ * FFTW plan.
+ *
  * This implementation was taken from the Insight Journal paper:
  * http://hdl.handle.net/10380/3154
  * or http://insight-journal.com/browse/publication/717
@@ -109,10 +115,19 @@ public:
     this->SetPlanRigor( FFTWGlobalConfiguration::GetPlanRigorValue( name ) );
   }
 
+  /**
+   * Set/Get the number of dimensions transformed. When smaller than the
+   * image dimension, each image along the remaining dimensions is
+   * transformed independently. The default is the image dimension.
+   */
+  itkSetClampMacro( NumberOfTransformedDimensions, unsigned int, 1, ImageDimension );
+  itkGetConstMacro( NumberOfTransformedDimensions, unsigned int );
+
 protected:
   FFTWComplexConjugateToRealImageFilter()
     {
     m_PlanRigor = FFTWGlobalConfiguration::GetPlanRigor();
+    m_NumberOfTransformedDimensions = ImageDimension;
     }
   virtual ~FFTWComplexConjugateToRealImageFilter()
     {
@@ -133,6 +148,7 @@ private:
 
   int m_PlanRigor;
 
+  unsigned int m_NumberOfTransformedDimensions;
 };
 
 
@@ -60,12 +60,10 @@ BeforeThreadedGenerateData()
   // size of input and output aren't the same which is handled in the superclass,
   // sort of.
   // the input size and output size only differ in the fastest moving dimension
-  unsigned int total_outputSize = 1;
   unsigned int total_inputSize = 1;
 
   for ( unsigned i = 0; i < ImageDimension; i++ )
     {
-    total_outputSize *= outputSize[i];
     total_inputSize *= inputSize[i];
     }
 
@@ -86,17 +84,27 @@ BeforeThreadedGenerateData()
   OutputPixelType * out = outputPtr->GetBufferPointer();
   typename FFTWProxyType::PlanType plan;
 
-  int *sizes = new int[ImageDimension];
-  for(unsigned int i = 0; i < ImageDimension; i++)
+  // the transformed dimensions are the fastest moving ones, and the images
+  // along the other dimensions are stored one after the other
+  const unsigned int rank = m_NumberOfTransformedDimensions;
+  int *sizes = new int[rank];
+  for(unsigned int i = 0; i < rank; i++)
+    {
+    sizes[(rank - 1) - i] = outputSize[i];
+    }
+  int howmany = 1;
+  for(unsigned int i = rank; i < ImageDimension; i++)
     {
-    sizes[(ImageDimension - 1) - i] = outputSize[i];
+    howmany *= outputSize[i];
     }
-  plan = FFTWProxyType::Plan_dft_c2r(ImageDimension,sizes,
-                              in,
-                              out,
-                              m_PlanRigor,
-                              this->GetNumberOfThreads(),
-                              !m_CanUseDestructiveAlgorithm);
+
+  const bool usePlanCache = FFTWGlobalConfiguration::GetUsePlanCache();
+  plan = FFTWProxyType::Plan_many_dft_c2r(rank,sizes,howmany,
+                                          in,
+                                          out,
+                                          m_PlanRigor,
+                                          this->GetNumberOfThreads(),
+                                          usePlanCache);
   delete [] sizes;
   if( !m_CanUseDestructiveAlgorithm )
     {
@@ -104,10 +112,17 @@ BeforeThreadedGenerateData()
            inputPtr->GetBufferPointer(),
            total_inputSize * sizeof(typename FFTWProxyType::ComplexType));
     }
-  FFTWProxyType::Execute(plan);
+  FFTWProxyType::Execute_dft_c2r(plan, in, out);
 
   // some cleanup
-  FFTWProxyType::DestroyPlan(plan);
+  if( usePlanCache )
+    {
+    FFTWProxyType::ReleaseCachedPlan(plan);
+    }
+  else
+    {
+    FFTWProxyType::DestroyPlan(plan);
+    }
   if( !m_CanUseDestructiveAlgorithm )
     {
     delete [] in;
@@ -120,7 +135,15 @@ FFTWComplexConjugateToRealImageFilter< TInputImage, TOutputImage >::
 ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId) )
 {
   typedef ImageRegionIterator< OutputImageType >   IteratorType;
-  unsigned long total_outputSize = this->GetOutput()->GetRequestedRegion().GetNumberOfPixels();
+  // FFTW doesn't normalize: divide by the number of pixels of each
+  // transformed image
+  const typename OutputImageType::SizeType & outputSize =
+    this->GetOutput()->GetRequestedRegion().GetSize();
+  unsigned long total_outputSize = 1;
+  for ( unsigned int i = 0; i < m_NumberOfTransformedDimensions; i++ )
+    {
+    total_outputSize *= outputSize[i];
+    }
   IteratorType it(this->GetOutput(), outputRegionForThread);
   while( !it.IsAtEnd() )
     {
@@ -157,6 +180,7 @@ FFTWComplexConjugateToRealImageFilter< TInputImage, TOutputImage >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "PlanRigor: " << FFTWGlobalConfiguration::GetPlanRigorName(m_PlanRigor) << " (" << m_PlanRigor << ")" << std::endl;
+  os << indent << "NumberOfTransformedDimensions: " << m_NumberOfTransformedDimensions << std::endl;
 }
 
 } // namespace itk
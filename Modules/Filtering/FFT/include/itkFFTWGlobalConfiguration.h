@@ -30,6 +30,7 @@
 #include "fftw3.h"
 #include <algorithm>
 #include <cctype>
+#include <map>
 
 //* The fftw utilities help control the various strategies
 //available for controlling optimizations for the FFTW library.
@@ -49,6 +50,13 @@
 //                             file to be generated.  If this is
 //                             set, then ITK_FFTW_WISDOM_CACHE_BASE
 //                             is ignored.
+//ITK_FFTW_USE_PLAN_CACHE    - Defines if the plans should be kept
+//                             and reused by the next transforms
+//                             with the same parameters (it is "On"
+//                             by default)
+//ITK_FFTW_PLAN_CACHE_SIZE   - Defines the maximum number of plans
+//                             kept in the cache for each precision
+//                             (32 by default)
 //
 // The above behaviors can also be controlled by the application.
 //
@@ -406,6 +414,64 @@ public:
   static bool ImportDefaultWisdomFileFloat();
   static bool ExportDefaultWisdomFileFloat();
 
+  /**
+   * \brief Set the behavior of plan caching
+   *
+   * When on, the plans created by the FFTW filters are kept until
+   * ClearPlanCache() is called, they are evicted or the program exits,
+   * and reused by the transforms with the same size, type, flags, number
+   * of threads and buffer alignment, so that transforming many images of
+   * the same size only pays for the planning once.
+   * If the environmental variable "ITK_FFTW_USE_PLAN_CACHE", is set,
+   * then the environmental setting overides default settings.
+   */
+  static void SetUsePlanCache( const bool & v )
+  {
+    GetInstance()->m_UsePlanCache = v;
+  }
+
+  static bool GetUsePlanCache()
+  {
+    return GetInstance()->m_UsePlanCache;
+  }
+
+  /**
+   * \brief Set the maximum number of cached plans
+   *
+   * When the cache holds more plans of a precision than this size, the
+   * least recently used plans are destroyed, except those still used by a
+   * transform. The default size is 32.
+   * If the environmental variable "ITK_FFTW_PLAN_CACHE_SIZE", is set,
+   * then the environmental setting overides default settings.
+   */
+  static void SetPlanCacheSize( const unsigned int & v );
+  static unsigned int GetPlanCacheSize()
+  {
+    return GetInstance()->m_PlanCacheSize;
+  }
+
+  /** Destroy all the cached plans, except those still used by a
+   * transform. */
+  static void ClearPlanCache();
+
+  /** Get a plan from the cache, or NULL if there is no plan for that key.
+   * The plan is used until it is released with ReleaseCachedPlanDouble()
+   * or ReleaseCachedPlanFloat(), and is not destroyed in the meantime.
+   * Lock() must be held by the caller. */
+  static fftw_plan GetCachedPlanDouble( const std::string & key );
+  static fftwf_plan GetCachedPlanFloat( const std::string & key );
+
+  /** Add a plan to the cache. The cache takes the ownership of the plan,
+   * which is used until it is released as the plans got from the cache.
+   * Lock() must be held by the caller. */
+  static void SetCachedPlanDouble( const std::string & key, fftw_plan plan );
+  static void SetCachedPlanFloat( const std::string & key, fftwf_plan plan );
+
+  /** Release a plan got from or added to the cache, which may then be
+   * evicted. Lock() must be held by the caller. */
+  static void ReleaseCachedPlanDouble( fftw_plan plan );
+  static void ReleaseCachedPlanFloat( fftwf_plan plan );
+
 private:
   FFTWGlobalConfiguration(); //This will process env variables
   ~FFTWGlobalConfiguration(); //This will write cache file if requested.
@@ -430,10 +496,33 @@ private:
   int                           m_PlanRigor;
   bool                          m_WriteWisdomCache;
   bool                          m_ReadWisdomCache;
+  bool                          m_UsePlanCache;
+  unsigned int                  m_PlanCacheSize;
   std::string                   m_WisdomCacheBase;
   //m_WriteWisdomCache Controls the behavior of default
   //wisdom file creation policies.
   WisdomFilenameGeneratorBase * m_WisdomFilenameGenerator;
+
+  /** A cached plan, with the number of transforms using it and the time
+   * of its last use. */
+  template< class TPlan >
+  struct CachedPlan
+  {
+    TPlan         m_Plan;
+    unsigned int  m_Users;
+    unsigned long m_LastUse;
+  };
+  typedef std::map< std::string, CachedPlan< fftw_plan > >  PlanCacheDoubleType;
+  typedef std::map< std::string, CachedPlan< fftwf_plan > > PlanCacheFloatType;
+
+  /** Destroy the least recently used plans that are not used, or all the
+   * plans if force is true, until each cache holds at most size plans.
+   * Lock() must be held by the caller. */
+  void TrimPlanCaches( size_t size, bool force = false );
+
+  PlanCacheDoubleType m_PlanCacheDouble;
+  PlanCacheFloatType  m_PlanCacheFloat;
+  unsigned long       m_PlanCacheTime;
 };
 }
 #endif
@@ -37,6 +37,12 @@ namespace itk
  * configuration to support float images, and USE_FFTWD must set to ON to
  * support double images.
  *
+ * The plans are kept in the FFTWGlobalConfiguration plan cache, so that
+ * transforming many images of the same size only creates the plan once.
+ * With SetNumberOfTransformedDimensions(), the image is seen as a series of
+ * images of lower dimension, for example a 2D+t or a stack of tiles, which are
+ * all transformed by a single batched FFTW plan.
+ *
  * This implementation was taken from the Insight Journal paper:
  * http://hdl.handle.net/10380/3154
  * or http://insight-journal.com/browse/publication/717
@@ -101,10 +107,19 @@ public:
   }
   itkGetConstReferenceMacro( PlanRigor, int );
 
+  /**
+   * Set/Get the number of dimensions transformed. When smaller than the
+   * image dimension, each image along the remaining dimensions is
+   * transformed independently. The default is the image dimension.
+   */
+  itkSetClampMacro( NumberOfTransformedDimensions, unsigned int, 1, ImageDimension );
+  itkGetConstMacro( NumberOfTransformedDimensions, unsigned int );
+
 protected:
   FFTWRealToComplexConjugateImageFilter()
     {
     m_PlanRigor = FFTWGlobalConfiguration::GetPlanRigor();
+    m_NumberOfTransformedDimensions = ImageDimension;
     }
   ~FFTWRealToComplexConjugateImageFilter()
     {
@@ -127,6 +142,8 @@ private:
   bool m_CanUseDestructiveAlgorithm;
 
   int m_PlanRigor;
+
+  unsigned int m_NumberOfTransformedDimensions;
 };
 } // namespace itk
 
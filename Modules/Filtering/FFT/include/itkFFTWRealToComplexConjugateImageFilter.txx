@@ -55,21 +55,6 @@ FFTWRealToComplexConjugateImageFilter< TInputImage, TOutputImage >::GenerateData
 
   const typename InputImageType::SizeType &   inputSize =
     inputPtr->GetLargestPossibleRegion().GetSize();
-  const typename OutputImageType::SizeType &   outputSize =
-    outputPtr->GetLargestPossibleRegion().GetSize();
-
-  // figure out sizes
-  // size of input and output aren't the same which is handled in the superclass,
-  // sort of.
-  // the input size and output size only differ in the fastest moving dimension
-  unsigned int total_inputSize = 1;
-  unsigned int total_outputSize = 1;
-
-  for ( unsigned i = 0; i < ImageDimension; i++ )
-    {
-    total_inputSize *= inputSize[i];
-    total_outputSize *= outputSize[i];
-    }
 
   typename FFTWProxyType::PlanType plan;
   InputPixelType * in = const_cast<InputPixelType*>(inputPtr->GetBufferPointer());
@@ -82,20 +67,37 @@ FFTWRealToComplexConjugateImageFilter< TInputImage, TOutputImage >::GenerateData
     // we must be careful to not destroy it.
     flags = flags | FFTW_PRESERVE_INPUT;
     }
-  int *sizes = new int[ImageDimension];
-  for(unsigned int i = 0; i < ImageDimension; i++)
+  // the transformed dimensions are the fastest moving ones, and the images
+  // along the other dimensions are stored one after the other
+  const unsigned int rank = m_NumberOfTransformedDimensions;
+  int *sizes = new int[rank];
+  for(unsigned int i = 0; i < rank; i++)
+    {
+    sizes[(rank - 1) - i] = inputSize[i];
+    }
+  int howmany = 1;
+  for(unsigned int i = rank; i < ImageDimension; i++)
     {
-    sizes[(ImageDimension - 1) - i] = inputSize[i];
+    howmany *= inputSize[i];
     }
 
-  plan = FFTWProxyType::Plan_dft_r2c(ImageDimension,sizes,
-                                    in,
-                                    out,
-                                    flags,
-                                    this->GetNumberOfThreads());
+  const bool usePlanCache = FFTWGlobalConfiguration::GetUsePlanCache();
+  plan = FFTWProxyType::Plan_many_dft_r2c(rank,sizes,howmany,
+                                          in,
+                                          out,
+                                          flags,
+                                          this->GetNumberOfThreads(),
+                                          usePlanCache);
   delete [] sizes;
-  FFTWProxyType::Execute(plan);
-  FFTWProxyType::DestroyPlan(plan);
+  FFTWProxyType::Execute_dft_r2c(plan, in, out);
+  if( usePlanCache )
+    {
+    FFTWProxyType::ReleaseCachedPlan(plan);
+    }
+  else
+    {
+    FFTWProxyType::DestroyPlan(plan);
+    }
 }
 
 template< class TInputImage, class TOutputImage >
@@ -125,6 +127,7 @@ FFTWRealToComplexConjugateImageFilter< TInputImage, TOutputImage >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "PlanRigor: " << FFTWGlobalConfiguration::GetPlanRigorName(m_PlanRigor) << " (" << m_PlanRigor << ")" << std::endl;
+  os << indent << "NumberOfTransformedDimensions: " << m_NumberOfTransformedDimensions << std::endl;
 }
 
 } // namespace itk
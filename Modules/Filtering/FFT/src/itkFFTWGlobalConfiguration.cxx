@@ -18,6 +18,7 @@
 #include "itkFFTWGlobalConfiguration.h"
 #if defined(USE_FFTWF) || defined(USE_FFTWD)
 #include "itksys/SystemTools.hxx"
+#include <cstdlib>
 #ifdef _WIN32
         #include <Windows.h>
         #include <sys/locking.h>
@@ -122,7 +123,10 @@ FFTWGlobalConfiguration
   m_PlanRigor(0),
   m_WriteWisdomCache(false),
   m_ReadWisdomCache(true),
-  m_WisdomCacheBase("")
+  m_UsePlanCache(true),
+  m_PlanCacheSize(32),
+  m_WisdomCacheBase(""),
+  m_PlanCacheTime(0)
 {
     {//Configure default method for creating WISDOM_CACHE files
     std::string manualCacheFilename="";
@@ -223,6 +227,17 @@ FFTWGlobalConfiguration
       this->m_ReadWisdomCache=true;
       }
     }
+    {
+    std::string use_plan_cache_env;
+    const bool envITK_FFTW_USE_PLAN_CACHEfound=
+      itksys::SystemTools::GetEnv("ITK_FFTW_USE_PLAN_CACHE", use_plan_cache_env);
+    this->m_UsePlanCache = !( envITK_FFTW_USE_PLAN_CACHEfound && isDeclineString(use_plan_cache_env) );
+    std::string plan_cache_size_env;
+    if( itksys::SystemTools::GetEnv("ITK_FFTW_PLAN_CACHE_SIZE", plan_cache_size_env) )
+      {
+      this->m_PlanCacheSize = static_cast< unsigned int >( atoi( plan_cache_size_env.c_str() ) );
+      }
+    }
 
   if( this->m_ReadWisdomCache )
     {
@@ -262,6 +277,8 @@ FFTWGlobalConfiguration
       }
 #endif
     }
+  // the plans must be destroyed before the cleanup of FFTW
+  this->TrimPlanCaches( 0, true );
 #if defined(USE_FFTWF)
   fftwf_cleanup_threads();
   fftwf_cleanup();
@@ -449,6 +466,150 @@ FFTWGlobalConfiguration
 }
 
 
+// Destroy the least recently used plans of a cache that are not used by a
+// transform, or all of them if force is true, until the cache holds at most
+// size plans
+template< class TPlanCache, class TPlan >
+static void trimPlanCache(TPlanCache & cache, size_t size, bool force, void (*destroy)(TPlan))
+{
+  while( cache.size() > size )
+    {
+    typename TPlanCache::iterator oldest = cache.end();
+    for( typename TPlanCache::iterator it = cache.begin(); it != cache.end(); ++it )
+      {
+      if( ( force || it->second.m_Users == 0 )
+          && ( oldest == cache.end() || it->second.m_LastUse < oldest->second.m_LastUse ) )
+        {
+        oldest = it;
+        }
+      }
+    if( oldest == cache.end() )
+      {
+      // all the remaining plans are used
+      return;
+      }
+    destroy( oldest->second.m_Plan );
+    cache.erase( oldest );
+    }
+}
+
+template< class TPlanCache, class TPlan >
+static TPlan getCachedPlan(TPlanCache & cache, const std::string & key, unsigned long time)
+{
+  typename TPlanCache::iterator it = cache.find( key );
+  if( it == cache.end() )
+    {
+    return NULL;
+    }
+  ++it->second.m_Users;
+  it->second.m_LastUse = time;
+  return it->second.m_Plan;
+}
+
+template< class TPlanCache, class TPlan >
+static void releaseCachedPlan(TPlanCache & cache, TPlan plan)
+{
+  for( typename TPlanCache::iterator it = cache.begin(); it != cache.end(); ++it )
+    {
+    if( it->second.m_Plan == plan && it->second.m_Users > 0 )
+      {
+      --it->second.m_Users;
+      return;
+      }
+    }
+}
+
+void
+FFTWGlobalConfiguration
+::SetPlanCacheSize( const unsigned int & v )
+{
+  Lock();
+  GetInstance()->m_PlanCacheSize = v;
+  GetInstance()->TrimPlanCaches( v );
+  Unlock();
+}
+
+void
+FFTWGlobalConfiguration
+::ClearPlanCache()
+{
+  Lock();
+  GetInstance()->TrimPlanCaches( 0 );
+  Unlock();
+}
+
+void
+FFTWGlobalConfiguration
+::TrimPlanCaches( size_t size, bool force )
+{
+#if defined(USE_FFTWD)
+  trimPlanCache( m_PlanCacheDouble, size, force, &fftw_destroy_plan );
+#endif
+#if defined(USE_FFTWF)
+  trimPlanCache( m_PlanCacheFloat, size, force, &fftwf_destroy_plan );
+#endif
+}
+
+fftw_plan
+FFTWGlobalConfiguration
+::GetCachedPlanDouble( const std::string & key )
+{
+  Pointer instance = GetInstance();
+  return getCachedPlan< PlanCacheDoubleType, fftw_plan >( instance->m_PlanCacheDouble, key,
+                                                         ++instance->m_PlanCacheTime );
+}
+
+fftwf_plan
+FFTWGlobalConfiguration
+::GetCachedPlanFloat( const std::string & key )
+{
+  Pointer instance = GetInstance();
+  return getCachedPlan< PlanCacheFloatType, fftwf_plan >( instance->m_PlanCacheFloat, key,
+                                                         ++instance->m_PlanCacheTime );
+}
+
+void
+FFTWGlobalConfiguration
+::SetCachedPlanDouble( const std::string & key, fftw_plan plan )
+{
+  Pointer instance = GetInstance();
+  CachedPlan< fftw_plan > & cached = instance->m_PlanCacheDouble[key];
+  cached.m_Plan = plan;
+  cached.m_Users = 1;
+  cached.m_LastUse = ++instance->m_PlanCacheTime;
+  instance->TrimPlanCaches( instance->m_PlanCacheSize );
+}
+
+void
+FFTWGlobalConfiguration
+::SetCachedPlanFloat( const std::string & key, fftwf_plan plan )
+{
+  Pointer instance = GetInstance();
+  CachedPlan< fftwf_plan > & cached = instance->m_PlanCacheFloat[key];
+  cached.m_Plan = plan;
+  cached.m_Users = 1;
+  cached.m_LastUse = ++instance->m_PlanCacheTime;
+  instance->TrimPlanCaches( instance->m_PlanCacheSize );
+}
+
+void
+FFTWGlobalConfiguration
+::ReleaseCachedPlanDouble( fftw_plan plan )
+{
+  Pointer instance = GetInstance();
+  releaseCachedPlan( instance->m_PlanCacheDouble, plan );
+  instance->TrimPlanCaches( instance->m_PlanCacheSize );
+}
+
+void
+FFTWGlobalConfiguration
+::ReleaseCachedPlanFloat( fftwf_plan plan )
+{
+  Pointer instance = GetInstance();
+  releaseCachedPlan( instance->m_PlanCacheFloat, plan );
+  instance->TrimPlanCaches( instance->m_PlanCacheSize );
+}
+
 void
 FFTWGlobalConfiguration
 ::Lock()
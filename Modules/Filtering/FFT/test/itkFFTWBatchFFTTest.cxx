@@ -0,0 +1,139 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTWRealToComplexConjugateImageFilter.h"
+#include "itkFFTWComplexConjugateToRealImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "vnl/vnl_sample.h"
+
+// Transform a series of 2D images stored as a 3D image with a single batched
+// plan, and compare each transformed slice with the transform of the slice
+// alone, with and without the plan cache. The inverse batched transform must
+// give back the input.
+
+#if defined(USE_FFTWD)
+int itkFFTWBatchFFTTest(int, char *[])
+{
+  typedef itk::Image< double, 3 >                           SeriesType;
+  typedef itk::Image< double, 2 >                           SliceType;
+  typedef itk::Image< std::complex< double >, 3 >           ComplexSeriesType;
+  typedef itk::Image< std::complex< double >, 2 >           ComplexSliceType;
+  typedef itk::FFTWRealToComplexConjugateImageFilter< SeriesType > SeriesFFTType;
+  typedef itk::FFTWRealToComplexConjugateImageFilter< SliceType >  SliceFFTType;
+  typedef itk::FFTWComplexConjugateToRealImageFilter< ComplexSeriesType, SeriesType >
+                                                                   SeriesIFFTType;
+
+  SeriesType::SizeType size;
+  size[0] = 7;
+  size[1] = 6;
+  size[2] = 5;
+  SeriesType::Pointer series = SeriesType::New();
+  series->SetRegions(size);
+  series->Allocate();
+  itk::ImageRegionIteratorWithIndex< SeriesType > it( series, series->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( vnl_sample_uniform(-10.0, 10.0) );
+    }
+
+  bool pass = true;
+
+  // the last pass keeps a single plan of each precision in the cache, so
+  // the plans are evicted
+  for ( unsigned int usePlanCache = 0; usePlanCache < 3; usePlanCache++ )
+    {
+    itk::FFTWGlobalConfiguration::SetUsePlanCache(usePlanCache != 0);
+    itk::FFTWGlobalConfiguration::SetPlanCacheSize(usePlanCache == 2 ? 1 : 32);
+
+    SeriesFFTType::Pointer fft = SeriesFFTType::New();
+    fft->SetInput(series);
+    fft->SetNumberOfTransformedDimensions(2);
+    fft->Update();
+    ComplexSeriesType * spectra = fft->GetOutput();
+
+    for ( unsigned int t = 0; t < size[2]; t++ )
+      {
+      SliceType::SizeType sliceSize;
+      sliceSize[0] = size[0];
+      sliceSize[1] = size[1];
+      SliceType::Pointer slice = SliceType::New();
+      slice->SetRegions(sliceSize);
+      slice->Allocate();
+      itk::ImageRegionIteratorWithIndex< SliceType > sit( slice, slice->GetBufferedRegion() );
+      for (; !sit.IsAtEnd(); ++sit )
+        {
+        SeriesType::IndexType index;
+        index[0] = sit.GetIndex()[0];
+        index[1] = sit.GetIndex()[1];
+        index[2] = t;
+        sit.Set( series->GetPixel(index) );
+        }
+
+      SliceFFTType::Pointer sliceFFT = SliceFFTType::New();
+      sliceFFT->SetInput(slice);
+      sliceFFT->Update();
+
+      itk::ImageRegionIteratorWithIndex< ComplexSliceType > cit( sliceFFT->GetOutput(),
+                                                                  sliceFFT->GetOutput()->GetBufferedRegion() );
+      for (; !cit.IsAtEnd(); ++cit )
+        {
+        ComplexSeriesType::IndexType index;
+        index[0] = cit.GetIndex()[0];
+        index[1] = cit.GetIndex()[1];
+        index[2] = t;
+        if ( std::abs( cit.Get() - spectra->GetPixel(index) ) > 1e-9 * ( 1.0 + std::abs( cit.Get() ) ) )
+          {
+          std::cerr << "Batched transform differs at " << index << ": " << spectra->GetPixel(index)
+                    << " instead of " << cit.Get() << " (plan cache " << usePlanCache << ")" << std::endl;
+          pass = false;
+          break;
+          }
+        }
+      }
+
+    SeriesIFFTType::Pointer ifft = SeriesIFFTType::New();
+    ifft->SetInput(spectra);
+    ifft->SetActualXDimensionIsOdd(true);
+    ifft->SetNumberOfTransformedDimensions(2);
+    ifft->Update();
+
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      if ( vnl_math_abs( it.Get() - ifft->GetOutput()->GetPixel( it.GetIndex() ) ) > 1e-9 )
+        {
+        std::cerr << "Inverse batched transform differs at " << it.GetIndex() << ": "
+                  << ifft->GetOutput()->GetPixel( it.GetIndex() ) << " instead of " << it.Get()
+                  << " (plan cache " << usePlanCache << ")" << std::endl;
+        pass = false;
+        break;
+        }
+      }
+    }
+
+  itk::FFTWGlobalConfiguration::ClearPlanCache();
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
@@ -25,6 +25,7 @@
 #include "itkDerivativeOperator.h"
 #include "itkSparseFieldLayer.h"
 #include "itkObjectStore.h"
+#include <vector>
 
 namespace itk
 {
@@ -52,6 +53,10 @@ public:
  *      (multiplied with zero-crossings) of the smoothed image to find and
  *      link edges.
  *
+ * Steps (2) and (3) are computed in a single multithreaded pass which keeps
+ * only a few slices of the second derivative for each thread, and the edges
+ * are linked in parallel, each thread following them in its own region.
+ *
  * \par Inputs and Outputs
  * The input to this filter should be a scalar, real-valued Itk image of
  * arbitrary dimension.  The output should also be a scalar, real-value Itk
@@ -196,7 +201,7 @@ public:
 
   OutputImageType * GetNonMaximumSuppressionImage()
   {
-    return this->m_MultiplyImageFilter->GetOutput();
+    return this->m_UpdateBuffer1;
   }
 
   /** CannyEdgeDetectionImageFilter needs a larger input requested
@@ -243,70 +248,65 @@ private:
     CannyEdgeDetectionImageFilter *Filter;
   };
 
-  /** This allocate storage for m_UpdateBuffer, m_UpdateBuffer1 */
-  void AllocateUpdateBuffer();
+  typedef typename OutputImageType::OffsetValueType OffsetValueType;
+  typedef typename IndexType::IndexValueType        IndexValueType;
+  typedef DerivativeOperator< OutputImagePixelType,
+                              itkGetStaticConstMacro(ImageDimension) > DerivativeOperatorType;
 
-  /** Implement hysteresis thresholding */
-  void HysteresisThresholding();
+  /** This allocate storage for m_UpdateBuffer1 */
+  void AllocateUpdateBuffer();
 
-  /** Edge linking funciton */
-  void FollowEdge(IndexType index);
-
-  /** Calculate the second derivative of the smoothed image, it writes the
-   *  result to m_UpdateBuffer using the ThreadedCompute2ndDerivative() method
-   *  and multithreading mechanism.   */
-  void Compute2ndDerivative();
-
-  /**
-   * Split the input into "num" pieces, returning region "i" as
-   * "splitRegion". This method is called "num" times to return non-overlapping
-   * regions. The method returns the number of pieces that the input
-   * can be split into by the routine. i.e. return value is less than or equal
-   * to "num".
-   * \sa ImageSource
-   */
-  //  virtual
-  //  int SplitUpdateContainer(int i, int num, ThreadRegionType& splitRegion);
+  /** Compute the non-maximum suppression image, the gradient magnitude at
+   * the zero-crossings of the second directional derivative, into
+   * m_UpdateBuffer1 using the ThreadedComputeNonMaximumSuppression() method
+   * and multithreading mechanism. */
+  void ComputeNonMaximumSuppression();
 
-  /** Does the actual work of calculating of the 2nd derivative over a region
-   *  supplied by the multithreading mechanism.
+  /** Does the actual work of computing the non-maximum suppression image
+   * over a region supplied by the multithreading mechanism. The second
+   * derivative, its zero-crossings and its gradient are computed in a single
+   * pass, slice by slice, keeping only three slices of the second derivative.
    *
-   *  \sa Compute2ndDerivative
-   *  \sa Compute2ndDerivativeThreaderCallBack   */
-  void ThreadedCompute2ndDerivative(const OutputImageRegionType &
-                                    outputRegionForThread, ThreadIdType threadId);
+   * \sa ComputeNonMaximumSuppression
+   * \sa ComputeNonMaximumSuppressionThreaderCallback */
+  void ThreadedComputeNonMaximumSuppression(const OutputImageRegionType &
+                                            outputRegionForThread, ThreadIdType threadId);
 
   /** This callback method uses ImageSource::SplitRequestedRegion to acquire an
-   * output region that it passes to ThreadedCompute2ndDerivative for
+   * output region that it passes to ThreadedComputeNonMaximumSuppression for
    * processing.  */
   static ITK_THREAD_RETURN_TYPE
-  Compute2ndDerivativeThreaderCallback(void *arg);
-
-  /** This methos is used to calculate the 2nd derivative for
-   * non-boundary pixels. It is called by the ThreadedCompute2ndDerivative
-   * method. */
-  OutputImagePixelType ComputeCannyEdge(const NeighborhoodType & it,
-                                        void *globalData);
+  ComputeNonMaximumSuppressionThreaderCallback(void *arg);
+
+  /** Copy the neighborhood of radius one of index in the smoothed image,
+   * using a zero flux Neumann boundary condition. */
+  void GetSmoothedNeighborhood(const IndexType & index,
+                               OutputImagePixelType *neighborhood) const;
+
+  /** Compute the second directional derivative from a neighborhood of the
+   * smoothed image. */
+  OutputImagePixelType ComputeCannyEdge(const OutputImagePixelType *neighborhood) const;
+
+  /** Apply a derivative operator to three consecutive pixels. */
+  OutputImagePixelType ApplyDerivative(const DerivativeOperatorType & op,
+                                       const OutputImagePixelType & previous,
+                                       const OutputImagePixelType & current,
+                                       const OutputImagePixelType & next) const;
+
+  /** Implement hysteresis thresholding: follow the edges from the pixels
+   * above the upper threshold through the pixels above the lower threshold.
+   * Each thread follows the edges in its own region and hands the pixels
+   * reached in the regions of the other threads over to them, until no edge
+   * crosses a region boundary anymore. */
+  void HysteresisThresholding();
 
-  /** Calculate the gradient of the second derivative of the smoothed image,
-   *  it writes the result to m_UpdateBuffer1 using the
-   *  ThreadedCompute2ndDerivativePos() method and multithreading mechanism.
-   */
-  void Compute2ndDerivativePos();
+  /** Follow the edges in the region of a thread. At the first iteration,
+   * the edges start from the pixels above the upper threshold, then from
+   * the pixels handed over by the other threads. */
+  void ThreadedHysteresisThresholding(ThreadIdType threadId);
 
-  /** Does the actual work of calculating of the 2nd derivative over a region
-   *  supplied by the multithreading mechanism.
-   *
-   *  \sa Compute2ndDerivativePos
-   *  \sa Compute3ndDerivativePosThreaderCallBack   */
-  void ThreadedCompute2ndDerivativePos(const OutputImageRegionType &
-                                       outputRegionForThread, ThreadIdType threadId);
-
-  /**This callback method uses ImageSource::SplitRequestedRegion to acquire an
-   * output region that it passes to ThreadedCompute2ndDerivative for
-   * processing.   */
   static ITK_THREAD_RETURN_TYPE
-  Compute2ndDerivativePosThreaderCallback(void *arg);
+  HysteresisThresholdingThreaderCallback(void *arg);
 
   /** The variance of the Gaussian Filter used in this filter */
   ArrayType m_Variance;
@@ -327,30 +327,30 @@ private:
   /** "Background" value for use in thresholding. */
   OutputImagePixelType m_OutsideValue;
 
-  /** Update buffers used during calculation of multiple steps */
+  /** Update buffer holding the non-maximum suppression image */
   typename OutputImageType::Pointer m_UpdateBuffer1;
 
   /** Gaussian filter to smooth the input image  */
   typename GaussianImageFilterType::Pointer m_GaussianFilter;
 
-  /** Multiply image filter to multiply with the zero crossings of the second
-   *  derivative.  */
-  typename MultiplyImageFilterType::Pointer m_MultiplyImageFilter;
-
   /** Function objects that are used in the inner loops of derivatiVex
       calculations. */
-  DerivativeOperator< OutputImagePixelType, itkGetStaticConstMacro(ImageDimension) >
-  m_ComputeCannyEdge1stDerivativeOper;
-  DerivativeOperator< OutputImagePixelType, itkGetStaticConstMacro(ImageDimension) >
-  m_ComputeCannyEdge2ndDerivativeOper;
-
-  std::slice m_ComputeCannyEdgeSlice[ImageDimension];
+  DerivativeOperatorType m_ComputeCannyEdge1stDerivativeOper;
+  DerivativeOperatorType m_ComputeCannyEdge2ndDerivativeOper;
 
   SizeValueType m_Stride[ImageDimension];
   SizeValueType m_Center;
 
-  typename ListNodeStorageType::Pointer m_NodeStore;
-  ListPointerType m_NodeList;
+  /** Offsets of the neighbors in the smoothed image buffer. */
+  std::vector< OffsetValueType > m_NeighborOffsets;
+
+  /** The regions of the threads for the hysteresis thresholding, the
+   * edge pixels, as offsets in the output buffer, handed over to each
+   * thread, and the ones reached by each thread in the other regions. */
+  std::vector< OutputImageRegionType >          m_ThreadRegions;
+  std::vector< std::vector< OffsetValueType > > m_PendingEdges;
+  std::vector< std::vector< OffsetValueType > > m_CrossingEdges;
+  bool                                          m_FindEdgeSeeds;
 };
 } //end of namespace itk
 
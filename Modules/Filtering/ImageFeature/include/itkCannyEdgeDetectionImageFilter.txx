@@ -19,11 +19,10 @@
 #define __itkCannyEdgeDetectionImageFilter_txx
 #include "itkCannyEdgeDetectionImageFilter.h"
 
-#include "itkZeroCrossingImageFilter.h"
-#include "itkNeighborhoodInnerProduct.h"
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
-#include "itkGradientMagnitudeImageFilter.h"
+#include "itkPipelineProfiler.h"
+#include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
 
 namespace itk
@@ -41,8 +40,7 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >::CannyEdgeDetectionIm
   m_UpperThreshold = NumericTraits< OutputImagePixelType >::Zero;
   m_LowerThreshold = NumericTraits< OutputImagePixelType >::Zero;
 
-  m_GaussianFilter      = GaussianImageFilterType::New();
-  m_MultiplyImageFilter = MultiplyImageFilterType::New();
+  m_GaussianFilter = GaussianImageFilterType::New();
   m_UpdateBuffer1  = OutputImageType::New();
 
   // Set up neighborhood slices for all the dimensions.
@@ -61,12 +59,6 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >::CannyEdgeDetectionIm
     m_Stride[i] = it.GetStride(i);
     }
 
-  for ( i = 0; i < ImageDimension; ++i )
-    {
-    m_ComputeCannyEdgeSlice[i] =
-      std::slice(m_Center - m_Stride[i], 3, m_Stride[i]);
-    }
-
   // Allocate the derivative operator.
   m_ComputeCannyEdge1stDerivativeOper.SetDirection(0);
   m_ComputeCannyEdge1stDerivativeOper.SetOrder(1);
@@ -76,9 +68,7 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >::CannyEdgeDetectionIm
   m_ComputeCannyEdge2ndDerivativeOper.SetOrder(2);
   m_ComputeCannyEdge2ndDerivativeOper.CreateDirectional();
 
-  //Initialize the list
-  m_NodeStore = ListNodeStorageType::New();
-  m_NodeList = ListType::New();
+  m_FindEdgeSeeds = false;
 }
 
 template< class TInputImage, class TOutputImage >
@@ -86,13 +76,13 @@ void
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
 ::AllocateUpdateBuffer()
 {
-  // The update buffer looks just like the input.
+  // The update buffer looks just like the output.
 
-  typename TInputImage::ConstPointer input = this->GetInput();
+  typename TOutputImage::Pointer output = this->GetOutput();
 
-  m_UpdateBuffer1->CopyInformation(input);
-  m_UpdateBuffer1->SetRequestedRegion( input->GetRequestedRegion() );
-  m_UpdateBuffer1->SetBufferedRegion( input->GetBufferedRegion() );
+  m_UpdateBuffer1->CopyInformation(output);
+  m_UpdateBuffer1->SetRequestedRegion( output->GetRequestedRegion() );
+  m_UpdateBuffer1->SetBufferedRegion( output->GetRequestedRegion() );
   m_UpdateBuffer1->Allocate();
 }
 
@@ -156,52 +146,47 @@ throw( InvalidRequestedRegionError )
 template< class TInputImage, class TOutputImage >
 void
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::ThreadedCompute2ndDerivative(const OutputImageRegionType &
-                               outputRegionForThread, ThreadIdType threadId)
+::GetSmoothedNeighborhood(const IndexType & index,
+                          OutputImagePixelType *neighborhood) const
 {
-  ZeroFluxNeumannBoundaryCondition< TInputImage > nbc;
-
-  ImageRegionIterator< TOutputImage > it;
-
-  void *globalData = 0;
-
-  // Here input is the result from the gaussian filter
-  //      output is the update buffer.
-  typename  OutputImageType::Pointer input  = m_GaussianFilter->GetOutput();
-  typename  OutputImageType::Pointer output = this->GetOutput();
-
-  // set iterator radius
-  Size< ImageDimension > radius; radius.Fill(1);
-
-  // Find the data-set boundary "faces"
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< TInputImage >::
-  FaceListType faceList;
-  NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< TInputImage > bC;
-  faceList = bC(input, outputRegionForThread, radius);
-
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< TInputImage >::
-  FaceListType::iterator fit;
-
-  // support progress methods/callbacks
-  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels(), 100, 0.0f, 0.5f);
-
-  // Process the non-boundady region and then each of the boundary faces.
-  // These are N-d regions which border the edge of the buffer.
-  for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
+  const OutputImageType *      smoothed = m_GaussianFilter->GetOutput();
+  const OutputImagePixelType * buffer = smoothed->GetBufferPointer();
+  const OffsetValueType *      offsetTable = smoothed->GetOffsetTable();
+  const IndexType              start = smoothed->GetBufferedRegion().GetIndex();
+  const typename OutputImageRegionType::SizeType size = smoothed->GetBufferedRegion().GetSize();
+
+  OffsetValueType center = 0;
+  bool            inside = true;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    NeighborhoodType bit(radius, input, *fit);
+    center += ( index[i] - start[i] ) * offsetTable[i];
+    inside = inside && index[i] > start[i]
+             && index[i] < start[i] + static_cast< IndexValueType >( size[i] ) - 1;
+    }
 
-    it = ImageRegionIterator< OutputImageType >(output, *fit);
-    bit.OverrideBoundaryCondition(&nbc);
-    bit.GoToBegin();
+  const unsigned int neighborhoodSize = 2 * m_Center + 1;
+  if ( inside )
+    {
+    for ( unsigned int n = 0; n < neighborhoodSize; n++ )
+      {
+      neighborhood[n] = buffer[center + m_NeighborOffsets[n]];
+      }
+    return;
+    }
 
-    while ( !bit.IsAtEnd() )
+  // zero flux Neumann boundary condition: take the closest pixel in the
+  // buffer
+  for ( unsigned int n = 0; n < neighborhoodSize; n++ )
+    {
+    OffsetValueType offset = 0;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
       {
-      it.Value() = ComputeCannyEdge(bit, globalData);
-      ++bit;
-      ++it;
-      progress.CompletedPixel();
+      IndexValueType neighbor = index[i] + static_cast< IndexValueType >( ( n / m_Stride[i] ) % 3 ) - 1;
+      neighbor = vnl_math_max( neighbor, start[i] );
+      neighbor = vnl_math_min( neighbor, start[i] + static_cast< IndexValueType >( size[i] ) - 1 );
+      offset += ( neighbor - start[i] ) * offsetTable[i];
       }
+    neighborhood[n] = buffer[offset];
     }
 }
 
@@ -209,12 +194,28 @@ template< class TInputImage, class TOutputImage >
 typename CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
 ::OutputImagePixelType
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::ComputeCannyEdge( const NeighborhoodType & it,
-                    void *itkNotUsed(globalData) )
+::ApplyDerivative(const DerivativeOperatorType & op,
+                  const OutputImagePixelType & previous,
+                  const OutputImagePixelType & current,
+                  const OutputImagePixelType & next) const
 {
-  unsigned int i, j;
+  // same computation as NeighborhoodInnerProduct
+  typedef typename NumericTraits< OutputImagePixelType >::RealType RealType;
+
+  RealType sum = NumericTraits< RealType >::Zero;
+  sum += static_cast< RealType >( op[0] * static_cast< RealType >( previous ) );
+  sum += static_cast< RealType >( op[1] * static_cast< RealType >( current ) );
+  sum += static_cast< RealType >( op[2] * static_cast< RealType >( next ) );
+  return static_cast< OutputImagePixelType >( sum );
+}
 
-  NeighborhoodInnerProduct< OutputImageType > innerProduct;
+template< class TInputImage, class TOutputImage >
+typename CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
+::OutputImagePixelType
+CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
+::ComputeCannyEdge(const OutputImagePixelType *it) const
+{
+  unsigned int i, j;
 
   OutputImagePixelType dx[ImageDimension];
   OutputImagePixelType dxx[ImageDimension];
@@ -227,10 +228,10 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
   //Calculate 1st & 2nd order derivative
   for ( i = 0; i < ImageDimension; i++ )
     {
-    dx[i] = innerProduct(m_ComputeCannyEdgeSlice[i], it,
-                         m_ComputeCannyEdge1stDerivativeOper);
-    dxx[i] = innerProduct(m_ComputeCannyEdgeSlice[i], it,
-                          m_ComputeCannyEdge2ndDerivativeOper);
+    dx[i] = ApplyDerivative(m_ComputeCannyEdge1stDerivativeOper, it[m_Center - m_Stride[i]],
+                            it[m_Center], it[m_Center + m_Stride[i]]);
+    dxx[i] = ApplyDerivative(m_ComputeCannyEdge2ndDerivativeOper, it[m_Center - m_Stride[i]],
+                             it[m_Center], it[m_Center + m_Stride[i]]);
     }
 
   deriv = NumericTraits< OutputImagePixelType >::Zero;
@@ -241,10 +242,10 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
     {
     for ( j = i + 1; j < ImageDimension; j++ )
       {
-      dxy[k] = 0.25 * it.GetPixel(m_Center - m_Stride[i] - m_Stride[j])
-               - 0.25 * it.GetPixel(m_Center - m_Stride[i] + m_Stride[j])
-               - 0.25 * it.GetPixel(m_Center + m_Stride[i] - m_Stride[j])
-               + 0.25 * it.GetPixel(m_Center + m_Stride[i] + m_Stride[j]);
+      dxy[k] = 0.25 * it[m_Center - m_Stride[i] - m_Stride[j]]
+               - 0.25 * it[m_Center - m_Stride[i] + m_Stride[j]]
+               - 0.25 * it[m_Center + m_Stride[i] - m_Stride[j]]
+               + 0.25 * it[m_Center + m_Stride[i] + m_Stride[j]];
 
       deriv += 2.0 * dx[i] * dx[j] * dxy[k];
       k++;
@@ -263,18 +264,183 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
   return deriv;
 }
 
-// Calculate the second derivative
 template< class TInputImage, class TOutputImage >
 void
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::Compute2ndDerivative()
+::ThreadedComputeNonMaximumSuppression(const OutputImageRegionType &
+                                       outputRegionForThread, ThreadIdType threadId)
+{
+  const OutputImageRegionType region = m_UpdateBuffer1->GetBufferedRegion();
+  const unsigned int          last = ImageDimension - 1;
+
+  // The second derivative is needed one pixel around the region of the
+  // thread. It is computed one slice at a time along the last dimension and
+  // only three slices are kept.
+  OutputImageRegionType derivativeRegion = outputRegionForThread;
+  derivativeRegion.PadByRadius(1);
+  derivativeRegion.Crop(region);
+
+  OffsetValueType sliceStride[ImageDimension];
+  OffsetValueType sliceSize = 1;
+  for ( unsigned int i = 0; i < last; i++ )
+    {
+    sliceStride[i] = sliceSize;
+    sliceSize *= derivativeRegion.GetSize(i);
+    }
+  std::vector< OutputImagePixelType > derivatives(3 * sliceSize);
+
+  const IndexValueType firstSlice = derivativeRegion.GetIndex(last);
+  const IndexValueType lastSlice = firstSlice + static_cast< IndexValueType >( derivativeRegion.GetSize(last) ) - 1;
+  IndexValueType       computedSlice = firstSlice - 1;
+
+  std::vector< OutputImagePixelType > neighborhood(2 * m_Center + 1);
+
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  const OutputImagePixelType zero = NumericTraits< OutputImagePixelType >::Zero;
+  const OutputImagePixelType foreground = NumericTraits< OutputImagePixelType >::One;
+
+  OutputImagePixelType dx[ImageDimension];
+  OutputImagePixelType dx1[ImageDimension];
+  OutputImagePixelType directional[ImageDimension];
+  OutputImagePixelType derivPos;
+  OutputImagePixelType gradMag;
+  OutputImagePixelType neighbors[2 * ImageDimension];
+
+  const IndexValueType firstOutputSlice = outputRegionForThread.GetIndex(last);
+  const IndexValueType lastOutputSlice = firstOutputSlice
+                                         + static_cast< IndexValueType >( outputRegionForThread.GetSize(last) ) - 1;
+  for ( IndexValueType z = firstOutputSlice; z <= lastOutputSlice; z++ )
+    {
+    // compute the second derivative up to the next slice
+    const IndexValueType nextSlice = vnl_math_min(z + 1, lastSlice);
+    while ( computedSlice < nextSlice )
+      {
+      computedSlice++;
+      OutputImagePixelType *slice = &derivatives[( ( computedSlice - firstSlice ) % 3 ) * sliceSize];
+
+      OutputImageRegionType sliceRegion = derivativeRegion;
+      sliceRegion.SetIndex(last, computedSlice);
+      sliceRegion.SetSize(last, 1);
+      ImageRegionConstIteratorWithIndex< OutputImageType > sit(m_UpdateBuffer1, sliceRegion);
+      for (; !sit.IsAtEnd(); ++sit, ++slice )
+        {
+        this->GetSmoothedNeighborhood(sit.GetIndex(), &neighborhood[0]);
+        *slice = this->ComputeCannyEdge(&neighborhood[0]);
+        }
+      }
+
+    // the slices of the second derivative around z, with a zero flux
+    // Neumann boundary condition
+    const OutputImagePixelType *previous = &derivatives[( ( vnl_math_max(z - 1, firstSlice) - firstSlice ) % 3 ) * sliceSize];
+    const OutputImagePixelType *current = &derivatives[( ( z - firstSlice ) % 3 ) * sliceSize];
+    const OutputImagePixelType *next = &derivatives[( ( nextSlice - firstSlice ) % 3 ) * sliceSize];
+
+    OutputImageRegionType outputSliceRegion = outputRegionForThread;
+    outputSliceRegion.SetIndex(last, z);
+    outputSliceRegion.SetSize(last, 1);
+    ImageRegionIteratorWithIndex< OutputImageType > it(m_UpdateBuffer1, outputSliceRegion);
+    for (; !it.IsAtEnd(); ++it )
+      {
+      const IndexType index = it.GetIndex();
+      OffsetValueType offset = 0;
+      for ( unsigned int i = 0; i < last; i++ )
+        {
+        offset += ( index[i] - derivativeRegion.GetIndex(i) ) * sliceStride[i];
+        }
+
+      // the second derivative of the neighbors along each dimension
+      const OutputImagePixelType thisOne = current[offset];
+      for ( unsigned int i = 0; i < last; i++ )
+        {
+        const bool hasPrevious = index[i] > region.GetIndex(i);
+        const bool hasNext = index[i] < region.GetIndex(i) + static_cast< IndexValueType >( region.GetSize(i) ) - 1;
+        neighbors[i] = hasPrevious ? current[offset - sliceStride[i]] : thisOne;
+        neighbors[i + ImageDimension] = hasNext ? current[offset + sliceStride[i]] : thisOne;
+        }
+      neighbors[last] = previous[offset];
+      neighbors[last + ImageDimension] = next[offset];
+
+      // gradient of the smoothed image and of the second derivative
+      this->GetSmoothedNeighborhood(index, &neighborhood[0]);
+      gradMag = 0.0001;
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        dx[i] = ApplyDerivative(m_ComputeCannyEdge1stDerivativeOper, neighborhood[m_Center - m_Stride[i]],
+                                neighborhood[m_Center], neighborhood[m_Center + m_Stride[i]]);
+        gradMag += dx[i] * dx[i];
+
+        dx1[i] = ApplyDerivative(m_ComputeCannyEdge1stDerivativeOper, neighbors[i],
+                                 thisOne, neighbors[i + ImageDimension]);
+        }
+
+      gradMag = vcl_sqrt( (double)gradMag );
+      derivPos = zero;
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        //First calculate the directional derivative
+
+        directional[i] = dx[i] / gradMag;
+
+        //calculate gradient of 2nd derivative
+
+        derivPos += dx1[i] * directional[i];
+        }
+
+      // zero crossings of the second derivative, as found by
+      // ZeroCrossingImageFilter
+      OutputImagePixelType zeroCrossing = zero;
+      for ( unsigned int i = 0; i < ImageDimension * 2; i++ )
+        {
+        const OutputImagePixelType that = neighbors[i];
+        if ( ( ( thisOne < zero ) && ( that > zero ) )
+             || ( ( thisOne > zero ) && ( that < zero ) )
+             || ( ( thisOne == zero ) && ( that != zero ) )
+             || ( ( thisOne != zero ) && ( that == zero ) ) )
+          {
+          const OutputImagePixelType absThisOne = vnl_math_abs(thisOne);
+          const OutputImagePixelType absThat = vnl_math_abs(that);
+          if ( absThisOne < absThat || ( absThisOne == absThat && i >= ImageDimension ) )
+            {
+            zeroCrossing = foreground;
+            break;
+            }
+          }
+        }
+
+      OutputImagePixelType value = ( ( derivPos <= zero ) );
+      value = value * gradMag;
+      it.Set(value * zeroCrossing);
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
+::ComputeNonMaximumSuppression()
 {
+  // offsets of the neighbors in the smoothed image
+  const OffsetValueType *offsetTable = m_GaussianFilter->GetOutput()->GetOffsetTable();
+
+  m_NeighborOffsets.resize(2 * m_Center + 1);
+  for ( unsigned int n = 0; n < m_NeighborOffsets.size(); n++ )
+    {
+    m_NeighborOffsets[n] = 0;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      m_NeighborOffsets[n] += ( static_cast< OffsetValueType >( ( n / m_Stride[i] ) % 3 ) - 1 ) * offsetTable[i];
+      }
+    }
+
   CannyThreadStruct str;
 
   str.Filter = this;
 
   this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
-  this->GetMultiThreader()->SetSingleMethod(this->Compute2ndDerivativeThreaderCallback, &str);
+  this->GetMultiThreader()->SetSingleMethod(this->ComputeNonMaximumSuppressionThreaderCallback, &str);
 
   this->GetMultiThreader()->SingleMethodExecute();
 }
@@ -282,7 +448,7 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
 template< class TInputImage, class TOutputImage >
 ITK_THREAD_RETURN_TYPE
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::Compute2ndDerivativeThreaderCallback(void *arg)
+::ComputeNonMaximumSuppressionThreaderCallback(void *arg)
 {
   CannyThreadStruct *str;
 
@@ -302,7 +468,17 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
 
   if ( threadId < total )
     {
-    str->Filter->ThreadedCompute2ndDerivative(splitRegion, threadId);
+    if ( PipelineProfiler::GetEnabled() )
+      {
+      const double start = PipelineProfiler::GetTime();
+      str->Filter->ThreadedComputeNonMaximumSuppression(splitRegion, threadId);
+      PipelineProfiler::AddThreadRecord(str->Filter, threadId, start, PipelineProfiler::GetTime() - start,
+                                        splitRegion.GetNumberOfPixels());
+      }
+    else
+      {
+      str->Filter->ThreadedComputeNonMaximumSuppression(splitRegion, threadId);
+      }
     }
 
   return ITK_THREAD_RETURN_VALUE;
@@ -313,21 +489,8 @@ void
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
-  // Allocate the output
-  this->GetOutput()->SetBufferedRegion( this->GetOutput()->GetRequestedRegion() );
-  this->GetOutput()->Allocate();
-
   typename  InputImageType::ConstPointer input  = this->GetInput();
 
-  typename ZeroCrossingImageFilter< TOutputImage, TOutputImage >::Pointer
-  zeroCrossFilter = ZeroCrossingImageFilter< TOutputImage, TOutputImage >::New();
-
-  typename GradientMagnitudeImageFilter< TOutputImage, TOutputImage >::Pointer
-  gradMag = GradientMagnitudeImageFilter< TOutputImage, TOutputImage >::New();
-
-  typename MultiplyImageFilter< TOutputImage, TOutputImage, TOutputImage >::Pointer multFilter =
-    MultiplyImageFilter< TOutputImage, TOutputImage, TOutputImage >::New();
-
   this->AllocateUpdateBuffer();
 
   // 1.Apply the Gaussian Filter to the input image.-------
@@ -338,33 +501,20 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
   m_GaussianFilter->Modified();
   m_GaussianFilter->Update();
 
-  //2. Calculate 2nd order directional derivative-------
-  // Calculate the 2nd order directional derivative of the smoothed image.
-  // The output of this filter will be used to store the directional
-  // derivative.
-  this->Compute2ndDerivative();
-
-  this->Compute2ndDerivativePos();
-
+  // 2. Calculate 2nd order directional derivative-------
   // 3. Non-maximum suppression----------
+  // The zero crossings of the 2nd directional derivative where the
+  // gradient magnitude is maximum are written to m_UpdateBuffer1.
+  this->ComputeNonMaximumSuppression();
 
-  // Calculate the zero crossings of the 2nd directional derivative and write
-  // the result to output buffer.
-  zeroCrossFilter->SetInput( this->GetOutput() );
-  zeroCrossFilter->Update();
-
-  // 4. Hysteresis Thresholding---------
-
-  // First get all the edges corresponding to zerocrossings
-  m_MultiplyImageFilter->SetInput1(m_UpdateBuffer1);
-  m_MultiplyImageFilter->SetInput2( zeroCrossFilter->GetOutput() );
+  // The smoothed image is no longer needed
+  m_GaussianFilter->GetOutput()->ReleaseData();
 
-  // To save memory, we will graft the output of the m_GaussianFilter,
-  // which is no longer needed, into the m_MultiplyImageFilter.
-  m_MultiplyImageFilter->GraftOutput( m_GaussianFilter->GetOutput() );
-  m_MultiplyImageFilter->Update();
+  // Allocate the output
+  this->GetOutput()->SetBufferedRegion( this->GetOutput()->GetRequestedRegion() );
+  this->GetOutput()->Allocate();
 
-  //Then do the double threshoulding upon the edge reponses
+  // 4. Hysteresis Thresholding---------
   this->HysteresisThresholding();
 }
 
@@ -373,255 +523,177 @@ void
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
 ::HysteresisThresholding()
 {
-  // This is the Zero crossings of the Second derivative multiplied with the
-  // gradients of the image. HysteresisThresholding of this image should give
-  // the Canny output.
-  typename OutputImageType::Pointer input = m_MultiplyImageFilter->GetOutput();
-  float value;
+  // Give each thread a region and follow the edges in parallel. Each
+  // iteration follows the edges handed over by the other threads, until no
+  // edge leaves the region of its thread.
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreads();
 
-  ListNodeType *node;
-
-// fix me
-  ImageRegionIterator< TOutputImage > oit( input, input->GetRequestedRegion() );
-
-  oit.GoToBegin();
-
-  ImageRegionIterator< TOutputImage > uit( this->GetOutput(),
-                                           this->GetOutput()->GetRequestedRegion() );
-  uit.GoToBegin();
-  while ( !uit.IsAtEnd() )
+  m_ThreadRegions.clear();
+  for ( ThreadIdType i = 0; i < numberOfThreads; i++ )
     {
-    uit.Value() = NumericTraits< OutputImagePixelType >::Zero;
-    ++uit;
+    OutputImageRegionType splitRegion;
+    const ThreadIdType    total = this->SplitRequestedRegion(i, numberOfThreads, splitRegion);
+    if ( i < total )
+      {
+      m_ThreadRegions.push_back(splitRegion);
+      }
     }
+  m_PendingEdges.assign( m_ThreadRegions.size(), std::vector< OffsetValueType >() );
+  m_CrossingEdges.assign( m_ThreadRegions.size(), std::vector< OffsetValueType >() );
+
+  CannyThreadStruct str;
+  str.Filter = this;
+  this->GetMultiThreader()->SetNumberOfThreads( m_ThreadRegions.size() );
+  this->GetMultiThreader()->SetSingleMethod(this->HysteresisThresholdingThreaderCallback, &str);
 
-  while ( !oit.IsAtEnd() )
+  m_FindEdgeSeeds = true;
+  bool pending = true;
+  while ( pending )
     {
-    value = oit.Value();
+    this->GetMultiThreader()->SingleMethodExecute();
+    m_FindEdgeSeeds = false;
 
-    if ( value > m_UpperThreshold )
+    // hand the edges which crossed a region boundary over to the thread
+    // owning them
+    pending = false;
+    for ( unsigned int t = 0; t < m_ThreadRegions.size(); t++ )
       {
-      node = m_NodeStore->Borrow();
-      node->m_Value = oit.GetIndex();
-      m_NodeList->PushFront(node);
-      FollowEdge( oit.GetIndex() );
+      m_PendingEdges[t].clear();
+      }
+    for ( unsigned int t = 0; t < m_CrossingEdges.size(); t++ )
+      {
+      for ( unsigned int e = 0; e < m_CrossingEdges[t].size(); e++ )
+        {
+        const IndexType index = this->GetOutput()->ComputeIndex(m_CrossingEdges[t][e]);
+        for ( unsigned int o = 0; o < m_ThreadRegions.size(); o++ )
+          {
+          if ( m_ThreadRegions[o].IsInside(index) )
+            {
+            m_PendingEdges[o].push_back(m_CrossingEdges[t][e]);
+            pending = true;
+            break;
+            }
+          }
+        }
+      m_CrossingEdges[t].clear();
       }
-
-    ++oit;
     }
+
+  m_ThreadRegions.clear();
+  m_PendingEdges.clear();
+  m_CrossingEdges.clear();
 }
 
 template< class TInputImage, class TOutputImage >
 void
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::FollowEdge(IndexType index)
+::ThreadedHysteresisThresholding(ThreadIdType threadId)
 {
   // This is the Zero crossings of the Second derivative multiplied with the
   // gradients of the image. HysteresisThresholding of this image should give
   // the Canny output.
-  typename OutputImageType::Pointer input = m_MultiplyImageFilter->GetOutput();
-  InputImageRegionType inputRegion = input->GetRequestedRegion();
+  const OutputImagePixelType *input = m_UpdateBuffer1->GetBufferPointer();
+  OutputImagePixelType *      output = this->GetOutput()->GetBufferPointer();
+  const OutputImageRegionType region = this->GetOutput()->GetRequestedRegion();
+  const OffsetValueType *     offsetTable = this->GetOutput()->GetOffsetTable();
+  const OutputImageRegionType threadRegion = m_ThreadRegions[threadId];
 
-  IndexType     nIndex;
-  IndexType     cIndex;
-  ListNodeType *node;
+  const OutputImagePixelType one = NumericTraits< OutputImagePixelType >::One;
 
-  //assign iterator radius
-  Size< ImageDimension > radius;
-  radius.Fill(1);
+  // The edge pixels found but whose neighbors haven't been visited yet
+  std::vector< OffsetValueType > edges;
 
-  ConstNeighborhoodIterator< TOutputImage > oit( radius,
-                                                 input, input->GetRequestedRegion() );
-  ImageRegionIteratorWithIndex< TOutputImage > uit( this->GetOutput(),
-                                                    this->GetOutput()->GetRequestedRegion() );
-
-  uit.SetIndex(index);
-  if ( uit.Get() == NumericTraits< OutputImagePixelType >::One )
+  if ( m_FindEdgeSeeds )
     {
-    // we must remove the node if we are not going to follow it!
+    ImageRegionIterator< TOutputImage > uit(this->GetOutput(), threadRegion);
+    for (; !uit.IsAtEnd(); ++uit )
+      {
+      uit.Set(NumericTraits< OutputImagePixelType >::Zero);
+      }
 
-    // Pop the front node from the list and read its index value.
-    node = m_NodeList->Front(); // get a pointer to the first node
-    m_NodeList->PopFront();     // unlink the front node
-    m_NodeStore->Return(node);  // return the memory for reuse
-    return;
+    ImageRegionConstIterator< TOutputImage > oit(m_UpdateBuffer1, threadRegion);
+    for ( uit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++uit )
+      {
+      if ( oit.Get() > m_UpperThreshold )
+        {
+        uit.Set(one);
+        edges.push_back( this->GetOutput()->ComputeOffset( uit.GetIndex() ) );
+        }
+      }
     }
-
-  int nSize = m_Center * 2 + 1;
-  while ( !m_NodeList->Empty() )
+  else
     {
-    // Pop the front node from the list and read its index value.
-    node = m_NodeList->Front(); // get a pointer to the first node
-    cIndex = node->m_Value;     // read the value of the first node
-    m_NodeList->PopFront();     // unlink the front node
-    m_NodeStore->Return(node);  // return the memory for reuse
-
-    // Move iterators to the correct index position.
-    oit.SetLocation(cIndex);
-    uit.SetIndex(cIndex);
-    uit.Value() = 1;
-
-    // Search the neighbors for new indicies to add to the list.
-    for ( int i = 0; i < nSize; i++ )
+    const std::vector< OffsetValueType > & pending = m_PendingEdges[threadId];
+    for ( unsigned int e = 0; e < pending.size(); e++ )
       {
-      nIndex = oit.GetIndex(i);
-      uit.SetIndex(nIndex);
-      if ( inputRegion.IsInside(nIndex) )
+      if ( output[pending[e]] != one )
         {
-        if ( oit.GetPixel(i) > m_LowerThreshold && uit.Value() != NumericTraits< OutputImagePixelType >::One  )
-          {
-          node = m_NodeStore->Borrow();  // get a new node struct
-          node->m_Value = nIndex;        // set its value
-          m_NodeList->PushFront(node);   // add the new node to the list
-
-          uit.SetIndex(nIndex);
-          uit.Value() = NumericTraits< OutputImagePixelType >::One;
-          }
+        output[pending[e]] = one;
+        edges.push_back(pending[e]);
         }
       }
     }
-}
-
-template< class TInputImage, class TOutputImage >
-void
-CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::ThreadedCompute2ndDerivativePos(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
-{
-  ZeroFluxNeumannBoundaryCondition< TInputImage > nbc;
-
-  ConstNeighborhoodIterator< TInputImage > bit;
-  ConstNeighborhoodIterator< TInputImage > bit1;
-
-  ImageRegionIterator< TOutputImage > it;
-
-  // Here input is the result from the gaussian filter
-  //      input1 is the 2nd derivative result
-  //      output is the gradient of 2nd derivative
-  typename OutputImageType::Pointer input1 = this->GetOutput();
-  typename OutputImageType::Pointer input = m_GaussianFilter->GetOutput();
-
-  typename  InputImageType::Pointer output  = m_UpdateBuffer1;
-
-  // set iterator radius
-  Size< ImageDimension > radius; radius.Fill(1);
-
-  // Find the data-set boundary "faces"
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< TInputImage >::
-  FaceListType faceList;
-  NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< TInputImage > bC;
-  faceList = bC(input, outputRegionForThread, radius);
-
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< TInputImage >::
-  FaceListType::iterator fit;
-
-  // support progress methods/callbacks
-  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels(), 100, 0.5f, 0.5f);
-
-  InputImagePixelType zero = NumericTraits< InputImagePixelType >::Zero;
-
-  OutputImagePixelType dx[ImageDimension];
-  OutputImagePixelType dx1[ImageDimension];
-
-  OutputImagePixelType directional[ImageDimension];
-  OutputImagePixelType derivPos;
-
-  OutputImagePixelType gradMag;
 
-  // Process the non-boundary region and then each of the boundary faces.
-  // These are N-d regions which border the edge of the buffer.
-
-  NeighborhoodInnerProduct< OutputImageType > IP;
-
-  for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
+  const unsigned int nSize = m_Center * 2 + 1;
+  while ( !edges.empty() )
     {
-    bit = ConstNeighborhoodIterator< InputImageType >(radius,
-                                                      input, *fit);
-    bit1 = ConstNeighborhoodIterator< InputImageType >(radius,
-                                                       input1, *fit);
-    it = ImageRegionIterator< OutputImageType >(output, *fit);
-    bit.OverrideBoundaryCondition(&nbc);
-    bit.GoToBegin();
-    bit1.GoToBegin();
-    it.GoToBegin();
-
-    while ( !bit.IsAtEnd() )
-      {
-      gradMag = 0.0001;
+    const OffsetValueType offset = edges.back();
+    edges.pop_back();
+    const IndexType cIndex = this->GetOutput()->ComputeIndex(offset);
 
+    // Search the neighbors for new edge pixels.
+    for ( unsigned int n = 0; n < nSize; n++ )
+      {
+      IndexType       nIndex;
+      OffsetValueType nOffset = 0;
       for ( unsigned int i = 0; i < ImageDimension; i++ )
         {
-        dx[i] = IP(m_ComputeCannyEdgeSlice[i], bit,
-                   m_ComputeCannyEdge1stDerivativeOper);
-        gradMag += dx[i] * dx[i];
-
-        dx1[i] = IP(m_ComputeCannyEdgeSlice[i], bit1,
-                    m_ComputeCannyEdge1stDerivativeOper);
+        nIndex[i] = cIndex[i] + static_cast< IndexValueType >( ( n / m_Stride[i] ) % 3 ) - 1;
+        nOffset += ( nIndex[i] - region.GetIndex(i) ) * offsetTable[i];
         }
-
-      gradMag = vcl_sqrt( (double)gradMag );
-      derivPos = zero;
-      for ( unsigned int i = 0; i < ImageDimension; i++ )
+      if ( region.IsInside(nIndex) && input[nOffset] > m_LowerThreshold )
         {
-        //First calculate the directional derivative
-
-        directional[i] = dx[i] / gradMag;
-
-        //calculate gradient of 2nd derivative
-
-        derivPos += dx1[i] * directional[i];
+        if ( !threadRegion.IsInside(nIndex) )
+          {
+          // let the thread owning that pixel follow the edge
+          m_CrossingEdges[threadId].push_back(nOffset);
+          }
+        else if ( output[nOffset] != one )
+          {
+          output[nOffset] = one;
+          edges.push_back(nOffset);
+          }
         }
-
-      it.Value() = ( ( derivPos <= zero ) );
-      it.Value() = it.Get() * gradMag;
-      ++bit;
-      ++bit1;
-      ++it;
-      progress.CompletedPixel();
       }
     }
 }
 
-//Calculate the second derivative
-template< class TInputImage, class TOutputImage >
-void
-CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::Compute2ndDerivativePos()
-{
-  CannyThreadStruct str;
-
-  str.Filter = this;
-
-  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
-  this->GetMultiThreader()->SetSingleMethod(this->Compute2ndDerivativePosThreaderCallback, &str);
-
-  this->GetMultiThreader()->SingleMethodExecute();
-}
-
 template< class TInputImage, class TOutputImage >
 ITK_THREAD_RETURN_TYPE
 CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
-::Compute2ndDerivativePosThreaderCallback(void *arg)
+::HysteresisThresholdingThreaderCallback(void *arg)
 {
   CannyThreadStruct *str;
 
-  ThreadIdType total, threadId, threadCount;
+  ThreadIdType threadId;
 
   threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
-  threadCount = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
 
   str = (CannyThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
 
-  // Execute the actual method with appropriate output region
-  // first find out how many pieces extent can be split into.
-  // Using the SplitRequestedRegion method from itk::ImageSource.
-
-  OutputImageRegionType splitRegion;
-  total = str->Filter->SplitRequestedRegion(threadId, threadCount,
-                                            splitRegion);
-
-  if ( threadId < total )
+  if ( threadId < str->Filter->m_ThreadRegions.size() )
     {
-    str->Filter->ThreadedCompute2ndDerivativePos(splitRegion, threadId);
+    if ( PipelineProfiler::GetEnabled() )
+      {
+      const double start = PipelineProfiler::GetTime();
+      str->Filter->ThreadedHysteresisThresholding(threadId);
+      PipelineProfiler::AddThreadRecord(str->Filter, threadId, start, PipelineProfiler::GetTime() - start,
+                                        str->Filter->m_ThreadRegions[threadId].GetNumberOfPixels());
+      }
+    else
+      {
+      str->Filter->ThreadedHysteresisThresholding(threadId);
+      }
     }
 
   return ITK_THREAD_RETURN_VALUE;
@@ -654,8 +726,6 @@ CannyEdgeDetectionImageFilter< TInputImage, TOutputImage >
      << m_Stride << std::endl;
   os << "Gaussian Filter: " << std::endl;
   m_GaussianFilter->Print( os, indent.GetNextIndent() );
-  os << "Multiply image Filter: " << std::endl;
-  m_MultiplyImageFilter->Print( os, indent.GetNextIndent() );
   os << "UpdateBuffer1: " << std::endl;
   m_UpdateBuffer1->Print( os, indent.GetNextIndent() );
 }
@@ -22,6 +22,7 @@
 #pragma warning ( disable : 4786 )
 #endif
 
+#include <vector>
 #include "itkImageToImageFilter.h"
 #include "itkEllipseSpatialObject.h"
 
@@ -44,6 +45,12 @@ namespace itk
  * radius given by the user, and fills in the array of radii.
  * The SweepAngle value can be adjusted to improve the segmentation.
  *
+ * The votes are accumulated in parallel: each thread handles a band of the
+ * input and votes in its own accumulator, which only covers the part of the
+ * output reachable from its band. The accumulators are summed at the end.
+ * They are kept between updates, so that running the filter on a series of
+ * inputs of the same size does not allocate them again.
+ *
  * \ingroup ImageFeatureExtraction
  *
  * \ingroup ITK-ImageFeature
@@ -184,6 +191,25 @@ private:
   HoughTransform2DCirclesImageFilter(const Self &);
   void operator=(const Self &);
 
+  /** Thread-Data Structure   */
+  struct HoughThreadStruct
+  {
+    HoughTransform2DCirclesImageFilter *Filter;
+  };
+
+  typedef typename OutputImageType::OffsetValueType OffsetValueType;
+
+  /** Vote for the centers of the circles going through the pixels of the
+   * region of a thread, in the accumulator of the thread. */
+  void ThreadedAccumulate(ThreadIdType threadId);
+
+  /** Sum the accumulators of the threads over the region of a thread, and
+   * compute the average radius. */
+  void ThreadedMerge(ThreadIdType threadId);
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE AccumulateThreaderCallback(void *arg);
+
   float  m_SweepAngle;
   double m_MinimumRadius;
   double m_MaximumRadius;
@@ -198,6 +224,18 @@ private:
   unsigned long         m_OldModifiedTime;
 
   CirclesListSizeType m_OldNumberOfCircles;
+
+  /** The directions swept around the gradient */
+  std::vector< double > m_SweepCosines;
+  std::vector< double > m_SweepSines;
+
+  /** The region of the input handled by each thread, the part of the
+   * output it votes in, and its votes and sum of the radii there. */
+  std::vector< OutputImageRegionType >  m_ThreadRegions;
+  std::vector< OutputImageRegionType >  m_ThreadBands;
+  std::vector< std::vector< double > > m_ThreadVotes;
+  std::vector< std::vector< double > > m_ThreadRadii;
+  bool                                 m_Merging;
 };
 } // end namespace itk
 
@@ -20,9 +20,12 @@
 
 #include "itkHoughTransform2DCirclesImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkGaussianDerivativeImageFunction.h"
 #include "itkMinimumMaximumImageCalculator.h"
+#include "itkProgressReporter.h"
+#include "itkPipelineProfiler.h"
 
 namespace itk
 {
@@ -40,6 +43,7 @@ HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
   m_OldNumberOfCircles = 0;
   m_SweepAngle = 0.0;
   m_NumberOfCircles = 1;
+  m_Merging = false;
 }
 
 template< typename TInputPixelType, typename TOutputPixelType >
@@ -85,30 +89,101 @@ HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
 
   // Allocate the output
   this->AllocateOutputs();
-  outputImage->FillBuffer(0);
 
+  // The buffer of the radius image is kept when the size of the output does
+  // not change, but the radii of the previous update are cleared
+  if ( !m_RadiusImage
+       || m_RadiusImage->GetBufferedRegion() != outputImage->GetLargestPossibleRegion() )
+    {
+    m_RadiusImage = OutputImageType::New();
+    m_RadiusImage->SetRegions( outputImage->GetLargestPossibleRegion() );
+    m_RadiusImage->Allocate();
+    }
+  m_RadiusImage->FillBuffer(0);
+  m_RadiusImage->SetOrigin( inputImage->GetOrigin() );
+  m_RadiusImage->SetSpacing( inputImage->GetSpacing() );
+  m_RadiusImage->SetDirection( inputImage->GetDirection() );
+
+  m_SweepCosines.clear();
+  m_SweepSines.clear();
+  for ( double angle = -m_SweepAngle; angle <= m_SweepAngle; angle += 0.05 )
+    {
+    m_SweepCosines.push_back( vcl_cos(angle) );
+    m_SweepSines.push_back( vcl_sin(angle) );
+    }
+
+  // Each step along a ray moves the vote by at most one pixel along each
+  // axis, and the rays stop once the maximum radius is reached, so the votes
+  // of a thread stay within this distance of its region.
+  const IndexValueType reach =
+    static_cast< IndexValueType >( vcl_ceil( vnl_math_max(m_MinimumRadius, m_MaximumRadius) ) ) + 3;
+
+  const OutputImageRegionType outputRegion = outputImage->GetRequestedRegion();
+  const ThreadIdType          numberOfThreads = this->GetNumberOfThreads();
+
+  m_ThreadRegions.clear();
+  m_ThreadBands.clear();
+  for ( ThreadIdType i = 0; i < numberOfThreads; i++ )
+    {
+    OutputImageRegionType splitRegion;
+    const ThreadIdType    total = this->SplitRequestedRegion(i, numberOfThreads, splitRegion);
+    if ( i < total )
+      {
+      m_ThreadRegions.push_back(splitRegion);
+
+      OutputImageRegionType band = splitRegion;
+      band.PadByRadius(reach);
+      band.Crop(outputRegion);
+      m_ThreadBands.push_back(band);
+      }
+    }
+  m_ThreadVotes.resize( m_ThreadRegions.size() );
+  m_ThreadRadii.resize( m_ThreadRegions.size() );
+
+  HoughThreadStruct str;
+  str.Filter = this;
+  this->GetMultiThreader()->SetNumberOfThreads( m_ThreadRegions.size() );
+  this->GetMultiThreader()->SetSingleMethod(this->AccumulateThreaderCallback, &str);
+
+  m_Merging = false;
+  this->GetMultiThreader()->SingleMethodExecute();
+  m_Merging = true;
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
+::ThreadedAccumulate(ThreadIdType threadId)
+{
+  InputImageConstPointer      inputImage = this->GetInput(0);
+  const OutputImageRegionType outputRegion = this->GetOutput(0)->GetRequestedRegion();
+  const OutputImageRegionType band = m_ThreadBands[threadId];
+
+  std::vector< double > & votes = m_ThreadVotes[threadId];
+  std::vector< double > & radii = m_ThreadRadii[threadId];
+  votes.assign(band.GetNumberOfPixels(), 0.0);
+  radii.assign(band.GetNumberOfPixels(), 0.0);
+
+  // The derivative function keeps a state, each thread needs its own
   typedef GaussianDerivativeImageFunction< InputImageType > DoGFunctionType;
   typename DoGFunctionType::Pointer DoGFunction = DoGFunctionType::New();
   DoGFunction->SetInputImage(inputImage);
   DoGFunction->SetSigma(m_SigmaGradient);
 
-  m_RadiusImage = OutputImageType::New();
-
-  m_RadiusImage->SetRegions( outputImage->GetLargestPossibleRegion() );
-  m_RadiusImage->SetOrigin( inputImage->GetOrigin() );
-  m_RadiusImage->SetSpacing( inputImage->GetSpacing() );
-  m_RadiusImage->SetDirection( inputImage->GetDirection() );
-  m_RadiusImage->Allocate();
-  m_RadiusImage->FillBuffer(0);
+  ImageRegionConstIteratorWithIndex< InputImageType > image_it(inputImage, m_ThreadRegions[threadId]);
 
-  ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage,  inputImage->GetRequestedRegion() );
-  image_it.Begin();
+  ProgressReporter progress( this, threadId, m_ThreadRegions[threadId].GetNumberOfPixels() );
 
   Index< 2 >        index;
   Point< float, 2 > point;
 
-  while ( !image_it.IsAtEnd() )
+  const OffsetValueType bandWidth = band.GetSize(0);
+
+  for (; !image_it.IsAtEnd(); ++image_it )
     {
+    progress.CompletedPixel();
+
     if ( image_it.Get() > m_Threshold )
       {
       point[0] = image_it.GetIndex()[0];
@@ -125,49 +200,108 @@ HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
         Vx /= norm;
         Vy /= norm;
 
-        for ( double angle = -m_SweepAngle; angle <= m_SweepAngle; angle += 0.05 )
+        for ( unsigned int a = 0; a < m_SweepCosines.size(); a++ )
           {
-          double i = m_MinimumRadius;
-          double distance;
+          const double cosine = m_SweepCosines[a];
+          const double sine = m_SweepSines[a];
+          double       i = m_MinimumRadius;
+          double       distance;
 
           do
             {
-            index[0] = (IndexValueType)( point[0] - i * ( Vx * vcl_cos(angle) + Vy * vcl_sin(angle) ) );
-            index[1] = (IndexValueType)( point[1] - i * ( Vx * vcl_sin(angle) + Vy * vcl_cos(angle) ) );
+            index[0] = (IndexValueType)( point[0] - i * ( Vx * cosine + Vy * sine ) );
+            index[1] = (IndexValueType)( point[1] - i * ( Vx * sine + Vy * cosine ) );
 
             distance = vcl_sqrt( ( index[1] - point[1] ) * ( index[1] - point[1] )
                                  + ( index[0] - point[0] ) * ( index[0] - point[0] ) );
 
-            if ( outputImage->GetRequestedRegion().IsInside(index) )
+            if ( band.IsInside(index) )
               {
-              outputImage->SetPixel(index, outputImage->GetPixel(index) + 1);
-              m_RadiusImage->SetPixel( index, ( m_RadiusImage->GetPixel(index) + distance ) );
+              const OffsetValueType offset = ( index[0] - band.GetIndex(0) )
+                                             + ( index[1] - band.GetIndex(1) ) * bandWidth;
+              votes[offset] += 1.0;
+              radii[offset] += distance;
               }
 
             i = i + 1;
             }
-          while ( outputImage->GetRequestedRegion().IsInside(index)
+          while ( outputRegion.IsInside(index)
                   && ( distance < m_MaximumRadius ) );
           }
         }
       }
-    ++image_it;
     }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
+::ThreadedMerge(ThreadIdType threadId)
+{
+  const OutputImageRegionType region = m_ThreadRegions[threadId];
 
-  // Compute the average radius
-  ImageRegionConstIterator< OutputImageType > output_it( outputImage, outputImage->GetLargestPossibleRegion() );
-  ImageRegionIterator< OutputImageType >      radius_it( m_RadiusImage, m_RadiusImage->GetLargestPossibleRegion() );
-  output_it.Begin();
-  radius_it.Begin();
-  while ( !output_it.IsAtEnd() )
+  ImageRegionIteratorWithIndex< OutputImageType > output_it(this->GetOutput(0), region);
+  ImageRegionIterator< OutputImageType >          radius_it(m_RadiusImage, region);
+
+  for (; !output_it.IsAtEnd(); ++output_it, ++radius_it )
     {
-    if ( output_it.Get() > 0 )
+    const IndexType index = output_it.GetIndex();
+
+    double votes = 0.0;
+    double radii = 0.0;
+    for ( unsigned int t = 0; t < m_ThreadBands.size(); t++ )
       {
-      radius_it.Set( radius_it.Get() / output_it.Get() );
+      const OutputImageRegionType & band = m_ThreadBands[t];
+      if ( band.IsInside(index) )
+        {
+        const OffsetValueType offset = ( index[0] - band.GetIndex(0) )
+                                       + ( index[1] - band.GetIndex(1) ) * band.GetSize(0);
+        votes += m_ThreadVotes[t][offset];
+        radii += m_ThreadRadii[t][offset];
+        }
       }
-    ++output_it;
-    ++radius_it;
+
+    // Compute the average radius
+    output_it.Set( static_cast< TOutputPixelType >( votes ) );
+    radius_it.Set( static_cast< TOutputPixelType >( votes > 0.0 ? radii / votes : 0.0 ) );
+    }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+ITK_THREAD_RETURN_TYPE
+HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
+::AccumulateThreaderCallback(void *arg)
+{
+  HoughThreadStruct *str;
+  ThreadIdType       threadId;
+
+  threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  str = (HoughThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  if ( threadId >= str->Filter->m_ThreadRegions.size() )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  const bool   profile = PipelineProfiler::GetEnabled();
+  const double start = profile ? PipelineProfiler::GetTime() : 0.0;
+
+  if ( str->Filter->m_Merging )
+    {
+    str->Filter->ThreadedMerge(threadId);
+    }
+  else
+    {
+    str->Filter->ThreadedAccumulate(threadId);
     }
+
+  if ( profile )
+    {
+    PipelineProfiler::AddThreadRecord(str->Filter, threadId, start, PipelineProfiler::GetTime() - start,
+                                      str->Filter->m_ThreadRegions[threadId].GetNumberOfPixels());
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 /** Get the list of circles. This recomputes the circles */
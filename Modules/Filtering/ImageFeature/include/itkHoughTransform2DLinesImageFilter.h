@@ -22,6 +22,7 @@
 #pragma warning ( disable : 4786 )
 #endif
 
+#include <vector>
 #include "itkImageToImageFilter.h"
 #include "itkLineSpatialObject.h"
 
@@ -51,6 +52,18 @@ namespace itk
  * (500 by default) for the angle axis. The distance axis depends on the
  * size of the diagonal of the input image.
  *
+ * The accumulator is split between the threads along the angle axis, so
+ * that each thread only counts the votes for its own angles. When
+ * UseGradientDirection is on, each pixel only votes for the lines whose
+ * normal is within AngleTolerance of the gradient of the input at this pixel,
+ * computed at the scale SigmaGradient. This cuts the number of votes by a
+ * large factor, but requires the input to have a gradient across the lines,
+ * like the edges of objects: as in HoughTransform2DCirclesImageFilter, the
+ * pixels where the gradient is flat do not vote.
+ *
+ * The buffers of the filter are kept between updates, so that running it on
+ * a series of inputs of the same size does not allocate them again.
+ *
  * \ingroup ImageFeatureExtraction
  * \sa LineSpatialObject
  *
@@ -127,6 +140,22 @@ public:
   /** Get the resolution angle */
   itkGetConstMacro(AngleResolution, float);
 
+  /** Set/Get whether the pixels only vote for the lines normal to their
+   * gradient. Off by default. */
+  itkSetMacro(UseGradientDirection, bool);
+  itkGetConstMacro(UseGradientDirection, bool);
+  itkBooleanMacro(UseGradientDirection);
+
+  /** Set/Get the scale of the derivative function (using DoG) used to
+   * compute the gradient direction */
+  itkSetMacro(SigmaGradient, double);
+  itkGetConstMacro(SigmaGradient, double);
+
+  /** Set/Get the largest angle, in radians, between the gradient and the
+   * normal of the lines a pixel votes for */
+  itkSetMacro(AngleTolerance, double);
+  itkGetConstMacro(AngleTolerance, double);
+
   /** Simplify the accumulator */
   void Simplify(void);
 
@@ -187,6 +216,25 @@ private:
   HoughTransform2DLinesImageFilter(const Self &);
   void operator=(const Self &);
 
+  /** Thread-Data Structure   */
+  struct HoughThreadStruct
+  {
+    HoughTransform2DLinesImageFilter *Filter;
+  };
+
+  typedef typename OutputImageType::OffsetValueType OffsetValueType;
+  typedef typename IndexType::IndexValueType        IndexValueType;
+
+  /** Compute the gradient direction of a part of the pixels which vote. */
+  void ThreadedComputeGradientDirections(ThreadIdType threadId);
+
+  /** Count the votes of all the pixels in the part of the accumulator
+   * handled by a thread. */
+  void ThreadedAccumulate(ThreadIdType threadId);
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE AccumulateThreaderCallback(void *arg);
+
   float              m_AngleResolution;
   float              m_Threshold;
   OutputImagePointer m_SimplifyAccumulator;
@@ -196,6 +244,25 @@ private:
   float              m_Variance;
   unsigned long      m_OldModifiedTime;
   LinesListSizeType  m_OldNumberOfLines;
+  bool               m_UseGradientDirection;
+  double             m_SigmaGradient;
+  double             m_AngleTolerance;
+
+  /** The angles of the accumulator, their cosines and sines, and the
+   * index along the angle axis of the accumulator where they are counted */
+  std::vector< double >         m_Angles;
+  std::vector< double >         m_AngleCosines;
+  std::vector< double >         m_AngleSines;
+  std::vector< IndexValueType > m_AngleIndices;
+
+  /** The pixels which vote, and the direction of their gradient */
+  std::vector< IndexType >     m_Voters;
+  std::vector< double >        m_VoterDirections;
+  std::vector< unsigned char > m_VoterHasDirection;
+
+  /** The part of the accumulator handled by each thread */
+  std::vector< OutputImageRegionType > m_ThreadRegions;
+  bool                                 m_ComputingGradients;
 };
 } // end namespace itk
 
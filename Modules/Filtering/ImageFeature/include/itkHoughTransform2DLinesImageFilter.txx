@@ -18,11 +18,16 @@
 #ifndef __itkHoughTransform2DLinesImageFilter_txx
 #define __itkHoughTransform2DLinesImageFilter_txx
 
+#include <algorithm>
 #include "itkHoughTransform2DLinesImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
 #include "itkDiscreteGaussianImageFilter.h"
+#include "itkGaussianDerivativeImageFunction.h"
 #include "itkMinimumMaximumImageCalculator.h"
 #include "itkCastImageFilter.h"
+#include "itkProgressReporter.h"
+#include "itkPipelineProfiler.h"
 
 namespace itk
 {
@@ -39,6 +44,10 @@ HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
   m_OldModifiedTime = 0;
   m_OldNumberOfLines = 0;
   m_SimplifyAccumulator = NULL;
+  m_UseGradientDirection = false;
+  m_SigmaGradient = 1;
+  m_AngleTolerance = 0.1;
+  m_ComputingGradients = false;
 }
 
 template< typename TInputPixelType, typename TOutputPixelType >
@@ -112,41 +121,228 @@ HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
 
   // Allocate the output
   this->AllocateOutputs();
-  outputImage->FillBuffer(0);
 
   const double nPI = 4.0 * vcl_atan(1.0);
 
+  // The angles of the accumulator
+  m_Angles.clear();
+  m_AngleCosines.clear();
+  m_AngleSines.clear();
+  m_AngleIndices.clear();
+  for ( double angle = -nPI; angle < nPI; angle += nPI / m_AngleResolution )
+    {
+    m_Angles.push_back(angle);
+    m_AngleCosines.push_back( vcl_cos(angle) );
+    m_AngleSines.push_back( vcl_sin(angle) );
+    // m_Theta
+    m_AngleIndices.push_back( (IndexValueType)( ( m_AngleResolution / 2 ) + m_AngleResolution * angle / ( 2 * nPI ) ) );
+    }
+
+  // The pixels which vote
+  m_Voters.clear();
   ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage,  inputImage->GetRequestedRegion() );
-  image_it.Begin();
+  for ( image_it.GoToBegin(); !image_it.IsAtEnd(); ++image_it )
+    {
+    if ( image_it.Get() > m_Threshold )
+      {
+      m_Voters.push_back( image_it.GetIndex() );
+      }
+    }
+  m_VoterDirections.resize( m_Voters.size() );
+  m_VoterHasDirection.assign(m_Voters.size(), 0);
 
-  Index< 2 > index;
+  // Split the accumulator along the angle axis
+  const OutputImageRegionType outputRegion = outputImage->GetBufferedRegion();
+  const SizeValueType         numberOfRows = outputRegion.GetSize(1);
+  const SizeValueType         numberOfThreads =
+    vnl_math_min( static_cast< SizeValueType >( this->GetNumberOfThreads() ), numberOfRows );
 
-  while ( !image_it.IsAtEnd() )
+  m_ThreadRegions.clear();
+  for ( SizeValueType i = 0; i < numberOfThreads; i++ )
     {
-    if ( image_it.Get() > m_Threshold )
+    const SizeValueType   first = i * numberOfRows / numberOfThreads;
+    const SizeValueType   last = ( i + 1 ) * numberOfRows / numberOfThreads;
+    OutputImageRegionType threadRegion = outputRegion;
+    threadRegion.SetIndex(1, outputRegion.GetIndex(1) + first);
+    threadRegion.SetSize(1, last - first);
+    m_ThreadRegions.push_back(threadRegion);
+    }
+
+  HoughThreadStruct str;
+  str.Filter = this;
+  this->GetMultiThreader()->SetNumberOfThreads( m_ThreadRegions.size() );
+  this->GetMultiThreader()->SetSingleMethod(this->AccumulateThreaderCallback, &str);
+
+  if ( m_UseGradientDirection )
+    {
+    m_ComputingGradients = true;
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+  m_ComputingGradients = false;
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
+::ThreadedComputeGradientDirections(ThreadIdType threadId)
+{
+  const SizeValueType numberOfVoters = m_Voters.size();
+  const SizeValueType numberOfThreads = m_ThreadRegions.size();
+  const SizeValueType first = threadId * numberOfVoters / numberOfThreads;
+  const SizeValueType last = ( threadId + 1 ) * numberOfVoters / numberOfThreads;
+
+  // The derivative function keeps a state, each thread needs its own
+  typedef GaussianDerivativeImageFunction< InputImageType > DoGFunctionType;
+  typename DoGFunctionType::Pointer DoGFunction = DoGFunctionType::New();
+  DoGFunction->SetInputImage( this->GetInput(0) );
+  DoGFunction->SetSigma(m_SigmaGradient);
+
+  for ( SizeValueType v = first; v < last; v++ )
+    {
+    typename DoGFunctionType::VectorType grad = DoGFunction->EvaluateAtIndex(m_Voters[v]);
+
+    // if the gradient is not flat
+    if ( ( vcl_fabs(grad[0]) > 1 ) || ( vcl_fabs(grad[1]) > 1 ) )
       {
-      for ( double angle = -nPI; angle < nPI; angle += nPI / m_AngleResolution )
+      m_VoterDirections[v] = vcl_atan2(grad[1], grad[0]);
+      m_VoterHasDirection[v] = 1;
+      }
+    }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
+::ThreadedAccumulate(ThreadIdType threadId)
+{
+  OutputImageType *           outputImage = this->GetOutput(0);
+  const OutputImageRegionType outputRegion = outputImage->GetBufferedRegion();
+  const OutputImageRegionType region = m_ThreadRegions[threadId];
+
+  ImageRegionIterator< OutputImageType > accu_it(outputImage, region);
+  for (; !accu_it.IsAtEnd(); ++accu_it )
+    {
+    accu_it.Set(0);
+    }
+
+  // The thread only counts the votes which fall in its rows. The votes for
+  // a distance equal to the size of the accumulator end up in the first
+  // pixel of the next row.
+  TOutputPixelType *    buffer = outputImage->GetBufferPointer();
+  const OffsetValueType width = outputRegion.GetSize(0);
+  const OffsetValueType begin = ( region.GetIndex(1) - outputRegion.GetIndex(1) ) * width;
+  const OffsetValueType end = begin + region.GetNumberOfPixels();
+  const IndexValueType  maximumDistance = (IndexValueType)outputRegion.GetSize()[0];
+
+  // The angles which may be counted by the thread
+  const typename std::vector< IndexValueType >::const_iterator anglesBegin =
+    std::lower_bound(m_AngleIndices.begin(), m_AngleIndices.end(), region.GetIndex(1) - 1);
+  const typename std::vector< IndexValueType >::const_iterator anglesEnd =
+    std::upper_bound( m_AngleIndices.begin(), m_AngleIndices.end(),
+                      region.GetIndex(1) + static_cast< IndexValueType >( region.GetSize(1) ) );
+  const SizeValueType firstAngle = anglesBegin - m_AngleIndices.begin();
+  const SizeValueType lastAngle = anglesEnd - m_AngleIndices.begin();
+
+  const double nPI = 4.0 * vcl_atan(1.0);
+  const bool   restricted = m_UseGradientDirection && m_AngleTolerance < nPI / 2;
+
+  ProgressReporter progress( this, threadId, m_Voters.size() );
+
+  for ( SizeValueType v = 0; v < m_Voters.size(); v++ )
+    {
+    progress.CompletedPixel();
+
+    if ( m_UseGradientDirection && !m_VoterHasDirection[v] )
+      {
+      continue;
+      }
+
+    // The ranges of angles the pixel votes for: those around the two
+    // directions of the gradient, modulo 2 pi, or all of them
+    SizeValueType ranges[12];
+    unsigned int  numberOfRanges = 0;
+    if ( restricted )
+      {
+      for ( unsigned int d = 0; d < 2; d++ )
         {
-        index[0] =
-          // m_R
-          (IndexValueType)( image_it.GetIndex()[0] * vcl_cos(angle) + image_it.GetIndex()[1] * vcl_sin(angle) );
-        // m_Theta
-        index[1] = (IndexValueType)( ( m_AngleResolution / 2 ) + m_AngleResolution * angle / ( 2 * nPI ) );
+        for ( int turn = -1; turn <= 1; turn++ )
+          {
+          const double center = m_VoterDirections[v] + d * nPI + 2 * nPI * turn;
+          ranges[numberOfRanges++] =
+            std::lower_bound(m_Angles.begin(), m_Angles.end(), center - m_AngleTolerance) - m_Angles.begin();
+          ranges[numberOfRanges++] =
+            std::upper_bound(m_Angles.begin(), m_Angles.end(), center + m_AngleTolerance) - m_Angles.begin();
+          }
+        }
+      }
+    else
+      {
+      ranges[numberOfRanges++] = firstAngle;
+      ranges[numberOfRanges++] = lastAngle;
+      }
+
+    const IndexValueType x = m_Voters[v][0];
+    const IndexValueType y = m_Voters[v][1];
+    for ( unsigned int r = 0; r < numberOfRanges; r += 2 )
+      {
+      const SizeValueType rangeEnd = vnl_math_min(ranges[r + 1], lastAngle);
+      for ( SizeValueType a = vnl_math_max(ranges[r], firstAngle); a < rangeEnd; a++ )
+        {
+        // m_R
+        const IndexValueType distance = (IndexValueType)( x * m_AngleCosines[a] + y * m_AngleSines[a] );
 
-        if ( ( index[0] > 0 )
-             && ( index[0] <= (IndexValueType)outputImage->GetBufferedRegion().GetSize()[0] ) )
-        // the preceeding "if" should be replacable with "if (
-        // outputImage->GetBufferedRegion().IsInside(index) )" but
-        // the algorithm fails if it is
+        if ( ( distance > 0 ) && ( distance <= maximumDistance ) )
           {
-          outputImage->SetPixel(index, outputImage->GetPixel(index) + 1);
+          const OffsetValueType offset = ( distance - outputRegion.GetIndex(0) )
+                                         + ( m_AngleIndices[a] - outputRegion.GetIndex(1) ) * width;
+          if ( offset >= begin && offset < end )
+            {
+            buffer[offset] = buffer[offset] + 1;
+            }
           }
         }
       }
-    ++image_it;
     }
 }
 
+template< typename TInputPixelType, typename TOutputPixelType >
+ITK_THREAD_RETURN_TYPE
+HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
+::AccumulateThreaderCallback(void *arg)
+{
+  HoughThreadStruct *str;
+  ThreadIdType       threadId;
+
+  threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  str = (HoughThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  if ( threadId >= str->Filter->m_ThreadRegions.size() )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  const bool   profile = PipelineProfiler::GetEnabled();
+  const double start = profile ? PipelineProfiler::GetTime() : 0.0;
+
+  if ( str->Filter->m_ComputingGradients )
+    {
+    str->Filter->ThreadedComputeGradientDirections(threadId);
+    }
+  else
+    {
+    str->Filter->ThreadedAccumulate(threadId);
+    }
+
+  if ( profile )
+    {
+    PipelineProfiler::AddThreadRecord(str->Filter, threadId, start, PipelineProfiler::GetTime() - start,
+                                      str->Filter->m_ThreadRegions[threadId].GetNumberOfPixels());
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 /** Simplify the accumulator
  * Do the same iteration process as the Update() method but find the maximum
  * along the curve and then remove the curve */
@@ -382,6 +578,9 @@ HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
   os << "Disc Radius: " << m_DiscRadius << std::endl;
   os << "Accumulator blur variance: " << m_Variance << std::endl;
   os << "Simplify Accumulator" << m_SimplifyAccumulator << std::endl;
+  os << "Use Gradient Direction: " << m_UseGradientDirection << std::endl;
+  os << "Derivative Scale : " << m_SigmaGradient << std::endl;
+  os << "Angle Tolerance: " << m_AngleTolerance << std::endl;
 }
 } // end namespace
 
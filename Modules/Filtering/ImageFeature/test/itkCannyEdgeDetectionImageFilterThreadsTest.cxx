@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkCannyEdgeDetectionImageFilter.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+// The edges must not depend on the number of threads, also when they cross
+// the regions of the threads, and must be the pixels of the non maximum
+// suppression image above the lower threshold which are connected to a pixel
+// above the upper threshold.
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size)
+{
+  typename TImage::IndexType start;
+  start.Fill(1);
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( typename TImage::RegionType(start, size) );
+  image->Allocate();
+
+  // a ball on a wavy background
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    double                           radius = 0.0;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+      {
+      const double x = index[d] - start[d] - size[d] / 2.0;
+      radius += x * x * ( 1.0 + 0.3 * d );
+      }
+    const double value = ( vcl_sqrt(radius) < size[0] / 3.0 ? 100.0 : 10.0 )
+                         + 20.0 * vcl_sin(index[0] * 0.7) * vcl_cos(index[TImage::ImageDimension - 1] * 0.4);
+    it.Set( static_cast< typename TImage::PixelType >( value ) );
+    }
+  return image;
+}
+
+template< class TImage >
+bool CheckEdges(const typename TImage::SizeType & size, bool partial)
+{
+  typedef itk::CannyEdgeDetectionImageFilter< TImage, TImage > FilterType;
+
+  typename TImage::Pointer image = MakeImage< TImage >(size);
+
+  typename TImage::RegionType requested = image->GetLargestPossibleRegion();
+  if ( partial )
+    {
+    requested.PadByRadius(-3);
+    requested.SetIndex(0, requested.GetIndex(0) + 2);
+    }
+
+  const double lower = 2.0;
+  const double upper = 8.0;
+
+  typename TImage::Pointer edges[2];
+  typename TImage::Pointer suppressed;
+  const unsigned int       threads[2] = { 1, 5 };
+  for ( unsigned int t = 0; t < 2; t++ )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetVariance(1.5);
+    filter->SetLowerThreshold(lower);
+    filter->SetUpperThreshold(upper);
+    filter->SetNumberOfThreads(threads[t]);
+    filter->GetOutput()->SetRequestedRegion(requested);
+    filter->Update();
+    edges[t] = filter->GetOutput();
+    edges[t]->DisconnectPipeline();
+    suppressed = filter->GetNonMaximumSuppressionImage();
+    }
+
+  // serial hysteresis thresholding of the non maximum suppression image
+  typename TImage::Pointer expected = TImage::New();
+  expected->SetRegions(requested);
+  expected->Allocate();
+  expected->FillBuffer(0);
+
+  typename itk::ConstNeighborhoodIterator< TImage >::RadiusType radius;
+  radius.Fill(1);
+  std::vector< typename TImage::IndexType > stack;
+  itk::ImageRegionIteratorWithIndex< TImage > sit(suppressed, requested);
+  for (; !sit.IsAtEnd(); ++sit )
+    {
+    if ( sit.Get() > upper && expected->GetPixel( sit.GetIndex() ) == 0 )
+      {
+      expected->SetPixel(sit.GetIndex(), 1);
+      stack.push_back( sit.GetIndex() );
+      }
+    while ( !stack.empty() )
+      {
+      itk::ConstNeighborhoodIterator< TImage > nit(radius, suppressed, requested);
+      nit.SetLocation( stack.back() );
+      stack.pop_back();
+      for ( unsigned int n = 0; n < nit.Size(); n++ )
+        {
+        const typename TImage::IndexType index = nit.GetIndex(n);
+        if ( requested.IsInside(index) && suppressed->GetPixel(index) > lower
+             && expected->GetPixel(index) == 0 )
+          {
+          expected->SetPixel(index, 1);
+          stack.push_back(index);
+          }
+        }
+      }
+    }
+
+  unsigned int                                numberOfEdges = 0;
+  itk::ImageRegionIteratorWithIndex< TImage > eit(expected, requested);
+  for (; !eit.IsAtEnd(); ++eit )
+    {
+    const typename TImage::IndexType index = eit.GetIndex();
+    numberOfEdges += ( eit.Get() != 0 );
+    if ( edges[0]->GetPixel(index) != eit.Get() || edges[1]->GetPixel(index) != eit.Get() )
+      {
+      std::cerr << "Wrong edge at " << index << ": " << edges[0]->GetPixel(index) << " with one thread, "
+                << edges[1]->GetPixel(index) << " with several threads instead of " << eit.Get() << std::endl;
+      return false;
+      }
+    }
+
+  std::cout << "Image " << size << ", partial " << partial << ": " << numberOfEdges << " edge pixels" << std::endl;
+  if ( numberOfEdges == 0 )
+    {
+    std::cerr << "No edge found" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkCannyEdgeDetectionImageFilterThreadsTest(int, char *[])
+{
+  typedef itk::Image< float, 2 >  Image2DType;
+  typedef itk::Image< double, 3 > Image3DType;
+
+  bool pass = true;
+
+  Image2DType::SizeType size2D;
+  size2D[0] = 61;
+  size2D[1] = 47;
+  pass &= CheckEdges< Image2DType >(size2D, false);
+  pass &= CheckEdges< Image2DType >(size2D, true);
+
+  Image3DType::SizeType size3D;
+  size3D[0] = 19;
+  size3D[1] = 17;
+  size3D[2] = 13;
+  pass &= CheckEdges< Image3DType >(size3D, false);
+  pass &= CheckEdges< Image3DType >(size3D, true);
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
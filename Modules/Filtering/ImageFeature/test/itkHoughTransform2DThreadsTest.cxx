@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkHoughTransform2DCirclesImageFilter.h"
+#include "itkHoughTransform2DLinesImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+// The accumulators of the Hough transforms must not depend on the number of
+// threads, nor on the inputs the filters were run on before. The lines found
+// when voting along the gradient direction must be the ones of the input.
+
+namespace
+{
+typedef itk::Image< float, 2 > ImageType;
+
+// A half plane above the line y = slope * x + intercept and two discs
+ImageType::Pointer MakeImage(double slope, double intercept)
+{
+  ImageType::SizeType size;
+  size[0] = 100;
+  size[1] = 80;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const double x = it.GetIndex()[0];
+    const double y = it.GetIndex()[1];
+    float        value = 0;
+    if ( y > slope * x + intercept )
+      {
+      value = 255;
+      }
+    if ( ( x - 30 ) * ( x - 30 ) + ( y - 60 ) * ( y - 60 ) < 12 * 12
+         || ( x - 70 ) * ( x - 70 ) + ( y - 20 ) * ( y - 20 ) < 8 * 8 )
+      {
+      value = 100;
+      }
+    it.Set(value);
+    }
+  return image;
+}
+
+bool Compare(const ImageType *first, const ImageType *second, double tolerance, const char *name)
+{
+  itk::ImageRegionConstIteratorWithIndex< ImageType > fit( first, first->GetBufferedRegion() );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > sit( second, second->GetBufferedRegion() );
+  for (; !fit.IsAtEnd(); ++fit, ++sit )
+    {
+    if ( vnl_math_abs( fit.Get() - sit.Get() ) > tolerance )
+      {
+      std::cerr << name << " differs at " << fit.GetIndex() << ": " << fit.Get() << " and " << sit.Get()
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkHoughTransform2DThreadsTest(int, char *[])
+{
+  typedef itk::HoughTransform2DCirclesImageFilter< float, float > CirclesFilterType;
+  typedef itk::HoughTransform2DLinesImageFilter< float, float >   LinesFilterType;
+
+  bool pass = true;
+
+  ImageType::Pointer image = MakeImage(0.5, 10.0);
+  ImageType::Pointer other = MakeImage(-0.3, 50.0);
+
+  // Circles: the votes are the same and the radii are the same up to the
+  // rounding errors for any number of threads, and when the filter was run
+  // on another input before
+  CirclesFilterType::Pointer circles[2];
+  const unsigned int         threads[2] = { 1, 4 };
+  for ( unsigned int t = 0; t < 2; t++ )
+    {
+    circles[t] = CirclesFilterType::New();
+    circles[t]->SetThreshold(5);
+    circles[t]->SetMinimumRadius(4);
+    circles[t]->SetMaximumRadius(15);
+    circles[t]->SetSweepAngle(0.3);
+    circles[t]->SetNumberOfThreads(threads[t]);
+    circles[t]->SetInput(t == 0 ? image : other);
+    circles[t]->Update();
+    }
+  circles[1]->SetInput(image);
+  circles[1]->Update();
+  pass &= Compare(circles[0]->GetOutput(), circles[1]->GetOutput(), 0.0, "Circle accumulator");
+  pass &= Compare(circles[0]->GetRadiusImage(), circles[1]->GetRadiusImage(), 1e-4, "Radius image");
+
+  // Lines: the accumulators are identical
+  LinesFilterType::Pointer lines[2];
+  for ( unsigned int t = 0; t < 2; t++ )
+    {
+    lines[t] = LinesFilterType::New();
+    lines[t]->SetNumberOfThreads(threads[t]);
+    lines[t]->SetInput(t == 0 ? image : other);
+    lines[t]->Update();
+    }
+  lines[1]->SetInput(image);
+  lines[1]->Update();
+  pass &= Compare(lines[0]->GetOutput(), lines[1]->GetOutput(), 0.0, "Line accumulator");
+
+  // Voting along the gradient finds the edge of the half plane, whose
+  // closest point to the origin is (-4, 8)
+  LinesFilterType::Pointer gradientLines = LinesFilterType::New();
+  gradientLines->SetInput(image);
+  gradientLines->SetThreshold(150);
+  gradientLines->UseGradientDirectionOn();
+  gradientLines->SetSigmaGradient(2);
+  gradientLines->SetAngleTolerance(0.1);
+  gradientLines->SetNumberOfThreads(3);
+  gradientLines->SetNumberOfLines(1);
+  gradientLines->Update();
+
+  LinesFilterType::LinesListType found = gradientLines->GetLines();
+  if ( found.size() != 1 )
+    {
+    std::cerr << "Found " << found.size() << " lines instead of 1" << std::endl;
+    pass = false;
+    }
+  else
+    {
+    const LinesFilterType::LinePointType point = found.front()->GetPoints()[0];
+    std::cout << "Line through " << point.GetPosition() << std::endl;
+    if ( vnl_math_abs(point.GetPosition()[0] + 4.0) > 1.0 || vnl_math_abs(point.GetPosition()[1] - 8.0) > 1.0 )
+      {
+      std::cerr << "Wrong line found along the gradient" << std::endl;
+      pass = false;
+      }
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
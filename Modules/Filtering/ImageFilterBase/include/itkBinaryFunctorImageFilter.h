@@ -20,6 +20,8 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkImageRegionSpans.h"
+#include "itkBatchFunctorTraits.h"
 
 namespace itk
 {
@@ -36,7 +38,11 @@ namespace itk
  * the pipeline. The SetConstant() and GetConstant() methods are provided as shortcuts
  * to set or get the constant value without manipulating the decorator.
  *
- * \sa UnaryFunctorImageFilter TernaryFunctorImageFilter
+ * When the pixels of the images can be accessed directly in their buffers,
+ * the functor is applied to the spans of pixels contiguous in the buffers,
+ * through BatchFunctorTraits.
+ *
+ * \sa UnaryFunctorImageFilter TernaryFunctorImageFilter BatchFunctorTraits
  *
  * \ingroup IntensityImageFilters   Multithreaded
  * \ingroup ITK-ImageFilterBase
@@ -192,6 +198,16 @@ private:
   BinaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);           //purposely not implemented
 
+  /** Apply the functor to the spans of pixels of the buffers.  Return false
+   * if the images cannot be walked by spans. */
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId,
+                                    const ImageToImageFilterDetail::BooleanDispatch< true > &);
+
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType &, ThreadIdType,
+                                    const ImageToImageFilterDetail::BooleanDispatch< false > &)
+  { return false; }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
@@ -214,6 +214,17 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
   OutputImagePointer outputPtr = this->GetOutput(0);
 
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    DirectBufferAccessTraits< TInputImage1 >::Supported
+    && DirectBufferAccessTraits< TInputImage2 >::Supported
+    && DirectBufferAccessTraits< TOutputImage >::Supported >
+  SpansDispatchType;
+
+  if ( this->ThreadedGenerateDataForSpans( outputRegionForThread, threadId, SpansDispatchType() ) )
+    {
+    return;
+    }
+
   if( inputPtr1 && inputPtr2 )
     {
     ImageRegionConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
@@ -277,6 +288,85 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     itkGenericExceptionMacro(<<"At most one of the inputs can be a constant.");
     }
 }
+
+template< class TInputImage1, class TInputImage2, class TOutputImage, class TFunction  >
+bool
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId,
+                               const ImageToImageFilterDetail::BooleanDispatch< true > &)
+{
+  Input1ImagePointer inputPtr1 =
+    dynamic_cast< const TInputImage1 * >( ProcessObject::GetInput(0) );
+  Input2ImagePointer inputPtr2 =
+    dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  if ( !inputPtr1 && !inputPtr2 )
+    {
+    return false;
+    }
+
+  ImageRegionSpans< TOutputImage::ImageDimension > spans(outputRegionForThread);
+  if ( inputPtr1 )
+    {
+    spans.AddBufferedRegion( inputPtr1->GetBufferedRegion() );
+    }
+  if ( inputPtr2 )
+    {
+    spans.AddBufferedRegion( inputPtr2->GetBufferedRegion() );
+    }
+  spans.AddBufferedRegion( outputPtr->GetBufferedRegion() );
+
+  OutputImagePixelType *outputBuffer = outputPtr->GetBufferPointer();
+  const SizeValueType   length = spans.GetSpanLength();
+
+  ProgressReporter progress( this, threadId, spans.GetNumberOfSpans() );
+
+  if ( inputPtr1 && inputPtr2 )
+    {
+    const Input1ImagePixelType *inputBuffer1 = inputPtr1->GetBufferPointer();
+    const Input2ImagePixelType *inputBuffer2 = inputPtr2->GetBufferPointer();
+    for ( spans.GoToBegin(); !spans.IsAtEnd(); ++spans )
+      {
+      BatchFunctorTraits< FunctorType >::Apply( m_Functor,
+                                                inputBuffer1 + inputPtr1->ComputeOffset( spans.GetIndex() ),
+                                                inputBuffer2 + inputPtr2->ComputeOffset( spans.GetIndex() ),
+                                                outputBuffer + outputPtr->ComputeOffset( spans.GetIndex() ),
+                                                length );
+      progress.CompletedPixel(); // potential exception thrown here
+      }
+    }
+  else if ( inputPtr1 )
+    {
+    const Input1ImagePixelType *inputBuffer1 = inputPtr1->GetBufferPointer();
+    const Input2ImagePixelType  input2Value = this->GetConstant2();
+    for ( spans.GoToBegin(); !spans.IsAtEnd(); ++spans )
+      {
+      BatchFunctorTraits< FunctorType >::ApplyConstant2( m_Functor,
+                                                         inputBuffer1 + inputPtr1->ComputeOffset( spans.GetIndex() ),
+                                                         input2Value,
+                                                         outputBuffer + outputPtr->ComputeOffset( spans.GetIndex() ),
+                                                         length );
+      progress.CompletedPixel(); // potential exception thrown here
+      }
+    }
+  else
+    {
+    const Input1ImagePixelType  input1Value = this->GetConstant1();
+    const Input2ImagePixelType *inputBuffer2 = inputPtr2->GetBufferPointer();
+    for ( spans.GoToBegin(); !spans.IsAtEnd(); ++spans )
+      {
+      BatchFunctorTraits< FunctorType >::ApplyConstant1( m_Functor,
+                                                         input1Value,
+                                                         inputBuffer2 + inputPtr2->ComputeOffset( spans.GetIndex() ),
+                                                         outputBuffer + outputPtr->ComputeOffset( spans.GetIndex() ),
+                                                         length );
+      progress.CompletedPixel(); // potential exception thrown here
+      }
+    }
+  return true;
+}
 } // end namespace itk
 
 #endif
@@ -85,6 +85,21 @@ public:
 };
 }
 
+/** Copy the spans of the same type, and convert the integers and floating
+ * point values to float or double by vectors */
+template< class TInput, class TOutput >
+class BatchFunctorTraits< Functor::Cast< TInput, TOutput > >
+{
+public:
+  typedef Functor::Cast< TInput, TOutput > FunctorType;
+
+  template< class TInputPixel, class TOutputPixel >
+  static void Apply(FunctorType &, const TInputPixel *input, TOutputPixel *output, SizeValueType n)
+  {
+    BatchFunctorDetail::ConvertKernel< TInputPixel, TOutputPixel >::Apply(input, output, n);
+  }
+};
+
 template< class TInputImage, class TOutputImage >
 class ITK_EXPORT CastImageFilter:
   public
@@ -22,6 +22,7 @@
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
 #include "itkConstNeighborhoodIterator.h"
+#include "itkConstInteriorNeighborhoodIterator.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -112,9 +113,22 @@ NeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
 
   // Process non-boundary region and each of the boundary faces.
   // These are N-d regions which border the edge of the buffer.
+  // The neighborhoods of the non-boundary region need no boundary
+  // condition, and are walked with the faster interior iterator.
   ConstNeighborhoodIterator< InputImageType > bit;
   for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
     {
+    if ( ConstInteriorNeighborhoodIterator< InputImageType >::IsInterior(m_Operator.GetRadius(), input, *fit) )
+      {
+      ConstInteriorNeighborhoodIterator< InputImageType > iit(m_Operator.GetRadius(), input, *fit);
+      it = ImageRegionIterator< OutputImageType >(output, *fit);
+      for (; !iit.IsAtEnd(); ++iit, ++it )
+        {
+        it.Value() = static_cast< typename OutputImageType::PixelType >( smartInnerProduct(iit, m_Operator) );
+        progress.CompletedPixel();
+        }
+      continue;
+      }
     bit =
       ConstNeighborhoodIterator< InputImageType >(m_Operator.GetRadius(),
                                                   input, *fit);
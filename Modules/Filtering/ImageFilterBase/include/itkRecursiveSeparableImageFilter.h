@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkNumericTraits.h"
+#include <vector>
 
 namespace itk
 {
@@ -43,6 +44,15 @@ namespace itk
  * G. Farneback & C.-F. Westin, "On Implementation of Recursive Gaussian
  * Filters", so far unpublished.
  *
+ * When the filtering direction is not the first image axis, the lines
+ * to be filtered are not contiguous in memory. In that case blocks of
+ * NumberOfLinesPerBlock lines that are adjacent along the first axis are
+ * gathered into an interleaved buffer and run through the recursion
+ * together, so that every memory access reads or writes a contiguous run
+ * of pixels and the inner loop runs over independent lines. Each line is
+ * computed with exactly the same arithmetic as in the line by line mode,
+ * so the result does not depend on the block size.
+ *
  * \ingroup ImageFilters
  * \ingroup ITK-ImageFilterBase
  */
@@ -87,6 +97,12 @@ public:
   /** Set the direction in which the filter is to be applied. */
   itkSetMacro(Direction, unsigned int);
 
+  /** Set/Get the number of lines filtered together when the direction is
+   * not the first image axis. A value of 1 filters one line at a
+   * time. Default is 8. */
+  itkSetClampMacro(NumberOfLinesPerBlock, unsigned int, 1, 64);
+  itkGetConstMacro(NumberOfLinesPerBlock, unsigned int);
+
   /** Set Input Image. */
   void SetInputImage(const TInputImage *);
 
@@ -130,6 +146,13 @@ protected:
   void FilterDataArray(RealType *outs, const RealType *data, RealType *scratch,
                        unsigned int ln);
 
+  /** Apply the Recursive Filter to a block of numberOfLines lines stored
+   * interleaved, i.e. sample i of line l is at index i * numberOfLines + l
+   * of the "outs", "data" and "scratch" arrays, each of which holds
+   * ln * numberOfLines values. */
+  void FilterDataBlock(RealType *outs, const RealType *data, RealType *scratch,
+                       unsigned int ln, unsigned int numberOfLines);
+
 protected:
   /** Causal coefficients that multiply the input data. */
   ScalarRealType m_N0;
@@ -169,6 +192,12 @@ private:
   /** Direction in which the filter is to be applied
    * this should be in the range [0,ImageDimension-1]. */
   unsigned int m_Direction;
+
+  unsigned int m_NumberOfLinesPerBlock;
+
+  /** Work buffers of each thread. They are kept between executions so
+   * that repeated updates do not allocate them again. */
+  std::vector< std::vector< RealType > > m_ThreadBuffers;
 };
 } // end namespace itk
 
@@ -20,7 +20,7 @@
 
 #include "itkRecursiveSeparableImageFilter.h"
 #include "itkObjectFactory.h"
-#include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include <new>
 
@@ -31,6 +31,7 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::RecursiveSeparableImageFilter()
 {
   m_Direction = 0;
+  m_NumberOfLinesPerBlock = 8;
   this->SetNumberOfRequiredOutputs(1);
   this->SetNumberOfRequiredInputs(1);
 
@@ -152,6 +153,120 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to a block of interleaved lines
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterDataBlock(RealType *outs, const RealType *data,
+                  RealType *scratch, unsigned int ln, unsigned int numberOfLines)
+{
+  const unsigned int L = numberOfLines;
+  const unsigned int n = ln * L;
+
+  // Local copies of the coefficients, so that the compiler does not have
+  // to assume that writing to the buffers modifies them.
+  const ScalarRealType n0 = m_N0;
+  const ScalarRealType n1 = m_N1;
+  const ScalarRealType n2 = m_N2;
+  const ScalarRealType n3 = m_N3;
+  const ScalarRealType d1 = m_D1;
+  const ScalarRealType d2 = m_D2;
+  const ScalarRealType d3 = m_D3;
+  const ScalarRealType d4 = m_D4;
+  const ScalarRealType m1 = m_M1;
+  const ScalarRealType m2 = m_M2;
+  const ScalarRealType m3 = m_M3;
+  const ScalarRealType m4 = m_M4;
+
+  /**
+   * Causal direction pass, borders are initialized as in FilterDataArray()
+   */
+  for ( unsigned int l = 0; l < L; l++ )
+    {
+    const RealType *x = data + l;
+    RealType       *y = scratch + l;
+    const RealType  outV1 = x[0];
+
+    y[0] = RealType(outV1 * n0 + outV1 * n1 + outV1 * n2 + outV1 * n3);
+    y[L] = RealType(x[L] * n0 + outV1 * n1 + outV1 * n2 + outV1 * n3);
+    y[2 * L] = RealType(x[2 * L] * n0 + x[L] * n1 + outV1 * n2 + outV1 * n3);
+    y[3 * L] = RealType(x[3 * L] * n0 + x[2 * L] * n1 + x[L] * n2 + outV1 * n3);
+
+    y[0] -= RealType(outV1 * m_BN1 + outV1 * m_BN2 + outV1 * m_BN3 + outV1 * m_BN4);
+    y[L] -= RealType(y[0] * d1 + outV1 * m_BN2 + outV1 * m_BN3 + outV1 * m_BN4);
+    y[2 * L] -= RealType(y[L] * d1 + y[0] * d2 + outV1 * m_BN3 + outV1 * m_BN4);
+    y[3 * L] -= RealType(y[2 * L] * d1 + y[L] * d2 + y[0] * d3 + outV1 * m_BN4);
+    }
+
+  for ( unsigned int i = 4; i < ln; i++ )
+    {
+    const RealType *x0 = data + i * L;
+    const RealType *x1 = x0 - L;
+    const RealType *x2 = x1 - L;
+    const RealType *x3 = x2 - L;
+    RealType       *y0 = scratch + i * L;
+    const RealType *y1 = y0 - L;
+    const RealType *y2 = y1 - L;
+    const RealType *y3 = y2 - L;
+    const RealType *y4 = y3 - L;
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      y0[l]  = RealType(x0[l] * n0 + x1[l] * n1 + x2[l] * n2 + x3[l] * n3);
+      y0[l] -= RealType(y1[l] * d1 + y2[l] * d2 + y3[l] * d3 + y4[l] * d4);
+      }
+    }
+
+  for ( unsigned int k = 0; k < n; k++ )
+    {
+    outs[k] = scratch[k];
+    }
+
+  /**
+   * AntiCausal direction pass
+   */
+  for ( unsigned int l = 0; l < L; l++ )
+    {
+    const RealType *x = data + ( ln - 1 ) * L + l;
+    RealType       *y = scratch + ( ln - 1 ) * L + l;
+    const RealType  outV2 = x[0];
+
+    y[0] = RealType(outV2 * m1 + outV2 * m2 + outV2 * m3 + outV2 * m4);
+    *( y - L ) = RealType(x[0] * m1 + outV2 * m2 + outV2 * m3 + outV2 * m4);
+    *( y - 2 * L ) = RealType(*( x - L ) * m1 + x[0] * m2 + outV2 * m3 + outV2 * m4);
+    *( y - 3 * L ) = RealType(*( x - 2 * L ) * m1 + *( x - L ) * m2 + x[0] * m3 + outV2 * m4);
+
+    y[0] -= RealType(outV2 * m_BM1 + outV2 * m_BM2 + outV2 * m_BM3 + outV2 * m_BM4);
+    *( y - L ) -= RealType(y[0] * d1 + outV2 * m_BM2 + outV2 * m_BM3 + outV2 * m_BM4);
+    *( y - 2 * L ) -= RealType(*( y - L ) * d1 + y[0] * d2 + outV2 * m_BM3 + outV2 * m_BM4);
+    *( y - 3 * L ) -= RealType(*( y - 2 * L ) * d1 + *( y - L ) * d2 + y[0] * d3 + outV2 * m_BM4);
+    }
+
+  for ( unsigned int i = ln - 4; i > 0; i-- )
+    {
+    const RealType *x1 = data + i * L;
+    const RealType *x2 = x1 + L;
+    const RealType *x3 = x2 + L;
+    const RealType *x4 = x3 + L;
+    const RealType *y1 = scratch + i * L;
+    const RealType *y2 = y1 + L;
+    const RealType *y3 = y2 + L;
+    const RealType *y4 = y3 + L;
+    RealType       *y0 = scratch + ( i - 1 ) * L;
+    for ( unsigned int l = 0; l < L; l++ )
+      {
+      y0[l]  = RealType(x1[l] * m1 + x2[l] * m2 + x3[l] * m3 + x4[l] * m4);
+      y0[l] -= RealType(y1[l] * d1 + y2[l] * d2 + y3[l] * d3 + y4[l] * d4);
+      }
+    }
+
+  for ( unsigned int k = 0; k < n; k++ )
+    {
+    outs[k] += scratch[k];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -274,11 +389,19 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
                                               <<
       " is less than 4. This filter requires a minimum of four pixels along the dimension to be processed.");
     }
+
+  // The buffers of each thread are sized on first use in
+  // ThreadedGenerateData().
+  if ( m_ThreadBuffers.size() < this->GetNumberOfThreads() )
+    {
+    m_ThreadBuffers.resize( this->GetNumberOfThreads() );
+    }
 }
 
 /**
  * Compute Recursive filter
- * line by line in one of the dimensions
+ * line by line in one of the dimensions, or block of lines by block of
+ * lines when the lines are not contiguous in memory
  */
 template< typename TInputImage, typename TOutputImage >
 void
@@ -287,92 +410,126 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 {
   typedef typename TOutputImage::PixelType OutputPixelType;
 
-  typedef ImageLinearConstIteratorWithIndex< TInputImage > InputConstIteratorType;
-  typedef ImageLinearIteratorWithIndex< TOutputImage >     OutputIteratorType;
+  typedef ImageRegionConstIterator< TInputImage > InputConstIteratorType;
+  typedef ImageRegionIterator< TOutputImage >     OutputIteratorType;
 
   typedef ImageRegion< TInputImage::ImageDimension > RegionType;
+  typedef typename RegionType::IndexType             IndexType;
+  typedef typename RegionType::SizeType              SizeType;
+
+  const unsigned int ImageDimension = TInputImage::ImageDimension;
 
   typename TInputImage::ConstPointer inputImage( this->GetInputImage () );
   typename TOutputImage::Pointer     outputImage( this->GetOutput() );
 
-  RegionType region = outputRegionForThread;
-
-  InputConstIteratorType inputIterator(inputImage,  region);
-  OutputIteratorType     outputIterator(outputImage, region);
-
-  inputIterator.SetDirection(this->m_Direction);
-  outputIterator.SetDirection(this->m_Direction);
-
-  const unsigned int ln = region.GetSize()[this->m_Direction];
+  const RegionType region = outputRegionForThread;
+  const IndexType  regionIndex = region.GetIndex();
+  const SizeType   regionSize = region.GetSize();
 
-  RealType *inps = 0;
-  RealType *outs = 0;
-  RealType *scratch = 0;
+  const unsigned int ln = regionSize[this->m_Direction];
 
-  try
-    {
-    inps = new RealType[ln];
-    }
-  catch ( std::bad_alloc & )
-    {
-    itkExceptionMacro("Problem allocating memory for internal computations");
-    }
-
-  try
-    {
-    outs = new RealType[ln];
-    }
-  catch ( std::bad_alloc & )
-    {
-    delete[] inps;
-    itkExceptionMacro("Problem allocating memory for internal computations");
-    }
+  // Lines that are adjacent along the first axis are filtered together,
+  // unless the first axis is the direction of filtering.
+  const unsigned int maximumLinesPerBlock =
+    ( this->m_Direction != 0 ) ? m_NumberOfLinesPerBlock : 1;
 
+  std::vector< RealType > & buffer = m_ThreadBuffers[threadId];
+  const std::size_t bufferSize = 3 * static_cast< std::size_t >( ln ) * maximumLinesPerBlock;
   try
     {
-    scratch = new RealType[ln];
+    if ( buffer.size() < bufferSize )
+      {
+      buffer.resize(bufferSize);
+      }
     }
   catch ( std::bad_alloc & )
     {
-    delete[] inps;
-    delete[] outs;
     itkExceptionMacro("Problem allocating memory for internal computations");
     }
 
-  inputIterator.GoToBegin();
-  outputIterator.GoToBegin();
+  RealType *inps = &buffer[0];
+  RealType *outs = inps + ln * maximumLinesPerBlock;
+  RealType *scratch = outs + ln * maximumLinesPerBlock;
 
   const typename TInputImage::OffsetValueType * offsetTable = inputImage->GetOffsetTable();
 
   const unsigned int numberOfLinesToProcess = offsetTable[TInputImage::ImageDimension] / ln;
   ProgressReporter   progress(this, threadId, numberOfLinesToProcess, 10);
 
+  // Region covering the current block: the lines along the first axis and
+  // the whole extent along the direction of filtering. Walking it in
+  // memory order visits the samples in the interleaved order expected by
+  // FilterDataBlock().
+  RegionType blockRegion = region;
+  IndexType  blockIndex = regionIndex;
+  SizeType   blockSize;
+  blockSize.Fill(1);
+  blockSize[this->m_Direction] = ln;
+
   try  // this try is intended to catch an eventual AbortException.
     {
-    while ( !inputIterator.IsAtEnd() && !outputIterator.IsAtEnd() )
+    for (;; )
       {
-      unsigned int i = 0;
-      while ( !inputIterator.IsAtEndOfLine() )
+      unsigned int numberOfLines = 1;
+      if ( this->m_Direction != 0 )
         {
-        inps[i++]      = inputIterator.Get();
-        ++inputIterator;
+        const SizeValueType remaining =
+          static_cast< SizeValueType >( regionIndex[0] + static_cast< IndexValueType >( regionSize[0] )
+                                        - blockIndex[0] );
+        numberOfLines = ( remaining < maximumLinesPerBlock ) ?
+                        static_cast< unsigned int >( remaining ) : maximumLinesPerBlock;
+        blockSize[0] = numberOfLines;
         }
+      blockRegion.SetIndex(blockIndex);
+      blockRegion.SetSize(blockSize);
 
-      this->FilterDataArray(outs, inps, scratch, ln);
+      InputConstIteratorType inputIterator(inputImage, blockRegion);
+      for ( RealType *p = inps; !inputIterator.IsAtEnd(); ++inputIterator )
+        {
+        *p++ = inputIterator.Get();
+        }
 
-      unsigned int j = 0;
-      while ( !outputIterator.IsAtEndOfLine() )
+      if ( numberOfLines == 1 )
         {
-        outputIterator.Set( static_cast< OutputPixelType >( outs[j++] ) );
-        ++outputIterator;
+        this->FilterDataArray(outs, inps, scratch, ln);
+        }
+      else
+        {
+        this->FilterDataBlock(outs, inps, scratch, ln, numberOfLines);
         }
 
-      inputIterator.NextLine();
-      outputIterator.NextLine();
+      OutputIteratorType outputIterator(outputImage, blockRegion);
+      for ( const RealType *p = outs; !outputIterator.IsAtEnd(); ++outputIterator )
+        {
+        outputIterator.Set( static_cast< OutputPixelType >( *p++ ) );
+        }
 
       // Although the method name is CompletedPixel(),
       // this is being called after each line is processed
-      progress.CompletedPixel();
+      for ( unsigned int l = 0; l < numberOfLines; l++ )
+        {
+        progress.CompletedPixel();
+        }
+
+      // Move to the next block, skipping the direction of filtering
+      unsigned int d = 0;
+      for (; d < ImageDimension; d++ )
+        {
+        if ( d == this->m_Direction )
+          {
+          continue;
+          }
+        blockIndex[d] += ( d == 0 ) ? numberOfLines : 1;
+        if ( blockIndex[d] < regionIndex[d] + static_cast< IndexValueType >( regionSize[d] ) )
+          {
+          break;
+          }
+        blockIndex[d] = regionIndex[d];
+        }
+      if ( d == ImageDimension )
+        {
+        break;
+        }
       }
     }
   catch ( ProcessAborted  & )
@@ -381,20 +538,12 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     // progress reporter and rethrow it with the correct line number and file
     // name. We also invoke AbortEvent in case some observer was interested on
     // it.
-    // release locally allocated memory
-    delete[] outs;
-    delete[] inps;
-    delete[] scratch;
     // Throw the final exception.
     ProcessAborted e(__FILE__, __LINE__);
     e.SetDescription("Process aborted.");
     e.SetLocation(ITK_LOCATION);
     throw e;
     }
-
-  delete[] outs;
-  delete[] inps;
-  delete[] scratch;
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -405,6 +554,7 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "Direction: " << m_Direction << std::endl;
+  os << indent << "NumberOfLinesPerBlock: " << m_NumberOfLinesPerBlock << std::endl;
 }
 } // end namespace itk
 
@@ -20,6 +20,8 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionSpans.h"
+#include "itkBatchFunctorTraits.h"
 
 namespace itk
 {
@@ -30,7 +32,11 @@ namespace itk
  * and the type of the output image.  It is also parameterized by the
  * operation to be applied, using a Functor style.
  *
- * \sa BinaryFunctorImageFilter UnaryFunctorImageFilter
+ * When the pixels of the images can be accessed directly in their buffers,
+ * the functor is applied to the spans of pixels contiguous in the buffers,
+ * through BatchFunctorTraits.
+ *
+ * \sa BinaryFunctorImageFilter UnaryFunctorImageFilter BatchFunctorTraits
  *
  * \ingroup IntensityImageFilters Multithreaded
  * \ingroup ITK-ImageFilterBase
@@ -156,6 +162,16 @@ private:
   TernaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);            //purposely not implemented
 
+  /** Apply the functor to the spans of pixels of the buffers.  Return false
+   * if the images cannot be walked by spans. */
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId,
+                                    const ImageToImageFilterDetail::BooleanDispatch< true > &);
+
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType &, ThreadIdType,
+                                    const ImageToImageFilterDetail::BooleanDispatch< false > &)
+  { return false; }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
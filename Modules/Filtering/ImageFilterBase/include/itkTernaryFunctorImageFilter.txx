@@ -120,6 +120,18 @@ TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImag
     dynamic_cast< const TInputImage3 * >( ( ProcessObject::GetInput(2) ) );
   OutputImagePointer outputPtr = this->GetOutput(0);
 
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    DirectBufferAccessTraits< TInputImage1 >::Supported
+    && DirectBufferAccessTraits< TInputImage2 >::Supported
+    && DirectBufferAccessTraits< TInputImage3 >::Supported
+    && DirectBufferAccessTraits< TOutputImage >::Supported >
+  SpansDispatchType;
+
+  if ( this->ThreadedGenerateDataForSpans( outputRegionForThread, threadId, SpansDispatchType() ) )
+    {
+    return;
+    }
+
   ImageRegionConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
   ImageRegionConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
   ImageRegionConstIterator< TInputImage3 > inputIt3(inputPtr3, outputRegionForThread);
@@ -142,6 +154,49 @@ TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImag
     progress.CompletedPixel(); // potential exception thrown here
     }
 }
+
+template< class TInputImage1, class TInputImage2,
+          class TInputImage3, class TOutputImage, class TFunction  >
+bool
+TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction >
+::ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId,
+                               const ImageToImageFilterDetail::BooleanDispatch< true > &)
+{
+  Input1ImagePointer inputPtr1 =
+    dynamic_cast< const TInputImage1 * >( ( ProcessObject::GetInput(0) ) );
+  Input2ImagePointer inputPtr2 =
+    dynamic_cast< const TInputImage2 * >( ( ProcessObject::GetInput(1) ) );
+  Input3ImagePointer inputPtr3 =
+    dynamic_cast< const TInputImage3 * >( ( ProcessObject::GetInput(2) ) );
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  ImageRegionSpans< TOutputImage::ImageDimension > spans(outputRegionForThread);
+  spans.AddBufferedRegion( inputPtr1->GetBufferedRegion() );
+  spans.AddBufferedRegion( inputPtr2->GetBufferedRegion() );
+  spans.AddBufferedRegion( inputPtr3->GetBufferedRegion() );
+  spans.AddBufferedRegion( outputPtr->GetBufferedRegion() );
+
+  const Input1ImagePixelType *inputBuffer1 = inputPtr1->GetBufferPointer();
+  const Input2ImagePixelType *inputBuffer2 = inputPtr2->GetBufferPointer();
+  const Input3ImagePixelType *inputBuffer3 = inputPtr3->GetBufferPointer();
+  OutputImagePixelType *      outputBuffer = outputPtr->GetBufferPointer();
+  const SizeValueType         length = spans.GetSpanLength();
+
+  ProgressReporter progress( this, threadId, spans.GetNumberOfSpans() );
+
+  for ( spans.GoToBegin(); !spans.IsAtEnd(); ++spans )
+    {
+    BatchFunctorTraits< FunctorType >::Apply( m_Functor,
+                                              inputBuffer1 + inputPtr1->ComputeOffset( spans.GetIndex() ),
+                                              inputBuffer2 + inputPtr2->ComputeOffset( spans.GetIndex() ),
+                                              inputBuffer3 + inputPtr3->ComputeOffset( spans.GetIndex() ),
+                                              outputBuffer + outputPtr->ComputeOffset( spans.GetIndex() ),
+                                              length );
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+  return true;
+}
 } // end namespace itk
 
 #endif
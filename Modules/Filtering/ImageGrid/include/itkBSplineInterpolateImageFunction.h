@@ -68,6 +68,14 @@ namespace itk
  *               Spline is determined in all dimensions, cannot selectively
  *                  pick dimension for calculating spline.
  *
+ * The supported spline orders are evaluated by code specialized for each
+ * order at compile time: the weights and the buffer offsets of the region
+ * of support are kept in fixed size arrays on the stack, whatever the
+ * threadID argument, and the weighted sum is reduced along the first
+ * dimension before the weights of the other dimensions are applied.
+ * EvaluateAtContinuousIndices() evaluates a whole sequence of positions,
+ * e.g. a scanline, with a single dispatch on the spline order.
+ *
  * \sa BSplineDecompositionImageFilter
  *
  * \ingroup ImageFunctions
@@ -107,7 +115,8 @@ public:
   itkStaticConstMacro(ImageDimension, unsigned int, Superclass::ImageDimension);
 
   /** Index typedef support. */
-  typedef typename Superclass::IndexType IndexType;
+  typedef typename Superclass::IndexType      IndexType;
+  typedef typename Superclass::IndexValueType IndexValueType;
 
   /** ContinuousIndex typedef support. */
   typedef typename Superclass::ContinuousIndexType ContinuousIndexType;
@@ -180,6 +189,13 @@ public:
                                                index,
                                                ThreadIdType threadID) const;
 
+  /** Evaluate the function at a sequence of continuous index positions,
+   * allocating the working space once. No bounds checking is done. This
+   * method is thread safe. */
+  virtual void EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                                           OutputType *values,
+                                           SizeValueType numberOfIndices) const;
+
   CovariantVectorType EvaluateDerivative(const PointType & point) const
   {
     ContinuousIndexType index;
@@ -330,6 +346,10 @@ protected:
    *  (hopefully) by looking up pre-allocated working space in arrays that are indexed by thread.
    *  The efficiency gain is likely dependent on the size of the working variables, which are
    *  in-turn dependent on the dimensionality of the image and the order of the spline.
+   *
+   *  All the Evaluate methods go through these methods. Their default implementations
+   *  evaluate the spline orders 0 to 5 with code specialized for each order, which does
+   *  not use the working space.
    */
   virtual OutputType EvaluateAtContinuousIndexInternal(const ContinuousIndexType & index,
                                                        vnl_matrix< long > & evaluateIndex,
@@ -367,6 +387,35 @@ private:
   BSplineInterpolateImageFunction(const Self &); //purposely not implemented
   void operator=(const Self &);                  //purposely not implemented
 
+  /** Evaluate the value and, if derivativeValue is not null, the
+   * derivative in the image grid at x with the code specialized for the
+   * spline order. Returns false if the spline order is not supported. */
+  bool EvaluateWithFixedSplineOrder(const ContinuousIndexType & x,
+                                    double & value,
+                                    CovariantVectorType *derivativeValue) const;
+
+  /** Same as above for the derivative only, oriented according to
+   * UseImageDirection. */
+  bool EvaluateDerivativeWithFixedSplineOrder(const ContinuousIndexType & x,
+                                              CovariantVectorType & derivativeValue) const;
+
+  template< unsigned int VSplineOrder >
+  void EvaluateFixedSplineOrder(const ContinuousIndexType & x,
+                                double & value,
+                                CovariantVectorType *derivativeValue) const;
+
+  /** First index of the region of support of x along one dimension. */
+  static long FirstIndexOfSupport(TCoordRep x, unsigned int splineOrder);
+
+  /** Interpolation and derivative weights of x along one dimension. */
+  static void ComputeInterpolationWeights(TCoordRep x, long firstIndex,
+                                          unsigned int splineOrder,
+                                          double *weights);
+
+  static void ComputeDerivativeWeights(TCoordRep x, long firstIndex,
+                                       unsigned int splineOrder,
+                                       double *weights);
+
   /** Determines the weights for interpolation of the value x */
   void SetInterpolationWeights(const ContinuousIndexType & x,
                                const vnl_matrix< long > & EvaluateIndex,
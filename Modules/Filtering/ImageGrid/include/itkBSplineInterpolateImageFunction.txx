@@ -385,6 +385,206 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
 #endif
 }
 
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                              OutputType *values,
+                              SizeValueType numberOfIndices) const
+{
+  // the working space is allocated once for all the indices
+  vnl_matrix< long >   evaluateIndex( ImageDimension, ( m_SplineOrder + 1 ) );
+  vnl_matrix< double > weights( ImageDimension, ( m_SplineOrder + 1 ) );
+
+  for ( SizeValueType i = 0; i < numberOfIndices; i++ )
+    {
+    values[i] = this->EvaluateAtContinuousIndexInternal(indices[i], evaluateIndex, weights);
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+bool
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateWithFixedSplineOrder(const ContinuousIndexType & x,
+                               double & value,
+                               CovariantVectorType *derivativeValue) const
+{
+  switch ( m_SplineOrder )
+    {
+    case 0:
+      this->template EvaluateFixedSplineOrder< 0 >(x, value, derivativeValue);
+      return true;
+    case 1:
+      this->template EvaluateFixedSplineOrder< 1 >(x, value, derivativeValue);
+      return true;
+    case 2:
+      this->template EvaluateFixedSplineOrder< 2 >(x, value, derivativeValue);
+      return true;
+    case 3:
+      this->template EvaluateFixedSplineOrder< 3 >(x, value, derivativeValue);
+      return true;
+    case 4:
+      this->template EvaluateFixedSplineOrder< 4 >(x, value, derivativeValue);
+      return true;
+    case 5:
+      this->template EvaluateFixedSplineOrder< 5 >(x, value, derivativeValue);
+      return true;
+    default:
+      return false;
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+bool
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateDerivativeWithFixedSplineOrder(const ContinuousIndexType & x,
+                                         CovariantVectorType & derivativeValue) const
+{
+  double value;
+
+  if ( !this->EvaluateWithFixedSplineOrder(x, value, &derivativeValue) )
+    {
+    return false;
+    }
+
+  if ( this->m_UseImageDirection )
+    {
+    CovariantVectorType orientedDerivative;
+    this->GetInputImage()->TransformLocalVectorToPhysicalVector(derivativeValue, orientedDerivative);
+    derivativeValue = orientedDerivative;
+    }
+  return true;
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+template< unsigned int VSplineOrder >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateFixedSplineOrder(const ContinuousIndexType & x,
+                           double & value,
+                           CovariantVectorType *derivativeValue) const
+{
+  const unsigned int Support = VSplineOrder + 1;
+
+  const IndexType        startIndex = this->GetStartIndex();
+  const IndexType        endIndex = this->GetEndIndex();
+  const IndexType        bufferIndex = m_Coefficients->GetBufferedRegion().GetIndex();
+  const OffsetValueType *offsetTable = m_Coefficients->GetOffsetTable();
+
+  // Weights and buffer offsets of the region of support along each
+  // dimension, with the mirror boundary conditions applied.
+  double          weights[ImageDimension][Support];
+  double          weightsDerivative[ImageDimension][Support];
+  OffsetValueType offsets[ImageDimension][Support];
+
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
+    {
+    const long firstIndex = FirstIndexOfSupport(x[n], VSplineOrder);
+    ComputeInterpolationWeights(x[n], firstIndex, VSplineOrder, weights[n]);
+    if ( derivativeValue )
+      {
+      ComputeDerivativeWeights(x[n], firstIndex, VSplineOrder, weightsDerivative[n]);
+      }
+
+    for ( unsigned int k = 0; k < Support; k++ )
+      {
+      IndexValueType indx = firstIndex + k;
+      if ( m_DataLength[n] == 1 )
+        {
+        indx = 0;
+        }
+      else
+        {
+        if ( indx < startIndex[n] )
+          {
+          indx = startIndex[n] + ( startIndex[n] - indx );
+          }
+        if ( indx >= endIndex[n] )
+          {
+          indx = endIndex[n] - ( indx - endIndex[n] );
+          }
+        }
+      offsets[n][k] = ( indx - bufferIndex[n] ) * offsetTable[n];
+      }
+    }
+
+  // The region of support is traversed line by line along the first
+  // dimension: each line is reduced with the weights of the first
+  // dimension before the weights of the other dimensions are applied.
+  const CoefficientDataType *buffer = m_Coefficients->GetBufferPointer();
+
+  unsigned int lineIndex[ImageDimension];
+  unsigned int numberOfLines = 1;
+  for ( unsigned int n = 1; n < ImageDimension; n++ )
+    {
+    lineIndex[n] = 0;
+    numberOfLines *= Support;
+    }
+
+  value = 0.0;
+  if ( derivativeValue )
+    {
+    derivativeValue->Fill(0.0);
+    }
+
+  for ( unsigned int line = 0; line < numberOfLines; line++ )
+    {
+    const CoefficientDataType *lineBuffer = buffer;
+    double                     lineWeight = 1.0;
+    for ( unsigned int n = 1; n < ImageDimension; n++ )
+      {
+      lineBuffer += offsets[n][lineIndex[n]];
+      lineWeight *= weights[n][lineIndex[n]];
+      }
+
+    double sum = 0.0;
+    for ( unsigned int k = 0; k < Support; k++ )
+      {
+      sum += weights[0][k] * lineBuffer[offsets[0][k]];
+      }
+    value += lineWeight * sum;
+
+    if ( derivativeValue )
+      {
+      double derivativeSum = 0.0;
+      for ( unsigned int k = 0; k < Support; k++ )
+        {
+        derivativeSum += weightsDerivative[0][k] * lineBuffer[offsets[0][k]];
+        }
+      ( *derivativeValue )[0] += lineWeight * derivativeSum;
+
+      for ( unsigned int n = 1; n < ImageDimension; n++ )
+        {
+        double derivativeWeight = 1.0;
+        for ( unsigned int m = 1; m < ImageDimension; m++ )
+          {
+          derivativeWeight *= ( m == n ) ? weightsDerivative[m][lineIndex[m]] : weights[m][lineIndex[m]];
+          }
+        ( *derivativeValue )[n] += derivativeWeight * sum;
+        }
+      }
+
+    for ( unsigned int n = 1; n < ImageDimension; n++ )
+      {
+      if ( ++lineIndex[n] < Support )
+        {
+        break;
+        }
+      lineIndex[n] = 0;
+      }
+    }
+
+  if ( derivativeValue )
+    {
+    // take spacing into account
+    const typename InputImageType::SpacingType & spacing = this->GetInputImage()->GetSpacing();
+    for ( unsigned int n = 0; n < ImageDimension; n++ )
+      {
+      ( *derivativeValue )[n] /= spacing[n];
+      }
+    }
+}
+
 template< class TImageType, class TCoordRep, class TCoefficientType >
 void
 BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
@@ -393,97 +593,103 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
                           vnl_matrix< double > & weights,
                           unsigned int splineOrder) const
 {
-  // For speed improvements we could make each case a separate function and use
-  // function pointers to reference the correct weight order.
-  // Left as is for now for readability.
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
+    {
+    ComputeInterpolationWeights(x[n], EvaluateIndex[n][0], splineOrder, weights[n]);
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::SetDerivativeWeights(const ContinuousIndexType & x,
+                       const vnl_matrix< long > & EvaluateIndex,
+                       vnl_matrix< double > & weights,
+                       unsigned int splineOrder) const
+{
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
+    {
+    ComputeDerivativeWeights(x[n], EvaluateIndex[n][0], splineOrder, weights[n]);
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::ComputeInterpolationWeights(TCoordRep x,
+                              long firstIndex,
+                              unsigned int splineOrder,
+                              double *weights)
+{
+  // The weights are computed relative to the index of the region of
+  // support that is the closest to x.
   double w, w2, w4, t, t0, t1;
 
   switch ( splineOrder )
     {
     case 3:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        w = x[n] - (double)EvaluateIndex[n][1];
-        weights[n][3] = ( 1.0 / 6.0 ) * w * w * w;
-        weights[n][0] = ( 1.0 / 6.0 ) + 0.5 * w * ( w - 1.0 ) - weights[n][3];
-        weights[n][2] = w + weights[n][0] - 2.0 * weights[n][3];
-        weights[n][1] = 1.0 - weights[n][0] - weights[n][2] - weights[n][3];
-        }
+      w = x - (double)( firstIndex + 1 );
+      weights[3] = ( 1.0 / 6.0 ) * w * w * w;
+      weights[0] = ( 1.0 / 6.0 ) + 0.5 * w * ( w - 1.0 ) - weights[3];
+      weights[2] = w + weights[0] - 2.0 * weights[3];
+      weights[1] = 1.0 - weights[0] - weights[2] - weights[3];
       break;
       }
     case 0:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        weights[n][0] = 1; // implements nearest neighbor
-        }
+      weights[0] = 1; // implements nearest neighbor
       break;
       }
     case 1:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        w = x[n] - (double)EvaluateIndex[n][0];
-        weights[n][1] = w;
-        weights[n][0] = 1.0 - w;
-        }
+      w = x - (double)firstIndex;
+      weights[1] = w;
+      weights[0] = 1.0 - w;
       break;
       }
     case 2:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        /* x */
-        w = x[n] - (double)EvaluateIndex[n][1];
-        weights[n][1] = 0.75 - w * w;
-        weights[n][2] = 0.5 * ( w - weights[n][1] + 1.0 );
-        weights[n][0] = 1.0 - weights[n][1] - weights[n][2];
-        }
+      w = x - (double)( firstIndex + 1 );
+      weights[1] = 0.75 - w * w;
+      weights[2] = 0.5 * ( w - weights[1] + 1.0 );
+      weights[0] = 1.0 - weights[1] - weights[2];
       break;
       }
     case 4:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        /* x */
-        w = x[n] - (double)EvaluateIndex[n][2];
-        w2 = w * w;
-        t = ( 1.0 / 6.0 ) * w2;
-        weights[n][0] = 0.5 - w;
-        weights[n][0] *= weights[n][0];
-        weights[n][0] *= ( 1.0 / 24.0 ) * weights[n][0];
-        t0 = w * ( t - 11.0 / 24.0 );
-        t1 = 19.0 / 96.0 + w2 * ( 0.25 - t );
-        weights[n][1] = t1 + t0;
-        weights[n][3] = t1 - t0;
-        weights[n][4] = weights[n][0] + t0 + 0.5 * w;
-        weights[n][2] = 1.0 - weights[n][0] - weights[n][1] - weights[n][3] - weights[n][4];
-        }
+      w = x - (double)( firstIndex + 2 );
+      w2 = w * w;
+      t = ( 1.0 / 6.0 ) * w2;
+      weights[0] = 0.5 - w;
+      weights[0] *= weights[0];
+      weights[0] *= ( 1.0 / 24.0 ) * weights[0];
+      t0 = w * ( t - 11.0 / 24.0 );
+      t1 = 19.0 / 96.0 + w2 * ( 0.25 - t );
+      weights[1] = t1 + t0;
+      weights[3] = t1 - t0;
+      weights[4] = weights[0] + t0 + 0.5 * w;
+      weights[2] = 1.0 - weights[0] - weights[1] - weights[3] - weights[4];
       break;
       }
     case 5:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        /* x */
-        w = x[n] - (double)EvaluateIndex[n][2];
-        w2 = w * w;
-        weights[n][5] = ( 1.0 / 120.0 ) * w * w2 * w2;
-        w2 -= w;
-        w4 = w2 * w2;
-        w -= 0.5;
-        t = w2 * ( w2 - 3.0 );
-        weights[n][0] = ( 1.0 / 24.0 ) * ( 1.0 / 5.0 + w2 + w4 ) - weights[n][5];
-        t0 = ( 1.0 / 24.0 ) * ( w2 * ( w2 - 5.0 ) + 46.0 / 5.0 );
-        t1 = ( -1.0 / 12.0 ) * w * ( t + 4.0 );
-        weights[n][2] = t0 + t1;
-        weights[n][3] = t0 - t1;
-        t0 = ( 1.0 / 16.0 ) * ( 9.0 / 5.0 - t );
-        t1 = ( 1.0 / 24.0 ) * w * ( w4 - w2 - 5.0 );
-        weights[n][1] = t0 + t1;
-        weights[n][4] = t0 - t1;
-        }
+      w = x - (double)( firstIndex + 2 );
+      w2 = w * w;
+      weights[5] = ( 1.0 / 120.0 ) * w * w2 * w2;
+      w2 -= w;
+      w4 = w2 * w2;
+      w -= 0.5;
+      t = w2 * ( w2 - 3.0 );
+      weights[0] = ( 1.0 / 24.0 ) * ( 1.0 / 5.0 + w2 + w4 ) - weights[5];
+      t0 = ( 1.0 / 24.0 ) * ( w2 * ( w2 - 5.0 ) + 46.0 / 5.0 );
+      t1 = ( -1.0 / 12.0 ) * w * ( t + 4.0 );
+      weights[2] = t0 + t1;
+      weights[3] = t0 - t1;
+      t0 = ( 1.0 / 16.0 ) * ( 9.0 / 5.0 - t );
+      t1 = ( 1.0 / 24.0 ) * w * ( w4 - w2 - 5.0 );
+      weights[1] = t0 + t1;
+      weights[4] = t0 - t1;
       break;
       }
     default:
@@ -501,114 +707,88 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
 template< class TImageType, class TCoordRep, class TCoefficientType >
 void
 BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
-::SetDerivativeWeights(const ContinuousIndexType & x,
-                       const vnl_matrix< long > & EvaluateIndex,
-                       vnl_matrix< double > & weights,
-                       unsigned int splineOrder) const
+::ComputeDerivativeWeights(TCoordRep x,
+                           long firstIndex,
+                           unsigned int splineOrder,
+                           double *weights)
 {
-  // For speed improvements we could make each case a separate function and use
-  // function pointers to reference the correct weight order.
-  // Another possiblity would be to loop inside the case statement (reducing
-  // the number
-  // of switch statement executions to one per routine call.
-  // Left as is for now for readability.
+  // Calculates B(splineOrder -1) ( (x + 1/2) - xi) -
+  //            B(splineOrder -1) ( (x - 1/2) - xi)
   double w, w1, w2, w3, w4, w5, t, t0, t1, t2;
-  int    derivativeSplineOrder = (int)splineOrder - 1;
 
-  switch ( derivativeSplineOrder )
+  switch ( splineOrder )
     {
-    // Calculates B(splineOrder) ( (x + 1/2) - xi) -
-    //            B(splineOrder -1)( (x - 1/2) - xi)
-    case -1:
-      {
-      // Why would we want to do this?
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        weights[n][0] = 0.0;
-        }
-      break;
-      }
     case 0:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        weights[n][0] = -1.0;
-        weights[n][1] =  1.0;
-        }
+      // Why would we want to do this?
+      weights[0] = 0.0;
       break;
       }
     case 1:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        w = x[n] + 0.5 - (double)EvaluateIndex[n][1];
-        // w2 = w;
-        w1 = 1.0 - w;
-
-        weights[n][0] = 0.0 - w1;
-        weights[n][1] = w1 - w;
-        weights[n][2] = w;
-        }
+      weights[0] = -1.0;
+      weights[1] =  1.0;
       break;
       }
     case 2:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        w = x[n] + .5 - (double)EvaluateIndex[n][2];
-        w2 = 0.75 - w * w;
-        w3 = 0.5 * ( w - w2 + 1.0 );
-        w1 = 1.0 - w2 - w3;
-
-        weights[n][0] = 0.0 - w1;
-        weights[n][1] = w1 - w2;
-        weights[n][2] = w2 - w3;
-        weights[n][3] = w3;
-        }
+      w = x + 0.5 - (double)( firstIndex + 1 );
+      w1 = 1.0 - w;
+
+      weights[0] = 0.0 - w1;
+      weights[1] = w1 - w;
+      weights[2] = w;
       break;
       }
     case 3:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        w = x[n] + 0.5 - (double)EvaluateIndex[n][2];
-        w4 = ( 1.0 / 6.0 ) * w * w * w;
-        w1 = ( 1.0 / 6.0 ) + 0.5 * w * ( w - 1.0 ) - w4;
-        w3 = w + w1 - 2.0 * w4;
-        w2 = 1.0 - w1 - w3 - w4;
-
-        weights[n][0] = 0.0 - w1;
-        weights[n][1] = w1 - w2;
-        weights[n][2] = w2 - w3;
-        weights[n][3] = w3 - w4;
-        weights[n][4] = w4;
-        }
+      w = x + .5 - (double)( firstIndex + 2 );
+      w2 = 0.75 - w * w;
+      w3 = 0.5 * ( w - w2 + 1.0 );
+      w1 = 1.0 - w2 - w3;
+
+      weights[0] = 0.0 - w1;
+      weights[1] = w1 - w2;
+      weights[2] = w2 - w3;
+      weights[3] = w3;
       break;
       }
     case 4:
       {
-      for ( unsigned int n = 0; n < ImageDimension; n++ )
-        {
-        w = x[n] + .5 - (double)EvaluateIndex[n][3];
-        t2 = w * w;
-        t = ( 1.0 / 6.0 ) * t2;
-        w1 = 0.5 - w;
-        w1 *= w1;
-        w1 *= ( 1.0 / 24.0 ) * w1;
-        t0 = w * ( t - 11.0 / 24.0 );
-        t1 = 19.0 / 96.0 + t2 * ( 0.25 - t );
-        w2 = t1 + t0;
-        w4 = t1 - t0;
-        w5 = w1 + t0 + 0.5 * w;
-        w3 = 1.0 - w1 - w2 - w4 - w5;
-
-        weights[n][0] = 0.0 - w1;
-        weights[n][1] = w1 - w2;
-        weights[n][2] = w2 - w3;
-        weights[n][3] = w3 - w4;
-        weights[n][4] = w4 - w5;
-        weights[n][5] = w5;
-        }
+      w = x + 0.5 - (double)( firstIndex + 2 );
+      w4 = ( 1.0 / 6.0 ) * w * w * w;
+      w1 = ( 1.0 / 6.0 ) + 0.5 * w * ( w - 1.0 ) - w4;
+      w3 = w + w1 - 2.0 * w4;
+      w2 = 1.0 - w1 - w3 - w4;
+
+      weights[0] = 0.0 - w1;
+      weights[1] = w1 - w2;
+      weights[2] = w2 - w3;
+      weights[3] = w3 - w4;
+      weights[4] = w4;
+      break;
+      }
+    case 5:
+      {
+      w = x + .5 - (double)( firstIndex + 3 );
+      t2 = w * w;
+      t = ( 1.0 / 6.0 ) * t2;
+      w1 = 0.5 - w;
+      w1 *= w1;
+      w1 *= ( 1.0 / 24.0 ) * w1;
+      t0 = w * ( t - 11.0 / 24.0 );
+      t1 = 19.0 / 96.0 + t2 * ( 0.25 - t );
+      w2 = t1 + t0;
+      w4 = t1 - t0;
+      w5 = w1 + t0 + 0.5 * w;
+      w3 = 1.0 - w1 - w2 - w4 - w5;
+
+      weights[0] = 0.0 - w1;
+      weights[1] = w1 - w2;
+      weights[2] = w2 - w3;
+      weights[3] = w3 - w4;
+      weights[4] = w4 - w5;
+      weights[5] = w5;
       break;
       }
     default:
@@ -624,6 +804,32 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
     }
 }
 
+template< class TImageType, class TCoordRep, class TCoefficientType >
+long
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::FirstIndexOfSupport(TCoordRep x, unsigned int splineOrder)
+{
+  long indx;
+
+  if ( splineOrder & 1 )     // Use this index calculation for odd splineOrder
+    {
+    indx = (long)x;
+    if ( indx < 0 && (double)indx != (double)x )
+      {
+      indx--;
+      }
+    }
+  else                       // Use this index calculation for even splineOrder
+    {
+    indx = (long)( x + 0.5 );
+    if ( indx < 0 && (double)indx != (double)( x + 0.5 ) )
+      {
+      indx--;
+      }
+    }
+  return indx - splineOrder / 2;
+}
+
 // Generates m_PointsToIndex;
 template< class TImageType, class TCoordRep, class TCoefficientType >
 void
@@ -680,39 +886,13 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
                            const ContinuousIndexType & x,
                            unsigned int splineOrder) const
 {
-  long indx;
-
-// compute the interpolation indexes
-  if ( splineOrder & 1 )     // Use this index calculation for odd splineOrder
-    {
-    for ( unsigned int n = 0; n < ImageDimension; n++ )
-      {
-      indx = (long)x[n];
-      if ( indx < 0 && (double)indx != (double)x[n] )
-        {
-        indx--;
-        }
-      indx -= splineOrder / 2;
-      for ( unsigned int k = 0; k <= splineOrder; k++ )
-        {
-        evaluateIndex[n][k] = indx++;
-        }
-      }
-    }
-  else                       // Use this index calculation for even splineOrder
+  // compute the interpolation indexes
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
     {
-    for ( unsigned int n = 0; n < ImageDimension; n++ )
+    long indx = FirstIndexOfSupport(x[n], splineOrder);
+    for ( unsigned int k = 0; k <= splineOrder; k++ )
       {
-      indx = (long)( x[n] + 0.5 );
-      if ( indx < 0 && (double)indx != (double)( x[n] + 0.5 ) )
-        {
-        indx--;
-        }
-      indx -= splineOrder / 2;
-      for ( unsigned int k = 0; k <= splineOrder; k++ )
-        {
-        evaluateIndex[n][k] = indx++;
-        }
+      evaluateIndex[n][k] = indx++;
       }
     }
 }
@@ -765,6 +945,13 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
                                     vnl_matrix< long > & evaluateIndex,
                                     vnl_matrix< double > & weights) const
 {
+  double value;
+
+  if ( this->EvaluateWithFixedSplineOrder(x, value, 0) )
+    {
+    return value;
+    }
+
   // compute the interpolation indexes
   this->DetermineRegionOfSupport( ( evaluateIndex ), x, m_SplineOrder );
 
@@ -804,6 +991,14 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
                                                       vnl_matrix< double > & weightsDerivative
                                                       ) const
 {
+  double realValue;
+
+  if ( this->EvaluateWithFixedSplineOrder(x, realValue, &derivativeValue) )
+    {
+    value = realValue;
+    return;
+    }
+
   this->DetermineRegionOfSupport( ( evaluateIndex ), x, m_SplineOrder );
 
   SetInterpolationWeights(x, ( evaluateIndex ), ( weights ), m_SplineOrder);
@@ -881,6 +1076,13 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
                                               vnl_matrix< double > & weightsDerivative
                                               ) const
 {
+  CovariantVectorType derivative;
+
+  if ( this->EvaluateDerivativeWithFixedSplineOrder(x, derivative) )
+    {
+    return derivative;
+    }
+
   this->DetermineRegionOfSupport( ( evaluateIndex ), x, m_SplineOrder );
 
   SetInterpolationWeights(x, ( evaluateIndex ), ( weights ), m_SplineOrder);
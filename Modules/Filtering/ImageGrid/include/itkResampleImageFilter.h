@@ -319,6 +319,18 @@ private:
 };
 } // end namespace itk
 
+// Define instantiation macro for this template.
+#define ITK_TEMPLATE_ResampleImageFilter(_, EXPORT, TypeX, TypeY)     \
+  namespace itk                                                       \
+  {                                                                   \
+  _( 3 ( class EXPORT ResampleImageFilter< ITK_TEMPLATE_3 TypeX > ) ) \
+  namespace Templates                                                 \
+  {                                                                   \
+  typedef ResampleImageFilter< ITK_TEMPLATE_3 TypeX >                 \
+  ResampleImageFilter##TypeY;                                         \
+  }                                                                   \
+  }
+
 #ifndef ITK_MANUAL_INSTANTIATION
 #include "itkResampleImageFilter.txx"
 #endif
@@ -26,6 +26,8 @@
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkSpecialCoordinatesImage.h"
 
+#include <vector>
+
 namespace itk
 {
 /**
@@ -412,6 +414,13 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
                                                     tmpInputIndex);
   delta = tmpInputIndex - inputIndex;
 
+  // The positions of a scanline that are inside the buffer are
+  // interpolated at once.
+  const SizeValueType                     lineLength = outputRegionForThread.GetSize(0);
+  std::vector< ContinuousInputIndexType > lineIndices(lineLength);
+  std::vector< OutputType >               lineValues(lineLength);
+  std::vector< unsigned char >            lineIsInside(lineLength);
+
   while ( !outIt.IsAtEnd() )
     {
     // Determine the continuous index of the first pixel of output
@@ -427,23 +436,30 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
     inputPoint = this->m_Transform->TransformPoint(outputPoint);
     inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
 
+    SizeValueType numberOfInside = 0;
+    for ( SizeValueType i = 0; i < lineLength; i++ )
+      {
+      lineIsInside[i] = m_Interpolator->IsInsideBuffer(inputIndex);
+      if ( lineIsInside[i] )
+        {
+        lineIndices[numberOfInside++] = inputIndex;
+        }
+      inputIndex += delta;
+      }
+
+    // Evaluate input at right position and copy to the output
+    m_Interpolator->EvaluateAtContinuousIndices(&lineIndices[0],
+                                                &lineValues[0],
+                                                numberOfInside);
+
+    SizeValueType pixel = 0;
+    SizeValueType inside = 0;
     while ( !outIt.IsAtEndOfLine() )
       {
-      // Evaluate input at right position and copy to the output
-      if ( m_Interpolator->IsInsideBuffer(inputIndex) )
+      if ( lineIsInside[pixel++] )
         {
-        PixelType  pixval;
-        OutputType value;
-        if ( m_InterpolatorIsBSpline )
-          {
-          value = m_BSplineInterpolator->EvaluateAtContinuousIndex(
-            inputIndex,
-            threadId);
-          }
-        else
-          {
-          value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
-          }
+        PixelType          pixval;
+        const OutputType & value = lineValues[inside++];
         //Check for value min/max
         if ( value <  minOutputValue )
           {
@@ -466,7 +482,6 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
 
       progress.CompletedPixel();
       ++outIt;
-      inputIndex += delta;
       }
     outIt.NextLine();
     } //while( !outIt.IsAtEnd() )
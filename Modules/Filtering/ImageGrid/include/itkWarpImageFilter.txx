@@ -25,6 +25,9 @@
 #include "itkProgressReporter.h"
 #include "itkContinuousIndex.h"
 #include "vnl/vnl_math.h"
+
+#include <vector>
+
 namespace itk
 {
 /**
@@ -306,26 +309,55 @@ WarpImageFilter< TInputImage, TOutputImage, TDeformationField >
   // support progress methods/callbacks
   ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
 
-  // iterator for the output image
+  typedef typename InterpolatorType::ContinuousIndexType ContinuousIndexType;
+  typedef typename InterpolatorType::OutputType          InterpolatorOutputType;
+
+  // iterators for the output image, the first one to compute the input
+  // positions and the second one to write the interpolated values
   ImageRegionIteratorWithIndex< OutputImageType > outputIt(
     outputPtr, outputRegionForThread);
-  IndexType        index;
-  PointType        point;
-  DisplacementType displacement;
+  ImageRegionIterator< OutputImageType > writeIt(
+    outputPtr, outputRegionForThread);
+
+  // iterator for the deformation field, when it has the same size as the
+  // output image
+  ImageRegionIterator< DeformationFieldType > fieldIt;
   if ( this->m_DefFieldSizeSame )
     {
-    // iterator for the deformation field
-    ImageRegionIterator< DeformationFieldType >
-    fieldIt(fieldPtr, outputRegionForThread);
+    fieldIt = ImageRegionIterator< DeformationFieldType >(fieldPtr, outputRegionForThread);
+    }
+
+  // The output is computed scanline by scanline: the positions of a
+  // scanline that are inside the input buffer are interpolated at once.
+  const SizeValueType                    lineLength = outputRegionForThread.GetSize(0);
+  std::vector< ContinuousIndexType >     lineIndices(lineLength);
+  std::vector< InterpolatorOutputType >  lineValues(lineLength);
+  std::vector< unsigned char >           lineIsInside(lineLength);
+
+  IndexType           index;
+  PointType           point;
+  DisplacementType    displacement;
+  ContinuousIndexType inputIndex;
 
-    while ( !outputIt.IsAtEnd() )
+  while ( !outputIt.IsAtEnd() )
+    {
+    SizeValueType numberOfInside = 0;
+    for ( SizeValueType i = 0; i < lineLength; i++ )
       {
       // get the output image index
       index = outputIt.GetIndex();
       outputPtr->TransformIndexToPhysicalPoint(index, point);
 
       // get the required displacement
-      displacement = fieldIt.Get();
+      if ( this->m_DefFieldSizeSame )
+        {
+        displacement = fieldIt.Get();
+        ++fieldIt;
+        }
+      else
+        {
+        displacement = this->EvaluateDeformationAtPhysicalPoint(point);
+        }
 
       // compute the required input image point
       for ( unsigned int j = 0; j < ImageDimension; j++ )
@@ -333,49 +365,32 @@ WarpImageFilter< TInputImage, TOutputImage, TDeformationField >
         point[j] += displacement[j];
         }
 
-      // get the interpolated value
-      if ( m_Interpolator->IsInsideBuffer(point) )
-        {
-        PixelType value =
-          static_cast< PixelType >( m_Interpolator->Evaluate(point) );
-        outputIt.Set(value);
-        }
-      else
+      inputPtr->TransformPhysicalPointToContinuousIndex(point, inputIndex);
+      lineIsInside[i] = m_Interpolator->IsInsideBuffer(inputIndex);
+      if ( lineIsInside[i] )
         {
-        outputIt.Set(m_EdgePaddingValue);
+        lineIndices[numberOfInside++] = inputIndex;
         }
       ++outputIt;
-      ++fieldIt;
-      progress.CompletedPixel();
       }
-    }
-  else
-    {
-    while ( !outputIt.IsAtEnd() )
-      {
-      // get the output image index
-      index = outputIt.GetIndex();
-      outputPtr->TransformIndexToPhysicalPoint(index, point);
 
-      displacement = this->EvaluateDeformationAtPhysicalPoint(point);
-      // compute the required input image point
-      for ( unsigned int j = 0; j < ImageDimension; j++ )
-        {
-        point[j] += displacement[j];
-        }
+    // get the interpolated values
+    m_Interpolator->EvaluateAtContinuousIndices(&lineIndices[0],
+                                                &lineValues[0],
+                                                numberOfInside);
 
-      // get the interpolated value
-      if ( m_Interpolator->IsInsideBuffer(point) )
+    SizeValueType inside = 0;
+    for ( SizeValueType i = 0; i < lineLength; i++ )
+      {
+      if ( lineIsInside[i] )
         {
-        PixelType value =
-          static_cast< PixelType >( m_Interpolator->Evaluate(point) );
-        outputIt.Set(value);
+        writeIt.Set( static_cast< PixelType >( lineValues[inside++] ) );
         }
       else
         {
-        outputIt.Set(m_EdgePaddingValue);
+        writeIt.Set(m_EdgePaddingValue);
         }
-      ++outputIt;
+      ++writeIt;
       progress.CompletedPixel();
       }
     }
@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <vector>
+
+// Check the specialized evaluation of BSplineInterpolateImageFunction:
+// the batch, thread and single position evaluations must agree, and a
+// linear ramp must be reproduced with its gradient far enough from the
+// borders, where the mirror boundary conditions have no influence. The
+// evaluations must also go through the protected methods a subclass
+// overrides.
+
+namespace
+{
+template< class TImage >
+class ConstantInterpolator:public itk::BSplineInterpolateImageFunction< TImage >
+{
+public:
+  typedef ConstantInterpolator                              Self;
+  typedef itk::BSplineInterpolateImageFunction< TImage >    Superclass;
+  typedef itk::SmartPointer< Self >                         Pointer;
+  typedef typename Superclass::OutputType                   OutputType;
+  typedef typename Superclass::ContinuousIndexType          ContinuousIndexType;
+
+  itkNewMacro(Self);
+
+protected:
+  ConstantInterpolator() {}
+
+  virtual OutputType EvaluateAtContinuousIndexInternal(const ContinuousIndexType &,
+                                                       vnl_matrix< long > &,
+                                                       vnl_matrix< double > &) const
+  {
+    return 42.0;
+  }
+
+private:
+  ConstantInterpolator(const Self &); //purposely not implemented
+  void operator=(const Self &);       //purposely not implemented
+};
+}
+
+int itkBSplineInterpolateImageFunctionBatchTest(int, char *[])
+{
+  const unsigned int Dimension = 2;
+  typedef float                                                 PixelType;
+  typedef itk::Image< PixelType, Dimension >                    ImageType;
+  typedef itk::BSplineInterpolateImageFunction< ImageType >     InterpolatorType;
+  typedef InterpolatorType::ContinuousIndexType                 ContinuousIndexType;
+  typedef InterpolatorType::OutputType                          OutputType;
+  typedef InterpolatorType::CovariantVectorType                 CovariantVectorType;
+
+  const double slope[Dimension] = { 1.5, -0.75 };
+
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -4;
+  ImageType::SizeType size;
+  size[0] = 50;
+  size[1] = 46;
+  ImageType::RegionType region(start, size);
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 2.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetSpacing(spacing);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( slope[0] * it.GetIndex()[0] + slope[1] * it.GetIndex()[1] );
+    }
+
+  // positions spread over the whole image, borders included
+  const unsigned int                 numberOfPositions = 500;
+  std::vector< ContinuousIndexType > positions(numberOfPositions);
+  for ( unsigned int i = 0; i < numberOfPositions; i++ )
+    {
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      const double t = vcl_fmod( 0.6180339887 * ( i + 1 ) * ( d + 2 ), 1.0 );
+      positions[i][d] = start[d] - 0.5 + t * size[d];
+      }
+    }
+
+  InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetNumberOfThreads(2);
+  interpolator->UseImageDirectionOff();
+
+  bool pass = true;
+  for ( unsigned int order = 0; order <= 5; order++ )
+    {
+    interpolator->SetSplineOrder(order);
+    interpolator->SetInputImage(image);
+
+    std::vector< OutputType > values(numberOfPositions);
+    interpolator->EvaluateAtContinuousIndices(&positions[0], &values[0], numberOfPositions);
+
+    for ( unsigned int i = 0; i < numberOfPositions; i++ )
+      {
+      const ContinuousIndexType & x = positions[i];
+
+      OutputType          value;
+      CovariantVectorType derivative;
+      interpolator->EvaluateValueAndDerivativeAtContinuousIndex(x, value, derivative, 1);
+
+      if ( values[i] != interpolator->EvaluateAtContinuousIndex(x)
+           || values[i] != interpolator->EvaluateAtContinuousIndex(x, 1)
+           || values[i] != value
+           || derivative != interpolator->EvaluateDerivativeAtContinuousIndex(x) )
+        {
+        std::cerr << "Order " << order << ": inconsistent evaluations at " << x << std::endl;
+        pass = false;
+        break;
+        }
+
+      bool interior = true;
+      for ( unsigned int d = 0; d < Dimension; d++ )
+        {
+        interior &= ( x[d] > start[d] + 18 && x[d] < start[d] + static_cast< double >( size[d] ) - 19 );
+        }
+      if ( order == 0 || !interior )
+        {
+        continue;
+        }
+
+      const double trueValue = slope[0] * x[0] + slope[1] * x[1];
+      if ( vnl_math_abs(value - trueValue) > 1e-4 )
+        {
+        std::cerr << "Order " << order << ": value at " << x << " is " << value
+                  << " instead of " << trueValue << std::endl;
+        pass = false;
+        break;
+        }
+      for ( unsigned int d = 0; d < Dimension; d++ )
+        {
+        if ( vnl_math_abs(derivative[d] - slope[d] / spacing[d]) > 1e-4 )
+          {
+          std::cerr << "Order " << order << ": derivative at " << x << " is " << derivative
+                    << std::endl;
+          pass = false;
+          break;
+          }
+        }
+      }
+    }
+
+  ConstantInterpolator< ImageType >::Pointer constant = ConstantInterpolator< ImageType >::New();
+  constant->SetInputImage(image);
+  std::vector< OutputType > constantValues(numberOfPositions);
+  constant->EvaluateAtContinuousIndices(&positions[0], &constantValues[0], numberOfPositions);
+  if ( constantValues[numberOfPositions - 1] != 42.0
+       || constant->EvaluateAtContinuousIndex(positions[0]) != 42.0
+       || constant->EvaluateAtContinuousIndex(positions[0], 0) != 42.0 )
+    {
+    std::cerr << "The evaluation overridden by a subclass is not used" << std::endl;
+    pass = false;
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed" << std::endl;
+  return EXIT_SUCCESS;
+}
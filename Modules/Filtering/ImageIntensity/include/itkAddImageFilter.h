@@ -94,6 +94,14 @@ public:
   }
 };
 }
+
+/** Compute the spans of float and double pixels by vectors */
+template< class TInput1, class TInput2, class TOutput >
+class BatchFunctorTraits< Functor::Add2< TInput1, TInput2, TOutput > >:
+  public BinaryBatchFunctorTraits< Functor::Add2< TInput1, TInput2, TOutput >,
+                                   BatchFunctorDetail::AddOperation >
+{};
+
 template< class TInputImage1, class TInputImage2 = TInputImage1, class TOutputImage = TInputImage1 >
 class ITK_EXPORT AddImageFilter:
   public
@@ -67,6 +67,13 @@ public:
 };
 }
 
+/** Compute the spans of float and double pixels by vectors */
+template< class TInput1, class TInput2, class TOutput >
+class BatchFunctorTraits< Functor::Div< TInput1, TInput2, TOutput > >:
+  public BinaryBatchFunctorTraits< Functor::Div< TInput1, TInput2, TOutput >,
+                                   BatchFunctorDetail::DivideOperation >
+{};
+
 template< class TInputImage1, class TInputImage2, class TOutputImage >
 class ITK_EXPORT DivideImageFilter:
   public
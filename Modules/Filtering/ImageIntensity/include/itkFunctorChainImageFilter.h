@@ -0,0 +1,349 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFunctorChainImageFilter_h
+#define __itkFunctorChainImageFilter_h
+
+#include "itkInPlaceImageFilter.h"
+#include "itkImageRegionSpans.h"
+#include "itkBatchFunctorTraits.h"
+#include <typeinfo>
+#include <vector>
+
+namespace itk
+{
+/** \class FunctorChainStage
+ * \brief A pixel-wise operation of a FunctorChainImageFilter.
+ *
+ * A stage applies a functor to arrays of pixels.  The pixel types of its
+ * input and output are only known at run time, through GetInputPixelType()
+ * and GetOutputPixelType(), so that the stages of any types can be chained
+ * in a filter.
+ *
+ * \sa FunctorChainImageFilter
+ * \ingroup ITK-ImageIntensity
+ */
+class FunctorChainStage:public LightObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef FunctorChainStage          Self;
+  typedef LightObject                Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FunctorChainStage, LightObject);
+
+  virtual const std::type_info & GetInputPixelType() const = 0;
+
+  virtual const std::type_info & GetOutputPixelType() const = 0;
+
+  /** Called by the filter before it applies the chain */
+  virtual void Initialize() {}
+
+  /** Modification time of the operation, for the stages that depend on
+   * some object */
+  virtual unsigned long GetMTime() const { return 0; }
+
+  /** Apply the operation to the n pixels of the input array, writing the
+   * output array.  The arrays must be of the input and output pixel
+   * types. */
+  virtual void Apply(const void *input, void *output, SizeValueType n) = 0;
+
+  /** Allocate and delete an array of n pixels of the output type */
+  virtual void * NewOutputArray(SizeValueType n) const = 0;
+
+  virtual void DeleteOutputArray(void *array) const = 0;
+
+protected:
+  FunctorChainStage() {}
+  virtual ~FunctorChainStage() {}
+
+private:
+  FunctorChainStage(const Self &); //purposely not implemented
+  void operator=(const Self &);    //purposely not implemented
+};
+
+/** \class FunctorChainFunctorStage
+ * \brief A stage of a FunctorChainImageFilter applying a functor.
+ *
+ * The functor is applied through BatchFunctorTraits, as in
+ * UnaryFunctorImageFilter.
+ *
+ * \sa FunctorChainImageFilter
+ * \ingroup ITK-ImageIntensity
+ */
+template< class TInputPixel, class TOutputPixel, class TFunction >
+class FunctorChainFunctorStage:public FunctorChainStage
+{
+public:
+  /** Standard class typedefs. */
+  typedef FunctorChainFunctorStage   Self;
+  typedef FunctorChainStage          Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FunctorChainFunctorStage, FunctorChainStage);
+
+  typedef TInputPixel  InputPixelType;
+  typedef TOutputPixel OutputPixelType;
+  typedef TFunction    FunctorType;
+
+  FunctorType & GetFunctor() { return m_Functor; }
+  const FunctorType & GetFunctor() const { return m_Functor; }
+
+  void SetFunctor(const FunctorType & functor) { m_Functor = functor; }
+
+  virtual const std::type_info & GetInputPixelType() const
+  { return typeid( InputPixelType ); }
+
+  virtual const std::type_info & GetOutputPixelType() const
+  { return typeid( OutputPixelType ); }
+
+  virtual void Apply(const void *input, void *output, SizeValueType n)
+  {
+    BatchFunctorTraits< FunctorType >::Apply( m_Functor,
+                                              static_cast< const InputPixelType * >( input ),
+                                              static_cast< OutputPixelType * >( output ), n );
+  }
+
+  virtual void * NewOutputArray(SizeValueType n) const
+  { return new OutputPixelType[n]; }
+
+  virtual void DeleteOutputArray(void *array) const
+  { delete[] static_cast< OutputPixelType * >( array ); }
+
+protected:
+  FunctorChainFunctorStage() {}
+  virtual ~FunctorChainFunctorStage() {}
+
+private:
+  FunctorChainFunctorStage(const Self &); //purposely not implemented
+  void operator=(const Self &);           //purposely not implemented
+
+  FunctorType m_Functor;
+};
+
+/** \class FunctorChainFilterStage
+ * \brief A stage of a FunctorChainImageFilter applying the functor of a
+ * UnaryFunctorImageFilter.
+ *
+ * The functor is copied from the filter each time the chain runs, so the
+ * filter can still be modified after it is added to the chain.  The filter
+ * itself is not executed: the filters which set their functor when they
+ * run, like RescaleIntensityImageFilter or IntensityWindowingImageFilter,
+ * must be added to the chain by their functor instead.
+ *
+ * \sa FunctorChainImageFilter
+ * \ingroup ITK-ImageIntensity
+ */
+template< class TFilter >
+class FunctorChainFilterStage:
+  public FunctorChainFunctorStage< typename TFilter::InputImagePixelType,
+                                   typename TFilter::OutputImagePixelType,
+                                   typename TFilter::FunctorType >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FunctorChainFilterStage Self;
+  typedef FunctorChainFunctorStage< typename TFilter::InputImagePixelType,
+                                    typename TFilter::OutputImagePixelType,
+                                    typename TFilter::FunctorType > Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FunctorChainFilterStage, FunctorChainFunctorStage);
+
+  typedef TFilter FilterType;
+
+  void SetFilter(const FilterType *filter) { m_Filter = filter; }
+  const FilterType * GetFilter() const { return m_Filter.GetPointer(); }
+
+  virtual void Initialize()
+  { this->SetFunctor( m_Filter->GetFunctor() ); }
+
+  virtual unsigned long GetMTime() const
+  { return m_Filter->GetMTime(); }
+
+protected:
+  FunctorChainFilterStage() {}
+  virtual ~FunctorChainFilterStage() {}
+
+private:
+  FunctorChainFilterStage(const Self &); //purposely not implemented
+  void operator=(const Self &);          //purposely not implemented
+
+  typename FilterType::ConstPointer m_Filter;
+};
+
+/** \class FunctorChainImageFilter
+ * \brief Applies a chain of pixel-wise functors in a single pass.
+ *
+ * A pipeline of pixel-wise filters, like a ShiftScaleImageFilter, a
+ * SigmoidImageFilter and a CastImageFilter, allocates and computes a full
+ * image at each filter.  FunctorChainImageFilter applies the functors of
+ * such filters one after the other to each pixel, in a single multithreaded
+ * pass over the input image, without any intermediate image: the pixels are
+ * processed by blocks of BlockSize pixels, small enough for the
+ * intermediate values of the block to stay in the cache.
+ *
+ * The stages of the chain are added in order, either as functors, with
+ * AddFunctor(), or as UnaryFunctorImageFilter objects, with AddFilter(),
+ * whose functors are read each time the chain runs.  The input pixel type
+ * of a stage must be the output pixel type of the previous stage, the input
+ * pixel type of the first stage must be the pixel type of the input image,
+ * and the output pixel type of the last stage the pixel type of the output
+ * image.  These types are checked when the filter runs.
+ *
+ *     chain->AddFunctor< short, float >(linearTransform);
+ *     chain->AddFilter(sigmoid);
+ *     chain->AddFilter(cast);
+ *
+ * When the pixels of the images can be accessed directly in their buffers,
+ * the blocks are read from and written to the buffers.
+ *
+ * \sa UnaryFunctorImageFilter BatchFunctorTraits
+ * \ingroup IntensityImageFilters  Multithreaded
+ * \ingroup ITK-ImageIntensity
+ */
+template< class TInputImage, class TOutputImage >
+class ITK_EXPORT FunctorChainImageFilter:
+  public InPlaceImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FunctorChainImageFilter                         Self;
+  typedef InPlaceImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FunctorChainImageFilter, InPlaceImageFilter);
+
+  /** Some typedefs. */
+  typedef TInputImage                              InputImageType;
+  typedef typename    InputImageType::ConstPointer InputImagePointer;
+  typedef typename    InputImageType::RegionType   InputImageRegionType;
+  typedef typename    InputImageType::PixelType    InputImagePixelType;
+
+  typedef TOutputImage                             OutputImageType;
+  typedef typename     OutputImageType::Pointer    OutputImagePointer;
+  typedef typename     OutputImageType::RegionType OutputImageRegionType;
+  typedef typename     OutputImageType::PixelType  OutputImagePixelType;
+
+  typedef FunctorChainStage StageType;
+
+  /** Number of pixels processed at once by each stage */
+  itkStaticConstMacro(BlockSize, SizeValueType, 512);
+
+  /** Append a functor to the chain */
+  template< class TInputPixel, class TOutputPixel, class TFunction >
+  void AddFunctor(const TFunction & functor)
+  {
+    typename FunctorChainFunctorStage< TInputPixel, TOutputPixel, TFunction >::Pointer stage =
+      FunctorChainFunctorStage< TInputPixel, TOutputPixel, TFunction >::New();
+    stage->SetFunctor(functor);
+    this->AddStage(stage);
+  }
+
+  /** Append the functor of a UnaryFunctorImageFilter to the chain */
+  template< class TFilter >
+  void AddFilter(const TFilter *filter)
+  {
+    typename FunctorChainFilterStage< TFilter >::Pointer stage = FunctorChainFilterStage< TFilter >::New();
+    stage->SetFilter(filter);
+    this->AddStage(stage);
+  }
+
+  /** Append a stage to the chain */
+  void AddStage(StageType *stage);
+
+  /** Remove all the stages */
+  void ClearStages();
+
+  unsigned int GetNumberOfStages() const
+  { return static_cast< unsigned int >( m_Stages.size() ); }
+
+  StageType * GetStage(unsigned int i)
+  { return m_Stages[i]; }
+
+  /** The filter is also modified when a stage is */
+  virtual unsigned long GetMTime() const;
+
+protected:
+  FunctorChainImageFilter() {}
+  virtual ~FunctorChainImageFilter() {}
+
+  /** Check the pixel types of the stages and initialize them */
+  void BeforeThreadedGenerateData();
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  FunctorChainImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);          //purposely not implemented
+
+  /** The intermediate blocks of a thread */
+  class IntermediateBlocks
+  {
+public:
+    IntermediateBlocks(const std::vector< StageType::Pointer > & stages);
+    ~IntermediateBlocks();
+    void * GetOutput(unsigned int stage) { return m_Blocks[stage]; }
+private:
+    const std::vector< StageType::Pointer > & m_Stages;
+    std::vector< void * >                               m_Blocks;
+  };
+
+  /** Apply the stages to n <= BlockSize pixels */
+  void ApplyStages(IntermediateBlocks & blocks, const InputImagePixelType *input,
+                   OutputImagePixelType *output, SizeValueType n);
+
+  /** Apply the chain to the spans of pixels of the buffers.  Return false
+   * if the images cannot be walked by spans. */
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId,
+                                    const ImageToImageFilterDetail::BooleanDispatch< true > &);
+
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType &, ThreadIdType,
+                                    const ImageToImageFilterDetail::BooleanDispatch< false > &)
+  { return false; }
+
+  std::vector< StageType::Pointer > m_Stages;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFunctorChainImageFilter.txx"
+#endif
+
+#endif
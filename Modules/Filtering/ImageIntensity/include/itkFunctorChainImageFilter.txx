@@ -0,0 +1,263 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFunctorChainImageFilter_txx
+#define __itkFunctorChainImageFilter_txx
+
+#include "itkFunctorChainImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+namespace itk
+{
+template< class TInputImage, class TOutputImage >
+void
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::AddStage(StageType *stage)
+{
+  if ( stage == 0 )
+    {
+    itkExceptionMacro(<< "Null stage");
+    }
+  m_Stages.push_back(stage);
+  this->Modified();
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::ClearStages()
+{
+  if ( !m_Stages.empty() )
+    {
+    m_Stages.clear();
+    this->Modified();
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+unsigned long
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::GetMTime() const
+{
+  unsigned long mtime = Superclass::GetMTime();
+
+  for ( unsigned int i = 0; i < m_Stages.size(); i++ )
+    {
+    const unsigned long stageMTime = m_Stages[i]->GetMTime();
+    if ( stageMTime > mtime )
+      {
+      mtime = stageMTime;
+      }
+    }
+  return mtime;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  if ( m_Stages.empty() )
+    {
+    itkExceptionMacro(<< "The chain has no stage");
+    }
+
+  const std::type_info *pixelType = &typeid( InputImagePixelType );
+  for ( unsigned int i = 0; i < m_Stages.size(); i++ )
+    {
+    if ( m_Stages[i]->GetInputPixelType() != *pixelType )
+      {
+      itkExceptionMacro(<< "The input pixel type of the stage " << i << ", "
+                        << m_Stages[i]->GetInputPixelType().name()
+                        << ", is not the output pixel type of the previous stage, "
+                        << pixelType->name());
+      }
+    pixelType = &m_Stages[i]->GetOutputPixelType();
+    }
+  if ( *pixelType != typeid( OutputImagePixelType ) )
+    {
+    itkExceptionMacro(<< "The output pixel type of the last stage, " << pixelType->name()
+                      << ", is not the pixel type of the output image, "
+                      << typeid( OutputImagePixelType ).name());
+    }
+
+  for ( unsigned int i = 0; i < m_Stages.size(); i++ )
+    {
+    m_Stages[i]->Initialize();
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+FunctorChainImageFilter< TInputImage, TOutputImage >::IntermediateBlocks
+::IntermediateBlocks(const std::vector< StageType::Pointer > & stages):
+  m_Stages(stages),
+  m_Blocks(stages.size(), static_cast< void * >( 0 ))
+{
+  // the last stage writes the output directly
+  for ( unsigned int i = 0; i + 1 < m_Stages.size(); i++ )
+    {
+    m_Blocks[i] = m_Stages[i]->NewOutputArray(BlockSize);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+FunctorChainImageFilter< TInputImage, TOutputImage >::IntermediateBlocks
+::~IntermediateBlocks()
+{
+  for ( unsigned int i = 0; i < m_Blocks.size(); i++ )
+    {
+    if ( m_Blocks[i] )
+      {
+      m_Stages[i]->DeleteOutputArray(m_Blocks[i]);
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::ApplyStages(IntermediateBlocks & blocks, const InputImagePixelType *input,
+              OutputImagePixelType *output, SizeValueType n)
+{
+  const unsigned int last = static_cast< unsigned int >( m_Stages.size() ) - 1;
+  const void *       stageInput = input;
+
+  for ( unsigned int i = 0; i < last; i++ )
+    {
+    m_Stages[i]->Apply( stageInput, blocks.GetOutput(i), n );
+    stageInput = blocks.GetOutput(i);
+    }
+  m_Stages[last]->Apply(stageInput, output, n);
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    DirectBufferAccessTraits< TInputImage >::Supported
+    && DirectBufferAccessTraits< TOutputImage >::Supported
+    && (unsigned int)TInputImage::ImageDimension == (unsigned int)TOutputImage::ImageDimension >
+  SpansDispatchType;
+
+  if ( this->ThreadedGenerateDataForSpans( outputRegionForThread, threadId, SpansDispatchType() ) )
+    {
+    return;
+    }
+
+  InputImagePointer  inputPtr = this->GetInput();
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  InputImageRegionType inputRegionForThread;
+  this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
+
+  ImageRegionConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
+  ImageRegionIterator< TOutputImage >     outputIt(outputPtr, outputRegionForThread);
+
+  const SizeValueType numberOfPixels = outputRegionForThread.GetNumberOfPixels();
+  ProgressReporter    progress( this, threadId, ( numberOfPixels + BlockSize - 1 ) / BlockSize );
+
+  IntermediateBlocks                  blocks(m_Stages);
+  std::vector< InputImagePixelType >  inputBlock(BlockSize);
+  std::vector< OutputImagePixelType > outputBlock(BlockSize);
+
+  // gather the pixels of a block, apply the chain and scatter them back
+  inputIt.GoToBegin();
+  outputIt.GoToBegin();
+  while ( !inputIt.IsAtEnd() )
+    {
+    SizeValueType n = 0;
+    while ( n < BlockSize && !inputIt.IsAtEnd() )
+      {
+      inputBlock[n++] = inputIt.Get();
+      ++inputIt;
+      }
+    this->ApplyStages(blocks, &inputBlock[0], &outputBlock[0], n);
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      outputIt.Set(outputBlock[i]);
+      ++outputIt;
+      }
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+bool
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId,
+                               const ImageToImageFilterDetail::BooleanDispatch< true > &)
+{
+  InputImagePointer  inputPtr = this->GetInput();
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  // the input region may be moved or reshaped by a subclass
+  InputImageRegionType inputRegionForThread;
+  this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
+  if ( !( inputRegionForThread == outputRegionForThread ) )
+    {
+    return false;
+    }
+
+  ImageRegionSpans< TOutputImage::ImageDimension > spans(outputRegionForThread);
+  spans.AddBufferedRegion( inputPtr->GetBufferedRegion() );
+  spans.AddBufferedRegion( outputPtr->GetBufferedRegion() );
+
+  const InputImagePixelType *inputBuffer = inputPtr->GetBufferPointer();
+  OutputImagePixelType *     outputBuffer = outputPtr->GetBufferPointer();
+  const SizeValueType        length = spans.GetSpanLength();
+
+  ProgressReporter progress( this, threadId, spans.GetNumberOfSpans() );
+
+  IntermediateBlocks blocks(m_Stages);
+
+  for ( spans.GoToBegin(); !spans.IsAtEnd(); ++spans )
+    {
+    const InputImagePixelType *input = inputBuffer + inputPtr->ComputeOffset( spans.GetIndex() );
+    OutputImagePixelType *     output = outputBuffer + outputPtr->ComputeOffset( spans.GetIndex() );
+    for ( SizeValueType offset = 0; offset < length; offset += BlockSize )
+      {
+      const SizeValueType n = std::min( length - offset, static_cast< SizeValueType >( BlockSize ) );
+      this->ApplyStages(blocks, input + offset, output + offset, n);
+      }
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+  return true;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FunctorChainImageFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfStages: " << m_Stages.size() << std::endl;
+  for ( unsigned int i = 0; i < m_Stages.size(); i++ )
+    {
+    os << indent << "Stage " << i << ": " << m_Stages[i]->GetNameOfClass() << " ("
+       << m_Stages[i]->GetInputPixelType().name() << " -> "
+       << m_Stages[i]->GetOutputPixelType().name() << ")" << std::endl;
+    }
+}
+} // end namespace itk
+
+#endif
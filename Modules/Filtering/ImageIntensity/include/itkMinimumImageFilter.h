@@ -62,6 +62,13 @@ public:
 };
 }
 
+/** Compute the spans of float and double pixels by vectors */
+template< class TInput1, class TInput2, class TOutput >
+class BatchFunctorTraits< Functor::Minimum< TInput1, TInput2, TOutput > >:
+  public BinaryBatchFunctorTraits< Functor::Minimum< TInput1, TInput2, TOutput >,
+                                   BatchFunctorDetail::MinimumOperation >
+{};
+
 template< class TInputImage1, class TInputImage2 = TInputImage1, class TOutputImage = TInputImage1 >
 class ITK_EXPORT MinimumImageFilter:
   public
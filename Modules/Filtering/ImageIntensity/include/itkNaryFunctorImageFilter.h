@@ -21,6 +21,7 @@
 #include "itkInPlaceImageFilter.h"
 #include "itkImageIterator.h"
 #include "itkArray.h"
+#include "itkImageRegionSpans.h"
 
 namespace itk
 {
@@ -34,6 +35,9 @@ namespace itk
  *
  * All the input images are of the same type.
  *
+ * When the pixels of the images can be accessed directly in their buffers,
+ * the pixels are read in the spans of pixels contiguous in the buffers.
+ *
  * \ingroup IntensityImageFilters   Multithreaded
  * \ingroup ITK-ImageIntensity
  */
@@ -123,6 +127,16 @@ private:
   NaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);         //purposely not implemented
 
+  /** Apply the functor to the spans of pixels of the buffers.  Return false
+   * if the images cannot be walked by spans. */
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId,
+                                    const ImageToImageFilterDetail::BooleanDispatch< true > &);
+
+  bool ThreadedGenerateDataForSpans(const OutputImageRegionType &, ThreadIdType,
+                                    const ImageToImageFilterDetail::BooleanDispatch< false > &)
+  { return false; }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
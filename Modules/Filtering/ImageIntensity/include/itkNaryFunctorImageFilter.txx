@@ -46,6 +46,16 @@ NaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    DirectBufferAccessTraits< TInputImage >::Supported
+    && DirectBufferAccessTraits< TOutputImage >::Supported >
+  SpansDispatchType;
+
+  if ( this->ThreadedGenerateDataForSpans( outputRegionForThread, threadId, SpansDispatchType() ) )
+    {
+    return;
+    }
+
   const unsigned int numberOfInputImages =
     static_cast< unsigned int >( this->GetNumberOfInputs() );
 
@@ -110,6 +120,66 @@ NaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
     delete ( *regionIterators++ );
     }
 }
+
+template< class TInputImage, class TOutputImage, class TFunction >
+bool
+NaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::ThreadedGenerateDataForSpans(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId,
+                               const ImageToImageFilterDetail::BooleanDispatch< true > &)
+{
+  const unsigned int numberOfInputImages =
+    static_cast< unsigned int >( this->GetNumberOfInputs() );
+
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  ImageRegionSpans< TOutputImage::ImageDimension > spans(outputRegionForThread);
+  spans.AddBufferedRegion( outputPtr->GetBufferedRegion() );
+
+  std::vector< const TInputImage * > inputs;
+  inputs.reserve(numberOfInputImages);
+  for ( unsigned int i = 0; i < numberOfInputImages; ++i )
+    {
+    const TInputImage *inputPtr = dynamic_cast< TInputImage * >( ProcessObject::GetInput(i) );
+    if ( inputPtr )
+      {
+      inputs.push_back(inputPtr);
+      spans.AddBufferedRegion( inputPtr->GetBufferedRegion() );
+      }
+    }
+
+  ProgressReporter progress( this, threadId, spans.GetNumberOfSpans() );
+
+  const unsigned int numberOfValidInputImages = inputs.size();
+  if ( numberOfValidInputImages == 0 )
+    {
+    return true;
+    }
+
+  NaryArrayType                              naryInputArray(numberOfValidInputImages);
+  std::vector< const InputImagePixelType * > inputSpans(numberOfValidInputImages);
+  OutputImagePixelType *                     outputBuffer = outputPtr->GetBufferPointer();
+  const SizeValueType                        length = spans.GetSpanLength();
+
+  for ( spans.GoToBegin(); !spans.IsAtEnd(); ++spans )
+    {
+    for ( unsigned int k = 0; k < numberOfValidInputImages; ++k )
+      {
+      inputSpans[k] = inputs[k]->GetBufferPointer() + inputs[k]->ComputeOffset( spans.GetIndex() );
+      }
+    OutputImagePixelType *outputSpan = outputBuffer + outputPtr->ComputeOffset( spans.GetIndex() );
+    for ( SizeValueType i = 0; i < length; ++i )
+      {
+      for ( unsigned int k = 0; k < numberOfValidInputImages; ++k )
+        {
+        naryInputArray[k] = inputSpans[k][i];
+        }
+      outputSpan[i] = m_Functor(naryInputArray);
+      }
+    progress.CompletedPixel();
+    }
+  return true;
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,228 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFunctorChainImageFilter.h"
+#include "itkRescaleIntensityImageFilter.h"
+#include "itkSigmoidImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkAddImageAdaptor.h"
+#include "itkImageRegionIterator.h"
+#include "itkTimeProbe.h"
+
+// A shift-scale-clamp, a sigmoid and a cast applied by a
+// FunctorChainImageFilter must give the output of the same filters run one
+// after the other, for the whole image, for a requested region, and when
+// the input pixels are read through an adaptor.
+
+namespace
+{
+const unsigned int Dimension = 3;
+
+typedef itk::Image< short, Dimension >         InputImageType;
+typedef itk::Image< float, Dimension >         RealImageType;
+typedef itk::Image< unsigned char, Dimension > OutputImageType;
+
+typedef itk::Functor::IntensityLinearTransform< short, float > LinearTransformType;
+
+typedef itk::UnaryFunctorImageFilter< InputImageType, RealImageType, LinearTransformType > LinearFilterType;
+typedef itk::SigmoidImageFilter< RealImageType, RealImageType >                          SigmoidFilterType;
+typedef itk::CastImageFilter< RealImageType, OutputImageType >                           CastFilterType;
+
+typedef itk::FunctorChainImageFilter< InputImageType, OutputImageType > ChainFilterType;
+
+InputImageType::Pointer CreateImage(const InputImageType::RegionType & region)
+{
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  unsigned int                              seed = 1;
+  itk::ImageRegionIterator< InputImageType > it( image, region );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    seed = seed * 1103515245u + 12345u;
+    it.Set( static_cast< short >( ( seed >> 16 ) % 4001 ) - 2000 );
+    }
+  return image;
+}
+
+bool Compare(const OutputImageType *output, const OutputImageType *expected,
+             const OutputImageType::RegionType & region, const char *name)
+{
+  itk::ImageRegionConstIterator< OutputImageType > it(output, region);
+  itk::ImageRegionConstIterator< OutputImageType > et(expected, region);
+  for (; !it.IsAtEnd(); ++it, ++et )
+    {
+    if ( it.Get() != et.Get() )
+      {
+      std::cerr << name << ": at " << it.GetIndex() << " got "
+                << static_cast< int >( it.Get() ) << " instead of "
+                << static_cast< int >( et.Get() ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkFunctorChainImageFilterTest(int, char * [])
+{
+  InputImageType::SizeType size;
+  size[0] = 67;
+  size[1] = 45;
+  size[2] = 23;
+  InputImageType::RegionType region(size);
+
+  InputImageType::Pointer input = CreateImage(region);
+
+  LinearTransformType linearTransform;
+  linearTransform.SetFactor(0.01);
+  linearTransform.SetOffset(2.0);
+  linearTransform.SetMinimum(-10.0f);
+  linearTransform.SetMaximum(15.0f);
+
+  // the unfused pipeline
+  LinearFilterType::Pointer linear = LinearFilterType::New();
+  linear->SetInput(input);
+  linear->SetFunctor(linearTransform);
+
+  SigmoidFilterType::Pointer sigmoid = SigmoidFilterType::New();
+  sigmoid->SetInput( linear->GetOutput() );
+  sigmoid->SetAlpha(3.0);
+  sigmoid->SetBeta(1.5);
+  sigmoid->SetOutputMinimum(0.0f);
+  sigmoid->SetOutputMaximum(255.0f);
+
+  CastFilterType::Pointer cast = CastFilterType::New();
+  cast->SetInput( sigmoid->GetOutput() );
+
+  itk::TimeProbe pipelineTime;
+  pipelineTime.Start();
+  cast->Update();
+  pipelineTime.Stop();
+
+  // the same stages in a single filter, the sigmoid and the cast being
+  // read from the filters of the pipeline
+  ChainFilterType::Pointer chain = ChainFilterType::New();
+  chain->SetInput(input);
+  chain->AddFunctor< short, float >(linearTransform);
+  chain->AddFilter( sigmoid.GetPointer() );
+  chain->AddFilter( cast.GetPointer() );
+  std::cout << chain;
+
+  if ( chain->GetNumberOfStages() != 3 )
+    {
+    std::cerr << "The chain has " << chain->GetNumberOfStages() << " stages" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::TimeProbe chainTime;
+  chainTime.Start();
+  chain->Update();
+  chainTime.Stop();
+
+  std::cout << "Pipeline: " << pipelineTime.GetMeanTime()
+            << " s, chain: " << chainTime.GetMeanTime() << " s" << std::endl;
+
+  // a single filter and a single output image
+  if ( chain->GetNumberOfOutputs() != 1 || chain->GetNumberOfInputs() != 1 )
+    {
+    std::cerr << "The chain is not a single filter" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( !Compare(chain->GetOutput(), cast->GetOutput(), region, "Whole image") )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the chain follows the modifications of the filters of its stages
+  sigmoid->SetBeta(-0.5);
+  cast->Update();
+  chain->Update();
+  if ( !Compare(chain->GetOutput(), cast->GetOutput(), region, "Modified stage") )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // a requested region that is not contiguous in the buffers
+  OutputImageType::RegionType subRegion = region;
+  subRegion.SetIndex(0, 5);
+  subRegion.SetSize(0, 50);
+  subRegion.SetIndex(2, 3);
+  subRegion.SetSize(2, 10);
+  chain->GetOutput()->SetRequestedRegion(subRegion);
+  chain->Update();
+  if ( !Compare(chain->GetOutput(), cast->GetOutput(), subRegion, "Requested region") )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // an input read through an adaptor is processed by blocks of pixels
+  // gathered by iterators
+  typedef itk::AddImageAdaptor< InputImageType >                 AdaptorType;
+  typedef itk::FunctorChainImageFilter< AdaptorType, OutputImageType > AdaptorChainFilterType;
+
+  AdaptorType::Pointer adaptor = AdaptorType::New();
+  adaptor->SetImage(input);
+  adaptor->SetValue(0);
+
+  AdaptorChainFilterType::Pointer adaptorChain = AdaptorChainFilterType::New();
+  adaptorChain->SetInput(adaptor);
+  adaptorChain->AddFunctor< short, float >(linearTransform);
+  adaptorChain->AddFilter( sigmoid.GetPointer() );
+  adaptorChain->AddFilter( cast.GetPointer() );
+  adaptorChain->Update();
+  if ( !Compare(adaptorChain->GetOutput(), cast->GetOutput(), region, "Adaptor") )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the pixel types of the stages must follow each other
+  ChainFilterType::Pointer badChain = ChainFilterType::New();
+  badChain->SetInput(input);
+  badChain->AddFunctor< short, float >(linearTransform);
+  badChain->AddFilter( cast.GetPointer() );
+  badChain->AddFilter( cast.GetPointer() );
+  try
+    {
+    badChain->Update();
+    std::cerr << "No exception for mismatched stages" << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    }
+
+  ChainFilterType::Pointer emptyChain = ChainFilterType::New();
+  emptyChain->SetInput(input);
+  try
+    {
+    emptyChain->Update();
+    std::cerr << "No exception for an empty chain" << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,459 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAddImageFilter.h"
+#include "itkSubtractImageFilter.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkDivideImageFilter.h"
+#include "itkMinimumImageFilter.h"
+#include "itkMaximumImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkTernaryMagnitudeImageFilter.h"
+#include "itkNaryAddImageFilter.h"
+#include "itkVectorIndexSelectionCastImageFilter.h"
+#include "itkAddImageAdaptor.h"
+#include "itkVectorImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkTimeProbe.h"
+
+// The functor image filters apply their functor to the spans of pixels of
+// the buffers, with vectorized implementations for some functors.  Their
+// output must be the output of the functor on each pixel, for the whole
+// images, for regions that are not contiguous in the buffers, with
+// constants, in place, and for the images that are not walked by spans.
+
+namespace
+{
+const unsigned int Dimension = 3;
+
+unsigned int randomSeed = 1;
+
+// A few zeros, small integers, and values of both signs
+double RandomValue()
+{
+  randomSeed = randomSeed * 1103515245u + 12345u;
+  const int value = static_cast< int >( ( randomSeed >> 16 ) % 2001 ) - 1000;
+  if ( value % 13 == 0 )
+    {
+    return 0;
+    }
+  return value / 7.0;
+}
+
+template< class TImage >
+typename TImage::Pointer CreateImage(const typename TImage::RegionType & region)
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIterator< TImage > it( image, region );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< typename TImage::PixelType >( RandomValue() ) );
+    }
+  return image;
+}
+
+// Same value, or both NaN
+template< class T >
+bool Same(const T & a, const T & b)
+{
+  return a == b || ( a != a && b != b );
+}
+
+template< class TOutputImage, class TExpected >
+bool CheckOutput(const char *name, const TOutputImage *output,
+                 const typename TOutputImage::RegionType & region, TExpected expected)
+{
+  itk::ImageRegionConstIterator< TOutputImage > it(output, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    const typename TOutputImage::PixelType value = expected( it.GetIndex() );
+    if ( !Same(it.Get(), value) )
+      {
+      std::cerr << name << ": " << it.Get() << " instead of " << value
+                << " at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// The expected outputs of a binary filter
+template< class TFilter >
+class BinaryExpected
+{
+public:
+  typedef typename TFilter::Input1ImageType Input1ImageType;
+  typedef typename TFilter::Input2ImageType Input2ImageType;
+  typedef typename TFilter::OutputImagePixelType OutputPixelType;
+  typedef typename Input1ImageType::IndexType IndexType;
+
+  BinaryExpected(TFilter *filter, const Input1ImageType *input1, const Input2ImageType *input2):
+    m_Filter(filter), m_Input1(input1), m_Input2(input2) {}
+
+  OutputPixelType operator()(const IndexType & index) const
+  {
+    return m_Filter->GetFunctor()( m_Input1 ? m_Input1->GetPixel(index) : m_Filter->GetConstant1(),
+                                   m_Input2 ? m_Input2->GetPixel(index) : m_Filter->GetConstant2() );
+  }
+
+private:
+  TFilter *              m_Filter;
+  const Input1ImageType *m_Input1;
+  const Input2ImageType *m_Input2;
+};
+
+template< class TFilter >
+bool TestBinaryFilter(const char *name)
+{
+  typedef typename TFilter::Input1ImageType Input1ImageType;
+  typedef typename TFilter::Input2ImageType Input2ImageType;
+  typedef typename TFilter::OutputImageType OutputImageType;
+  typedef typename Input1ImageType::RegionType RegionType;
+
+  RegionType region;
+  region.SetIndex(0, -3);
+  region.SetIndex(1, 5);
+  region.SetIndex(2, 0);
+  region.SetSize(0, 37);
+  region.SetSize(1, 21);
+  region.SetSize(2, 9);
+  typename Input1ImageType::Pointer input1 = CreateImage< Input1ImageType >(region);
+  typename Input2ImageType::Pointer input2 = CreateImage< Input2ImageType >(region);
+
+  // a region of lines that are not contiguous, with odd lengths
+  RegionType subregion = region;
+  subregion.SetIndex(0, 0);
+  subregion.SetIndex(1, 7);
+  subregion.SetSize(0, 19);
+  subregion.SetSize(1, 11);
+  subregion.SetSize(2, 5);
+
+  bool pass = true;
+
+  // two images, on the whole region and on the subregion
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetInput1(input1);
+  filter->SetInput2(input2);
+  filter->SetNumberOfThreads(3);
+  filter->Update();
+  pass &= CheckOutput( name, filter->GetOutput(), region,
+                       BinaryExpected< TFilter >(filter, input1, input2) );
+
+  filter = TFilter::New();
+  filter->SetInput1(input1);
+  filter->SetInput2(input2);
+  filter->GetOutput()->SetRequestedRegion(subregion);
+  filter->Update();
+  pass &= CheckOutput( name, filter->GetOutput(), subregion,
+                       BinaryExpected< TFilter >(filter, input1, input2) );
+
+  // an image and a constant
+  filter = TFilter::New();
+  filter->SetInput1(input1);
+  filter->SetConstant2( static_cast< typename Input2ImageType::PixelType >( 3 ) );
+  filter->Update();
+  pass &= CheckOutput( name, filter->GetOutput(), region,
+                       BinaryExpected< TFilter >( filter, input1, static_cast< Input2ImageType * >( 0 ) ) );
+
+  filter = TFilter::New();
+  filter->SetConstant1( static_cast< typename Input1ImageType::PixelType >( -5 ) );
+  filter->SetInput2(input2);
+  filter->GetOutput()->SetRequestedRegion(subregion);
+  filter->Update();
+  pass &= CheckOutput( name, filter->GetOutput(), subregion,
+                       BinaryExpected< TFilter >( filter, static_cast< Input1ImageType * >( 0 ), input2 ) );
+
+  // in place: the output is the buffer of the first input
+  typename TFilter::Pointer reference = TFilter::New();
+  reference->SetInput1(input1);
+  reference->SetInput2(input2);
+  reference->Update();
+
+  typename Input1ImageType::Pointer copy = CreateImage< Input1ImageType >(region);
+  itk::ImageRegionIterator< Input1ImageType > it(copy, region);
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( input1->GetPixel( it.GetIndex() ) );
+    }
+  const void *copyBuffer = copy->GetBufferPointer();
+  filter = TFilter::New();
+  filter->SetInput1(copy);
+  filter->SetInput2(input2);
+  filter->InPlaceOn();
+  filter->Update();
+  if ( filter->CanRunInPlace()
+       && static_cast< const void * >( filter->GetOutput()->GetBufferPointer() ) != copyBuffer )
+    {
+    std::cerr << name << " did not run in place" << std::endl;
+    pass = false;
+    }
+  pass &= CheckOutput( name, filter->GetOutput(), region,
+                       BinaryExpected< TFilter >(reference, input1, input2) );
+
+  if ( !pass )
+    {
+    std::cerr << name << " FAILED" << std::endl;
+    }
+  return pass;
+}
+
+// The expected output of a unary filter
+template< class TFilter >
+class UnaryExpected
+{
+public:
+  typedef typename TFilter::InputImageType       InputImageType;
+  typedef typename TFilter::OutputImagePixelType OutputPixelType;
+  typedef typename InputImageType::IndexType     IndexType;
+
+  UnaryExpected(TFilter *filter, const InputImageType *input):
+    m_Filter(filter), m_Input(input) {}
+
+  OutputPixelType operator()(const IndexType & index) const
+  {
+    return m_Filter->GetFunctor()( m_Input->GetPixel(index) );
+  }
+
+private:
+  TFilter *             m_Filter;
+  const InputImageType *m_Input;
+};
+
+template< class TInputPixel, class TOutputPixel >
+bool TestCast(const char *name)
+{
+  typedef itk::Image< TInputPixel, Dimension >                    InputImageType;
+  typedef itk::Image< TOutputPixel, Dimension >                   OutputImageType;
+  typedef itk::CastImageFilter< InputImageType, OutputImageType > FilterType;
+
+  typename InputImageType::RegionType region;
+  region.SetSize(0, 67);
+  region.SetSize(1, 13);
+  region.SetSize(2, 3);
+  typename InputImageType::Pointer input = CreateImage< InputImageType >(region);
+  // the extreme values
+  typename InputImageType::IndexType index;
+  index.Fill(0);
+  input->SetPixel( index, itk::NumericTraits< TInputPixel >::max() );
+  index[0] = 1;
+  input->SetPixel( index, itk::NumericTraits< TInputPixel >::NonpositiveMin() );
+
+  typename InputImageType::RegionType subregion = region;
+  subregion.SetIndex(0, 3);
+  subregion.SetSize(0, 50);
+
+  bool pass = true;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(input);
+  filter->Update();
+  pass &= CheckOutput( name, filter->GetOutput(), region, UnaryExpected< FilterType >(filter, input) );
+
+  filter = FilterType::New();
+  filter->SetInput(input);
+  filter->GetOutput()->SetRequestedRegion(subregion);
+  filter->Update();
+  pass &= CheckOutput( name, filter->GetOutput(), subregion, UnaryExpected< FilterType >(filter, input) );
+
+  if ( !pass )
+    {
+    std::cerr << name << " FAILED" << std::endl;
+    }
+  return pass;
+}
+}
+
+int itkFunctorImageFilterSpansTest(int argc, char *argv[])
+{
+  typedef itk::Image< float, Dimension >  FloatImageType;
+  typedef itk::Image< double, Dimension > DoubleImageType;
+  typedef itk::Image< short, Dimension >  ShortImageType;
+
+  bool pass = true;
+
+  // the vectorized operations, and the same functors on integers
+  pass &= TestBinaryFilter< itk::AddImageFilter< FloatImageType > >("Add float");
+  pass &= TestBinaryFilter< itk::AddImageFilter< DoubleImageType > >("Add double");
+  pass &= TestBinaryFilter< itk::AddImageFilter< ShortImageType > >("Add short");
+  pass &= TestBinaryFilter< itk::AddImageFilter< ShortImageType, FloatImageType, FloatImageType > >("Add short float");
+  pass &= TestBinaryFilter< itk::SubtractImageFilter< FloatImageType > >("Subtract float");
+  pass &= TestBinaryFilter< itk::SubtractImageFilter< DoubleImageType > >("Subtract double");
+  pass &= TestBinaryFilter< itk::MultiplyImageFilter< FloatImageType > >("Multiply float");
+  pass &= TestBinaryFilter< itk::MultiplyImageFilter< DoubleImageType > >("Multiply double");
+  pass &= TestBinaryFilter< itk::DivideImageFilter< FloatImageType, FloatImageType, FloatImageType > >("Divide float");
+  pass &= TestBinaryFilter< itk::DivideImageFilter< DoubleImageType, DoubleImageType, DoubleImageType > >(
+    "Divide double");
+  pass &= TestBinaryFilter< itk::DivideImageFilter< ShortImageType, ShortImageType, ShortImageType > >(
+    "Divide short");
+  pass &= TestBinaryFilter< itk::MinimumImageFilter< FloatImageType > >("Minimum float");
+  pass &= TestBinaryFilter< itk::MinimumImageFilter< DoubleImageType > >("Minimum double");
+  pass &= TestBinaryFilter< itk::MaximumImageFilter< FloatImageType > >("Maximum float");
+  pass &= TestBinaryFilter< itk::MaximumImageFilter< DoubleImageType > >("Maximum double");
+
+  pass &= TestCast< unsigned char, float >("Cast unsigned char float");
+  pass &= TestCast< short, float >("Cast short float");
+  pass &= TestCast< unsigned short, float >("Cast unsigned short float");
+  pass &= TestCast< int, float >("Cast int float");
+  pass &= TestCast< float, double >("Cast float double");
+  pass &= TestCast< double, float >("Cast double float");
+  pass &= TestCast< float, float >("Cast float float");
+  pass &= TestCast< short, unsigned char >("Cast short unsigned char");
+
+  FloatImageType::RegionType region;
+  region.SetSize(0, 45);
+  region.SetSize(1, 10);
+  region.SetSize(2, 4);
+  FloatImageType::Pointer input1 = CreateImage< FloatImageType >(region);
+  FloatImageType::Pointer input2 = CreateImage< FloatImageType >(region);
+  FloatImageType::Pointer input3 = CreateImage< FloatImageType >(region);
+  FloatImageType::RegionType subregion = region;
+  subregion.SetIndex(1, 2);
+  subregion.SetSize(0, 30);
+  subregion.SetSize(1, 5);
+
+  // ternary and n-ary filters
+  typedef itk::TernaryMagnitudeImageFilter< FloatImageType, FloatImageType, FloatImageType, FloatImageType >
+  TernaryFilterType;
+  TernaryFilterType::Pointer ternary = TernaryFilterType::New();
+  ternary->SetInput1(input1);
+  ternary->SetInput2(input2);
+  ternary->SetInput3(input3);
+  ternary->GetOutput()->SetRequestedRegion(subregion);
+  ternary->Update();
+
+  typedef itk::NaryAddImageFilter< FloatImageType, FloatImageType > NaryFilterType;
+  NaryFilterType::Pointer nary = NaryFilterType::New();
+  nary->SetInput(0, input1);
+  nary->SetInput(1, input2);
+  nary->SetInput(2, input3);
+  nary->GetOutput()->SetRequestedRegion(subregion);
+  nary->Update();
+
+  for ( itk::ImageRegionConstIteratorWithIndex< FloatImageType > it(input1, subregion); !it.IsAtEnd(); ++it )
+    {
+    const FloatImageType::IndexType & index = it.GetIndex();
+    const float                       a = input1->GetPixel(index);
+    const float                       b = input2->GetPixel(index);
+    const float                       c = input3->GetPixel(index);
+    std::vector< float >              values;
+    values.push_back(a);
+    values.push_back(b);
+    values.push_back(c);
+    if ( ternary->GetOutput()->GetPixel(index) != ternary->GetFunctor()(a, b, c)
+         || nary->GetOutput()->GetPixel(index) != nary->GetFunctor()(values) )
+      {
+      std::cerr << "Wrong ternary or n-ary output at " << index << std::endl;
+      pass = false;
+      break;
+      }
+    }
+
+  // an image adaptor and a vector image are walked by iterators
+  typedef itk::AddImageAdaptor< FloatImageType > AdaptorType;
+  AdaptorType::Pointer adaptor = AdaptorType::New();
+  adaptor->SetImage(input1);
+  adaptor->SetValue(10);
+  typedef itk::AddImageFilter< AdaptorType, FloatImageType, FloatImageType > AdaptorFilterType;
+  AdaptorFilterType::Pointer adaptorFilter = AdaptorFilterType::New();
+  adaptorFilter->SetInput1(adaptor);
+  adaptorFilter->SetInput2(input2);
+  adaptorFilter->Update();
+
+  typedef itk::VectorImage< float, Dimension > VectorImageType;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(region);
+  vectorImage->SetVectorLength(2);
+  vectorImage->Allocate();
+  for ( itk::ImageRegionConstIteratorWithIndex< FloatImageType > it(input1, region); !it.IsAtEnd(); ++it )
+    {
+    itk::VariableLengthVector< float > vector(2);
+    vector[0] = it.Get();
+    vector[1] = input2->GetPixel( it.GetIndex() );
+    vectorImage->SetPixel(it.GetIndex(), vector);
+    }
+  typedef itk::VectorIndexSelectionCastImageFilter< VectorImageType, FloatImageType > SelectionFilterType;
+  SelectionFilterType::Pointer selection = SelectionFilterType::New();
+  selection->SetInput(vectorImage);
+  selection->SetIndex(1);
+  selection->Update();
+
+  for ( itk::ImageRegionConstIteratorWithIndex< FloatImageType > it(input1, region); !it.IsAtEnd(); ++it )
+    {
+    const FloatImageType::IndexType & index = it.GetIndex();
+    if ( adaptorFilter->GetOutput()->GetPixel(index) != ( it.Get() + 10.0f ) + input2->GetPixel(index)
+         || selection->GetOutput()->GetPixel(index) != input2->GetPixel(index) )
+      {
+      std::cerr << "Wrong adaptor or vector image output at " << index << std::endl;
+      pass = false;
+      break;
+      }
+    }
+
+  // time the spans against a loop of iterators calling the same functor
+  unsigned int repetitions = 5;
+  if ( argc > 1 )
+    {
+    repetitions = atoi(argv[1]);
+    }
+  FloatImageType::RegionType largeRegion;
+  largeRegion.SetSize(0, 256);
+  largeRegion.SetSize(1, 256);
+  largeRegion.SetSize(2, 64);
+  FloatImageType::Pointer large1 = CreateImage< FloatImageType >(largeRegion);
+  FloatImageType::Pointer large2 = CreateImage< FloatImageType >(largeRegion);
+  FloatImageType::Pointer largeOutput = CreateImage< FloatImageType >(largeRegion);
+
+  typedef itk::AddImageFilter< FloatImageType > AddFilterType;
+  itk::TimeProbe spansProbe;
+  itk::TimeProbe iteratorsProbe;
+  for ( unsigned int r = 0; r < repetitions; r++ )
+    {
+    AddFilterType::Pointer add = AddFilterType::New();
+    add->SetInput1(large1);
+    add->SetInput2(large2);
+    add->SetNumberOfThreads(1);
+    spansProbe.Start();
+    add->Update();
+    spansProbe.Stop();
+
+    itk::Functor::Add2< float, float, float >  functor;
+    itk::ImageRegionConstIterator< FloatImageType > it1(large1, largeRegion);
+    itk::ImageRegionConstIterator< FloatImageType > it2(large2, largeRegion);
+    itk::ImageRegionIterator< FloatImageType >      ot(largeOutput, largeRegion);
+    iteratorsProbe.Start();
+    for (; !ot.IsAtEnd(); ++it1, ++it2, ++ot )
+      {
+      ot.Set( functor( it1.Get(), it2.Get() ) );
+      }
+    iteratorsProbe.Stop();
+    }
+  std::cout << "Addition of " << largeRegion.GetNumberOfPixels() << " floats in one thread: "
+            << spansProbe.GetMean() << " s by spans, "
+            << iteratorsProbe.GetMean() << " s by iterators" << std::endl;
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,7 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include <vector>
 
 namespace itk
 {
@@ -55,6 +56,18 @@ namespace itk
  * Enhancement using Generalizations of Histogram Equalization."
  * J.Alex Stark. IEEE Transactions on Image Processing, May 2000.
  *
+ * The local histograms are computed incrementally as the window slides
+ * along the first image axis, and the filter is multithreaded. The input
+ * intensities are collected in at most 4096 bins. When the input only
+ * holds integer values over a range of at most 4096 gray levels, each bin
+ * is one gray level and the result is the one of the power law mapping
+ * applied to the exact window histogram. Otherwise the intensities are
+ * rounded to the center of their bin, i.e. moved by at most 1/8190 of the
+ * intensity range, before comparing them in the cumulative function. The
+ * result then differs from the exact one by about the same fraction of the
+ * intensity range for alpha close to 1, and more for alpha close to 0,
+ * where the cumulative function is discontinuous.
+ *
  * \ingroup ImageEnhancement
  * \ingroup ITK-ImageStatistics
  */
@@ -98,7 +111,9 @@ public:
   itkGetConstMacro(Beta, float);
 
   /** Set/Get whether an optimized lookup table for the intensity
-   * mapping function is used.  Default is off. */
+   * mapping function is used.  Default is off. The mapping function is
+   * now always tabulated, so this flag has no effect and is only kept for
+   * backward compatibility. */
   itkSetMacro(UseLookupTable, bool);
   itkGetConstMacro(UseLookupTable, bool);
   itkBooleanMacro(UseLookupTable);
@@ -109,15 +124,21 @@ protected:
     m_Beta = .3;
     this->SetRadius(5);
     m_UseLookupTable = false;
+    m_InputMinimum = 0.0;
+    m_InputMaximum = 0.0;
+    m_BinSize = 1.0;
+    m_NumberOfBins = 1;
   }
 
   virtual ~AdaptiveHistogramEqualizationImageFilter(){}
   void PrintSelf(std::ostream & os, Indent indent) const;
 
-  /**
-   * Standard pipeline method
-   */
-  void GenerateData();
+  /** Compute the intensity range of the input and tabulate the
+   * cumulative function. */
+  void BeforeThreadedGenerateData();
+
+  void ThreadedGenerateData(const typename ImageType::RegionType & outputRegionForThread,
+                            ThreadIdType threadId);
 
 private:
   AdaptiveHistogramEqualizationImageFilter(const Self &); //purposely not
@@ -136,8 +157,16 @@ private:
    * intensity mapping function? */
   bool m_UseLookupTable;
 
-  /** A function which is used in GenerateData(). */
-  float CumulativeFunction(float u, float v);
+  /** Intensity range of the input, width of the histogram bins in
+   * intensity units, and number of bins. */
+  double        m_InputMinimum;
+  double        m_InputMaximum;
+  double        m_BinSize;
+  SizeValueType m_NumberOfBins;
+
+  /** Cumulative function minus its Beta * u term, tabulated for the
+   * differences of intensity of -m_NumberOfBins to m_NumberOfBins bins. */
+  std::vector< double > m_CumulativeTable;
 };
 } // end namespace itk
 
@@ -18,65 +18,32 @@
 #ifndef __itkAdaptiveHistogramEqualizationImageFilter_txx
 #define __itkAdaptiveHistogramEqualizationImageFilter_txx
 
-#include <map>
-#include <set>
 #include "vnl/vnl_math.h"
 
 #include "itkAdaptiveHistogramEqualizationImageFilter.h"
-#include "itkImageRegionIterator.h"
-#include "itkImageRegionIteratorWithIndex.h"
-#include "itkConstNeighborhoodIterator.h"
-#include "itkNeighborhoodAlgorithm.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageLinearIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 
 namespace itk
 {
-template< class TImageType >
-float
-AdaptiveHistogramEqualizationImageFilter< TImageType >
-::CumulativeFunction(float u, float v)
-{
-  // Calculate cumulative function
-  float s, ad;
-
-  s = vnl_math_sgn(u - v);
-  ad = vnl_math_abs( 2.0 * ( u - v ) );
-
-  return 0.5 *s *vcl_pow(ad, m_Alpha) - m_Beta * 0.5 * s * ad + m_Beta * u;
-}
-
 template< class TImageType >
 void
 AdaptiveHistogramEqualizationImageFilter< TImageType >
-::GenerateData()
+::BeforeThreadedGenerateData()
 {
   typename ImageType::ConstPointer input = this->GetInput();
-  typename ImageType::Pointer output = this->GetOutput();
-
-  // Allocate the output
-  this->AllocateOutputs();
 
-  unsigned int i;
-
-  //Set the kernel value of PLAHE algorithm
-  float kernel = 1;
-  for ( i = 0; i < ImageDimension; i++ )
-    {
-    kernel = kernel * ( 2 * this->GetRadius()[i] + 1 );
-    }
-  kernel = 1 / kernel;
-
-  // Iterator which traverse the input
+  // Calculate min and max gray level of an input image, and find whether
+  // it only holds integer values
   ImageRegionConstIterator< ImageType > itInput( input,
                                                  input->GetRequestedRegion() );
-
-  // Calculate min and max gray level of an input image
   double min = static_cast< double >( itInput.Get() );
   double max = min;
-  double value;
-  while ( !itInput.IsAtEnd() )
+  bool   integerValues = true;
+  for (; !itInput.IsAtEnd(); ++itInput )
     {
-    value = static_cast< double >( itInput.Get() );
+    const double value = static_cast< double >( itInput.Get() );
     if ( min > value )
       {
       min = value;
@@ -85,190 +52,214 @@ AdaptiveHistogramEqualizationImageFilter< TImageType >
       {
       max = value;
       }
-    ++itInput;
+    if ( integerValues && value != vcl_floor(value) )
+      {
+      integerValues = false;
+      }
     }
+  m_InputMinimum = min;
+  m_InputMaximum = max;
 
-  // Allocate a float type image which has the same size with an input image.
-  // This image store normalized pixel values [-0.5 0.5] of the input image.
-  typedef Image< float, ImageDimension > ImageFloatType;
-  typename ImageFloatType::Pointer inputFloat = ImageFloatType::New();
-  inputFloat->SetRegions( input->GetRequestedRegion() );
-  inputFloat->Allocate();
-
-  // Scale factors to convert back and forth to the [-0.5, 0.5] and
-  // original gray level range
-  float iscale = max - min;
-  float scale = (float)1 / iscale;
-
-  // Normalize input image to [-0.5 0.5] gray level and store in
-  // inputFloat. AdaptiveHistogramEqualization only use float type
-  // image which has gray range [-0.5 0.5]
-  ImageRegionIterator< ImageFloatType > itFloat( inputFloat,
-                                                 input->GetRequestedRegion() );
-
-  itInput.GoToBegin(); // rewind the previous input iterator
-  while ( !itInput.IsAtEnd() )
+  const SizeValueType maximumNumberOfBins = 4096;
+  if ( integerValues && max - min < maximumNumberOfBins )
+    {
+    m_BinSize = 1.0;
+    m_NumberOfBins = static_cast< SizeValueType >( max - min ) + 1;
+    }
+  else
     {
-    itFloat.Set(scale * ( itInput.Get() - min ) - 0.5);
-    ++itFloat;
-    ++itInput;
+    m_BinSize = ( max - min ) / ( maximumNumberOfBins - 1 );
+    m_NumberOfBins = maximumNumberOfBins;
     }
 
-  // Calculate cumulative array which will store the value of
-  // cumulative function. During the AdaptiveHistogramEqualization
-  // process, cumulative function will not be calculated, instead the
-  // cumulative function will be pre-calculated and result will be
-  // stored in cumulative array.  The cumulative array will be
-  // referenced during AdaptiveHistogramEqualization processing.  This
-  // pre-calculation can reduce computation time even though this
-  // method uses a huge array.  If the cumulative array can not be
-  // assigned, the cumulative function will be calculated each time.
-  //
-  //
-  bool cachedCumulative = false;
-
-  typedef std::set< float > FloatSetType;
-  FloatSetType row;
-
-  typedef std::map< std::pair< float, float >, float > ArrayMapType;
-  ArrayMapType CumulativeArray;
-
-  if ( m_UseLookupTable )
+  // The intensities are normalized to [-0.5 0.5]. The cumulative function
+  // of the normalized intensities u and v,
+  //   0.5 * s * |2 (u - v)|^alpha - beta * 0.5 * s * |2 (u - v)| + beta * u
+  // with s the sign of u - v, is the sum of beta * u and of a function of
+  // u - v. The latter is tabulated for differences of whole bins.
+  const double          binWidth = ( max > min ) ? m_BinSize / ( max - min ) : 0.0;
+  const IndexValueType  numberOfBins = static_cast< IndexValueType >( m_NumberOfBins );
+  m_CumulativeTable.resize(2 * m_NumberOfBins + 1);
+  for ( IndexValueType k = -numberOfBins; k <= numberOfBins; k++ )
     {
-    // determine what intensities are used on the input
-    itFloat.GoToBegin(); // rewind the iterator for the normalized image
-    while ( !itFloat.IsAtEnd() )
-      {
-      row.insert( itFloat.Get() );
-      ++itFloat;
-      }
-    // only cache the array if it can be done without taking too much space
-    if ( row.size() < ( input->GetRequestedRegion().GetNumberOfPixels() / 10 ) )
-      {
-      cachedCumulative = true;
-      }
-    else
-      {
-      cachedCumulative = false;
-      row.clear();
-      }
+    const double d = k * binWidth;
+    const double s = vnl_math_sgn(d);
+    const double ad = vnl_math_abs(2.0 * d);
+    m_CumulativeTable[k + numberOfBins] =
+      0.5 * s * vcl_pow( ad, static_cast< double >( m_Alpha ) ) - m_Beta * 0.5 * s * ad;
+    }
+}
+
+template< class TImageType >
+void
+AdaptiveHistogramEqualizationImageFilter< TImageType >
+::ThreadedGenerateData(const typename ImageType::RegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  typedef typename ImageType::PixelType         PixelType;
+  typedef typename ImageType::IndexType         IndexType;
+  typedef typename ImageType::OffsetValueType   OffsetValueType;
+  typedef typename ImageType::InternalPixelType InternalPixelType;
 
-    if ( cachedCumulative )
+  typename ImageType::ConstPointer input = this->GetInput();
+  typename ImageType::Pointer output = this->GetOutput();
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  const double min = m_InputMinimum;
+  const double iscale = m_InputMaximum - m_InputMinimum;
+
+  ImageLinearIteratorWithIndex< ImageType > itOut(output, outputRegionForThread);
+  itOut.SetDirection(0);
+  ImageRegionConstIterator< ImageType > itIn(input, outputRegionForThread);
+
+  if ( iscale == 0.0 )
+    {
+    // A constant image is left unchanged
+    for ( itOut.GoToBegin(); !itOut.IsAtEnd(); itOut.NextLine() )
       {
-      // calculate cumulative function for each possible pairing of
-      // intensities and store result in cumulative array
-      FloatSetType::iterator itU, itV;
-      ArrayMapType::key_type key;
-      for ( itU = row.begin(); itU != row.end(); ++itU )
+      for (; !itOut.IsAtEndOfLine(); ++itOut )
         {
-        key.first = *itU;
-        for ( itV = row.begin(); itV != row.end(); ++itV )
-          {
-          key.second = *itV;
-          CumulativeArray.insert( ArrayMapType::value_type( key,
-                                                            this->CumulativeFunction(*itU, *itV) ) );
-          }
+        itOut.Set( itIn.Get() );
+        ++itIn;
+        progress.CompletedPixel();
         }
       }
+    return;
     }
 
-  // Setup for processing the image
-  //
-  ZeroFluxNeumannBoundaryCondition< ImageFloatType > nbc;
-  ConstNeighborhoodIterator< ImageFloatType >        bit;
+  const ImageSizeType & radius = this->GetRadius();
 
-  // Find the data-set boundary "faces"
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< ImageFloatType >::FaceListType faceList;
-  NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< ImageFloatType > bC;
-  faceList = bC( inputFloat, output->GetRequestedRegion(), this->GetRadius() );
+  // The window is made of segments of the "rows", the lines along the first
+  // axis that it crosses. The pixels outside of the input requested region
+  // take the value of the closest pixel inside of it, as with the
+  // ZeroFluxNeumannBoundaryCondition.
+  const typename ImageType::RegionType & inputRegion = input->GetRequestedRegion();
+  const IndexType     inputStart = inputRegion.GetIndex();
+  const ImageSizeType inputSize = inputRegion.GetSize();
+  const IndexType     bufferStart = input->GetBufferedRegion().GetIndex();
+  const OffsetValueType *offsetTable = input->GetOffsetTable();
 
-  typename NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< ImageFloatType >::FaceListType::iterator fit;
+  const InternalPixelType *buffer = input->GetBufferPointer();
+  const typename ImageType::AccessorType accessor = input->GetPixelAccessor();
 
-  // Map stores (number of pixel)/(window size) for each gray value.
-  typedef std::map< float, float > MapType;
-  MapType           count;
-  MapType::iterator itMap;
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int d = 1; d < ImageDimension; d++ )
+    {
+    numberOfRows *= 2 * radius[d] + 1;
+    }
+  const SizeValueType width = 2 * radius[0] + 1;
+  const double        kernel = 1.0 / ( numberOfRows * width );
 
-  ProgressReporter progress( this, 0, output->GetRequestedRegion().GetNumberOfPixels() );
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
 
-  // Process each faces.  These are N-d regions which border
-  // the edge of the buffer.
-  for ( fit = faceList.begin(); fit != faceList.end(); ++fit )
+  std::vector< OffsetValueType > rows(numberOfRows);
+  std::vector< OffsetValueType > columns(lineLength + width - 1);
+
+  const IndexValueType numberOfBins = static_cast< IndexValueType >( m_NumberOfBins );
+  const double         binScale = 1.0 / m_BinSize;
+  std::vector< SizeValueType > histogram(m_NumberOfBins, 0);
+  const double *cumulative = &m_CumulativeTable[numberOfBins];
+
+  // Range of the non empty bins of the histogram
+  IndexValueType lowestBin = numberOfBins;
+  IndexValueType highestBin = -1;
+
+  for ( itOut.GoToBegin(); !itOut.IsAtEnd(); itOut.NextLine() )
     {
-    // Create a neighborhood iterator for the normalized image for the
-    // region for this face
-    bit = ConstNeighborhoodIterator< ImageFloatType >(this->GetRadius(),
-                                                      inputFloat, *fit);
-    bit.OverrideBoundaryCondition(&nbc);
-    bit.GoToBegin();
-    unsigned int neighborhoodSize = bit.Size();
-
-    // iterator for the output for this face
-    ImageRegionIterator< ImageType > itOut(output, *fit);
-
-    // iterate over the region for this face
-    ArrayMapType::key_type key;
-    while ( !bit.IsAtEnd() )
+    const IndexType lineIndex = itOut.GetIndex();
+
+    for ( SizeValueType r = 0; r < numberOfRows; r++ )
       {
-      // AdaptiveHistogramEqualization algorithm
-      //
-      //
-      float f;
-      float sum;
-
-      // "Histogram the window"
-      count.clear();
-      for ( i = 0; i < neighborhoodSize; ++i )
+      OffsetValueType offset = 0;
+      SizeValueType   position = r;
+      for ( unsigned int d = 1; d < ImageDimension; d++ )
         {
-        f = bit.GetPixel(i);
-        itMap = count.find(f);
-        if ( itMap != count.end() )
-          {
-          count[f] = count[f] + kernel;
-          }
-        else
-          {
-          count.insert( MapType::value_type(f, kernel) );
-          }
+        const SizeValueType  span = 2 * radius[d] + 1;
+        const IndexValueType index = lineIndex[d] + static_cast< IndexValueType >( position % span )
+                                     - static_cast< IndexValueType >( radius[d] );
+        const IndexValueType clamped = vnl_math_min(
+          vnl_math_max(index, inputStart[d]),
+          inputStart[d] + static_cast< IndexValueType >( inputSize[d] ) - 1 );
+        offset += ( clamped - bufferStart[d] ) * offsetTable[d];
+        position /= span;
         }
+      rows[r] = offset;
+      }
 
-      typedef typename ImageType::PixelType PixelType;
+    for ( SizeValueType c = 0; c < columns.size(); c++ )
+      {
+      const IndexValueType index = lineIndex[0] + static_cast< IndexValueType >( c )
+                                   - static_cast< IndexValueType >( radius[0] );
+      columns[c] = vnl_math_min( vnl_math_max(index, inputStart[0]),
+                                 inputStart[0] + static_cast< IndexValueType >( inputSize[0] ) - 1 )
+                   - bufferStart[0];
+      }
 
-      // if we cached the cumulative array
-      // if not, use CumulativeFunction()
-      if ( cachedCumulative )
+    for ( SizeValueType c = 0; c < columns.size(); c++ )
+      {
+      // Add the column entering the window
+      for ( SizeValueType r = 0; r < numberOfRows; r++ )
         {
-        sum = 0;
-        itMap = count.begin();
-        f = bit.GetCenterPixel();
-        key.first = f;
-        while ( itMap != count.end() )
-          {
-          key.second = itMap->first;
-          sum = sum
-                + itMap->second * CumulativeArray[key];
-          ++itMap;
-          }
-        itOut.Set( (PixelType)( iscale * ( sum + 0.5 ) + min ) );
+        const double value = static_cast< double >( accessor.Get(buffer[rows[r] + columns[c]]) );
+        const IndexValueType bin = vnl_math_min(
+          static_cast< IndexValueType >( ( value - min ) * binScale + 0.5 ), numberOfBins - 1 );
+        ++histogram[bin];
+        lowestBin = vnl_math_min(lowestBin, bin);
+        highestBin = vnl_math_max(highestBin, bin);
         }
-      else
+
+      if ( c + 1 < width )
+        {
+        continue;
+        }
+
+      while ( histogram[lowestBin] == 0 )
+        {
+        ++lowestBin;
+        }
+      while ( histogram[highestBin] == 0 )
+        {
+        --highestBin;
+        }
+
+      // The center pixel is binned like its neighbors, so that equal
+      // intensities always have a zero difference
+      const double         f = static_cast< double >( itIn.Get() );
+      const IndexValueType centerBin = vnl_math_min(
+        static_cast< IndexValueType >( ( f - min ) * binScale + 0.5 ), numberOfBins - 1 );
+
+      double sum = 0.0;
+      for ( IndexValueType j = lowestBin; j <= highestBin; j++ )
         {
-        sum = 0;
-        itMap = count.begin();
-        f = bit.GetCenterPixel();
-        while ( itMap != count.end() )
-          {
-          sum = sum + itMap->second *CumulativeFunction(f, itMap->first);
-          ++itMap;
-          }
-        itOut.Set( (PixelType)( iscale * ( sum + 0.5 ) + min ) );
+        sum += histogram[j] * cumulative[centerBin - j];
         }
 
-      // move the neighborhood
-      ++bit;
+      const double u = ( f - min ) / iscale - 0.5;
+      sum = kernel * sum + m_Beta * u;
+      itOut.Set( static_cast< PixelType >( iscale * ( sum + 0.5 ) + min ) );
       ++itOut;
+      ++itIn;
       progress.CompletedPixel();
+
+      // Remove the column leaving the window
+      for ( SizeValueType r = 0; r < numberOfRows; r++ )
+        {
+        const double value = static_cast< double >(
+          accessor.Get(buffer[rows[r] + columns[c + 1 - width]]) );
+        const IndexValueType bin = vnl_math_min(
+          static_cast< IndexValueType >( ( value - min ) * binScale + 0.5 ), numberOfBins - 1 );
+        --histogram[bin];
+        }
+      }
+
+    // Empty the histogram for the next line
+    for ( IndexValueType j = lowestBin; j <= highestBin; j++ )
+      {
+      histogram[j] = 0;
       }
+    lowestBin = numberOfBins;
+    highestBin = -1;
     }
 }
 
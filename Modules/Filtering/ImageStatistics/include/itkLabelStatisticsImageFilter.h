@@ -24,6 +24,7 @@
 #include "itk_hash_map.h"
 #include "itkHistogram.h"
 #include "itkFastMutexLock.h"
+#include "itkCompensatedSummation.h"
 #include <vector>
 
 namespace itk
@@ -47,7 +48,13 @@ namespace itk
  *
  * The filter passes its intensity input through unmodified.  The filter is
  * threaded. It computes statistics in each thread then combines them in
- * its AfterThreadedGenerate method.
+ * its AfterThreadedGenerate method.  The sums are compensated for the
+ * rounding errors (see CompensatedSummation).
+ *
+ * When AccumulateStreamedRegions is on, the filter does not request its
+ * whole inputs, and can be followed by a StreamingImageFilter: the
+ * statistics are accumulated over the streamed regions, as in
+ * StatisticsImageFilter.
  *
  * \ingroup MathematicalStatisticsImageFilters
  * \ingroup ITK-ImageStatistics
@@ -188,6 +195,8 @@ public:
       m_Mean = l.m_Mean;
       m_Sum = l.m_Sum;
       m_SumOfSquares = l.m_SumOfSquares;
+      m_SumAccumulator = l.m_SumAccumulator;
+      m_SumOfSquaresAccumulator = l.m_SumOfSquaresAccumulator;
       m_Sigma = l.m_Sigma;
       m_Variance = l.m_Variance;
       m_BoundingBox = l.m_BoundingBox;
@@ -203,6 +212,8 @@ public:
       m_Mean = l.m_Mean;
       m_Sum = l.m_Sum;
       m_SumOfSquares = l.m_SumOfSquares;
+      m_SumAccumulator = l.m_SumAccumulator;
+      m_SumOfSquaresAccumulator = l.m_SumOfSquaresAccumulator;
       m_Sigma = l.m_Sigma;
       m_Variance = l.m_Variance;
       m_BoundingBox = l.m_BoundingBox;
@@ -219,6 +230,10 @@ public:
     RealType        m_Variance;
     BoundingBoxType m_BoundingBox;
     typename HistogramType::Pointer m_Histogram;
+
+    // compensated sums, from which m_Sum and m_SumOfSquares are set
+    CompensatedSummation< RealType > m_SumAccumulator;
+    CompensatedSummation< RealType > m_SumOfSquaresAccumulator;
   };
 
   /** Type of the map used to store data per label */
@@ -235,6 +250,12 @@ public:
   itkGetConstMacro(UseHistograms, bool);
   itkBooleanMacro(UseHistograms);
 
+  /** Accumulate the statistics over the regions streamed through the
+   * filter instead of requesting the whole inputs.  Off by default. */
+  itkSetMacro(AccumulateStreamedRegions, bool);
+  itkGetConstMacro(AccumulateStreamedRegions, bool);
+  itkBooleanMacro(AccumulateStreamedRegions);
+
 
   virtual const ValidLabelValuesContainerType &GetValidLabelValues() const
   {
@@ -358,6 +379,12 @@ private:
   RealType            m_LowerBound;
   RealType            m_UpperBound;
   SimpleFastMutexLock m_Mutex;
+
+  bool m_AccumulateStreamedRegions;
+
+  /** Number of pixels of the regions accumulated in m_LabelStatistics */
+  SizeValueType m_AccumulatedCount;
+  unsigned long m_AccumulationMTime;
 }; // end of class
 } // end namespace itk
 
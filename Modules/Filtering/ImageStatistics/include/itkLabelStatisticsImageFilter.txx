@@ -22,6 +22,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkProgressReporter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -36,6 +37,9 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
   m_LowerBound = static_cast< RealType >( NumericTraits< PixelType >::NonpositiveMin() );
   m_UpperBound = static_cast< RealType >( NumericTraits< PixelType >::max() );
   m_ValidLabelValues.clear();
+  m_AccumulateStreamedRegions = false;
+  m_AccumulatedCount = 0;
+  m_AccumulationMTime = 0;
 }
 
 template< class TInputImage, class TLabelImage >
@@ -44,6 +48,11 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 ::GenerateInputRequestedRegion()
 {
   Superclass::GenerateInputRequestedRegion();
+  if ( m_AccumulateStreamedRegions )
+    {
+    // the inputs are requested over the streamed output region
+    return;
+    }
   if ( this->GetInput() )
     {
     InputImagePointer image =
@@ -67,7 +76,10 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 ::EnlargeOutputRequestedRegion(DataObject *data)
 {
   Superclass::EnlargeOutputRequestedRegion(data);
-  data->SetRequestedRegionToLargestPossibleRegion();
+  if ( !m_AccumulateStreamedRegions )
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
 }
 
 template< class TInputImage, class TLabelImage >
@@ -111,8 +123,17 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
     m_LabelStatisticsPerThread[i].clear();
     }
 
-  // Initialize the final map
-  m_LabelStatistics.clear();
+  // Initialize the final map, unless the regions of an unmodified image
+  // are streamed through the filter
+  const unsigned long mtime = std::max( this->GetMTime(), this->GetInput()->GetPipelineMTime() );
+  if ( !m_AccumulateStreamedRegions
+       || mtime != m_AccumulationMTime
+       || m_AccumulatedCount >= this->GetInput()->GetLargestPossibleRegion().GetNumberOfPixels() )
+    {
+    m_LabelStatistics.clear();
+    m_AccumulatedCount = 0;
+    m_AccumulationMTime = mtime;
+    }
 }
 
 template< class TInputImage, class TLabelImage >
@@ -155,8 +176,9 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 
       // accumulate the information from this thread
       ( *mapIt ).second.m_Count += ( *threadIt ).second.m_Count;
-      ( *mapIt ).second.m_Sum += ( *threadIt ).second.m_Sum;
-      ( *mapIt ).second.m_SumOfSquares += ( *threadIt ).second.m_SumOfSquares;
+      ( *mapIt ).second.m_SumAccumulator += ( *threadIt ).second.m_SumAccumulator;
+      ( *mapIt ).second.m_SumOfSquaresAccumulator += ( *threadIt ).second.m_SumOfSquaresAccumulator;
+      m_AccumulatedCount += ( *threadIt ).second.m_Count;
 
       if ( ( *mapIt ).second.m_Minimum > ( *threadIt ).second.m_Minimum )
         {
@@ -200,6 +222,9 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
         mapIt != m_LabelStatistics.end();
         ++mapIt )
     {
+    ( *mapIt ).second.m_Sum = ( *mapIt ).second.m_SumAccumulator.GetSum();
+    ( *mapIt ).second.m_SumOfSquares = ( *mapIt ).second.m_SumOfSquaresAccumulator.GetSum();
+
     // mean
     ( *mapIt ).second.m_Mean = ( *mapIt ).second.m_Sum
                                / static_cast< RealType >( ( *mapIt ).second.m_Count );
@@ -304,8 +329,8 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
         }
       }
 
-    ( *mapIt ).second.m_Sum += value;
-    ( *mapIt ).second.m_SumOfSquares += ( value * value );
+    ( *mapIt ).second.m_SumAccumulator += value;
+    ( *mapIt ).second.m_SumOfSquaresAccumulator += ( value * value );
     ( *mapIt ).second.m_Count++;
 
     // if enabled, update the histogram for this label
@@ -587,6 +612,8 @@ LabelStatisticsImageFilter< TImage, TLabelImage >
      << std::endl;
   os << indent << "Histogram Upper Bound: " << m_UpperBound
      << std::endl;
+  os << indent << "AccumulateStreamedRegions: " << m_AccumulateStreamedRegions
+     << std::endl;
 }
 } // end namespace itk
 #endif
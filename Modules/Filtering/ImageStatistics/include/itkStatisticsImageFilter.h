@@ -22,6 +22,8 @@
 #include "itkNumericTraits.h"
 #include "itkArray.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkCompensatedSummation.h"
+#include <vector>
 
 namespace itk
 {
@@ -36,7 +38,17 @@ namespace itk
  *
  * The filter passes its input through unmodified.  The filter is
  * threaded. It computes statistics in each thread then combines them in
- * its AfterThreadedGenerate method.
+ * its AfterThreadedGenerate method.  The sums are compensated for the
+ * rounding errors (see CompensatedSummation), so the mean and variance of
+ * very large images keep their precision.
+ *
+ * When AccumulateStreamedRegions is on, the filter does not request its
+ * whole input, and can be followed by a StreamingImageFilter: each
+ * execution over a streamed region adds the pixels of the region to the
+ * statistics, which are those of the whole image once all the regions of
+ * the image have been processed.  The accumulation restarts after all the
+ * pixels of the image have been counted, or when the filter or its
+ * upstream pipeline is modified.  The streamed regions must not overlap.
  *
  * \ingroup MathematicalStatisticsImageFilters
  * \ingroup ITK-ImageStatistics
@@ -122,6 +134,12 @@ public:
 
   const RealObjectType * GetSumOutput() const;
 
+  /** Accumulate the statistics over the regions streamed through the
+   * filter instead of requesting the whole input.  Off by default. */
+  itkSetMacro(AccumulateStreamedRegions, bool);
+  itkGetConstMacro(AccumulateStreamedRegions, bool);
+  itkBooleanMacro(AccumulateStreamedRegions);
+
   /** Make a DataObject of the correct type to be used as the specified
    * output. */
   virtual DataObjectPointer MakeOutput(unsigned int idx);
@@ -164,11 +182,23 @@ private:
   StatisticsImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);        //purposely not implemented
 
-  Array< RealType >       m_ThreadSum;
-  Array< RealType >       m_SumOfSquares;
+  typedef CompensatedSummation< RealType > SumType;
+
+  std::vector< SumType >  m_ThreadSum;
+  std::vector< SumType >  m_SumOfSquares;
   Array< SizeValueType >  m_Count;
   Array< PixelType >      m_ThreadMin;
   Array< PixelType >      m_ThreadMax;
+
+  bool m_AccumulateStreamedRegions;
+
+  /** Statistics of the regions processed so far */
+  SumType       m_AccumulatedSum;
+  SumType       m_AccumulatedSumOfSquares;
+  SizeValueType m_AccumulatedCount;
+  PixelType     m_AccumulatedMinimum;
+  PixelType     m_AccumulatedMaximum;
+  unsigned long m_AccumulationMTime;
 }; // end of class
 } // end namespace itk
 
@@ -21,6 +21,7 @@
 
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -54,6 +55,12 @@ StatisticsImageFilter< TInputImage >
   this->GetSigmaOutput()->Set( NumericTraits< RealType >::max() );
   this->GetVarianceOutput()->Set( NumericTraits< RealType >::max() );
   this->GetSumOutput()->Set(NumericTraits< RealType >::Zero);
+
+  m_AccumulateStreamedRegions = false;
+  m_AccumulatedCount = 0;
+  m_AccumulatedMinimum = NumericTraits< PixelType >::max();
+  m_AccumulatedMaximum = NumericTraits< PixelType >::NonpositiveMin();
+  m_AccumulationMTime = 0;
 }
 
 template< class TInputImage >
@@ -187,7 +194,7 @@ StatisticsImageFilter< TInputImage >
 ::GenerateInputRequestedRegion()
 {
   Superclass::GenerateInputRequestedRegion();
-  if ( this->GetInput() )
+  if ( this->GetInput() && !m_AccumulateStreamedRegions )
     {
     InputImagePointer image =
       const_cast< typename Superclass::InputImageType * >( this->GetInput() );
@@ -201,7 +208,10 @@ StatisticsImageFilter< TInputImage >
 ::EnlargeOutputRequestedRegion(DataObject *data)
 {
   Superclass::EnlargeOutputRequestedRegion(data);
-  data->SetRequestedRegionToLargestPossibleRegion();
+  if ( !m_AccumulateStreamedRegions )
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
 }
 
 template< class TInputImage >
@@ -227,17 +237,35 @@ StatisticsImageFilter< TInputImage >
 
   // Resize the thread temporaries
   m_Count.SetSize(numberOfThreads);
-  m_SumOfSquares.SetSize(numberOfThreads);
-  m_ThreadSum.SetSize(numberOfThreads);
+  m_SumOfSquares.resize(numberOfThreads);
+  m_ThreadSum.resize(numberOfThreads);
   m_ThreadMin.SetSize(numberOfThreads);
   m_ThreadMax.SetSize(numberOfThreads);
 
   // Initialize the temporaries
   m_Count.Fill(NumericTraits< SizeValueType >::Zero);
-  m_ThreadSum.Fill(NumericTraits< RealType >::Zero);
-  m_SumOfSquares.Fill(NumericTraits< RealType >::Zero);
+  for ( ThreadIdType i = 0; i < numberOfThreads; i++ )
+    {
+    m_ThreadSum[i].ResetToZero();
+    m_SumOfSquares[i].ResetToZero();
+    }
   m_ThreadMin.Fill( NumericTraits< PixelType >::max() );
   m_ThreadMax.Fill( NumericTraits< PixelType >::NonpositiveMin() );
+
+  // The statistics of the previous executions are kept only while the
+  // regions of an unmodified image are streamed through the filter
+  const unsigned long mtime = std::max( this->GetMTime(), this->GetInput()->GetPipelineMTime() );
+  if ( !m_AccumulateStreamedRegions
+       || mtime != m_AccumulationMTime
+       || m_AccumulatedCount >= this->GetInput()->GetLargestPossibleRegion().GetNumberOfPixels() )
+    {
+    m_AccumulatedSum.ResetToZero();
+    m_AccumulatedSumOfSquares.ResetToZero();
+    m_AccumulatedCount = 0;
+    m_AccumulatedMinimum = NumericTraits< PixelType >::max();
+    m_AccumulatedMaximum = NumericTraits< PixelType >::NonpositiveMin();
+    m_AccumulationMTime = mtime;
+    }
 }
 
 template< class TInputImage >
@@ -245,41 +273,36 @@ void
 StatisticsImageFilter< TInputImage >
 ::AfterThreadedGenerateData()
 {
-  ThreadIdType    i;
-  SizeValueType   count;
-  RealType        sumOfSquares;
-
   ThreadIdType numberOfThreads = this->GetNumberOfThreads();
 
-  PixelType minimum;
-  PixelType maximum;
-  RealType  mean;
-  RealType  sigma;
-  RealType  variance;
-  RealType  sum;
-
-  sum = sumOfSquares = NumericTraits< RealType >::Zero;
-  count = 0;
+  RealType mean;
+  RealType sigma;
+  RealType variance;
 
   // Find the min/max over all threads and accumulate count, sum and
-  // sum of squares
-  minimum = NumericTraits< PixelType >::max();
-  maximum = NumericTraits< PixelType >::NonpositiveMin();
-  for ( i = 0; i < numberOfThreads; i++ )
+  // sum of squares, with those of the regions already processed
+  for ( ThreadIdType i = 0; i < numberOfThreads; i++ )
     {
-    count += m_Count[i];
-    sum += m_ThreadSum[i];
-    sumOfSquares += m_SumOfSquares[i];
+    m_AccumulatedCount += m_Count[i];
+    m_AccumulatedSum += m_ThreadSum[i];
+    m_AccumulatedSumOfSquares += m_SumOfSquares[i];
 
-    if ( m_ThreadMin[i] < minimum )
+    if ( m_ThreadMin[i] < m_AccumulatedMinimum )
       {
-      minimum = m_ThreadMin[i];
+      m_AccumulatedMinimum = m_ThreadMin[i];
       }
-    if ( m_ThreadMax[i] > maximum )
+    if ( m_ThreadMax[i] > m_AccumulatedMaximum )
       {
-      maximum = m_ThreadMax[i];
+      m_AccumulatedMaximum = m_ThreadMax[i];
       }
     }
+
+  const SizeValueType count = m_AccumulatedCount;
+  const RealType      sum = m_AccumulatedSum.GetSum();
+  const RealType      sumOfSquares = m_AccumulatedSumOfSquares.GetSum();
+  const PixelType     minimum = m_AccumulatedMinimum;
+  const PixelType     maximum = m_AccumulatedMaximum;
+
   // compute statistics
   mean = sum / static_cast< RealType >( count );
 
@@ -306,6 +329,21 @@ StatisticsImageFilter< TInputImage >
   RealType  realValue;
   PixelType value;
 
+  // accumulate in local variables, written once to the thread temporaries
+  PixelType     minimum = NumericTraits< PixelType >::max();
+  PixelType     maximum = NumericTraits< PixelType >::NonpositiveMin();
+  SumType       sum;
+  SumType       sumOfSquares;
+  SizeValueType count = 0;
+
+  // The pixels are summed naively by blocks, whose sums are then added
+  // with compensation: the error is that of the sum of a block, at nearly
+  // the cost of the naive sum
+  const SizeValueType blockLength = 1024;
+  RealType            blockSum = NumericTraits< RealType >::Zero;
+  RealType            blockSumOfSquares = NumericTraits< RealType >::Zero;
+  SizeValueType       blockCount = 0;
+
   ImageRegionConstIterator< TInputImage > it (this->GetInput(), outputRegionForThread);
 
   // support progress methods/callbacks
@@ -316,21 +354,37 @@ StatisticsImageFilter< TInputImage >
     {
     value = it.Get();
     realValue = static_cast< RealType >( value );
-    if ( value < m_ThreadMin[threadId] )
+    if ( value < minimum )
       {
-      m_ThreadMin[threadId] = value;
+      minimum = value;
       }
-    if ( value > m_ThreadMax[threadId] )
+    if ( value > maximum )
       {
-      m_ThreadMax[threadId] = value;
+      maximum = value;
       }
 
-    m_ThreadSum[threadId] += realValue;
-    m_SumOfSquares[threadId] += ( realValue * realValue );
-    m_Count[threadId]++;
+    blockSum += realValue;
+    blockSumOfSquares += ( realValue * realValue );
+    if ( ++blockCount == blockLength )
+      {
+      sum += blockSum;
+      sumOfSquares += blockSumOfSquares;
+      blockSum = blockSumOfSquares = NumericTraits< RealType >::Zero;
+      count += blockCount;
+      blockCount = 0;
+      }
     ++it;
     progress.CompletedPixel();
     }
+  sum += blockSum;
+  sumOfSquares += blockSumOfSquares;
+  count += blockCount;
+
+  m_ThreadMin[threadId] = minimum;
+  m_ThreadMax[threadId] = maximum;
+  m_ThreadSum[threadId] = sum;
+  m_SumOfSquares[threadId] = sumOfSquares;
+  m_Count[threadId] = count;
 }
 
 template< class TImage >
@@ -348,6 +402,7 @@ StatisticsImageFilter< TImage >
   os << indent << "Mean: "     << this->GetMean() << std::endl;
   os << indent << "Sigma: "    << this->GetSigma() << std::endl;
   os << indent << "Variance: " << this->GetVariance() << std::endl;
+  os << indent << "AccumulateStreamedRegions: " << m_AccumulateStreamedRegions << std::endl;
 }
 } // end namespace itk
 #endif
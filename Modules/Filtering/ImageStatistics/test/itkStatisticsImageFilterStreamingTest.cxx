@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkStatisticsImageFilter.h"
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkImageRegionIterator.h"
+
+// The statistics accumulated over the regions streamed through
+// StatisticsImageFilter and LabelStatisticsImageFilter must be those
+// computed over the whole image, without the upstream filter producing the
+// whole image, and must be computed again when the input is modified.
+
+namespace
+{
+const unsigned int Dimension = 3;
+
+typedef itk::Image< float, Dimension >         ImageType;
+typedef itk::Image< unsigned char, Dimension > LabelImageType;
+
+typedef itk::CastImageFilter< ImageType, ImageType >                  SourceType;
+typedef itk::StatisticsImageFilter< ImageType >                       StatisticsType;
+typedef itk::LabelStatisticsImageFilter< ImageType, LabelImageType > LabelStatisticsType;
+typedef itk::StreamingImageFilter< ImageType, ImageType >            StreamerType;
+
+void FillImages(ImageType *image, LabelImageType *labels, float offset)
+{
+  itk::ImageRegionIterator< ImageType >      it( image, image->GetBufferedRegion() );
+  itk::ImageRegionIterator< LabelImageType > lt( labels, labels->GetBufferedRegion() );
+  unsigned int                               seed = 1;
+  for (; !it.IsAtEnd(); ++it, ++lt )
+    {
+    seed = seed * 1103515245u + 12345u;
+    it.Set( offset + static_cast< float >( ( seed >> 16 ) % 1000 ) / 8.0f );
+    lt.Set( static_cast< unsigned char >( ( seed >> 8 ) % 4 ) );
+    }
+  image->Modified();
+}
+
+bool Close(double value, double expected, const char *name)
+{
+  if ( vnl_math_abs(value - expected) > 1e-9 * ( 1.0 + vnl_math_abs(expected) ) )
+    {
+    std::cerr << name << ": " << value << " instead of " << expected << std::endl;
+    return false;
+    }
+  return true;
+}
+
+bool CompareStatistics(const StatisticsType *streamed, const StatisticsType *expected)
+{
+  bool ok = true;
+
+  if ( streamed->GetMinimum() != expected->GetMinimum()
+       || streamed->GetMaximum() != expected->GetMaximum() )
+    {
+    std::cerr << "Extrema: " << streamed->GetMinimum() << ", " << streamed->GetMaximum()
+              << " instead of " << expected->GetMinimum() << ", " << expected->GetMaximum() << std::endl;
+    ok = false;
+    }
+  ok = Close(streamed->GetSum(), expected->GetSum(), "Sum") && ok;
+  ok = Close(streamed->GetMean(), expected->GetMean(), "Mean") && ok;
+  ok = Close(streamed->GetVariance(), expected->GetVariance(), "Variance") && ok;
+  return ok;
+}
+
+bool CompareLabelStatistics(const LabelStatisticsType *streamed, const LabelStatisticsType *expected)
+{
+  bool ok = true;
+
+  if ( streamed->GetNumberOfLabels() != expected->GetNumberOfLabels() )
+    {
+    std::cerr << streamed->GetNumberOfLabels() << " labels instead of "
+              << expected->GetNumberOfLabels() << std::endl;
+    return false;
+    }
+  for ( unsigned char label = 0; label < 4; label++ )
+    {
+    if ( streamed->GetCount(label) != expected->GetCount(label)
+         || streamed->GetMinimum(label) != expected->GetMinimum(label)
+         || streamed->GetMaximum(label) != expected->GetMaximum(label)
+         || !( streamed->GetRegion(label) == expected->GetRegion(label) ) )
+      {
+      std::cerr << "Wrong count, extrema or region of the label " << int(label) << std::endl;
+      ok = false;
+      }
+    ok = Close(streamed->GetSum(label), expected->GetSum(label), "Label sum") && ok;
+    ok = Close(streamed->GetVariance(label), expected->GetVariance(label), "Label variance") && ok;
+    }
+  return ok;
+}
+}
+
+int itkStatisticsImageFilterStreamingTest(int, char *[])
+{
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 48;
+  size[2] = 40;
+  ImageType::RegionType region(size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(region);
+  labels->Allocate();
+
+  // values far from zero, whose variance is lost by naive sums
+  FillImages(image, labels, 1000.0f);
+
+  // the statistics of the whole image
+  StatisticsType::Pointer expected = StatisticsType::New();
+  expected->SetInput(image);
+  expected->Update();
+
+  LabelStatisticsType::Pointer expectedLabels = LabelStatisticsType::New();
+  expectedLabels->SetInput(image);
+  expectedLabels->SetLabelInput(labels);
+  expectedLabels->Update();
+
+  // the same statistics over the regions streamed from a source filter
+  SourceType::Pointer source = SourceType::New();
+  source->SetInput(image);
+
+  StatisticsType::Pointer statistics = StatisticsType::New();
+  statistics->SetInput( source->GetOutput() );
+  statistics->AccumulateStreamedRegionsOn();
+
+  LabelStatisticsType::Pointer labelStatistics = LabelStatisticsType::New();
+  labelStatistics->SetInput( statistics->GetOutput() );
+  labelStatistics->SetLabelInput(labels);
+  labelStatistics->AccumulateStreamedRegionsOn();
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( labelStatistics->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(5);
+  streamer->Update();
+
+  std::cout << "Streamed: " << statistics;
+
+  if ( source->GetOutput()->GetBufferedRegion() == region )
+    {
+    std::cerr << "The whole image was produced upstream" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !CompareStatistics(statistics, expected)
+       || !CompareLabelStatistics(labelStatistics, expectedLabels) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the accumulation restarts when the input is modified
+  FillImages(image, labels, -50.0f);
+  expected->Update();
+  expectedLabels->Update();
+  streamer->Update();
+  if ( !CompareStatistics(statistics, expected)
+       || !CompareLabelStatistics(labelStatistics, expectedLabels) )
+    {
+    std::cerr << "After the modification of the input" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // and when the filter is modified
+  statistics->Modified();
+  labelStatistics->Modified();
+  streamer->Update();
+  if ( !CompareStatistics(statistics, expected)
+       || !CompareLabelStatistics(labelStatistics, expectedLabels) )
+    {
+    std::cerr << "After the modification of the filters" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // without accumulation, the filters request their whole input
+  statistics->AccumulateStreamedRegionsOff();
+  labelStatistics->AccumulateStreamedRegionsOff();
+  streamer->Update();
+  if ( !( source->GetOutput()->GetBufferedRegion() == region ) )
+    {
+    std::cerr << "The whole image was not produced upstream" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !CompareStatistics(statistics, expected)
+       || !CompareLabelStatistics(labelStatistics, expectedLabels) )
+    {
+    std::cerr << "Without accumulation" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -21,6 +21,7 @@
 #include "itkQuadEdgeMeshToQuadEdgeMeshFilter.h"
 #include "itkConceptChecking.h"
 #include "itkTriangleHelper.h"
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
 
 namespace itk
 {
@@ -29,6 +30,11 @@ namespace itk
  *
  * \brief FIXME
  *
+ * When UseCompactAdjacency is on, the vertices are enumerated once in
+ * compressed sparse row arrays and the curvatures are estimated by
+ * GetNumberOfThreads() threads before being stored as point data.
+ * EstimateCurvature() must then be reentrant.
+ *
  * \ingroup ITK-QuadEdgeMeshFiltering
  */
 template< class TInputMesh, class TOutputMesh=TInputMesh >
@@ -68,10 +74,20 @@ public:
   /** End concept checking */
 #endif
 
+  /** Set/Get whether the vertices are processed by several threads over
+   * the flattened adjacency of the mesh. Off by default. */
+  itkSetMacro(UseCompactAdjacency, bool);
+  itkGetConstMacro(UseCompactAdjacency, bool);
+  itkBooleanMacro(UseCompactAdjacency);
+
 protected:
-  DiscreteCurvatureQuadEdgeMeshFilter() {}
+  DiscreteCurvatureQuadEdgeMeshFilter():m_UseCompactAdjacency(false) {}
   ~DiscreteCurvatureQuadEdgeMeshFilter() {}
 
+  typedef QuadEdgeMeshOneRingAdjacency< OutputMeshType > AdjacencyType;
+
+  bool m_UseCompactAdjacency;
+
   virtual OutputCurvatureType EstimateCurvature(const OutputPointType & iP) = 0;
 
   OutputCurvatureType ComputeMixedArea(OutputQEType *iQE1, OutputQEType *iQE2)
@@ -123,12 +139,50 @@ protected:
       }
   }
 
+  /** Estimate the curvature of a range of vertices of m_Adjacency. */
+  void EstimateCurvatures(SizeValueType first, SizeValueType last)
+  {
+    for ( SizeValueType v = first; v < last; ++v )
+      {
+      m_Curvatures[v] = this->EstimateCurvature(*m_MeshPoints[v]);
+      }
+  }
+
   virtual void GenerateData()
   {
     this->CopyInputMeshToOutputMesh();
 
     OutputMeshPointer output = this->GetOutput();
 
+    if ( m_UseCompactAdjacency )
+      {
+      m_Adjacency.Build(output);
+
+      const SizeValueType numberOfVertices = m_Adjacency.GetNumberOfVertices();
+      OutputPointsContainerPointer points = output->GetPoints();
+      m_MeshPoints.resize(numberOfVertices);
+      m_Curvatures.resize(numberOfVertices);
+      for ( SizeValueType v = 0; v < numberOfVertices; ++v )
+        {
+        m_MeshPoints[v] = &( points->ElementAt( m_Adjacency.GetPointIdentifier(v) ) );
+        }
+
+      this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+      EstimateCurvaturesFunctor estimate;
+      estimate.m_Filter = this;
+      m_Adjacency.ParallelForEachVertexRange(this->GetMultiThreader(), estimate);
+
+      for ( SizeValueType v = 0; v < numberOfVertices; ++v )
+        {
+        output->SetPointData(m_Adjacency.GetPointIdentifier(v), m_Curvatures[v]);
+        }
+
+      m_Adjacency = AdjacencyType();
+      std::vector< const OutputPointType * >().swap(m_MeshPoints);
+      std::vector< OutputCurvatureType >().swap(m_Curvatures);
+      return;
+      }
+
     OutputPointsContainerPointer  points = output->GetPoints();
     OutputPointsContainerIterator p_it = points->Begin();
 
@@ -143,6 +197,18 @@ protected:
   }
 
 private:
+  struct EstimateCurvaturesFunctor {
+    Self *m_Filter;
+    void operator()(SizeValueType first, SizeValueType last)
+    { m_Filter->EstimateCurvatures(first, last); }
+  };
+
+  friend struct EstimateCurvaturesFunctor;
+
+  AdjacencyType                          m_Adjacency;
+  std::vector< const OutputPointType * > m_MeshPoints;
+  std::vector< OutputCurvatureType >     m_Curvatures;
+
   DiscreteCurvatureQuadEdgeMeshFilter(const Self &); // purposely not
                                                         // implemented
   void operator=(const Self &);                         // purposely not
@@ -77,8 +77,11 @@ protected:
 
   virtual OutputCurvatureType EstimateCurvature(const OutputPointType & iP)
   {
-    this->ComputeMeanAndGaussianCurvatures(iP);
-    return this->m_Mean - vcl_sqrt( this->ComputeDelta() );
+    OutputCurvatureType mean;
+    OutputCurvatureType gaussian;
+
+    this->ComputeMeanAndGaussianCurvatures(iP, mean, gaussian);
+    return mean - vcl_sqrt( this->ComputeDelta(mean, gaussian) );
   }
 
 private:
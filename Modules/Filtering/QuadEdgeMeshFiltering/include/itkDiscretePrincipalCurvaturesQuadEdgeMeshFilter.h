@@ -79,13 +79,22 @@ protected:
   OutputCurvatureType m_Mean;
 
   void ComputeMeanAndGaussianCurvatures(const OutputPointType & iP)
+  {
+    this->ComputeMeanAndGaussianCurvatures(iP, m_Mean, m_Gaussian);
+  }
+
+  /** Compute the mean and Gaussian curvatures at iP without modifying
+   * the filter, so that the vertices can be processed by several threads. */
+  void ComputeMeanAndGaussianCurvatures(const OutputPointType & iP,
+                                        OutputCurvatureType & oMean,
+                                        OutputCurvatureType & oGaussian)
   {
     OutputMeshPointer output = this->GetOutput();
 
     OutputQEType *qe = iP.GetEdge();
 
-    m_Mean = 0.;
-    m_Gaussian = 0.;
+    oMean = 0.;
+    oGaussian = 0.;
 
     if ( qe != 0 )
       {
@@ -139,17 +148,23 @@ protected:
           {
           area = 1. / area;
           Laplace *= 0.25 * area;
-          m_Mean = Laplace * normal;
-          m_Gaussian = ( 2. * vnl_math::pi - sum_theta ) * area;
+          oMean = Laplace * normal;
+          oGaussian = ( 2. * vnl_math::pi - sum_theta ) * area;
           }
         }
       }
   }
 
   virtual OutputCurvatureType ComputeDelta()
+  {
+    return this->ComputeDelta(m_Mean, m_Gaussian);
+  }
+
+  OutputCurvatureType ComputeDelta(const OutputCurvatureType & iMean,
+                                   const OutputCurvatureType & iGaussian) const
   {
     return vnl_math_max( static_cast<OutputCurvatureType>( 0. ),
-                         m_Mean * m_Mean - m_Gaussian );
+                         iMean * iMean - iGaussian );
   }
 
 private:
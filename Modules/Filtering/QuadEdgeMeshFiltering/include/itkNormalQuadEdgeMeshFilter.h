@@ -21,6 +21,7 @@
 #include "itkQuadEdgeMeshToQuadEdgeMeshFilter.h"
 #include "itkQuadEdgeMeshPolygonCell.h"
 #include "itkTriangleHelper.h"
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
 
 namespace itk
 {
@@ -57,6 +58,11 @@ namespace itk
  *
  * \note By default the weight is set to the TURMER weight.
  *
+ * When UseCompactAdjacency is on, face normals and vertex normals are
+ * computed by GetNumberOfThreads() threads, the vertex one-rings being read
+ * from a QuadEdgeMeshOneRingAdjacency, and then stored serially in the
+ * output mesh. Isolated points get a null normal.
+ *
  * \todo Fix run-time issues regarding the difference between the Traits of
  * TInputMesh and the one of TOutputMesh. Right now, it only works if
  * TInputMesh::MeshTraits == TOutputMesh::MeshTraits
@@ -124,6 +130,12 @@ public:
 
   itkSetMacro (Weight, WeightType);
   itkGetConstMacro (Weight, WeightType);
+
+  /** Set/Get whether the normals are computed by several threads. Off by
+   * default. */
+  itkSetMacro(UseCompactAdjacency, bool);
+  itkGetConstMacro(UseCompactAdjacency, bool);
+  itkBooleanMacro(UseCompactAdjacency);
 protected:
   NormalQuadEdgeMeshFilter();
   ~NormalQuadEdgeMeshFilter();
@@ -131,6 +143,10 @@ protected:
 
   WeightType m_Weight;
 
+  bool m_UseCompactAdjacency;
+
+  typedef QuadEdgeMeshOneRingAdjacency< OutputMeshType > AdjacencyType;
+
   /** \brief Compute the normal to a face iPoly. It assumes that iPoly != 0
   * and
   * iPoly is a Triangle, i.e. 3 points only.
@@ -164,6 +180,16 @@ protected:
   OutputVertexNormalComponentType Weight(const OutputPointIdentifier & iPId,
                                          const OutputCellIdentifier & iCId);
 
+  /** Compute the normals of the faces [first, last) of m_Faces. */
+  void ComputeFaceNormals(SizeValueType first, SizeValueType last);
+
+  /** Compute the normals of the vertices [first, last) of m_Adjacency. */
+  void ComputeVertexNormals(SizeValueType first, SizeValueType last);
+
+  /** Multi-threaded counterpart of ComputeAllFaceNormals() and
+   * ComputeAllVertexNormals(), used when UseCompactAdjacency is on. */
+  void ComputeAllNormalsWithCompactAdjacency();
+
   /** \note Calling Superclass::GenerateData( ) is the longest part in the
   * filter! Something must be done in the class
   * itkQuadEdgeMeshToQuadEdgeMeshFilter.
@@ -171,6 +197,26 @@ protected:
   void GenerateData();
 
 private:
+  struct FaceThreadStruct {
+    Self *Filter;
+  };
+
+  static ITK_THREAD_RETURN_TYPE ComputeFaceNormalsThreaderCallback(void *arg);
+
+  struct VertexNormalsFunctor {
+    Self *m_Filter;
+    void operator()(SizeValueType first, SizeValueType last)
+    { m_Filter->ComputeVertexNormals(first, last); }
+  };
+
+  friend struct VertexNormalsFunctor;
+
+  AdjacencyType                            m_Adjacency;
+  std::vector< OutputCellIdentifier >      m_FaceIdentifiers;
+  std::vector< OutputPolygonType * >       m_Faces;
+  std::vector< OutputFaceNormalType >      m_FaceNormals;
+  std::vector< OutputVertexNormalType >    m_VertexNormals;
+
   NormalQuadEdgeMeshFilter (const Self &);
   void operator=(const Self &);
 };
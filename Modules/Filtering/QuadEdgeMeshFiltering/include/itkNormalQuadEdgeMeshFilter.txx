@@ -27,6 +27,7 @@ NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
 ::NormalQuadEdgeMeshFilter()
 {
   this->m_Weight = THURMER;
+  this->m_UseCompactAdjacency = false;
 }
 
 template< class TInputMesh, class TOutputMesh >
@@ -130,6 +131,131 @@ NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
   return n;
 }
 
+template< class TInputMesh, class TOutputMesh >
+void
+NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeFaceNormals(SizeValueType first, SizeValueType last)
+{
+  for ( SizeValueType f = first; f < last; ++f )
+    {
+    m_FaceNormals[f] = ComputeFaceNormal(m_Faces[f]);
+    }
+}
+
+template< class TInputMesh, class TOutputMesh >
+void
+NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeVertexNormals(SizeValueType first, SizeValueType last)
+{
+  OutputMeshPointer output = this->GetOutput();
+
+  OutputFaceNormalType face_normal(0.);
+
+  for ( SizeValueType v = first; v < last; ++v )
+    {
+    const OutputPointIdentifier id = m_Adjacency.GetPointIdentifier(v);
+    const SizeValueType         end = m_Adjacency.GetRingEnd(v);
+    OutputVertexNormalType      n(0.);
+
+    if ( m_Adjacency.GetRingBegin(v) == end )
+      {
+      m_VertexNormals[v] = n;
+      continue;
+      }
+
+    // same ring order as ComputeVertexNormal()
+    for ( SizeValueType k = m_Adjacency.GetRingBegin(v); k < end; ++k )
+      {
+      OutputCellIdentifier cell_id = m_Adjacency.GetEdge(k)->GetLeft();
+      if ( cell_id != OutputMeshType::m_NoFace )
+        {
+        output->GetCellData(cell_id, &face_normal);
+        n += face_normal * Weight(id, cell_id);
+        }
+      }
+
+    n.Normalize();
+    m_VertexNormals[v] = n;
+    }
+}
+
+template< class TInputMesh, class TOutputMesh >
+ITK_THREAD_RETURN_TYPE
+NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeFaceNormalsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  FaceThreadStruct *               str = static_cast< FaceThreadStruct * >( info->UserData );
+
+  const SizeValueType numberOfFaces = str->Filter->m_Faces.size();
+  const SizeValueType threadId = info->ThreadID;
+  const SizeValueType numberOfThreads = info->NumberOfThreads;
+
+  str->Filter->ComputeFaceNormals( ( numberOfFaces * threadId ) / numberOfThreads,
+                                   ( numberOfFaces * ( threadId + 1 ) ) / numberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TInputMesh, class TOutputMesh >
+void
+NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeAllNormalsWithCompactAdjacency()
+{
+  OutputMeshPointer output = this->GetOutput();
+  OutputPolygonType *poly;
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+  // Faces are gathered first: the cells container is not walked by the
+  // threads, and the cell data is only written once they are done.
+  for ( OutputCellsContainerConstIterator
+        cell_it = output->GetCells()->Begin();
+        cell_it != output->GetCells()->End();
+        ++cell_it )
+    {
+    poly = dynamic_cast< OutputPolygonType * >( cell_it.Value() );
+
+    if ( poly != 0 )
+      {
+      if ( poly->GetNumberOfPoints() == 3 )
+        {
+        m_FaceIdentifiers.push_back( cell_it->Index() );
+        m_Faces.push_back(poly);
+        }
+      }
+    }
+  m_FaceNormals.resize( m_Faces.size() );
+
+  FaceThreadStruct str;
+  str.Filter = this;
+  this->GetMultiThreader()->SetSingleMethod(&Self::ComputeFaceNormalsThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  for ( SizeValueType f = 0; f < m_Faces.size(); ++f )
+    {
+    output->SetCellData(m_FaceIdentifiers[f], m_FaceNormals[f]);
+    }
+
+  m_Adjacency.Build(output);
+  m_VertexNormals.resize( m_Adjacency.GetNumberOfVertices() );
+
+  VertexNormalsFunctor vertexNormals;
+  vertexNormals.m_Filter = this;
+  m_Adjacency.ParallelForEachVertexRange(this->GetMultiThreader(), vertexNormals);
+
+  for ( SizeValueType v = 0; v < m_VertexNormals.size(); ++v )
+    {
+    output->SetPointData(m_Adjacency.GetPointIdentifier(v), m_VertexNormals[v]);
+    }
+
+  m_Adjacency = AdjacencyType();
+  std::vector< OutputCellIdentifier >().swap(m_FaceIdentifiers);
+  std::vector< OutputPolygonType * >().swap(m_Faces);
+  std::vector< OutputFaceNormalType >().swap(m_FaceNormals);
+  std::vector< OutputVertexNormalType >().swap(m_VertexNormals);
+}
+
 template< class TInputMesh, class TOutputMesh >
 typename NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::OutputVertexNormalComponentType
 NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
@@ -235,6 +361,11 @@ void NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
 ::GenerateData()
 {
   this->CopyInputMeshToOutputMesh();
+  if ( m_UseCompactAdjacency )
+    {
+    this->ComputeAllNormalsWithCompactAdjacency();
+    return;
+    }
   this->ComputeAllFaceNormals();
   this->ComputeAllVertexNormals();
 }
@@ -246,6 +377,7 @@ void NormalQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
   Superclass::PrintSelf(os, indent);
 
   std::cout << indent << "Weight: " << m_Weight << std::endl;
+  os << indent << "UseCompactAdjacency: " << m_UseCompactAdjacency << std::endl;
 }
 }
 
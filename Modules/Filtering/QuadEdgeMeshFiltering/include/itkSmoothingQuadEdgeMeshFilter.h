@@ -20,12 +20,21 @@
 
 #include "itkDelaunayConformingQuadEdgeMeshFilter.h"
 #include "itkQuadEdgeMeshParamMatrixCoefficients.h"
+#include "itkQuadEdgeMeshOneRingAdjacency.h"
 
 namespace itk
 {
 /**
  * \class SmoothingQuadEdgeMeshFilter
  * \brief Quad Edge Mesh Smoothing Filter
+ *
+ * When UseCompactAdjacency is on, the one-ring of every vertex is
+ * flattened once in compressed sparse row arrays (rebuilt at each
+ * iteration in the Delaunay conforming mode) and the new positions are
+ * computed by GetNumberOfThreads() threads. All the vertices of an
+ * iteration are then moved from the positions of the previous iteration,
+ * whereas the default mode moves the vertices in place from the second
+ * iteration on, so both modes only agree for a single iteration.
  * \ingroup ITK-QuadEdgeMeshFiltering
  */
 template< class TInputMesh, class TOutputMesh=TInputMesh >
@@ -82,6 +91,12 @@ public:
 
   itkSetMacro(RelaxationFactor, OutputCoordType);
   itkGetConstMacro(RelaxationFactor, OutputCoordType);
+
+  /** Set/Get whether the one-ring adjacency is flattened and the
+   * vertices are processed by several threads. Off by default. */
+  itkSetMacro(UseCompactAdjacency, bool);
+  itkGetConstMacro(UseCompactAdjacency, bool);
+  itkBooleanMacro(UseCompactAdjacency);
 protected:
   SmoothingQuadEdgeMeshFilter();
   ~SmoothingQuadEdgeMeshFilter();
@@ -99,9 +114,42 @@ protected:
 
   OutputCoordType m_RelaxationFactor;
 
+  bool m_UseCompactAdjacency;
+
   void GenerateData();
 
+  typedef QuadEdgeMeshOneRingAdjacency< OutputMeshType > AdjacencyType;
+
+  /** One smoothing iteration over the flattened adjacency of the mesh. */
+  void SmoothWithCompactAdjacency(OutputMeshType *mesh, bool rebuildAdjacency);
+
+  /** Compute the new positions of a range of vertices. */
+  void ComputeNewPositions(SizeValueType first, SizeValueType last);
+
+  /** Copy the new positions of a range of vertices to the mesh. */
+  void UpdatePositions(SizeValueType first, SizeValueType last);
+
 private:
+  struct ComputeNewPositionsFunctor {
+    Self *m_Filter;
+    void operator()(SizeValueType first, SizeValueType last)
+    { m_Filter->ComputeNewPositions(first, last); }
+  };
+
+  struct UpdatePositionsFunctor {
+    Self *m_Filter;
+    void operator()(SizeValueType first, SizeValueType last)
+    { m_Filter->UpdatePositions(first, last); }
+  };
+
+  friend struct ComputeNewPositionsFunctor;
+  friend struct UpdatePositionsFunctor;
+
+  AdjacencyType                   m_Adjacency;
+  OutputMeshType *                m_AdjacencyMesh;
+  std::vector< OutputPointType * > m_MeshPoints;
+  std::vector< OutputPointType >   m_NewPositions;
+
   SmoothingQuadEdgeMeshFilter(const Self &);
   void operator=(const Self &);
 };
@@ -30,6 +30,8 @@ SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
   this->m_DelaunayConforming = false;
   this->m_NumberOfIterations = 1;
   this->m_RelaxationFactor = static_cast< OutputCoordType >( 1.0 );
+  this->m_UseCompactAdjacency = false;
+  this->m_AdjacencyMesh = 0;
 
   this->m_InputDelaunayFilter = InputOutputDelaunayConformingType::New();
   this->m_OutputDelaunayFilter = OutputDelaunayConformingType::New();
@@ -92,44 +94,51 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
 
   for ( unsigned int iter = 0; iter < m_NumberOfIterations; ++iter )
     {
-    points = mesh->GetPoints();
-
-    for ( it = points->Begin(); it != points->End(); ++it )
+    if ( this->m_UseCompactAdjacency )
+      {
+      this->SmoothWithCompactAdjacency( mesh, iter == 0 || this->m_DelaunayConforming );
+      }
+    else
       {
-      p = it.Value();
-      qe = p.GetEdge();
-      if ( qe != 0 )
+      points = mesh->GetPoints();
+
+      for ( it = points->Begin(); it != points->End(); ++it )
         {
-        r = p;
-        v.Fill(0.0);
-        qe_it = qe;
-        sum_coeff = 0.;
-        do
+        p = it.Value();
+        qe = p.GetEdge();
+        if ( qe != 0 )
           {
-          q = mesh->GetPoint( qe_it->GetDestination() );
+          r = p;
+          v.Fill(0.0);
+          qe_it = qe;
+          sum_coeff = 0.;
+          do
+            {
+            q = mesh->GetPoint( qe_it->GetDestination() );
 
-          coeff = ( *m_CoefficientsMethod )( mesh, qe_it );
-          sum_coeff += coeff;
+            coeff = ( *m_CoefficientsMethod )( mesh, qe_it );
+            sum_coeff += coeff;
 
-          v += coeff * ( q - p );
-          qe_it = qe_it->GetOnext();
-          }
-        while ( qe_it != qe );
+            v += coeff * ( q - p );
+            qe_it = qe_it->GetOnext();
+            }
+          while ( qe_it != qe );
 
-        den = 1.0 / static_cast< OutputCoordType >( sum_coeff );
-        v *= den;
+          den = 1.0 / static_cast< OutputCoordType >( sum_coeff );
+          v *= den;
 
-        r += m_RelaxationFactor * v;
-        r.SetEdge(qe);
-        temp->SetElement(it.Index(), r);
-        }
-      else
-        {
-        temp->SetElement(it.Index(), p);
+          r += m_RelaxationFactor * v;
+          r.SetEdge(qe);
+          temp->SetElement(it.Index(), r);
+          }
+        else
+          {
+          temp->SetElement(it.Index(), p);
+          }
         }
-      }
 
-    mesh->SetPoints(temp);
+      mesh->SetPoints(temp);
+      }
 
     if ( this->m_DelaunayConforming )
       {
@@ -154,6 +163,104 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
       this->GraftOutput(mesh);
       }
     }
+
+  // release the flattened adjacency
+  m_Adjacency = AdjacencyType();
+  m_AdjacencyMesh = 0;
+  std::vector< OutputPointType * >().swap(m_MeshPoints);
+  std::vector< OutputPointType >().swap(m_NewPositions);
+}
+
+template< class TInputMesh, class TOutputMesh >
+void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::SmoothWithCompactAdjacency(OutputMeshType *mesh, bool rebuildAdjacency)
+{
+  if ( rebuildAdjacency )
+    {
+    m_Adjacency.Build(mesh);
+    m_AdjacencyMesh = mesh;
+
+    // the point objects of the mesh are updated in place
+    OutputPointsContainer *points = mesh->GetPoints();
+    const SizeValueType    numberOfVertices = m_Adjacency.GetNumberOfVertices();
+    m_MeshPoints.resize(numberOfVertices);
+    for ( SizeValueType v = 0; v < numberOfVertices; v++ )
+      {
+      m_MeshPoints[v] = &( points->ElementAt( m_Adjacency.GetPointIdentifier(v) ) );
+      }
+    m_NewPositions.resize(numberOfVertices);
+    }
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+  // all the new positions are computed from the current ones before
+  // the mesh is updated
+  ComputeNewPositionsFunctor compute;
+  compute.m_Filter = this;
+  m_Adjacency.ParallelForEachVertexRange(this->GetMultiThreader(), compute);
+
+  UpdatePositionsFunctor update;
+  update.m_Filter = this;
+  m_Adjacency.ParallelForEachVertexRange(this->GetMultiThreader(), update);
+}
+
+template< class TInputMesh, class TOutputMesh >
+void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ComputeNewPositions(SizeValueType first, SizeValueType last)
+{
+  const OutputMeshType *mesh = m_AdjacencyMesh;
+
+  OutputVectorType v;
+  OutputCoordType  coeff;
+  OutputCoordType  sum_coeff;
+  OutputCoordType  den;
+
+  for ( SizeValueType vertex = first; vertex < last; ++vertex )
+    {
+    const OutputPointType & p = *m_MeshPoints[vertex];
+    OutputPointType &       r = m_NewPositions[vertex];
+
+    r = p;
+
+    const SizeValueType ringEnd = m_Adjacency.GetRingEnd(vertex);
+    SizeValueType       k = m_Adjacency.GetRingBegin(vertex);
+    if ( k == ringEnd )
+      {
+      continue;
+      }
+
+    v.Fill(0.0);
+    sum_coeff = 0.;
+    for (; k < ringEnd; ++k )
+      {
+      const OutputPointType & q = *m_MeshPoints[m_Adjacency.GetNeighbor(k)];
+
+      coeff = ( *m_CoefficientsMethod )( mesh, m_Adjacency.GetEdge(k) );
+      sum_coeff += coeff;
+
+      v += coeff * ( q - p );
+      }
+
+    den = 1.0 / static_cast< OutputCoordType >( sum_coeff );
+    v *= den;
+
+    r += m_RelaxationFactor * v;
+    }
+}
+
+template< class TInputMesh, class TOutputMesh >
+void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::UpdatePositions(SizeValueType first, SizeValueType last)
+{
+  for ( SizeValueType vertex = first; vertex < last; ++vertex )
+    {
+    OutputPointType &       p = *m_MeshPoints[vertex];
+    const OutputPointType & r = m_NewPositions[vertex];
+    for ( unsigned int d = 0; d < PointDimension; d++ )
+      {
+      p[d] = r[d];
+      }
+    }
 }
 
 template< class TInputMesh, class TOutputMesh >
@@ -168,6 +275,8 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
      << m_NumberOfIterations << std::endl;
   os << indent << "RelaxationFactor: "
      << m_RelaxationFactor << std::endl;
+  os << indent << "UseCompactAdjacency: "
+     << (m_UseCompactAdjacency ? "On" : "Off") << std::endl;
 }
 }
 
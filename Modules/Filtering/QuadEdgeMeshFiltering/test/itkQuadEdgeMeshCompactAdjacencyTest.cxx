@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkQuadEdgeMesh.h"
+#include "itkQuadEdgeMeshExtendedTraits.h"
+#include "itkRegularSphereMeshSource.h"
+#include "itkDiscreteMeanCurvatureQuadEdgeMeshFilter.h"
+#include "itkDiscreteGaussianCurvatureQuadEdgeMeshFilter.h"
+#include "itkDiscreteMaximumCurvatureQuadEdgeMeshFilter.h"
+#include "itkNormalQuadEdgeMeshFilter.h"
+#include "itkSmoothingQuadEdgeMeshFilter.h"
+
+#include <iostream>
+
+// Compare the multi-threaded compact adjacency mode of the curvature,
+// normal and smoothing filters with their default mode.
+
+namespace
+{
+template< class TMesh >
+bool SamePointData(const TMesh *mesh1, const TMesh *mesh2, const char *name)
+{
+  typename TMesh::PointDataContainer::ConstIterator it;
+  for ( it = mesh1->GetPointData()->Begin(); it != mesh1->GetPointData()->End(); ++it )
+    {
+    typename TMesh::PixelType value;
+    if ( !mesh2->GetPointData(it.Index(), &value) || !( value == it.Value() ) )
+      {
+      std::cerr << name << ": point data of point " << it.Index() << " differs: "
+                << it.Value() << " != " << value << std::endl;
+      return false;
+      }
+    }
+  return mesh1->GetPointData()->Size() == mesh2->GetPointData()->Size();
+}
+
+template< class TMesh >
+bool SamePoints(const TMesh *mesh1, const TMesh *mesh2, const char *name)
+{
+  typename TMesh::PointsContainer::ConstIterator it;
+  for ( it = mesh1->GetPoints()->Begin(); it != mesh1->GetPoints()->End(); ++it )
+    {
+    typename TMesh::PointType p = mesh2->GetPoint( it.Index() );
+    for ( unsigned int d = 0; d < TMesh::PointDimension; d++ )
+      {
+      if ( p[d] != it.Value()[d] )
+        {
+        std::cerr << name << ": point " << it.Index() << " differs: "
+                  << it.Value() << " != " << p << std::endl;
+        return false;
+        }
+      }
+    }
+  return mesh1->GetNumberOfPoints() == mesh2->GetNumberOfPoints();
+}
+
+template< class TFilter, class TMesh >
+bool CompareCurvatures(TMesh *mesh, const char *name)
+{
+  typename TFilter::Pointer legacy = TFilter::New();
+  legacy->SetInput(mesh);
+  legacy->Update();
+
+  typename TFilter::Pointer compact = TFilter::New();
+  compact->SetInput(mesh);
+  compact->SetNumberOfThreads(4);
+  compact->UseCompactAdjacencyOn();
+  compact->Update();
+
+  return SamePointData( legacy->GetOutput(), compact->GetOutput(), name );
+}
+}
+
+int itkQuadEdgeMeshCompactAdjacencyTest(int, char *[])
+{
+  const unsigned int Dimension = 3;
+  typedef double CoordType;
+
+  typedef itk::QuadEdgeMeshExtendedTraits <
+    CoordType,
+    Dimension,
+    2,
+    CoordType,
+    CoordType,
+    CoordType,
+    bool,
+    bool > Traits;
+
+  typedef itk::QuadEdgeMesh< CoordType, Dimension, Traits > MeshType;
+
+  typedef itk::RegularSphereMeshSource< MeshType > SphereMeshSourceType;
+  SphereMeshSourceType::Pointer sphere = SphereMeshSourceType::New();
+  SphereMeshSourceType::VectorType scale;
+  scale[0] = 1.0;
+  scale[1] = 1.5;
+  scale[2] = 0.75;
+  sphere->SetScale(scale);
+  sphere->SetResolution(4);
+  sphere->Update();
+
+  MeshType::Pointer mesh = sphere->GetOutput();
+  mesh->DisconnectPipeline();
+
+  // make the surface bumpy so that the vertices do not all look alike
+  MeshType::PointsContainer *points = mesh->GetPoints();
+  for ( MeshType::PointsContainer::Iterator it = points->Begin(); it != points->End(); ++it )
+    {
+    const double factor = 1.0 + 0.05 * vcl_sin( 7.0 * it.Value()[0] + 3.0 * it.Value()[1] );
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      it.Value()[d] *= factor;
+      }
+    }
+
+  std::cout << "Number of points: " << mesh->GetNumberOfPoints() << std::endl;
+
+  // ** CURVATURES **
+  bool pass = true;
+  pass &= CompareCurvatures< itk::DiscreteMeanCurvatureQuadEdgeMeshFilter< MeshType, MeshType > >
+            (mesh.GetPointer(), "Mean curvature");
+  pass &= CompareCurvatures< itk::DiscreteGaussianCurvatureQuadEdgeMeshFilter< MeshType, MeshType > >
+            (mesh.GetPointer(), "Gaussian curvature");
+  pass &= CompareCurvatures< itk::DiscreteMaximumCurvatureQuadEdgeMeshFilter< MeshType, MeshType > >
+            (mesh.GetPointer(), "Maximum curvature");
+
+  // ** NORMALS **
+  typedef itk::Vector< CoordType, Dimension > VectorType;
+  typedef itk::QuadEdgeMeshExtendedTraits <
+    VectorType,
+    Dimension,
+    2,
+    CoordType,
+    CoordType,
+    VectorType,
+    bool,
+    bool > NormalTraits;
+  typedef itk::QuadEdgeMesh< VectorType, Dimension, NormalTraits > NormalMeshType;
+  typedef itk::NormalQuadEdgeMeshFilter< MeshType, NormalMeshType > NormalFilterType;
+
+  const NormalFilterType::WeightType weights[3] =
+    { NormalFilterType::GOURAUD, NormalFilterType::THURMER, NormalFilterType::AREA };
+  for ( unsigned int w = 0; w < 3; w++ )
+    {
+    NormalFilterType::Pointer legacy = NormalFilterType::New();
+    legacy->SetInput(mesh);
+    legacy->SetWeight(weights[w]);
+    legacy->Update();
+
+    NormalFilterType::Pointer compact = NormalFilterType::New();
+    compact->SetInput(mesh);
+    compact->SetWeight(weights[w]);
+    compact->SetNumberOfThreads(4);
+    compact->UseCompactAdjacencyOn();
+    compact->Update();
+
+    pass &= SamePointData( legacy->GetOutput(), compact->GetOutput(), "Vertex normals" );
+
+    NormalMeshType::CellDataContainer::ConstIterator it;
+    const NormalMeshType *legacyOutput = legacy->GetOutput();
+    const NormalMeshType *compactOutput = compact->GetOutput();
+    for ( it = legacyOutput->GetCellData()->Begin(); it != legacyOutput->GetCellData()->End(); ++it )
+      {
+      VectorType normal;
+      if ( !compactOutput->GetCellData(it.Index(), &normal) || normal != it.Value() )
+        {
+        std::cerr << "Face normals: normal of cell " << it.Index() << " differs" << std::endl;
+        pass = false;
+        break;
+        }
+      }
+    if ( legacyOutput->GetCellData()->Size() != compactOutput->GetCellData()->Size() )
+      {
+      std::cerr << "Face normals: different number of normals" << std::endl;
+      pass = false;
+      }
+    }
+
+  // ** SMOOTHING **
+  typedef itk::SmoothingQuadEdgeMeshFilter< MeshType, MeshType > SmoothingType;
+  itk::OnesMatrixCoefficients< MeshType > coeff0;
+
+  // a single iteration gives the same result in both modes
+  SmoothingType::Pointer legacy = SmoothingType::New();
+  legacy->SetInput(mesh);
+  legacy->SetNumberOfIterations(1);
+  legacy->SetRelaxationFactor(0.5);
+  legacy->SetCoefficientsMethod(&coeff0);
+  legacy->Update();
+
+  SmoothingType::Pointer compact = SmoothingType::New();
+  compact->SetInput(mesh);
+  compact->SetNumberOfIterations(1);
+  compact->SetRelaxationFactor(0.5);
+  compact->SetCoefficientsMethod(&coeff0);
+  compact->SetNumberOfThreads(4);
+  compact->UseCompactAdjacencyOn();
+  compact->Update();
+
+  pass &= SamePoints( legacy->GetOutput(), compact->GetOutput(), "Smoothing" );
+
+  // several iterations do not depend on the number of threads
+  SmoothingType::Pointer compact1 = SmoothingType::New();
+  compact1->SetInput(mesh);
+  compact1->SetNumberOfIterations(5);
+  compact1->SetRelaxationFactor(0.5);
+  compact1->SetCoefficientsMethod(&coeff0);
+  compact1->SetNumberOfThreads(1);
+  compact1->UseCompactAdjacencyOn();
+  compact1->Update();
+
+  SmoothingType::Pointer compact4 = SmoothingType::New();
+  compact4->SetInput(mesh);
+  compact4->SetNumberOfIterations(5);
+  compact4->SetRelaxationFactor(0.5);
+  compact4->SetCoefficientsMethod(&coeff0);
+  compact4->SetNumberOfThreads(4);
+  compact4->UseCompactAdjacencyOn();
+  compact4->Update();
+
+  pass &= SamePoints( compact1->GetOutput(), compact4->GetOutput(), "Threaded smoothing" );
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed" << std::endl;
+  return EXIT_SUCCESS;
+}
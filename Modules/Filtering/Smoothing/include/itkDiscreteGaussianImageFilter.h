@@ -43,6 +43,21 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * The cost of the convolution grows with the width of the kernel. The
+ * dimensions whose discrete kernel would need a radius of
+ * MaximumKernelWidth pixels or more to reach MaximumError, and so would
+ * be truncated, are instead smoothed with a RecursiveGaussianImageFilter,
+ * whose cost per pixel does not depend on the variance. With the default
+ * MaximumError of 0.01 and MaximumKernelWidth of 32, the switch happens
+ * for a standard deviation of about 12 pixels. The recursive
+ * filter approximates the continuous Gaussian, which the discrete
+ * Gaussian kernel approaches for such variances. Its impulse response
+ * differs from the continuous Gaussian by less than 0.3% of the peak
+ * value, whatever the variance. The recursive passes run in place on a
+ * single buffer, and the dimension is processed over its whole extent.
+ * Turn UseRecursiveGaussianForWideKernels off to truncate the kernel as
+ * in the previous versions of this filter.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -210,6 +225,14 @@ public:
   itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(InternalNumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get whether the dimensions whose discrete kernel would be
+   * truncated by MaximumKernelWidth are smoothed with a recursive Gaussian
+   * filter instead. Default is on. When it is off, the kernel is
+   * truncated. */
+  itkSetMacro(UseRecursiveGaussianForWideKernels, bool);
+  itkGetConstMacro(UseRecursiveGaussianForWideKernels, bool);
+  itkBooleanMacro(UseRecursiveGaussianForWideKernels);
+
   /** DiscreteGaussianImageFilter needs a larger input requested region
    * than the output requested region (larger by the size of the
    * Gaussian kernel).  As such, DiscreteGaussianImageFilter needs to
@@ -236,6 +259,7 @@ protected:
     m_UseImageSpacing = true;
     m_FilterDimensionality = ImageDimension;
     m_InternalNumberOfStreamDivisions = ImageDimension * ImageDimension;
+    m_UseRecursiveGaussianForWideKernels = true;
   }
 
   virtual ~DiscreteGaussianImageFilter() {}
@@ -248,6 +272,19 @@ protected:
    * multithreaded by default. */
   void GenerateData();
 
+  /** Variance of the kernel along a dimension, in pixels. */
+  double GetVarianceInPixels(unsigned int dimension) const;
+
+  /** Whether a dimension is smoothed with the recursive Gaussian filter. */
+  bool IsRecursiveDimension(unsigned int dimension) const;
+
+  /** Create the filter that smooths along one dimension, either by
+   * convolution with the discrete kernel or with a recursive Gaussian
+   * filter. The recursive filter runs in place when runInPlace is true. */
+  template< class TStageInputImage, class TStageOutputImage, class TOperator >
+  typename ImageToImageFilter< TStageInputImage, TStageOutputImage >::Pointer
+  CreateSmoothingStage(const TOperator & oper, bool recursive, bool runInPlace) const;
+
 private:
   DiscreteGaussianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);              //purposely not implemented
@@ -274,9 +311,25 @@ private:
   /** Number of pieces to divide the input on the internal composite
   pipeline. The upstream pipeline will not be effected. */
   unsigned int m_InternalNumberOfStreamDivisions;
+
+  /** Flag to indicate whether wide kernels are replaced by recursive
+   * filters. */
+  bool m_UseRecursiveGaussianForWideKernels;
 };
 } // end namespace itk
 
+// Define instantiation macro for this template.
+#define ITK_TEMPLATE_DiscreteGaussianImageFilter(_, EXPORT, TypeX, TypeY)     \
+  namespace itk                                                               \
+  {                                                                           \
+  _( 2 ( class EXPORT DiscreteGaussianImageFilter< ITK_TEMPLATE_2 TypeX > ) ) \
+  namespace Templates                                                         \
+  {                                                                           \
+  typedef DiscreteGaussianImageFilter< ITK_TEMPLATE_2 TypeX >                 \
+  DiscreteGaussianImageFilter##TypeY;                                         \
+  }                                                                           \
+  }
+
 #ifndef ITK_MANUAL_INSTANTIATION
 #include "itkDiscreteGaussianImageFilter.txx"
 #endif
@@ -20,6 +20,7 @@
 
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkRecursiveGaussianImageFilter.h"
 #include "itkGaussianOperator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
@@ -51,29 +52,22 @@ throw( InvalidRequestedRegionError )
 
   typename TInputImage::SizeType radius;
 
+  const unsigned int filterDimensionality =
+    vnl_math_min( m_FilterDimensionality, static_cast< unsigned int >( ImageDimension ) );
+
   for ( unsigned int i = 0; i < TInputImage::ImageDimension; i++ )
     {
+    if ( i < filterDimensionality && this->IsRecursiveDimension(i) )
+      {
+      // the recursive filter is enlarged to the whole dimension below
+      radius[i] = 0;
+      continue;
+      }
+
     // Determine the size of the operator in this dimension.  Note that the
     // Gaussian is built as a 1D operator in each of the specified directions.
     oper.SetDirection(i);
-    if ( m_UseImageSpacing == true )
-      {
-      if ( this->GetInput()->GetSpacing()[i] == 0.0 )
-        {
-        itkExceptionMacro(<< "Pixel spacing cannot be zero");
-        }
-      else
-        {
-        // convert the variance from physical units to pixels
-        double s = this->GetInput()->GetSpacing()[i];
-        s = s * s;
-        oper.SetVariance(m_Variance[i] / s);
-        }
-      }
-    else
-      {
-      oper.SetVariance(m_Variance[i]);
-      }
+    oper.SetVariance( this->GetVarianceInPixels(i) );
     oper.SetMaximumError(m_MaximumError[i]);
     oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
     oper.CreateDirectional();
@@ -89,6 +83,17 @@ throw( InvalidRequestedRegionError )
   // pad the input requested region by the operator radius
   inputRequestedRegion.PadByRadius(radius);
 
+  // the recursive filters need whole lines of their dimension
+  const typename TInputImage::RegionType & largestRegion = inputPtr->GetLargestPossibleRegion();
+  for ( unsigned int i = 0; i < filterDimensionality; i++ )
+    {
+    if ( this->IsRecursiveDimension(i) )
+      {
+      inputRequestedRegion.SetIndex( i, largestRegion.GetIndex(i) );
+      inputRequestedRegion.SetSize( i, largestRegion.GetSize(i) );
+      }
+    }
+
   // crop the input requested region at the input's largest possible region
   if ( inputRequestedRegion.Crop( inputPtr->GetLargestPossibleRegion() ) )
     {
@@ -112,6 +117,90 @@ throw( InvalidRequestedRegionError )
     }
 }
 
+template< class TInputImage, class TOutputImage >
+double
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GetVarianceInPixels(unsigned int dimension) const
+{
+  if ( m_UseImageSpacing == true )
+    {
+    const double s = this->GetInput()->GetSpacing()[dimension];
+    if ( s == 0.0 )
+      {
+      itkExceptionMacro(<< "Pixel spacing cannot be zero");
+      }
+    // convert the variance from physical units to pixels
+    return m_Variance[dimension] / ( s * s );
+    }
+  return m_Variance[dimension];
+}
+
+template< class TInputImage, class TOutputImage >
+bool
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::IsRecursiveDimension(unsigned int dimension) const
+{
+  if ( !m_UseRecursiveGaussianForWideKernels )
+    {
+    return false;
+    }
+
+  // the recursive filter needs at least four pixels along its dimension
+  if ( this->GetInput()->GetLargestPossibleRegion().GetSize(dimension) < 4 )
+    {
+    return false;
+    }
+
+  // The radius of the discrete kernel exceeds the standard deviation for
+  // any sensible maximum error. Checking this first also avoids building
+  // kernels for variances at which the Bessel functions overflow.
+  const double variance = this->GetVarianceInPixels(dimension);
+  if ( variance >= static_cast< double >( m_MaximumKernelWidth ) * m_MaximumKernelWidth )
+    {
+    return true;
+    }
+
+  // Build the kernel without truncating it, GaussianOperator truncates
+  // its kernel when its radius reaches MaximumKernelWidth. The radius
+  // needed for the standard deviations left here is well below the width
+  // used.
+  GaussianOperator< double, ImageDimension > oper;
+  oper.SetDirection(dimension);
+  oper.SetVariance(variance);
+  oper.SetMaximumError(m_MaximumError[dimension]);
+  oper.SetMaximumKernelWidth(10 * m_MaximumKernelWidth + 10);
+  oper.CreateDirectional();
+
+  return oper.GetRadius(dimension) >= static_cast< SizeValueType >( m_MaximumKernelWidth );
+}
+
+template< class TInputImage, class TOutputImage >
+template< class TStageInputImage, class TStageOutputImage, class TOperator >
+typename ImageToImageFilter< TStageInputImage, TStageOutputImage >::Pointer
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::CreateSmoothingStage(const TOperator & oper, bool recursive, bool runInPlace) const
+{
+  if ( recursive )
+    {
+    typedef RecursiveGaussianImageFilter< TStageInputImage, TStageOutputImage > RecursiveFilterType;
+    typename RecursiveFilterType::Pointer filter = RecursiveFilterType::New();
+
+    // the recursive filter takes a standard deviation in physical units
+    const unsigned int dimension = oper.GetDirection();
+    filter->SetDirection(dimension);
+    filter->SetSigma( vcl_sqrt( this->GetVarianceInPixels(dimension) )
+                      * this->GetInput()->GetSpacing()[dimension] );
+    filter->SetInPlace(runInPlace);
+    return filter.GetPointer();
+    }
+
+  typedef NeighborhoodOperatorImageFilter< TStageInputImage, TStageOutputImage,
+                                           typename TOperator::PixelType > ConvolutionFilterType;
+  typename ConvolutionFilterType::Pointer filter = ConvolutionFilterType::New();
+  filter->SetOperator(oper);
+  return filter.GetPointer();
+}
+
 template< class TInputImage, class TOutputImage >
 void
 DiscreteGaussianImageFilter< TInputImage, TOutputImage >
@@ -159,7 +248,8 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
 
   typedef typename NumericTraits<RealOutputPixelType>::ValueType RealOutputPixelValueType;
 
-  // Type definition for the internal neighborhood filter
+  // Type definition for the internal smoothing filters, that convolve
+  // with the discrete kernel or run a recursive Gaussian filter
   //
   // First filter convolves and changes type from input type to real type
   // Middle filters convolves from real to real
@@ -167,14 +257,10 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
   // Streaming filter forces the mini-pipeline to run in chunks
 
 
-  typedef NeighborhoodOperatorImageFilter< InputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType > FirstFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType > IntermediateFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           OutputImageType, RealOutputPixelValueType > LastFilterType;
-  typedef NeighborhoodOperatorImageFilter< InputImageType,
-                                           OutputImageType, RealOutputPixelValueType > SingleFilterType;
+  typedef ImageToImageFilter< InputImageType, RealOutputImageType >      FirstFilterType;
+  typedef ImageToImageFilter< RealOutputImageType, RealOutputImageType > IntermediateFilterType;
+  typedef ImageToImageFilter< RealOutputImageType, OutputImageType >     LastFilterType;
+  typedef ImageToImageFilter< InputImageType, OutputImageType >          SingleFilterType;
 
   typedef StreamingImageFilter< OutputImageType, OutputImageType >
   StreamingFilterType;
@@ -190,6 +276,8 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
 
   std::vector< OperatorType > oper;
   oper.resize(filterDimensionality);
+  std::vector< bool > recursive(filterDimensionality, false);
+  bool                anyRecursive = false;
 
   // Create a process accumulator for tracking the progress of minipipeline
   ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
@@ -205,24 +293,14 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
 
     // Set up the operator for this dimension
     oper[reverse_i].SetDirection(i);
-    if ( m_UseImageSpacing == true )
-      {
-      if ( localInput->GetSpacing()[i] == 0.0 )
-        {
-        itkExceptionMacro(<< "Pixel spacing cannot be zero");
-        }
-      else
-        {
-        // convert the variance from physical units to pixels
-        double s = localInput->GetSpacing()[i];
-        s = s * s;
-        oper[reverse_i].SetVariance(m_Variance[i] / s);
-        }
-      }
-    else
+    if ( this->IsRecursiveDimension(i) )
       {
-      oper[reverse_i].SetVariance(m_Variance[i]);
+      // the recursive filter only needs the direction
+      recursive[reverse_i] = true;
+      anyRecursive = true;
+      continue;
       }
+    oper[reverse_i].SetVariance( this->GetVarianceInPixels(i) );
 
     oper[reverse_i].SetMaximumKernelWidth(m_MaximumKernelWidth);
     oper[reverse_i].SetMaximumError(m_MaximumError[i]);
@@ -236,8 +314,8 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
   if ( filterDimensionality == 1 )
     {
     // Use just a single filter
-    SingleFilterPointer singleFilter = SingleFilterType::New();
-    singleFilter->SetOperator(oper[0]);
+    SingleFilterPointer singleFilter =
+      this->template CreateSmoothingStage< InputImageType, OutputImageType >(oper[0], recursive[0], false);
     singleFilter->SetInput(localInput);
     progress->RegisterInternalFilter(singleFilter, 1.0f / m_FilterDimensionality);
 
@@ -261,20 +339,21 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     unsigned int numberOfStages = filterDimensionality * this->GetInternalNumberOfStreamDivisions() + 1;
 
     // First filter convolves and changes type from input type to real type
-    FirstFilterPointer firstFilter = FirstFilterType::New();
-    firstFilter->SetOperator(oper[0]);
+    FirstFilterPointer firstFilter =
+      this->template CreateSmoothingStage< InputImageType, RealOutputImageType >(oper[0], recursive[0], false);
     firstFilter->ReleaseDataFlagOn();
     firstFilter->SetInput(localInput);
     progress->RegisterInternalFilter(firstFilter, 1.0f / numberOfStages);
 
-    // Middle filters convolves from real to real
+    // Middle filters convolves from real to real. The recursive ones run
+    // in place on the output of the previous filter.
     std::vector< IntermediateFilterPointer > intermediateFilters;
     if ( filterDimensionality > 2 )
       {
       for ( i = 1; i < filterDimensionality - 1; ++i )
         {
-        IntermediateFilterPointer f = IntermediateFilterType::New();
-        f->SetOperator(oper[i]);
+        IntermediateFilterPointer f =
+          this->template CreateSmoothingStage< RealOutputImageType, RealOutputImageType >(oper[i], recursive[i], true);
         f->ReleaseDataFlagOn();
         progress->RegisterInternalFilter(f, 1.0f / numberOfStages);
 
@@ -293,8 +372,9 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
       }
 
     // Last filter convolves and changes type from real type to output type
-    LastFilterPointer lastFilter = LastFilterType::New();
-    lastFilter->SetOperator(oper[filterDimensionality - 1]);
+    LastFilterPointer lastFilter =
+      this->template CreateSmoothingStage< RealOutputImageType, OutputImageType >(
+        oper[filterDimensionality - 1], recursive[filterDimensionality - 1], true);
     lastFilter->ReleaseDataFlagOn();
     if ( filterDimensionality > 2 )
       {
@@ -307,10 +387,12 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     progress->RegisterInternalFilter(lastFilter, 1.0f / numberOfStages);
 
     // Put in a StreamingImageFilter so the mini-pipeline is processed
-    // in chunks to minimize memory usage
+    // in chunks to minimize memory usage. A recursive filter needs whole
+    // lines of its dimension, which chunks would make it compute again for
+    // every chunk, so the pipeline is then run at once.
     StreamingFilterPointer streamingFilter = StreamingFilterType::New();
     streamingFilter->SetInput( lastFilter->GetOutput() );
-    streamingFilter->SetNumberOfStreamDivisions( this->GetInternalNumberOfStreamDivisions() );
+    streamingFilter->SetNumberOfStreamDivisions( anyRecursive ? 1 : this->GetInternalNumberOfStreamDivisions() );
     progress->RegisterInternalFilter(streamingFilter, 1.0f / numberOfStages);
 
     // Graft this filters output onto the mini-pipeline so the mini-pipeline
@@ -341,6 +423,7 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
   os << indent << "FilterDimensionality: " << m_FilterDimensionality << std::endl;
   os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
   os << indent << "InternalNumberOfStreamDivisions: " << m_InternalNumberOfStreamDivisions << std::endl;
+  os << indent << "UseRecursiveGaussianForWideKernels: " << m_UseRecursiveGaussianForWideKernels << std::endl;
 }
 } // end namespace itk
 
@@ -23,6 +23,39 @@
 
 namespace itk
 {
+/** \class MedianImageFilterHistogramTraits
+ * \brief Selects the pixel types for which MedianImageFilter uses a
+ * sliding histogram.
+ *
+ * Supported is true for the 8 and 16 bit integer types. MinimumNeighborhoodSize
+ * is the number of pixels in the neighborhood from which the histogram is
+ * cheaper than sorting the neighborhood of each pixel.
+ *
+ * \ingroup ITK-Smoothing
+ */
+template< class TPixel >
+struct MedianImageFilterHistogramTraits
+{
+  static const bool         Supported = false;
+  static const unsigned int MinimumNeighborhoodSize = 0;
+};
+
+#define itkMedianImageFilterHistogramTraitsMacro(T, minimumSize)  \
+  template< >                                                      \
+  struct MedianImageFilterHistogramTraits< T >                     \
+  {                                                                \
+    static const bool         Supported = true;                    \
+    static const unsigned int MinimumNeighborhoodSize = minimumSize; \
+  };
+
+itkMedianImageFilterHistogramTraitsMacro(char, 9)
+itkMedianImageFilterHistogramTraitsMacro(signed char, 9)
+itkMedianImageFilterHistogramTraitsMacro(unsigned char, 9)
+itkMedianImageFilterHistogramTraitsMacro(short, 27)
+itkMedianImageFilterHistogramTraitsMacro(unsigned short, 27)
+
+#undef itkMedianImageFilterHistogramTraitsMacro
+
 /** \class MedianImageFilter
  * \brief Applies a median filter to an image
  *
@@ -35,6 +68,15 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For 8 and 16 bit integer pixel types and large enough neighborhoods, the
+ * median is computed from a histogram of the neighborhood that is updated
+ * as the neighborhood slides along the first image axis (T. Huang, G. Yang
+ * and G. Tang, "A fast two-dimensional median filtering algorithm", IEEE
+ * Trans. ASSP, 27(1), 1979). Only the pixels entering and leaving the
+ * neighborhood are processed at each step, instead of sorting the whole
+ * neighborhood. Other pixel types and small neighborhoods use a partial
+ * sort of the neighborhood. Both methods give the same result.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -110,6 +152,23 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                             ThreadIdType threadId);
 
+  /** Compute the median by partially sorting each neighborhood. */
+  void ThreadedGenerateDataWithSort(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId);
+
+  /** Compute the median from a sliding histogram. Only implemented for the
+   * pixel types of MedianImageFilterHistogramTraits. */
+  void ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId,
+                                         ImageToImageFilterDetail::BooleanDispatch< true >);
+
+  void ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId,
+                                         ImageToImageFilterDetail::BooleanDispatch< false >)
+  {
+    this->ThreadedGenerateDataWithSort(outputRegionForThread, threadId);
+  }
+
 private:
   MedianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
@@ -20,11 +20,14 @@
 #include "itkMedianImageFilter.h"
 
 #include "itkConstNeighborhoodIterator.h"
+#include "itkConstInteriorNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageLinearIteratorWithIndex.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
+#include "vnl/vnl_math.h"
 
 #include <vector>
 #include <algorithm>
@@ -41,6 +44,194 @@ void
 MedianImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
+{
+  typedef MedianImageFilterHistogramTraits< InputPixelType > HistogramTraitsType;
+
+  const InputSizeType & radius = this->GetRadius();
+  SizeValueType         neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; d++ )
+    {
+    neighborhoodSize *= 2 * radius[d] + 1;
+    }
+
+  if ( HistogramTraitsType::Supported
+       && neighborhoodSize >= HistogramTraitsType::MinimumNeighborhoodSize )
+    {
+    this->ThreadedGenerateDataWithHistogram( outputRegionForThread, threadId,
+                                             ImageToImageFilterDetail::BooleanDispatch<
+                                               HistogramTraitsType::Supported >() );
+    }
+  else
+    {
+    this->ThreadedGenerateDataWithSort(outputRegionForThread, threadId);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId,
+                                    ImageToImageFilterDetail::BooleanDispatch< true >)
+{
+  typedef typename InputImageType::IndexType        InputIndexType;
+  typedef typename InputImageType::OffsetValueType  OffsetValueType;
+  typedef typename InputImageType::InternalPixelType InputInternalPixelType;
+  typedef ImageLinearIteratorWithIndex< OutputImageType > OutputIteratorType;
+
+  typename OutputImageType::Pointer output = this->GetOutput();
+  typename  InputImageType::ConstPointer input  = this->GetInput();
+
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  const InputSizeType & radius = this->GetRadius();
+
+  // The pixels outside of the buffered region take the value of the
+  // closest buffered pixel, as with the ZeroFluxNeumannBoundaryCondition
+  // used by the neighborhood iterators.
+  const InputImageRegionType & bufferedRegion = input->GetBufferedRegion();
+  const InputIndexType         bufferStart = bufferedRegion.GetIndex();
+  const InputSizeType          bufferSize = bufferedRegion.GetSize();
+  const OffsetValueType *      offsetTable = input->GetOffsetTable();
+
+  const InputInternalPixelType *buffer = input->GetBufferPointer();
+  const typename InputImageType::AccessorType accessor = input->GetPixelAccessor();
+
+  const IndexValueType pixelMinimum =
+    static_cast< IndexValueType >( NumericTraits< InputPixelType >::NonpositiveMin() );
+  const IndexValueType pixelMaximum =
+    static_cast< IndexValueType >( NumericTraits< InputPixelType >::max() );
+  std::vector< SizeValueType > histogram(pixelMaximum - pixelMinimum + 1, 0);
+
+  // A neighborhood is made of the segments of "rows", the lines along the
+  // first axis, that it crosses. "columns" holds the first axis offsets of
+  // the pixels covered by the neighborhoods of a whole line.
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int d = 1; d < InputImageDimension; d++ )
+    {
+    numberOfRows *= 2 * radius[d] + 1;
+    }
+  const SizeValueType neighborhoodSize = numberOfRows * ( 2 * radius[0] + 1 );
+  const SizeValueType medianPosition = neighborhoodSize / 2;
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  const SizeValueType width = 2 * radius[0] + 1;
+
+  std::vector< OffsetValueType > rows(numberOfRows);
+  std::vector< OffsetValueType > columns(lineLength + width - 1);
+
+  // Bin of the current median, and number of neighborhood pixels in the
+  // bins below it. Both are updated incrementally, the median moving
+  // only by a few bins from one pixel to the next.
+  IndexValueType medianBin = 0;
+  SizeValueType  below = 0;
+
+  OutputIteratorType it(output, outputRegionForThread);
+  it.SetDirection(0);
+  for ( it.GoToBegin(); !it.IsAtEnd(); it.NextLine() )
+    {
+    const InputIndexType lineIndex = it.GetIndex();
+
+    for ( SizeValueType r = 0; r < numberOfRows; r++ )
+      {
+      OffsetValueType offset = 0;
+      SizeValueType   position = r;
+      for ( unsigned int d = 1; d < InputImageDimension; d++ )
+        {
+        const SizeValueType   span = 2 * radius[d] + 1;
+        const IndexValueType  index = lineIndex[d] + static_cast< IndexValueType >( position % span )
+                                      - static_cast< IndexValueType >( radius[d] );
+        const IndexValueType  clamped = vnl_math_min(
+          vnl_math_max(index, bufferStart[d]),
+          bufferStart[d] + static_cast< IndexValueType >( bufferSize[d] ) - 1 );
+        offset += ( clamped - bufferStart[d] ) * offsetTable[d];
+        position /= span;
+        }
+      rows[r] = offset;
+      }
+
+    for ( SizeValueType c = 0; c < columns.size(); c++ )
+      {
+      const IndexValueType index = lineIndex[0] + static_cast< IndexValueType >( c )
+                                   - static_cast< IndexValueType >( radius[0] );
+      columns[c] = vnl_math_min( vnl_math_max(index, bufferStart[0]),
+                                 bufferStart[0] + static_cast< IndexValueType >( bufferSize[0] ) - 1 )
+                   - bufferStart[0];
+      }
+
+    for ( SizeValueType c = 0; c < columns.size(); c++ )
+      {
+      // Add the column entering the neighborhood
+      for ( SizeValueType r = 0; r < numberOfRows; r++ )
+        {
+        const IndexValueType bin = static_cast< IndexValueType >(
+          accessor.Get(buffer[rows[r] + columns[c]]) ) - pixelMinimum;
+        ++histogram[bin];
+        if ( bin < medianBin )
+          {
+          ++below;
+          }
+        }
+
+      if ( c + 1 < width )
+        {
+        continue;
+        }
+
+      // Move the median to the bin holding the pixel of rank
+      // medianPosition
+      while ( below > medianPosition )
+        {
+        --medianBin;
+        below -= histogram[medianBin];
+        }
+      while ( below + histogram[medianBin] <= medianPosition )
+        {
+        below += histogram[medianBin];
+        ++medianBin;
+        }
+
+      it.Set( static_cast< OutputPixelType >(
+                static_cast< InputPixelType >( medianBin + pixelMinimum ) ) );
+      ++it;
+      progress.CompletedPixel();
+
+      // Remove the column leaving the neighborhood
+      for ( SizeValueType r = 0; r < numberOfRows; r++ )
+        {
+        const IndexValueType bin = static_cast< IndexValueType >(
+          accessor.Get(buffer[rows[r] + columns[c + 1 - width]]) ) - pixelMinimum;
+        --histogram[bin];
+        if ( bin < medianBin )
+          {
+          --below;
+          }
+        }
+      }
+
+    // Empty the histogram for the next line
+    for ( SizeValueType c = columns.size() + 1 - width; c < columns.size(); c++ )
+      {
+      for ( SizeValueType r = 0; r < numberOfRows; r++ )
+        {
+        const IndexValueType bin = static_cast< IndexValueType >(
+          accessor.Get(buffer[rows[r] + columns[c]]) ) - pixelMinimum;
+        --histogram[bin];
+        if ( bin < medianBin )
+          {
+          --below;
+          }
+        }
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithSort(const OutputImageRegionType & outputRegionForThread,
+                               ThreadIdType threadId)
 {
   // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
@@ -67,6 +258,27 @@ MedianImageFilter< TInputImage, TOutputImage >
     {
     ImageRegionIterator< OutputImageType > it = ImageRegionIterator< OutputImageType >(output, *fit);
 
+    // the non-boundary region is read without boundary condition
+    if ( ConstInteriorNeighborhoodIterator< InputImageType >::IsInterior(this->GetRadius(), input, *fit) )
+      {
+      ConstInteriorNeighborhoodIterator< InputImageType > iit(this->GetRadius(), input, *fit);
+      const unsigned int neighborhoodSize = iit.Size();
+      const unsigned int medianPosition = neighborhoodSize / 2;
+      pixels.resize(neighborhoodSize);
+      for (; !iit.IsAtEnd(); ++iit, ++it )
+        {
+        for ( unsigned int i = 0; i < neighborhoodSize; ++i )
+          {
+          pixels[i] = iit.GetPixel(i);
+          }
+        const typename std::vector< InputPixelType >::iterator medianIterator = pixels.begin() + medianPosition;
+        std::nth_element( pixels.begin(), medianIterator, pixels.end() );
+        it.Set( static_cast< typename OutputImageType::PixelType >( *medianIterator ) );
+        progress.CompletedPixel();
+        }
+      continue;
+      }
+
     ConstNeighborhoodIterator< InputImageType > bit =
       ConstNeighborhoodIterator< InputImageType >(this->GetRadius(), input, *fit);
     bit.OverrideBoundaryCondition(&nbc);
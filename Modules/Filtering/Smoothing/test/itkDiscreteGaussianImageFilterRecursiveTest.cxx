@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+// Check the recursive Gaussian used by DiscreteGaussianImageFilter for wide
+// kernels: narrow kernels are unaffected, wide kernels approach the
+// continuous Gaussian, and requesting part of the output gives the same
+// values as computing the whole image.
+
+int itkDiscreteGaussianImageFilterRecursiveTest(int, char *[])
+{
+  typedef itk::Image< float, 2 >                                   ImageType;
+  typedef itk::DiscreteGaussianImageFilter< ImageType, ImageType > FilterType;
+
+  ImageType::SizeType size;
+  size[0] = 201;
+  size[1] = 161;
+  ImageType::RegionType region;
+  region.SetSize(size);
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 2.0;
+
+  ImageType::Pointer impulse = ImageType::New();
+  impulse->SetRegions(region);
+  impulse->SetSpacing(spacing);
+  impulse->Allocate();
+  impulse->FillBuffer(0.0f);
+  ImageType::IndexType center;
+  center[0] = 100;
+  center[1] = 80;
+  impulse->SetPixel(center, 1.0f);
+
+  bool pass = true;
+
+  // The recursive Gaussian is used by default, but narrow kernels are not
+  // replaced
+  FilterType::Pointer reference = FilterType::New();
+  reference->SetInput(impulse);
+  reference->SetVariance(4.0);
+  reference->UseRecursiveGaussianForWideKernelsOff();
+  reference->Update();
+
+  FilterType::Pointer narrow = FilterType::New();
+  narrow->SetInput(impulse);
+  narrow->SetVariance(4.0);
+  if ( !narrow->GetUseRecursiveGaussianForWideKernels() )
+    {
+    std::cerr << "The recursive Gaussian is not used by default" << std::endl;
+    pass = false;
+    }
+  narrow->Update();
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > rit( reference->GetOutput(), region );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > nit( narrow->GetOutput(), region );
+  for (; !rit.IsAtEnd(); ++rit, ++nit )
+    {
+    if ( rit.Get() != nit.Get() )
+      {
+      std::cerr << "Narrow kernel result changed at " << rit.GetIndex() << std::endl;
+      pass = false;
+      break;
+      }
+    }
+
+  // Wide kernels approach the continuous Gaussian. The variance is in
+  // physical units: 400 pixels squared along x, 100 along y.
+  FilterType::Pointer wide = FilterType::New();
+  wide->SetInput(impulse);
+  wide->SetVariance(400.0);
+  wide->SetMaximumKernelWidth(16);
+  wide->Update();
+
+  const double variance[2] = { 400.0, 100.0 };
+  const double peak = 1.0 / ( 2.0 * vnl_math::pi * vcl_sqrt(variance[0] * variance[1]) );
+  double       maximumError = 0.0;
+  itk::ImageRegionConstIteratorWithIndex< ImageType > wit( wide->GetOutput(), region );
+  for (; !wit.IsAtEnd(); ++wit )
+    {
+    double exponent = 0.0;
+    for ( unsigned int d = 0; d < 2; d++ )
+      {
+      const double x = wit.GetIndex()[d] - center[d];
+      exponent += x * x / ( 2.0 * variance[d] );
+      }
+    maximumError = vnl_math_max( maximumError,
+                                 vnl_math_abs(wit.Get() - peak * vcl_exp(-exponent) ) / peak );
+    }
+  std::cout << "Maximum relative error of the wide kernel: " << maximumError << std::endl;
+  if ( maximumError > 0.01 )
+    {
+    std::cerr << "Wide kernel differs from the continuous Gaussian by " << maximumError << std::endl;
+    pass = false;
+    }
+
+  // Requesting part of the output gives the same values
+  ImageType::RegionType requested;
+  requested.SetIndex(0, 30);
+  requested.SetIndex(1, 50);
+  requested.SetSize(0, 70);
+  requested.SetSize(1, 40);
+
+  FilterType::Pointer part = FilterType::New();
+  part->SetInput(impulse);
+  part->SetVariance(400.0);
+  part->SetMaximumKernelWidth(16);
+  part->GetOutput()->SetRequestedRegion(requested);
+  part->Update();
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > pit( part->GetOutput(), requested );
+  for (; !pit.IsAtEnd(); ++pit )
+    {
+    if ( pit.Get() != wide->GetOutput()->GetPixel( pit.GetIndex() ) )
+      {
+      std::cerr << "Partial output differs at " << pit.GetIndex() << std::endl;
+      pass = false;
+      break;
+      }
+    }
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMedianImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "vnl/vnl_sample.h"
+
+// The sliding histogram used for 8 and 16 bit pixels must give the same
+// result as the partial sort used for float pixels, including at the image
+// borders and when only part of the input is buffered: the pixels outside of
+// the buffered region take the value of the closest buffered pixel.
+
+namespace
+{
+template< class TPixel, unsigned int VDimension >
+bool CompareWithSort(const itk::Size< VDimension > & size,
+                     const itk::Size< VDimension > & radius,
+                     double minimum, double maximum)
+{
+  typedef itk::Image< TPixel, VDimension > ImageType;
+  typedef itk::Image< float, VDimension >  FloatImageType;
+
+  typename ImageType::IndexType start;
+  start.Fill(-2);
+  typename ImageType::RegionType region(start, size);
+
+  // Only buffer the input from the third pixel along each axis, so that
+  // the neighborhoods cross the border of the image on the upper side and
+  // the border of the buffered region on the lower side
+  typename ImageType::RegionType buffered = region;
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    buffered.SetIndex(d, start[d] + 3);
+    buffered.SetSize(d, size[d] - 3);
+    }
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetLargestPossibleRegion(region);
+  image->SetBufferedRegion(buffered);
+  image->SetRequestedRegion(buffered);
+  image->Allocate();
+  typename FloatImageType::Pointer floatImage = FloatImageType::New();
+  floatImage->SetLargestPossibleRegion(region);
+  floatImage->SetBufferedRegion(buffered);
+  floatImage->SetRequestedRegion(buffered);
+  floatImage->Allocate();
+
+  itk::ImageRegionIterator< ImageType >      it( image, buffered );
+  itk::ImageRegionIterator< FloatImageType > fit( floatImage, buffered );
+  for (; !it.IsAtEnd(); ++it, ++fit )
+    {
+    const TPixel value = static_cast< TPixel >( vnl_sample_uniform(minimum, maximum) );
+    it.Set(value);
+    fit.Set(value);
+    }
+
+  typedef itk::MedianImageFilter< ImageType, ImageType >           FilterType;
+  typedef itk::MedianImageFilter< FloatImageType, FloatImageType > FloatFilterType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetRadius(radius);
+  filter->SetNumberOfThreads(3);
+
+  typename FloatFilterType::Pointer floatFilter = FloatFilterType::New();
+  floatFilter->SetInput(floatImage);
+  floatFilter->SetRadius(radius);
+
+  // Request the whole buffered region first, then a region in its middle
+  filter->GetOutput()->SetRequestedRegion(buffered);
+  floatFilter->GetOutput()->SetRequestedRegion(buffered);
+
+  bool pass = true;
+  for ( unsigned int pass2 = 0; pass2 < 2; pass2++ )
+    {
+    filter->Update();
+    floatFilter->Update();
+
+    const typename ImageType::RegionType outputRegion =
+      filter->GetOutput()->GetRequestedRegion();
+    itk::ImageRegionConstIterator< ImageType >      ot( filter->GetOutput(), outputRegion );
+    itk::ImageRegionConstIterator< FloatImageType > fot( floatFilter->GetOutput(), outputRegion );
+    for (; !ot.IsAtEnd(); ++ot, ++fot )
+      {
+      if ( static_cast< float >( ot.Get() ) != fot.Get() )
+        {
+        std::cerr << "Median differs at " << ot.GetIndex() << ": "
+                  << static_cast< double >( ot.Get() ) << " instead of " << fot.Get()
+                  << " (radius " << radius << ")" << std::endl;
+        pass = false;
+        break;
+        }
+      }
+
+    typename ImageType::RegionType requested = buffered;
+    requested.PadByRadius(-2);
+    filter->GetOutput()->SetRequestedRegion(requested);
+    floatFilter->GetOutput()->SetRequestedRegion(requested);
+    }
+  return pass;
+}
+}
+
+int itkMedianImageFilterHistogramTest(int, char *[])
+{
+  bool pass = true;
+
+  itk::Size< 2 > size2D;
+  size2D[0] = 40;
+  size2D[1] = 23;
+  itk::Size< 2 > radius2D;
+  radius2D[0] = 1;
+  radius2D[1] = 1;
+  pass &= CompareWithSort< unsigned char, 2 >(size2D, radius2D, 0, 255);
+  radius2D[0] = 4;
+  radius2D[1] = 2;
+  pass &= CompareWithSort< unsigned char, 2 >(size2D, radius2D, 0, 255);
+  pass &= CompareWithSort< signed char, 2 >(size2D, radius2D, -128, 127);
+  pass &= CompareWithSort< short, 2 >(size2D, radius2D, -1000, 3000);
+  radius2D[0] = 1;
+  radius2D[1] = 7;
+  pass &= CompareWithSort< unsigned short, 2 >(size2D, radius2D, 0, 65535);
+
+  itk::Size< 3 > size3D;
+  size3D[0] = 17;
+  size3D[1] = 13;
+  size3D[2] = 9;
+  itk::Size< 3 > radius3D;
+  radius3D.Fill(2);
+  pass &= CompareWithSort< unsigned char, 3 >(size3D, radius3D, 0, 255);
+  pass &= CompareWithSort< short, 3 >(size3D, radius3D, -1024, 3071);
+  radius3D[0] = 3;
+  radius3D[1] = 1;
+  radius3D[2] = 4;
+  pass &= CompareWithSort< unsigned short, 3 >(size3D, radius3D, 0, 40);
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkVector.h"
+#include "vnl/vnl_sample.h"
+
+// Filtering blocks of lines at once must give exactly the same result as
+// filtering one line at a time, for every direction, order and block size.
+
+namespace
+{
+template< class TValue >
+void RandomPixel(TValue & value)
+{
+  value = static_cast< TValue >( vnl_sample_uniform(0.0, 100.0) );
+}
+
+template< class TValue, unsigned int VDimension >
+void RandomPixel(itk::Vector< TValue, VDimension > & value)
+{
+  for ( unsigned int c = 0; c < VDimension; c++ )
+    {
+    RandomPixel(value[c]);
+    }
+}
+
+template< class TImage >
+void FillImage(TImage *image)
+{
+  typedef typename TImage::PixelType PixelType;
+  itk::ImageRegionIterator< TImage > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    PixelType value;
+    RandomPixel(value);
+    it.Set(value);
+    }
+}
+
+template< class TImage >
+typename TImage::Pointer
+Smooth(const TImage *input, unsigned int direction, unsigned int order,
+       unsigned int linesPerBlock, unsigned int numberOfThreads)
+{
+  typedef itk::RecursiveGaussianImageFilter< TImage, TImage > FilterType;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetDirection(direction);
+  filter->SetSigma(1.7);
+  filter->SetNumberOfThreads(numberOfThreads);
+  filter->SetNumberOfLinesPerBlock(linesPerBlock);
+  if ( order == 1 )
+    {
+    filter->SetFirstOrder();
+    }
+  else if ( order == 2 )
+    {
+    filter->SetSecondOrder();
+    }
+  filter->Update();
+  typename TImage::Pointer output = filter->GetOutput();
+  output->DisconnectPipeline();
+  return output;
+}
+
+template< class TImage >
+bool SameImages(const TImage *a, const TImage *b)
+{
+  itk::ImageRegionConstIterator< TImage > ita( a, a->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< TImage > itb( b, b->GetBufferedRegion() );
+  for (; !ita.IsAtEnd(); ++ita, ++itb )
+    {
+    if ( ita.Get() != itb.Get() )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< class TImage >
+bool CheckBlocks(const typename TImage::SizeType & size)
+{
+  typename TImage::Pointer input = TImage::New();
+  typename TImage::IndexType start;
+  start.Fill(3);
+  typename TImage::RegionType region(start, size);
+  input->SetRegions(region);
+  input->Allocate();
+  FillImage( input.GetPointer() );
+
+  const unsigned int linesPerBlock[] = { 3, 8, 16 };
+
+  bool pass = true;
+  for ( unsigned int direction = 0; direction < TImage::ImageDimension; direction++ )
+    {
+    for ( unsigned int order = 0; order < 3; order++ )
+      {
+      typename TImage::Pointer reference = Smooth(input.GetPointer(), direction, order, 1, 1);
+      for ( unsigned int b = 0; b < 3; b++ )
+        {
+        typename TImage::Pointer output =
+          Smooth(input.GetPointer(), direction, order, linesPerBlock[b], 3);
+        if ( !SameImages( reference.GetPointer(), output.GetPointer() ) )
+          {
+          std::cerr << "Mismatch for direction " << direction << ", order " << order
+                    << " and " << linesPerBlock[b] << " lines per block" << std::endl;
+          pass = false;
+          }
+        }
+      }
+    }
+  return pass;
+}
+}
+
+int itkRecursiveGaussianImageFilterLinesPerBlockTest(int, char *[])
+{
+  typedef itk::Image< float, 2 >                         Image2DType;
+  typedef itk::Image< double, 3 >                        Image3DType;
+  typedef itk::Image< itk::Vector< float, 2 >, 3 >       VectorImageType;
+
+  bool pass = true;
+
+  // The first size is not a multiple of the block sizes, so that the last
+  // block of each row is partially filled.
+  Image2DType::SizeType size2D;
+  size2D[0] = 37;
+  size2D[1] = 29;
+  pass &= CheckBlocks< Image2DType >(size2D);
+
+  Image3DType::SizeType size3D;
+  size3D[0] = 21;
+  size3D[1] = 17;
+  size3D[2] = 11;
+  pass &= CheckBlocks< Image3DType >(size3D);
+
+  VectorImageType::SizeType sizeVector;
+  sizeVector[0] = 9;
+  sizeVector[1] = 6;
+  sizeVector[2] = 5;
+  pass &= CheckBlocks< VectorImageType >(sizeVector);
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -85,6 +85,15 @@ public:
   void SetOutsideValue(const TOutput & value)
   { m_OutsideValue = value; }
 
+  const TInput & GetLowerThreshold() const
+  { return m_LowerThreshold; }
+  const TInput & GetUpperThreshold() const
+  { return m_UpperThreshold; }
+  const TOutput & GetInsideValue() const
+  { return m_InsideValue; }
+  const TOutput & GetOutsideValue() const
+  { return m_OutsideValue; }
+
   bool operator!=(const BinaryThreshold & other) const
   {
     if ( m_LowerThreshold != other.m_LowerThreshold
@@ -119,6 +128,32 @@ private:
 };
 }
 
+/** Compare the float and double pixels by vectors, without branches */
+template< class TInput, class TOutput >
+class BatchFunctorTraits< Functor::BinaryThreshold< TInput, TOutput > >
+{
+public:
+  typedef Functor::BinaryThreshold< TInput, TOutput > FunctorType;
+
+  template< class TInputPixel, class TOutputPixel >
+  static void Apply(FunctorType & functor, const TInputPixel *input, TOutputPixel *output, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; i++ )
+      {
+      output[i] = functor(input[i]);
+      }
+  }
+
+  static void Apply(FunctorType & functor, const TInput *input, TOutput *output, SizeValueType n)
+  {
+    BatchFunctorDetail::ThresholdKernel< TInput, TOutput >::Apply( input, output, n,
+                                                                   functor.GetLowerThreshold(),
+                                                                   functor.GetUpperThreshold(),
+                                                                   functor.GetInsideValue(),
+                                                                   functor.GetOutsideValue() );
+  }
+};
+
 template< class TInputImage, class TOutputImage >
 class ITK_EXPORT BinaryThresholdImageFilter:
   public
@@ -0,0 +1,129 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkExplicitInstantiation_h
+#define __itkExplicitInstantiation_h
+
+/** \file itkExplicitInstantiation.h
+ * \brief Use the precompiled instantiations of the ITK-ExplicitInstantiation
+ * library.
+ *
+ * The templates of ITK are defined in headers, so each translation unit
+ * using a filter compiles it again for its image types, and each
+ * application holds its own copy of the code.  The ITK-ExplicitInstantiation
+ * library compiles once the most used filters for the images of
+ * unsigned char, short, float and double pixels in 2 and 3 dimensions:
+ *
+ *   - Image, ImageSource and ImageToImageFilter,
+ *   - ResampleImageFilter, with its default LinearInterpolateImageFunction,
+ *   - DiscreteGaussianImageFilter,
+ *   - ImageToImageMetric and MattesMutualInformationImageToImageMetric,
+ *
+ * the input and output images being of the same type.  A translation unit
+ * including this header declares these instantiations with extern
+ * templates, so the compiler uses those of the library instead of
+ * instantiating them again.  The other instantiations are not affected.
+ *
+ * This header includes those of the instantiated classes.  It also defines
+ * the itk::Templates typedefs of the instantiations, named as in the
+ * Wrapping, like Templates::ImageF3 or
+ * Templates::ResampleImageFilterIF3IF3D.
+ *
+ * The library may be compiled with instructions specific to an
+ * architecture, like AVX2, with the ITK_EXPLICIT_INSTANTIATION_CXX_FLAGS
+ * option.  The applications using it then only run on processors
+ * supporting these instructions.
+ *
+ * \ingroup ITK-ExplicitInstantiation
+ */
+
+#include "itkImage.h"
+#include "itkImageSource.h"
+#include "itkImageToImageFilter.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkResampleImageFilter.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageToImageMetric.h"
+#include "itkMattesMutualInformationImageToImageMetric.h"
+
+#if ( defined( _WIN32 ) || defined( WIN32 ) ) && !defined( ITKSTATIC )
+#ifdef ITK_ExplicitInstantiation_EXPORTS
+#define ITKExplicitInstantiation_EXPORT __declspec(dllexport)
+#else
+#define ITKExplicitInstantiation_EXPORT __declspec(dllimport)
+#endif  /* ITK_ExplicitInstantiation_EXPORTS */
+#else
+/* unix needs nothing */
+#define ITKExplicitInstantiation_EXPORT
+#endif
+
+/* Define macros to export and import the template instantiations of the
+   library, as ITK_EXPORT_ITKCommon and ITK_IMPORT_ITKCommon.  */
+#define ITK_EXPORT_ITKExplicitInstantiation(c, x, n) \
+  ITK_EXPORT_TEMPLATE(ITKExplicitInstantiation_EXPORT, c, x, n)
+#define ITK_IMPORT_ITKExplicitInstantiation(c, x, n) \
+  ITK_IMPORT_TEMPLATE(ITKExplicitInstantiation_EXPORT, c, x, n)
+
+/* The image types of the instantiations.  m(_, Y) is called for the suffix
+   Y of each image type, with _ one of the macros above.  */
+#define ITK_EXPLICIT_INSTANTIATION_FOREACH_IMAGE(m, _) \
+  m(_, UC2) m(_, UC3)                                  \
+  m(_, SS2) m(_, SS3)                                  \
+  m(_, F2) m(_, F3)                                    \
+  m(_, D2) m(_, D3)
+
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_UC2 (unsigned char, 2)
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_UC3 (unsigned char, 3)
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_SS2 (short, 2)
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_SS3 (short, 3)
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_F2 (float, 2)
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_F3 (float, 3)
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_D2 (double, 2)
+#define ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_D3 (double, 3)
+
+/* The instantiations for an image type, in groups compiled by separate
+   source files of the library.  The image group must come first: the
+   other ones use its typedefs.  */
+#define ITK_EXPLICIT_INSTANTIATION_Image(_, Y)                                   \
+  _(Image, ITK_EXPLICIT_INSTANTIATION_IMAGE_PARAMETERS_##Y, Y)                   \
+  _(ImageSource, (Templates::Image##Y), I##Y)                                    \
+  _(ImageToImageFilter, (Templates::Image##Y, Templates::Image##Y), I##Y##I##Y)
+
+#define ITK_EXPLICIT_INSTANTIATION_ResampleImageFilter(_, Y)                              \
+  _(LinearInterpolateImageFunction, (Templates::Image##Y, double), I##Y##D)               \
+  _(ResampleImageFilter, (Templates::Image##Y, Templates::Image##Y, double), I##Y##I##Y##D)
+
+#define ITK_EXPLICIT_INSTANTIATION_DiscreteGaussianImageFilter(_, Y) \
+  _(DiscreteGaussianImageFilter, (Templates::Image##Y, Templates::Image##Y), I##Y##I##Y)
+
+#define ITK_EXPLICIT_INSTANTIATION_MattesMutualInformationImageToImageMetric(_, Y)        \
+  _(ImageToImageMetric, (Templates::Image##Y, Templates::Image##Y), I##Y##I##Y)           \
+  _(MattesMutualInformationImageToImageMetric, (Templates::Image##Y, Templates::Image##Y), \
+    I##Y##I##Y)
+
+/* Declare the instantiations of the library.  Where extern templates are
+   not supported, only the typedefs are defined.  */
+ITK_EXPLICIT_INSTANTIATION_FOREACH_IMAGE(ITK_EXPLICIT_INSTANTIATION_Image,
+                                         ITK_IMPORT_ITKExplicitInstantiation)
+ITK_EXPLICIT_INSTANTIATION_FOREACH_IMAGE(ITK_EXPLICIT_INSTANTIATION_ResampleImageFilter,
+                                         ITK_IMPORT_ITKExplicitInstantiation)
+ITK_EXPLICIT_INSTANTIATION_FOREACH_IMAGE(ITK_EXPLICIT_INSTANTIATION_DiscreteGaussianImageFilter,
+                                         ITK_IMPORT_ITKExplicitInstantiation)
+ITK_EXPLICIT_INSTANTIATION_FOREACH_IMAGE(ITK_EXPLICIT_INSTANTIATION_MattesMutualInformationImageToImageMetric,
+                                         ITK_IMPORT_ITKExplicitInstantiation)
+
+#endif
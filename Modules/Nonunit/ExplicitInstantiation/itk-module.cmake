@@ -0,0 +1,19 @@
+set(DOCUMENTATION "This module contains the explicit instantiations of
+the most used filters, ResampleImageFilter, DiscreteGaussianImageFilter and
+MattesMutualInformationImageToImageMetric, for the images of unsigned char,
+short, float and double pixels in 2 and 3 dimensions.  The applications
+including itkExplicitInstantiation.h link to these instantiations instead
+of compiling them again.")
+
+itk_module(ITK-ExplicitInstantiation
+  DEPENDS
+    ITK-Common
+    ITK-ImageFunction
+    ITK-ImageGrid
+    ITK-Smoothing
+    ITK-RegistrationCommon
+  TEST_DEPENDS
+    ITK-TestKernel
+  EXCLUDE_FROM_ALL
+  DESCRIPTION
+    "${DOCUMENTATION}")
@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// The filters of a typical application, run through the instantiations of
+// ITK-ExplicitInstantiation.  itkExplicitInstantiationBenchmark.cmake also
+// compiles this file with ITK_EXPLICIT_INSTANTIATION_BENCHMARK_IMPLICIT, to
+// compare the compilation time and the size of the object files when the
+// filters are instantiated implicitly.
+
+#ifndef ITK_EXPLICIT_INSTANTIATION_BENCHMARK_IMPLICIT
+#include "itkExplicitInstantiation.h"
+#endif
+
+#include "itkImage.h"
+#include "itkResampleImageFilter.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkMattesMutualInformationImageToImageMetric.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer CreateImage(unsigned int size)
+{
+  typename TImage::SizeType imageSize;
+  imageSize.Fill(size);
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(imageSize);
+  image->Allocate();
+
+  // a blob, with a structure for the mutual information
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    double distance = 0.0;
+    for ( unsigned int i = 0; i < TImage::ImageDimension; i++ )
+      {
+      const double x = it.GetIndex()[i] - 0.5 * size;
+      distance += x * x;
+      }
+    it.Set( static_cast< typename TImage::PixelType >( 100.0 / ( 1.0 + 0.05 * distance ) ) );
+    }
+  return image;
+}
+
+template< class TImage >
+bool SameImages(const TImage *image1, const TImage *image2)
+{
+  itk::ImageRegionConstIterator< TImage > it1( image1, image1->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< TImage > it2( image2, image1->GetBufferedRegion() );
+  for (; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if ( it1.Get() != it2.Get() )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< class TImage >
+bool RunFilters(const char *name, unsigned int size)
+{
+  typedef itk::ResampleImageFilter< TImage, TImage >                       ResampleType;
+  typedef itk::DiscreteGaussianImageFilter< TImage, TImage >               GaussianType;
+  typedef itk::MattesMutualInformationImageToImageMetric< TImage, TImage > MetricType;
+  typedef itk::LinearInterpolateImageFunction< TImage, double >            InterpolatorType;
+  typedef itk::TranslationTransform< double, TImage::ImageDimension >      TransformType;
+
+  typename TImage::Pointer image = CreateImage< TImage >(size);
+
+  // the resampling with the identity transform gives the input
+  typename ResampleType::Pointer resample = ResampleType::New();
+  resample->SetInput(image);
+  resample->SetOutputParametersFromImage(image);
+  resample->Update();
+  if ( !SameImages< TImage >( image, resample->GetOutput() ) )
+    {
+    std::cerr << name << ": the resampled image is not the input" << std::endl;
+    return false;
+    }
+
+  // a smoothed image is not the input
+  typename GaussianType::Pointer gaussian = GaussianType::New();
+  gaussian->SetInput(image);
+  gaussian->SetVariance(2.0);
+  gaussian->Update();
+  if ( SameImages< TImage >( image, gaussian->GetOutput() ) )
+    {
+    std::cerr << name << ": the image was not smoothed" << std::endl;
+    return false;
+    }
+
+  // the images are more similar without translation
+  typename MetricType::Pointer metric = MetricType::New();
+  typename TransformType::Pointer transform = TransformType::New();
+  metric->SetFixedImage(image);
+  metric->SetMovingImage( gaussian->GetOutput() );
+  metric->SetFixedImageRegion( image->GetBufferedRegion() );
+  metric->SetTransform(transform);
+  metric->SetInterpolator( InterpolatorType::New() );
+  metric->SetNumberOfHistogramBins(20);
+  metric->UseAllPixelsOn();
+  metric->Initialize();
+
+  typename TransformType::ParametersType parameters( transform->GetNumberOfParameters() );
+  parameters.Fill(0.0);
+  const double aligned = metric->GetValue(parameters);
+  parameters.Fill(3.0);
+  const double translated = metric->GetValue(parameters);
+
+  std::cout << name << ": " << aligned << " aligned, " << translated << " translated" << std::endl;
+  if ( !( aligned < translated ) )
+    {
+    std::cerr << name << ": the mutual information is not larger without translation" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkExplicitInstantiationTest(int, char *[])
+{
+  bool ok = true;
+
+  ok = RunFilters< itk::Image< unsigned char, 2 > >("unsigned char 2D", 64) && ok;
+  ok = RunFilters< itk::Image< short, 3 > >("short 3D", 24) && ok;
+  ok = RunFilters< itk::Image< float, 3 > >("float 3D", 24) && ok;
+  ok = RunFilters< itk::Image< double, 2 > >("double 2D", 64) && ok;
+
+  if ( !ok )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -34,6 +34,7 @@ BinaryImageToStatisticsLabelMapFilter< TInputImage, TFeatureImage, TOutputImage
   m_ComputePerimeter = true;
   m_NumberOfBins = 128;
   m_ComputeHistogram = true;
+  m_ComputeWeightedMoments = true;
   this->SetNumberOfRequiredInputs(2);
 }
 
@@ -90,6 +91,7 @@ BinaryImageToStatisticsLabelMapFilter< TInputImage, TFeatureImage, TOutputImage
   valuator->SetComputePerimeter(m_ComputePerimeter);
   valuator->SetComputeFeretDiameter(m_ComputeFeretDiameter);
   valuator->SetComputeHistogram(m_ComputeHistogram);
+  valuator->SetComputeWeightedMoments(m_ComputeWeightedMoments);
   valuator->SetNumberOfBins(m_NumberOfBins);
   progress->RegisterInternalFilter(valuator, .5f);
 
@@ -114,6 +116,7 @@ BinaryImageToStatisticsLabelMapFilter< TInputImage, TFeatureImage, TOutputImage
   os << indent << "ComputeFeretDiameter: " << m_ComputeFeretDiameter << std::endl;
   os << indent << "ComputePerimeter: " << m_ComputePerimeter << std::endl;
   os << indent << "ComputeHistogram: " << m_ComputeHistogram << std::endl;
+  os << indent << "ComputeWeightedMoments: " << m_ComputeWeightedMoments << std::endl;
   os << indent << "NumberOfBins: " << m_NumberOfBins << std::endl;
 }
 } // end namespace itk
@@ -22,6 +22,10 @@
 
 #include "itkProgressAccumulator.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "vnl/algo/vnl_fft_prime_factors.h"
+#include "vcl_limits.h"
+#include <complex>
+#include <vector>
 
 namespace itk
 {
@@ -42,6 +46,20 @@ namespace itk
  * The kernel can optionally be normalized to sum to 1 using
  * NormalizeOn(). Normalization is off by default.
  *
+ * By default the inner products are computed in the spatial domain, at a
+ * cost proportional to the number of kernel pixels per output pixel. With
+ * UseFFTOn(), the convolution is computed in the frequency domain with the
+ * overlap-save method instead: the requested output region is cut into
+ * tiles, and each tile is computed from the Fourier transform of the input
+ * block it depends on, multiplied by the transform of the kernel. The tiles
+ * are distributed over the threads and their size is chosen from the kernel
+ * size, so the memory used does not depend on the image size. The input
+ * block of a tile is read with the boundary condition, so both modes give
+ * the same result up to rounding errors. The frequency domain is faster for
+ * kernels with more than a few hundred pixels. It requires scalar pixels:
+ * for the other pixel types, Update() throws an exception when UseFFT is
+ * on.
+ *
  * \warning This filter ignores the spacing, origin, and orientation
  * of the kernel image and treats them as identical to those in the
  * input image.
@@ -90,6 +108,12 @@ public:
   typedef typename InputImageType::RegionType  InputRegionType;
   typedef typename OutputImageType::RegionType OutputRegionType;
 
+  /** Whether the convolution can be computed in the frequency domain,
+   * which requires scalar input and output pixels. */
+  itkStaticConstMacro(FFTSupported, bool,
+                      vcl_numeric_limits< InputPixelType >::is_specialized
+                      && vcl_numeric_limits< OutputPixelType >::is_specialized);
+
   /** Typedef to describe the boundary condition. */
   typedef ImageBoundaryCondition< TInputImage >           BoundaryConditionType;
   typedef BoundaryConditionType *                         BoundaryConditionPointerType;
@@ -109,6 +133,12 @@ public:
   itkGetConstMacro(Normalize, bool);
   itkBooleanMacro(Normalize);
 
+  /** Compute the convolution in the frequency domain, tile by tile.
+   * Defaults to off. */
+  itkSetMacro(UseFFT, bool);
+  itkGetConstMacro(UseFFT, bool);
+  itkBooleanMacro(UseFFT);
+
   /** ConvolutionImageFilter needs a smaller 2nd input (the image kernel)
    * requested region than output requested region.  As such, this filter
    * needs to provide an implementation for GenerateInputRequestedRegion() in
@@ -124,6 +154,29 @@ protected:
 
   void GenerateData();
 
+  /** Compute the tiles of the frequency domain convolution that lie in
+   * the region of the thread. */
+  void ThreadedGenerateData(const OutputRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  /** Compute the convolution in the frequency domain. It is only compiled
+   * for scalar pixels. */
+  void GenerateDataWithFFT(ImageToImageFilterDetail::BooleanDispatch< true >);
+
+  void GenerateDataWithFFT(ImageToImageFilterDetail::BooleanDispatch< false >)
+  {
+    itkExceptionMacro(<< "The frequency domain convolution requires scalar pixels");
+  }
+
+  void ThreadedGenerateDataWithFFT(const OutputRegionType & outputRegionForThread,
+                                   ThreadIdType threadId,
+                                   ImageToImageFilterDetail::BooleanDispatch< true >);
+
+  void ThreadedGenerateDataWithFFT(const OutputRegionType &,
+                                   ThreadIdType,
+                                   ImageToImageFilterDetail::BooleanDispatch< false >)
+  {}
+
   /** The kernel needs padding if any of the sizes of its dimensions is
    * even. This method checks for this condition. */
   bool GetKernelNeedsPadding() const;
@@ -139,7 +192,27 @@ private:
   void ComputeConvolution( const TKernelImage *kernelImage,
                            ProgressAccumulator *progress );
 
+  typedef std::complex< double >     ComplexType;
+  typedef std::vector< ComplexType > ComplexBufferType;
+
+  /** Choose the size of the Fourier transforms and the tiles, and compute
+   * the transform of the kernel. */
+  void PrepareFFTConvolution();
+
+  /** In place Fourier transform of a block of size m_FFTSize. */
+  void TransformBlock(ComplexBufferType & block, int direction) const;
+
   bool m_Normalize;
+  bool m_UseFFT;
+
+  /** Size of the transforms, of the tiles and of the kernel radius in the
+   * frequency domain mode. */
+  InputSizeType m_FFTSize;
+  InputSizeType m_TileSize;
+  InputSizeType m_KernelRadius;
+
+  vnl_fft_prime_factors< double > m_FFTFactors[ImageDimension];
+  ComplexBufferType               m_KernelSpectrum;
 
   DefaultBoundaryConditionType m_DefaultBoundaryCondition;
   BoundaryConditionPointerType m_BoundaryCondition;
@@ -21,11 +21,17 @@
 
 #include "itkConvolutionImageFilter.h"
 
+#include "itkConstantBoundaryCondition.h"
 #include "itkConstantPadImageFilter.h"
+#include "itkConstNeighborhoodIterator.h"
 #include "itkImageBase.h"
 #include "itkImageKernelOperator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkNeighborhoodOperatorImageFilter.h"
 #include "itkNormalizeToConstantImageFilter.h"
+#include "itkProgressReporter.h"
+#include "vnl/algo/vnl_fft.h"
 
 
 /*
@@ -47,7 +53,11 @@ ConvolutionImageFilter< TInputImage, TOutputImage >
 {
   this->SetNumberOfRequiredInputs(2);
   m_Normalize = false;
+  m_UseFFT = false;
   m_BoundaryCondition = &m_DefaultBoundaryCondition;
+  m_FFTSize.Fill(0);
+  m_TileSize.Fill(0);
+  m_KernelRadius.Fill(0);
 }
 
 template< class TInputImage, class TOutputImage >
@@ -63,6 +73,13 @@ ConvolutionImageFilter< TInputImage, TOutputImage >
   // Allocate the output
   this->AllocateOutputs();
 
+  if ( m_UseFFT )
+    {
+    this->GenerateDataWithFFT(
+      ImageToImageFilterDetail::BooleanDispatch< itkGetStaticConstMacro(FFTSupported) >() );
+    return;
+    }
+
   // Create a process accumulator for tracking the progress of this minipipeline
   ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter( this );
@@ -93,6 +110,25 @@ ConvolutionImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< class TInputImage, class TOutputImage >
+void
+ConvolutionImageFilter< TInputImage, TOutputImage >
+::GenerateDataWithFFT(ImageToImageFilterDetail::BooleanDispatch< true >)
+{
+  this->PrepareFFTConvolution();
+
+  // The tiles of each thread are computed in ThreadedGenerateData()
+  typename Superclass::ThreadStruct str;
+  str.Filter = this;
+
+  MultiThreader *multithreader = this->GetMultiThreader();
+  multithreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  multithreader->SetSingleMethod(this->ThreaderCallback, &str);
+  multithreader->SingleMethodExecute();
+
+  ComplexBufferType().swap(m_KernelSpectrum);
+}
+
 template< class TInputImage, class TOutputImage >
 template< class TKernelImage >
 void
@@ -157,6 +193,341 @@ ConvolutionImageFilter< TInputImage, TOutputImage >
   this->GraftOutput( convolutionFilter->GetOutput() );
 }
 
+template< class TInputImage, class TOutputImage >
+void
+ConvolutionImageFilter< TInputImage, TOutputImage >
+::PrepareFFTConvolution()
+{
+  typedef typename InputSizeType::SizeValueType SizeValueType;
+
+  const InputImageType *kernel = this->GetImageKernelInput();
+  const InputRegionType kernelRegion = kernel->GetLargestPossibleRegion();
+  const InputSizeType   kernelSize = kernelRegion.GetSize();
+  const InputSizeType   padSize = this->GetKernelPadSize();
+  const OutputSizeType  outputSize = this->GetOutput()->GetRequestedRegion().GetSize();
+
+  // In each dimension, a transform of size n gives a tile of n - 2 * radius
+  // pixels. Choose the size with the lowest cost per output pixel among the
+  // sizes that are products of 2, 3 and 5, without making the tile much
+  // larger than the kernel or than the output.
+  SizeValueType numberOfPixels = 1;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    const SizeValueType radius = kernelSize[i] / 2;
+    const SizeValueType width = 2 * radius + 1;
+    const SizeValueType largest =
+      vnl_math_min( vnl_math_max(8 * width, static_cast< SizeValueType >( 64 ) ),
+                    outputSize[i] + 2 * radius );
+
+    SizeValueType best = 0;
+    double        bestCost = NumericTraits< double >::max();
+    for ( SizeValueType n = width;; n++ )
+      {
+      SizeValueType m = n;
+      const SizeValueType factors[3] = { 2, 3, 5 };
+      for ( unsigned int f = 0; f < 3; f++ )
+        {
+        while ( m % factors[f] == 0 )
+          {
+          m /= factors[f];
+          }
+        }
+      if ( m != 1 )
+        {
+        continue;
+        }
+      const double cost = n * ( vcl_log( static_cast< double >( n ) ) + 1.0 ) / ( n - 2 * radius );
+      if ( cost < bestCost )
+        {
+        best = n;
+        bestCost = cost;
+        }
+      if ( n >= largest )
+        {
+        break;
+        }
+      }
+
+    m_KernelRadius[i] = radius;
+    m_FFTSize[i] = best;
+    m_TileSize[i] = best - 2 * radius;
+    m_FFTFactors[i].resize( static_cast< int >( best ) );
+    numberOfPixels *= best;
+    }
+
+  itkDebugMacro(<< "FFT size: " << m_FFTSize << ", tile size: " << m_TileSize);
+
+  // Put the kernel at the origin of a block, after the padding that makes
+  // its size odd
+  m_KernelSpectrum.assign( numberOfPixels, ComplexType(0.0, 0.0) );
+  double sum = 0.0;
+  ImageRegionConstIteratorWithIndex< InputImageType > kit(kernel, kernelRegion);
+  for ( kit.GoToBegin(); !kit.IsAtEnd(); ++kit )
+    {
+    SizeValueType offset = 0;
+    SizeValueType stride = 1;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      offset += ( kit.GetIndex()[i] - kernelRegion.GetIndex()[i] + padSize[i] ) * stride;
+      stride *= m_FFTSize[i];
+      }
+    const double value = static_cast< double >( kit.Get() );
+    m_KernelSpectrum[offset] = ComplexType(value, 0.0);
+    sum += value;
+    }
+
+  this->TransformBlock(m_KernelSpectrum, +1);
+
+  // The output is a correlation with the kernel, so the transform of the
+  // kernel is conjugated. The scaling of the inverse transform and the
+  // normalization of the kernel are included.
+  double scale = 1.0 / static_cast< double >( numberOfPixels );
+  if ( m_Normalize )
+    {
+    scale /= sum;
+    }
+  for ( SizeValueType p = 0; p < numberOfPixels; p++ )
+    {
+    m_KernelSpectrum[p] = std::conj(m_KernelSpectrum[p]) * scale;
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+ConvolutionImageFilter< TInputImage, TOutputImage >
+::TransformBlock(ComplexBufferType & block, int direction) const
+{
+  const long total = static_cast< long >( block.size() );
+  long       stride = 1;
+
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    const long n = static_cast< long >( m_FFTSize[i] );
+    if ( n > 1 )
+      {
+      // All the lines along the dimension that start in the same slab are
+      // adjacent in memory and are transformed by a single call.
+      const long numberOfSlabs = total / ( stride * n );
+      long       info = 0;
+      if ( stride == 1 )
+        {
+        double *data = reinterpret_cast< double * >( &block[0] );
+        vnl_fft_gpfa(data, data + 1, m_FFTFactors[i].trigs(), 2, 2 * n, n,
+                     numberOfSlabs, direction, m_FFTFactors[i].pqr(), &info);
+        }
+      else
+        {
+        for ( long s = 0; s < numberOfSlabs; s++ )
+          {
+          double *data = reinterpret_cast< double * >( &block[s * stride * n] );
+          vnl_fft_gpfa(data, data + 1, m_FFTFactors[i].trigs(), 2 * stride, 2, n,
+                       stride, direction, m_FFTFactors[i].pqr(), &info);
+          }
+        }
+      }
+    stride *= n;
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+ConvolutionImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  this->ThreadedGenerateDataWithFFT(
+    outputRegionForThread, threadId,
+    ImageToImageFilterDetail::BooleanDispatch< itkGetStaticConstMacro(FFTSupported) >() );
+}
+
+template< class TInputImage, class TOutputImage >
+void
+ConvolutionImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithFFT(const OutputRegionType & outputRegionForThread,
+                              ThreadIdType threadId,
+                              ImageToImageFilterDetail::BooleanDispatch< true >)
+{
+  typedef typename InputSizeType::SizeValueType     SizeValueType;
+  typedef typename InputImageType::IndexType        IndexType;
+  typedef typename IndexType::IndexValueType        IndexValueType;
+  typedef typename InputImageType::OffsetType       OffsetType;
+  typedef typename OffsetType::OffsetValueType      OffsetValueType;
+
+  const InputImageType *input = this->GetInput();
+  const InputPixelType *buffer = input->GetBufferPointer();
+  OutputImageType      *output = this->GetOutput();
+  const InputRegionType bufferedRegion = input->GetBufferedRegion();
+  const IndexType       regionIndex = outputRegionForThread.GetIndex();
+  const OutputSizeType  regionSize = outputRegionForThread.GetSize();
+
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  SizeValueType numberOfTiles = 1;
+  SizeValueType blockStride[ImageDimension];
+  SizeValueType stride = 1;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    numberOfTiles *= ( regionSize[i] + m_TileSize[i] - 1 ) / m_TileSize[i];
+    blockStride[i] = stride;
+    stride *= m_FFTSize[i];
+    }
+  ProgressReporter progress(this, threadId, numberOfTiles);
+
+  // The usual boundary conditions are evaluated directly, the other ones
+  // through a neighborhood iterator
+  enum { ZeroFluxNeumann, Constant, Other } boundary = Other;
+  double constant = 0.0;
+  if ( dynamic_cast< ZeroFluxNeumannBoundaryCondition< InputImageType > * >( m_BoundaryCondition ) )
+    {
+    boundary = ZeroFluxNeumann;
+    }
+  else if ( ConstantBoundaryCondition< InputImageType > *constantBoundary =
+              dynamic_cast< ConstantBoundaryCondition< InputImageType > * >( m_BoundaryCondition ) )
+    {
+    boundary = Constant;
+    constant = static_cast< double >( constantBoundary->GetConstant() );
+    }
+  ConstNeighborhoodIterator< InputImageType > nit(m_KernelRadius, input, outputRegionForThread);
+  nit.OverrideBoundaryCondition(m_BoundaryCondition);
+
+  std::vector< OffsetValueType > nearestOffsets[ImageDimension];
+  std::vector< bool >            outside[ImageDimension];
+
+  ComplexBufferType block( m_KernelSpectrum.size() );
+
+  IndexType tileIndex = regionIndex;
+  for ( SizeValueType tile = 0; tile < numberOfTiles; tile++ )
+    {
+    OutputSizeType tileSize;
+    IndexType      blockIndex;
+    OutputSizeType blockSize;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      tileSize[i] = vnl_math_min( m_TileSize[i],
+                                  static_cast< SizeValueType >( regionIndex[i] + regionSize[i] - tileIndex[i] ) );
+      blockIndex[i] = tileIndex[i] - static_cast< typename IndexType::IndexValueType >( m_KernelRadius[i] );
+      blockSize[i] = tileSize[i] + 2 * m_KernelRadius[i];
+      }
+    const OutputRegionType tileRegion(tileIndex, tileSize);
+
+    // Read the input block the tile depends on. The rest of the transform
+    // does not contribute to the tile. The offset in the input buffer of
+    // the nearest buffered pixel is tabulated for each dimension.
+    std::fill( block.begin(), block.end(), ComplexType(0.0, 0.0) );
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      const IndexValueType first = bufferedRegion.GetIndex()[i];
+      const IndexValueType last = first + static_cast< IndexValueType >( bufferedRegion.GetSize()[i] ) - 1;
+      nearestOffsets[i].resize(blockSize[i]);
+      outside[i].resize(blockSize[i]);
+      for ( SizeValueType j = 0; j < blockSize[i]; j++ )
+        {
+        const IndexValueType index = blockIndex[i] + static_cast< IndexValueType >( j );
+        const IndexValueType nearest = vnl_math_min( vnl_math_max(index, first), last );
+        nearestOffsets[i][j] = ( nearest - first ) * input->GetOffsetTable()[i];
+        outside[i][j] = ( nearest != index );
+        }
+      }
+
+    OutputSizeType position;
+    position.Fill(0);
+    SizeValueType numberOfLines = 1;
+    for ( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      numberOfLines *= blockSize[i];
+      }
+    for ( SizeValueType line = 0; line < numberOfLines; line++ )
+      {
+      OffsetValueType lineOffset = 0;
+      SizeValueType   blockOffset = 0;
+      bool            lineOutside = false;
+      for ( unsigned int i = 1; i < ImageDimension; i++ )
+        {
+        lineOffset += nearestOffsets[i][position[i]];
+        blockOffset += position[i] * blockStride[i];
+        lineOutside |= outside[i][position[i]];
+        }
+
+      for ( SizeValueType j = 0; j < blockSize[0]; j++ )
+        {
+        double value;
+        if ( !lineOutside && !outside[0][j] )
+          {
+          value = static_cast< double >( buffer[lineOffset + nearestOffsets[0][j]] );
+          }
+        else if ( boundary == ZeroFluxNeumann )
+          {
+          value = static_cast< double >( buffer[lineOffset + nearestOffsets[0][j]] );
+          }
+        else if ( boundary == Constant )
+          {
+          value = constant;
+          }
+        else
+          {
+          // Other boundary conditions are only available through a
+          // neighborhood iterator centered in the tile
+          IndexType  center;
+          OffsetType o;
+          for ( unsigned int i = 0; i < ImageDimension; i++ )
+            {
+            const IndexValueType index =
+              blockIndex[i] + static_cast< IndexValueType >( i == 0 ? j : position[i] );
+            center[i] = vnl_math_min( vnl_math_max(index, tileIndex[i]),
+                                      tileIndex[i] + static_cast< IndexValueType >( tileSize[i] ) - 1 );
+            o[i] = index - center[i];
+            }
+          nit.SetLocation(center);
+          value = static_cast< double >( nit.GetPixel(o) );
+          }
+        block[blockOffset + j] = ComplexType(value, 0.0);
+        }
+
+      for ( unsigned int i = 1; i < ImageDimension; i++ )
+        {
+        if ( ++position[i] < blockSize[i] )
+          {
+          break;
+          }
+        position[i] = 0;
+        }
+      }
+
+    this->TransformBlock(block, +1);
+    for ( SizeValueType p = 0; p < block.size(); p++ )
+      {
+      block[p] *= m_KernelSpectrum[p];
+      }
+    this->TransformBlock(block, -1);
+
+    ImageRegionIteratorWithIndex< OutputImageType > ot(output, tileRegion);
+    for ( ot.GoToBegin(); !ot.IsAtEnd(); ++ot )
+      {
+      SizeValueType offset = 0;
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        offset += ( ot.GetIndex()[i] - tileIndex[i] ) * blockStride[i];
+        }
+      ot.Set( static_cast< OutputPixelType >( block[offset].real() ) );
+      }
+
+    // next tile
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      tileIndex[i] += m_TileSize[i];
+      if ( tileIndex[i] < regionIndex[i] + static_cast< typename IndexType::IndexValueType >( regionSize[i] ) )
+        {
+        break;
+        }
+      tileIndex[i] = regionIndex[i];
+      }
+    progress.CompletedPixel();
+    }
+}
+
 template< class TInputImage, class TOutputImage >
 bool
 ConvolutionImageFilter< TInputImage, TOutputImage >
@@ -241,6 +612,20 @@ ConvolutionImageFilter< TInputImage, TOutputImage >
         {
         Superclass::CallCopyOutputRegionToInputRegion( inputRegion,
                                                        this->GetOutput()->GetRequestedRegion() );
+
+        // Pad by the kernel radius, so that the pixels out of the requested
+        // region are only given by the boundary condition out of the
+        // largest possible region
+        if ( this->GetImageKernelInput() )
+          {
+          InputSizeType radius;
+          for ( unsigned int i = 0; i < ImageDimension; i++ )
+            {
+            radius[i] = this->GetImageKernelInput()->GetLargestPossibleRegion().GetSize()[i] / 2;
+            }
+          inputRegion.PadByRadius(radius);
+          inputRegion.Crop( input->GetLargestPossibleRegion() );
+          }
         }
       else  // the input is the image kernel
         {
@@ -264,6 +649,7 @@ ConvolutionImageFilter< TInputImage, TOutputImage >
   Superclass::PrintSelf( os, indent );
 
   os << indent << "Normalize: "  << m_Normalize << std::endl;
+  os << indent << "UseFFT: "  << m_UseFFT << std::endl;
 }
 }
 #endif
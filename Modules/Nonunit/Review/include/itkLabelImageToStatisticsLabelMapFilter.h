@@ -156,6 +156,14 @@ public:
   itkGetConstReferenceMacro(ComputeHistogram, bool);
   itkBooleanMacro(ComputeHistogram);
 
+  /**
+   * Set/Get whether the moments weighted by the feature image should be computed
+   * or not. This option defaults to `true`.
+   */
+  itkSetMacro(ComputeWeightedMoments, bool);
+  itkGetConstReferenceMacro(ComputeWeightedMoments, bool);
+  itkBooleanMacro(ComputeWeightedMoments);
+
   /**
    * Set/Get the number of bins in the histogram. Note that the histogram is used
    * to compute the median value, and that this option may have an effect on the
@@ -191,6 +199,7 @@ private:
   bool                 m_ComputePerimeter;
   unsigned int         m_NumberOfBins;
   bool                 m_ComputeHistogram;
+  bool                 m_ComputeWeightedMoments;
 }; // end of class
 } // end namespace itk
 
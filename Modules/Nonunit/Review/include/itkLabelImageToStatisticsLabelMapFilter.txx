@@ -32,6 +32,7 @@ LabelImageToStatisticsLabelMapFilter< TInputImage, TFeatureImage, TOutputImage >
   m_ComputePerimeter = true;
   m_NumberOfBins = 128;
   m_ComputeHistogram = true;
+  m_ComputeWeightedMoments = true;
   this->SetNumberOfRequiredInputs(2);
 }
 
@@ -86,6 +87,7 @@ LabelImageToStatisticsLabelMapFilter< TInputImage, TFeatureImage, TOutputImage >
   valuator->SetComputePerimeter(m_ComputePerimeter);
   valuator->SetComputeFeretDiameter(m_ComputeFeretDiameter);
   valuator->SetComputeHistogram(m_ComputeHistogram);
+  valuator->SetComputeWeightedMoments(m_ComputeWeightedMoments);
   valuator->SetNumberOfBins(m_NumberOfBins);
   progress->RegisterInternalFilter(valuator, .5f);
 
@@ -106,6 +108,7 @@ LabelImageToStatisticsLabelMapFilter< TInputImage, TFeatureImage, TOutputImage >
   os << indent << "ComputeFeretDiameter: " << m_ComputeFeretDiameter << std::endl;
   os << indent << "ComputePerimeter: " << m_ComputePerimeter << std::endl;
   os << indent << "ComputeHistogram: " << m_ComputeHistogram << std::endl;
+  os << indent << "ComputeWeightedMoments: " << m_ComputeWeightedMoments << std::endl;
   os << indent << "NumberOfBins: " << m_NumberOfBins << std::endl;
 }
 } // end namespace itk
@@ -43,6 +43,11 @@ namespace itk
  * With that class, the developer doesn't need to take care of iterating over all the objects in
  * the image, or to manage by hand the threads.
  *
+ * The objects are distributed dynamically to the threads. To limit the contention on
+ * the lock with label maps made of many small objects, a thread takes several objects
+ * at once, and the number of objects taken decreases with the remaining work, so the
+ * load stays balanced at the end of the computation.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -127,6 +132,7 @@ private:
   void operator=(const Self &); //purposely not implemented
 
   LabelObjectContainerConstIterator m_LabelObjectIterator;
+  SizeValueType                     m_NumberOfRemainingLabelObjects;
 
   ProgressReporter *m_Progress;
 };
@@ -36,6 +36,7 @@ LabelMapFilter< TInputImage, TOutputImage >
 ::LabelMapFilter()
 {
   m_Progress = NULL;
+  m_NumberOfRemainingLabelObjects = 0;
 }
 
 template< class TInputImage, class TOutputImage >
@@ -81,6 +82,7 @@ LabelMapFilter< TInputImage, TOutputImage >
 {
   // initialize the iterator
   m_LabelObjectIterator = this->GetLabelMap()->GetLabelObjectContainer().begin();
+  m_NumberOfRemainingLabelObjects = this->GetLabelMap()->GetNumberOfLabelObjects();
 
   // and the mutex
   m_LabelObjectContainerLock = FastMutexLock::New();
@@ -109,6 +111,11 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData( const OutputImageRegionType &, ThreadIdType itkNotUsed(threadId) )
 {
+  const SizeValueType numberOfThreads = vnl_math_max( this->GetNumberOfThreads(), (ThreadIdType)1 );
+
+  // the objects taken by the thread at once
+  std::vector< LabelObjectType * > labelObjects;
+
   while ( true )
     {
     // first lock the mutex
@@ -121,22 +128,38 @@ LabelMapFilter< TInputImage, TOutputImage >
       return;
       }
 
-    // get the label object
-    LabelObjectType *labelObject = m_LabelObjectIterator->second;
+    // take a share of the remaining objects, so the lock is not taken for
+    // every small object, but all the threads still have some work at the end
+    const SizeValueType numberToTake =
+      vnl_math_max( m_NumberOfRemainingLabelObjects / ( 4 * numberOfThreads ), (SizeValueType)1 );
 
-    // increment the iterator now, so it will not be invalidated if the object
-    // is destroyed
-    m_LabelObjectIterator++;
+    labelObjects.clear();
+    while ( labelObjects.size() < numberToTake
+            && m_LabelObjectIterator != this->GetLabelMap()->GetLabelObjectContainer().end() )
+      {
+      // get the label object
+      labelObjects.push_back(m_LabelObjectIterator->second);
 
-    // pretend one more object is processed, even if it will be done later, to
-    // simplify the lock management
-    m_Progress->CompletedPixel();
+      // increment the iterator now, so it will not be invalidated if the object
+      // is destroyed
+      m_LabelObjectIterator++;
+
+      // pretend one more object is processed, even if it will be done later, to
+      // simplify the lock management
+      m_Progress->CompletedPixel();
+      }
+    m_NumberOfRemainingLabelObjects -= vnl_math_min( (SizeValueType)labelObjects.size(),
+                                                     m_NumberOfRemainingLabelObjects );
 
     // unlock the mutex, so the other threads can get an object
     m_LabelObjectContainerLock->Unlock();
 
-    // and run the user defined method for that object
-    this->ThreadedProcessLabelObject(labelObject);
+    // and run the user defined method for those objects
+    for ( typename std::vector< LabelObjectType * >::const_iterator it = labelObjects.begin();
+          it != labelObjects.end(); ++it )
+      {
+      this->ThreadedProcessLabelObject(*it);
+      }
     }
 }
 
@@ -28,15 +28,17 @@ namespace itk
  * ShapeLabelMapFilter can be used to set the attributes values of the
  * ShapeLabelObject in a LabelMap.
  *
- * ShapeLabelMapFilter takes an optional parameter, used only to
- * optimize the computation time and the memory usage when the
- * perimeter or the feret diameter is used: the exact copy of the
- * input LabelMap is stored in an Image.
- * It can be set with SetLabelImage(). It is cleared at the end of the
- * computation, so must be reset before running Update() again. It is
- * not part of the pipeline management design, to let the subclasses
- * of ShapeLabelMapFilter use the pipeline design to specify truly
- * required inputs.
+ * The feret diameter is computed from the ends of the lines of the
+ * objects: they are reduced to the vertices of the convex hull of each
+ * plane of the object, and the farthest pair is found with rotating
+ * calipers in 2D, or by comparing the remaining pairs in higher
+ * dimensions. The cost is far below the quadratic cost of the
+ * comparison of all the pixels on the border of the object.
+ *
+ * ShapeLabelMapFilter used to take an optional label image, to
+ * optimize the computation of the feret diameter. That image is not
+ * needed anymore, and SetLabelImage() is only kept for backward
+ * compatibility.
  *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
@@ -115,7 +117,7 @@ public:
   itkGetConstReferenceMacro(ComputePerimeter, bool);
   itkBooleanMacro(ComputePerimeter);
 
-  /** Set the label image */
+  /** Set the label image. Not used anymore - kept for backward compatibility. */
   void SetLabelImage(const TLabelImage *input)
   {
     m_LabelImage = input;
@@ -144,6 +146,49 @@ private:
   void ComputeFeretDiameter(LabelObjectType *labelObject);
   void ComputePerimeter(LabelObjectType *labelObject);
 
+  typedef typename ImageType::SpacingType SpacingType;
+  typedef std::vector< IndexType >        IndexListType;
+
+  // sort the indexes plane by plane, and in lexicographic order on the
+  // dimensions 1 and 0 in a plane
+  class IndexPlaneComparator
+  {
+public:
+    bool operator()(const IndexType & a, const IndexType & b) const
+    {
+      for ( int i = ImageDimension - 1; i >= 0; i-- )
+        {
+        if ( a[i] != b[i] )
+          {
+          return a[i] < b[i];
+          }
+        }
+      return false;
+    }
+
+    static bool SamePlane(const IndexType & a, const IndexType & b)
+    {
+      for ( unsigned int i = 2; i < ImageDimension; i++ )
+        {
+        if ( a[i] != b[i] )
+          {
+          return false;
+          }
+        }
+      return true;
+    }
+  };
+
+  static double SquaredDistance(const IndexType & a, const IndexType & b, const SpacingType & spacing);
+
+  static double Cross2D(const IndexType & o, const IndexType & a, const IndexType & b);
+
+  static void ConvexHull2D(typename IndexListType::const_iterator begin,
+                           typename IndexListType::const_iterator end,
+                           IndexListType & hull);
+
+  static double RotatingCalipers(const IndexListType & hull, const SpacingType & spacing);
+
   typedef itk::Offset<2>                                                          Offset2Type;
   typedef itk::Offset<3>                                                          Offset3Type;
   typedef itk::Vector<double, 2>                                                  Spacing2Type;
@@ -20,15 +20,13 @@
 
 #include "itkShapeLabelMapFilter.h"
 #include "itkProgressReporter.h"
-#include "itkConstNeighborhoodIterator.h"
 #include "itkConstShapedNeighborhoodIterator.h"
-#include "itkLabelMapToLabelImageFilter.h"
-#include "itkConstantBoundaryCondition.h"
 #include "itkGeometryUtilities.h"
 #include "itkConnectedComponentAlgorithm.h"
 #include "vnl/algo/vnl_real_eigensystem.h"
 #include "vnl/algo/vnl_symmetric_eigensystem.h"
 #include "vnl/vnl_math.h"
+#include <algorithm>
 #include <deque>
 #include <map>
 
@@ -49,21 +47,8 @@ ShapeLabelMapFilter< TImage, TLabelImage >
 {
   Superclass::BeforeThreadedGenerateData();
 
-  // Generate the label image, if needed
-  if ( m_ComputeFeretDiameter )
-    {
-    if ( !m_LabelImage )
-      {
-      // generate an image of the labelized image
-      typedef LabelMapToLabelImageFilter< TImage, LabelImageType > LCI2IType;
-      typename LCI2IType::Pointer lci2i = LCI2IType::New();
-      lci2i->SetInput( this->GetOutput() );
-      // Respect the number of threads of the filter
-      lci2i->SetNumberOfThreads( this->GetNumberOfThreads() );
-      lci2i->Update();
-      m_LabelImage = lci2i->GetOutput();
-      }
-    }
+  // Nothing more to prepare: the feret diameter is computed from the lines
+  // of the objects and doesn't need the label image anymore.
 }
 
 template< class TImage, class TLabelImage >
@@ -401,84 +386,210 @@ void
 ShapeLabelMapFilter< TImage, TLabelImage >
 ::ComputeFeretDiameter(LabelObjectType *labelObject)
 {
-  const LabelPixelType & label = labelObject->GetLabel();
-
-  typedef typename std::deque< IndexType > IndexListType;
-  IndexListType idxList;
+  // The feret diameter is the largest distance between two pixels of the
+  // object. Those two pixels are vertices of the convex hull of the object,
+  // so only the ends of the lines are candidates. The candidates are first
+  // reduced to the vertices of the 2D convex hull of each plane, then the
+  // farthest pair is found with rotating calipers in 2D, or by comparing all
+  // the remaining pairs in higher dimensions.
+  IndexListType candidates;
 
-  // the iterators
   typename LabelObjectType::LineContainerType::const_iterator lit;
   typename LabelObjectType::LineContainerType & lineContainer = labelObject->GetLineContainer();
 
-  typedef typename LabelObjectType::LengthType LengthType;
-
-  typedef typename itk::ConstNeighborhoodIterator< LabelImageType > NeighborIteratorType;
-  SizeType neighborHoodRadius;
-  neighborHoodRadius.Fill(1);
-  NeighborIteratorType                        it( neighborHoodRadius, m_LabelImage, m_LabelImage->GetBufferedRegion() );
-  ConstantBoundaryCondition< LabelImageType > lcbc;
-  // Use label + 1 to have a label different of the current label on the border
-  lcbc.SetConstant(label + 1);
-  it.OverrideBoundaryCondition(&lcbc);
-  it.GoToBegin();
+  for ( lit = lineContainer.begin(); lit != lineContainer.end(); lit++ )
+    {
+    IndexType idx = lit->GetIndex();
+    candidates.push_back(idx);
+    if ( lit->GetLength() > 1 )
+      {
+      idx[0] += lit->GetLength() - 1;
+      candidates.push_back(idx);
+      }
+    }
 
-  typedef typename NeighborIteratorType::NeighborIndexType   NeighborIndexType;
+  const typename ImageType::SpacingType & spacing = this->GetOutput()->GetSpacing();
 
-  // Iterate over all the lines
-  for ( lit = lineContainer.begin(); lit != lineContainer.end(); lit++ )
+  double feretDiameter = 0;
+  if ( ImageDimension == 1 )
     {
-    const IndexType & firstIdx = lit->GetIndex();
-    LengthType     length = lit->GetLength();
+    IndexValueType min = NumericTraits< IndexValueType >::max();
+    IndexValueType max = NumericTraits< IndexValueType >::NonpositiveMin();
+    for ( typename IndexListType::const_iterator iIt = candidates.begin(); iIt != candidates.end(); iIt++ )
+      {
+      min = vnl_math_min( min, ( *iIt )[0] );
+      max = vnl_math_max( max, ( *iIt )[0] );
+      }
+    if ( !candidates.empty() )
+      {
+      feretDiameter = vnl_math_sqr( ( max - min ) * spacing[0] );
+      }
+    }
+  else
+    {
+    std::sort( candidates.begin(), candidates.end(), IndexPlaneComparator() );
 
-    IndexValueType endIdx0 = firstIdx[0] + (OffsetValueType)length;
-    for ( IndexType idx = firstIdx; idx[0] < endIdx0; idx[0]++ )
+    IndexListType hull;
+    IndexListType planeHull;
+    typename IndexListType::const_iterator planeBegin = candidates.begin();
+    while ( planeBegin != candidates.end() )
       {
-      // Move the iterator to the new location
-      it += idx - it.GetIndex();
+      // search the end of the plane
+      typename IndexListType::const_iterator planeEnd = planeBegin;
+      while ( planeEnd != candidates.end() && IndexPlaneComparator::SamePlane(*planeBegin, *planeEnd) )
+        {
+        planeEnd++;
+        }
 
-      // Push the pixel in the list if it is on the border of the object
-      for ( NeighborIndexType i = 0; i < it.Size(); i++ )
+      Self::ConvexHull2D(planeBegin, planeEnd, planeHull);
+      if ( ImageDimension == 2 )
         {
-        if ( it.GetPixel(i) != label )
-          {
-          idxList.push_back(idx);
-          break;
-          }
+        // there is only one plane
+        feretDiameter = Self::RotatingCalipers(planeHull, spacing);
+        }
+      else
+        {
+        hull.insert( hull.end(), planeHull.begin(), planeHull.end() );
+        }
+      planeBegin = planeEnd;
+      }
+
+    for ( typename IndexListType::const_iterator iIt1 = hull.begin(); iIt1 != hull.end(); iIt1++ )
+      {
+      typename IndexListType::const_iterator iIt2 = iIt1;
+      for ( iIt2++; iIt2 != hull.end(); iIt2++ )
+        {
+        feretDiameter = vnl_math_max( feretDiameter, Self::SquaredDistance(*iIt1, *iIt2, spacing) );
         }
       }
     }
 
-  ImageType *output = this->GetOutput();
+  // Finally put the values in the label object
+  labelObject->SetFeretDiameter( vcl_sqrt(feretDiameter) );
+}
+
+template< class TImage, class TLabelImage >
+double
+ShapeLabelMapFilter< TImage, TLabelImage >
+::SquaredDistance(const IndexType & a, const IndexType & b, const SpacingType & spacing)
+{
+  double length = 0;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    length += vnl_math_sqr( ( a[i] - b[i] ) * spacing[i] );
+    }
+  return length;
+}
 
-  const typename ImageType::SpacingType & spacing = output->GetSpacing();
+template< class TImage, class TLabelImage >
+void
+ShapeLabelMapFilter< TImage, TLabelImage >
+::ConvexHull2D(typename IndexListType::const_iterator begin,
+               typename IndexListType::const_iterator end,
+               IndexListType & hull)
+{
+  // Andrew's monotone chain, in the plane of the dimensions 0 and 1. The
+  // points are sorted on the dimension 1, then on the dimension 0.
+  // Collinear points are removed from the hull.
+  const SizeValueType nbOfPoints = end - begin;
 
-  // We can now search the feret diameter
-  double feretDiameter = 0;
-  for ( typename IndexListType::const_iterator iIt1 = idxList.begin();
-        iIt1 != idxList.end();
-        iIt1++ )
+  hull.clear();
+  if ( nbOfPoints < 3 )
     {
-    typename IndexListType::const_iterator iIt2 = iIt1;
-    for ( iIt2++; iIt2 != idxList.end(); iIt2++ )
+    hull.insert(hull.end(), begin, end);
+    return;
+    }
+
+  hull.resize(2 * nbOfPoints);
+  SizeValueType k = 0;
+  // lower hull
+  for ( typename IndexListType::const_iterator it = begin; it != end; ++it )
+    {
+    while ( k >= 2 && Self::Cross2D(hull[k - 2], hull[k - 1], *it) <= 0 )
       {
-      // Compute the length between the 2 indexes
-      double length = 0;
-      for ( unsigned int i = 0; i < ImageDimension; i++ )
-        {
-        const OffsetValueType indexDifference = ( iIt1->operator[](i) - iIt2->operator[](i) );
-        length += vcl_pow(indexDifference * spacing[i], 2);
-        }
-      if ( feretDiameter < length )
+      k--;
+      }
+    hull[k++] = *it;
+    }
+  // upper hull
+  const SizeValueType lowerSize = k + 1;
+  for ( typename IndexListType::const_iterator it = end - 2; ; --it )
+    {
+    while ( k >= lowerSize && Self::Cross2D(hull[k - 2], hull[k - 1], *it) <= 0 )
+      {
+      k--;
+      }
+    hull[k++] = *it;
+    if ( it == begin )
+      {
+      break;
+      }
+    }
+  // the first point is repeated at the end
+  hull.resize(k - 1);
+}
+
+template< class TImage, class TLabelImage >
+double
+ShapeLabelMapFilter< TImage, TLabelImage >
+::Cross2D(const IndexType & o, const IndexType & a, const IndexType & b)
+{
+  const unsigned int d1 = ( ImageDimension > 1 ) ? 1 : 0;
+
+  return static_cast< double >( a[d1] - o[d1] ) * static_cast< double >( b[0] - o[0] )
+         - static_cast< double >( a[0] - o[0] ) * static_cast< double >( b[d1] - o[d1] );
+}
+
+template< class TImage, class TLabelImage >
+double
+ShapeLabelMapFilter< TImage, TLabelImage >
+::RotatingCalipers(const IndexListType & hull, const SpacingType & spacing)
+{
+  const SizeValueType nbOfPoints = hull.size();
+  const unsigned int  d1 = ( ImageDimension > 1 ) ? 1 : 0;
+
+  if ( nbOfPoints < 2 )
+    {
+    return 0;
+    }
+  if ( nbOfPoints == 2 )
+    {
+    return Self::SquaredDistance(hull[0], hull[1], spacing);
+    }
+
+  // the polygon in physical coordinates - a scaling keeps it convex
+  std::vector< double > x(nbOfPoints);
+  std::vector< double > y(nbOfPoints);
+  for ( SizeValueType i = 0; i < nbOfPoints; i++ )
+    {
+    x[i] = hull[i][0] * spacing[0];
+    y[i] = hull[i][d1] * spacing[d1];
+    }
+
+  // for each edge, move the opposite caliper to the farthest vertex, and
+  // check the antipodal pairs
+  double        feretDiameter = 0;
+  SizeValueType k = 1;
+  for ( SizeValueType i = 0; i < nbOfPoints; i++ )
+    {
+    const SizeValueType j = ( i + 1 ) % nbOfPoints;
+    const double        ex = x[j] - x[i];
+    const double        ey = y[j] - y[i];
+    while ( true )
+      {
+      const SizeValueType k1 = ( k + 1 ) % nbOfPoints;
+      const double        area = vcl_abs( ex * ( y[k] - y[i] ) - ey * ( x[k] - x[i] ) );
+      const double        area1 = vcl_abs( ex * ( y[k1] - y[i] ) - ey * ( x[k1] - x[i] ) );
+      if ( area1 <= area )
         {
-        feretDiameter = length;
+        break;
         }
+      k = k1;
       }
+    feretDiameter = vnl_math_max( feretDiameter, Self::SquaredDistance(hull[i], hull[k], spacing) );
+    feretDiameter = vnl_math_max( feretDiameter, Self::SquaredDistance(hull[j], hull[k], spacing) );
     }
-  // Final computation
-  feretDiameter = vcl_sqrt(feretDiameter);
-
-  // Finally put the values in the label object
-  labelObject->SetFeretDiameter(feretDiameter);
+  return feretDiameter;
 }
 
 template< class TImage, class TLabelImage >
@@ -528,11 +639,11 @@ ShapeLabelMapFilter< TImage, TLabelImage >
     lineImage->GetPixel( lIdx ).push_back( *lit );
     }
 
-  // a data structure to store the number of intercepts on each direction
-  typedef typename std::map<OffsetType, SizeValueType, typename OffsetType::LexicographicCompare> MapInterceptType;
-  MapInterceptType intercepts;
-  // int nbOfDirections = (int)vcl_pow( 2.0, (int)ImageDimension ) - 1;
-  // intecepts.resize(nbOfDirections + 1);  // code begins at position 1
+  // a data structure to store the number of intercepts on each direction.
+  // The components of the directions are 0 or 1, so the counts are stored in
+  // an array indexed by the bit pattern of the direction, to avoid a map
+  // lookup in the inner loop.
+  std::vector< SizeValueType > interceptCounts( 1 << ImageDimension, 0 );
 
   // now iterate over the vectors of lines
   typedef ConstShapedNeighborhoodIterator< LineImageType > LineImageIteratorType;
@@ -543,11 +654,8 @@ ShapeLabelMapFilter< TImage, TLabelImage >
     const VectorLineType & ls = lIt.GetCenterPixel();
 
     // there are two intercepts on the 0 axis for each line
-    OffsetType no;
-    no.Fill(0);
-    no[0] = 1;
-    // std::cout << no << "-> " << 2 * ls.size() << std::endl;
-    intercepts[no] += 2 * ls.size();
+    // std::cout << "1 -> " << 2 * ls.size() << std::endl;
+    interceptCounts[1] += 2 * ls.size();
 
     // and look at the neighbors
     typename LineImageIteratorType::ConstIterator ci;
@@ -558,13 +666,16 @@ ShapeLabelMapFilter< TImage, TLabelImage >
       const VectorLineType & ns = ci.Get();
       // prepare the offset to be stored in the intercepts map
       typename LineImageType::OffsetType lno = ci.GetNeighborhoodOffset();
-      no[0] = 0;
+      SizeValueType no = 0;
       for( int i=0; i<ImageDimension-1; i++ )
         {
-        no[i+1] = vnl_math_abs(lno[i]);
+        if( lno[i] != 0 )
+          {
+          no |= 2 << i;
+          }
         }
-      OffsetType dno = no; // offset for the diagonal
-      dno[0] = 1;
+      SizeValueType & nCount = interceptCounts[no];
+      SizeValueType & dCount = interceptCounts[no | 1]; // the diagonal
 
       // now process the two lines to search the pixels on the contour of the object
       if( ls.empty() )
@@ -580,9 +691,9 @@ ShapeLabelMapFilter< TImage, TLabelImage >
           // std::cout << "ns.empty()" << std::endl;
           const typename LabelObjectType::LineType & l = *li;
           // add as much intercepts as the line size
-          intercepts[no] += l.GetLength();
+          nCount += l.GetLength();
           // and 2 times as much diagonal intercepts as the line size
-          intercepts[dno] += l.GetLength() * 2;
+          dCount += l.GetLength() * 2;
           }
         }
       else
@@ -607,7 +718,7 @@ ShapeLabelMapFilter< TImage, TLabelImage >
           lMax = lMin + li->GetLength() - 1;
 
           // add as much intercepts as intersections of the 2 lines
-          intercepts[no] += vnl_math_max( lZero, vnl_math_min(lMax, nMax) - vnl_math_max(lMin, nMin) + 1 );
+          nCount += vnl_math_max( lZero, vnl_math_min(lMax, nMax) - vnl_math_max(lMin, nMin) + 1 );
           // std::cout << "============" << std::endl;
           // std::cout << "  lMin:" << lMin << " lMax:" << lMax << " nMin:" << nMin << " nMax:" << nMax;
           // std::cout << " count: " << vnl_math_max( 0l, vnl_math_min(lMax, nMax) - vnl_math_max(lMin, nMin) + 1 ) << std::endl;
@@ -615,9 +726,9 @@ ShapeLabelMapFilter< TImage, TLabelImage >
           // std::cout << vnl_math_max( lZero, vnl_math_min(lMax, nMax+1) - vnl_math_max(lMin, nMin+1) + 1 ) << std::endl;
           // std::cout << vnl_math_max( lZero, vnl_math_min(lMax, nMax-1) - vnl_math_max(lMin, nMin-1) + 1 ) << std::endl;
           // left diagonal intercepts
-          intercepts[dno] += vnl_math_max( lZero, vnl_math_min(lMax, nMax+1) - vnl_math_max(lMin, nMin+1) + 1 );
+          dCount += vnl_math_max( lZero, vnl_math_min(lMax, nMax+1) - vnl_math_max(lMin, nMin+1) + 1 );
           // right diagonal intercepts
-          intercepts[dno] += vnl_math_max( lZero, vnl_math_min(lMax, nMax-1) - vnl_math_max(lMin, nMin-1) + 1 );
+          dCount += vnl_math_max( lZero, vnl_math_min(lMax, nMax-1) - vnl_math_max(lMin, nMin-1) + 1 );
 
           // go to the next line or the next neighbor depending on where we are
           if(nMax <= lMax )
@@ -646,6 +757,19 @@ ShapeLabelMapFilter< TImage, TLabelImage >
       }
     }
 
+  // store the counts in the structure used to compute the perimeter
+  typedef typename std::map<OffsetType, SizeValueType, typename OffsetType::LexicographicCompare> MapInterceptType;
+  MapInterceptType intercepts;
+  for( SizeValueType c = 1; c < interceptCounts.size(); c++ )
+    {
+    OffsetType no;
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      no[i] = ( c >> i ) & 1;
+      }
+    intercepts[no] = interceptCounts[c];
+    }
+
   // compute the perimeter based on the intercept counts
   double perimeter = PerimeterFromInterceptCount( intercepts, this->GetOutput()->GetSpacing() );
   labelObject->SetPerimeter( perimeter );
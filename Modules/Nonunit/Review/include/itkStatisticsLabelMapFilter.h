@@ -122,6 +122,17 @@ public:
   itkGetConstReferenceMacro(ComputeHistogram, bool);
   itkBooleanMacro(ComputeHistogram);
 
+  /**
+   * Set/Get whether the moments weighted by the feature image should be computed
+   * or not: the center of gravity, the weighted principal moments and axes, the
+   * weighted elongation and the weighted flatness. This option defaults to `true`.
+   * Turning it off saves a large part of the computation time when those attributes
+   * are not required.
+   */
+  itkSetMacro(ComputeWeightedMoments, bool);
+  itkGetConstReferenceMacro(ComputeWeightedMoments, bool);
+  itkBooleanMacro(ComputeWeightedMoments);
+
   /**
    * Set/Get the number of bins in the histogram. Note that the histogram is used
    * to compute the median value, and that this option may have an effect on the
@@ -147,6 +158,7 @@ private:
   FeatureImagePixelType m_Maximum;
   unsigned int          m_NumberOfBins;
   bool                  m_ComputeHistogram;
+  bool                  m_ComputeWeightedMoments;
 }; // end of class
 } // end namespace itk
 
@@ -33,6 +33,7 @@ StatisticsLabelMapFilter< TImage, TFeatureImage >
 {
   m_NumberOfBins = 128;
   m_ComputeHistogram = true;
+  m_ComputeWeightedMoments = true;
   this->SetNumberOfRequiredInputs(2);
 }
 
@@ -106,14 +107,30 @@ StatisticsLabelMapFilter< TImage, TFeatureImage >
   VectorType principalMoments;
   principalMoments.Fill(0);
 
+  // the physical positions are updated incrementally along the lines
+  PointType physicalPosition;
+  PointType nextPhysicalPosition;
+  IndexType nextIdx;
+  nextIdx.Fill(0);
+  output->TransformIndexToPhysicalPoint(nextIdx, physicalPosition);
+  nextIdx[0] = 1;
+  output->TransformIndexToPhysicalPoint(nextIdx, nextPhysicalPosition);
+  const typename PointType::VectorType physicalStep = nextPhysicalPosition - physicalPosition;
+
+  typename HistogramType::MeasurementVectorType mv;
+  mv.SetSize(1);
+
   // iterate over all the lines
   for ( lit = lineContainer.begin(); lit != lineContainer.end(); lit++ )
     {
     const IndexType & firstIdx = lit->GetIndex();
     OffsetValueType     length = lit->GetLength();
 
-    typename HistogramType::MeasurementVectorType mv;
-    mv.SetSize(1);
+    if ( m_ComputeWeightedMoments )
+      {
+      output->TransformIndexToPhysicalPoint(firstIdx, physicalPosition);
+      }
+
     IndexValueType endIdx0 = firstIdx[0] + length;
     for ( IndexType idx = firstIdx; idx[0] < endIdx0; idx[0]++ )
       {
@@ -134,24 +151,28 @@ StatisticsLabelMapFilter< TImage, TFeatureImage >
         }
 
       //increase the sums
-      sum += v;
-      sum2 += vcl_pow( (double)v, 2 );
-      sum3 += vcl_pow( (double)v, 3 );
-      sum4 += vcl_pow( (double)v, 4 );
+      const double dv = v;
+      const double dv2 = dv * dv;
+      sum += dv;
+      sum2 += dv2;
+      sum3 += dv2 * dv;
+      sum4 += dv2 * dv2;
 
       // moments
-      PointType physicalPosition;
-      output->TransformIndexToPhysicalPoint(idx, physicalPosition);
-      for ( unsigned int i = 0; i < ImageDimension; i++ )
+      if ( m_ComputeWeightedMoments )
         {
-        centerOfGravity[i] += physicalPosition[i] * v;
-        centralMoments[i][i] += v * physicalPosition[i] * physicalPosition[i];
-        for ( unsigned int j = i + 1; j < ImageDimension; j++ )
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
           {
-          double weight = v * physicalPosition[i] * physicalPosition[j];
-          centralMoments[i][j] += weight;
-          centralMoments[j][i] += weight;
+          centerOfGravity[i] += physicalPosition[i] * v;
+          centralMoments[i][i] += v * physicalPosition[i] * physicalPosition[i];
+          for ( unsigned int j = i + 1; j < ImageDimension; j++ )
+            {
+            double weight = v * physicalPosition[i] * physicalPosition[j];
+            centralMoments[i][j] += weight;
+            centralMoments[j][i] += weight;
+            }
           }
+        physicalPosition += physicalStep;
         }
       }
     }
@@ -199,7 +220,7 @@ StatisticsLabelMapFilter< TImage, TFeatureImage >
 
   double elongation = 0;
   double flatness = 0;
-  if ( sum != 0 )
+  if ( m_ComputeWeightedMoments && sum != 0 )
     {
     // Normalize using the total mass
     for ( unsigned int i = 0; i < ImageDimension; i++ )
@@ -313,6 +334,7 @@ StatisticsLabelMapFilter< TImage, TFeatureImage >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "ComputeHistogram: " << m_ComputeHistogram << std::endl;
+  os << indent << "ComputeWeightedMoments: " << m_ComputeWeightedMoments << std::endl;
   os << indent << "NumberOfBins: " << m_NumberOfBins << std::endl;
 }
 } // end namespace itk
@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConvolutionImageFilter.h"
+#include "itkConstantBoundaryCondition.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "vnl/vnl_sample.h"
+
+// The frequency domain convolution must give the same result as the spatial
+// domain one, for odd and even kernel sizes, with normalization, with the
+// zero flux Neumann, constant and periodic boundary conditions and when only
+// part of the output is requested.
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer
+RandomImage(const typename TImage::SizeType & size, double minimum, double maximum)
+{
+  typename TImage::IndexType start;
+  start.Fill(2);
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( typename TImage::RegionType(start, size) );
+  image->Allocate();
+
+  itk::ImageRegionIterator< TImage > it( image, image->GetBufferedRegion() );
+  for (; !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< typename TImage::PixelType >( vnl_sample_uniform(minimum, maximum) ) );
+    }
+  return image;
+}
+
+template< class TImage >
+bool CompareWithSpatial(const typename TImage::SizeType & imageSize,
+                        const typename TImage::SizeType & kernelSize,
+                        bool normalize, unsigned int boundary, bool partial)
+{
+  typedef itk::ConvolutionImageFilter< TImage > FilterType;
+
+  typename TImage::Pointer image = RandomImage< TImage >(imageSize, 0.0, 100.0);
+  typename TImage::Pointer kernel = RandomImage< TImage >(kernelSize, -1.0, 2.0);
+
+  itk::ConstantBoundaryCondition< TImage > boundaryCondition;
+  boundaryCondition.SetConstant(7.0);
+  itk::PeriodicBoundaryCondition< TImage > periodicBoundaryCondition;
+
+  typename TImage::RegionType requested = image->GetLargestPossibleRegion();
+  if ( partial )
+    {
+    requested.PadByRadius(-2);
+    requested.SetIndex(0, requested.GetIndex(0) + 3);
+    requested.SetSize(0, requested.GetSize(0) - 3);
+    }
+
+  typename TImage::Pointer outputs[2];
+  for ( unsigned int useFFT = 0; useFFT < 2; useFFT++ )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetImageKernelInput(kernel);
+    filter->SetNormalize(normalize);
+    filter->SetUseFFT(useFFT);
+    filter->SetNumberOfThreads(3);
+    if ( boundary == 1 )
+      {
+      filter->SetBoundaryCondition(&boundaryCondition);
+      }
+    else if ( boundary == 2 )
+      {
+      filter->SetBoundaryCondition(&periodicBoundaryCondition);
+      }
+    filter->GetOutput()->SetRequestedRegion(requested);
+    filter->Update();
+    outputs[useFFT] = filter->GetOutput();
+    outputs[useFFT]->DisconnectPipeline();
+    }
+
+  double maximumError = 0.0;
+  double maximumValue = 0.0;
+  itk::ImageRegionConstIterator< TImage > sit(outputs[0], requested);
+  itk::ImageRegionConstIterator< TImage > fit(outputs[1], requested);
+  for (; !sit.IsAtEnd(); ++sit, ++fit )
+    {
+    maximumError = vnl_math_max( maximumError, static_cast< double >( vnl_math_abs( sit.Get() - fit.Get() ) ) );
+    maximumValue = vnl_math_max( maximumValue, static_cast< double >( vnl_math_abs( sit.Get() ) ) );
+    }
+
+  std::cout << "Image " << imageSize << ", kernel " << kernelSize << ", normalize " << normalize
+            << ", boundary condition " << boundary << ", partial " << partial
+            << ": maximum difference " << maximumError << std::endl;
+  if ( maximumError > 1e-5 * maximumValue )
+    {
+    std::cerr << "The frequency domain convolution differs from the spatial one" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkConvolutionImageFilterFFTTest(int, char *[])
+{
+  typedef itk::Image< float, 2 >  Image2DType;
+  typedef itk::Image< double, 3 > Image3DType;
+
+  bool pass = true;
+
+  Image2DType::SizeType imageSize2D;
+  imageSize2D[0] = 67;
+  imageSize2D[1] = 41;
+  Image2DType::SizeType kernelSize2D;
+  kernelSize2D[0] = 9;
+  kernelSize2D[1] = 5;
+  pass &= CompareWithSpatial< Image2DType >(imageSize2D, kernelSize2D, false, 0, false);
+  pass &= CompareWithSpatial< Image2DType >(imageSize2D, kernelSize2D, true, 1, true);
+  kernelSize2D[0] = 16;
+  kernelSize2D[1] = 1;
+  pass &= CompareWithSpatial< Image2DType >(imageSize2D, kernelSize2D, false, 2, false);
+  kernelSize2D[0] = 30;
+  kernelSize2D[1] = 25;
+  pass &= CompareWithSpatial< Image2DType >(imageSize2D, kernelSize2D, true, 0, true);
+
+  Image3DType::SizeType imageSize3D;
+  imageSize3D[0] = 23;
+  imageSize3D[1] = 19;
+  imageSize3D[2] = 14;
+  Image3DType::SizeType kernelSize3D;
+  kernelSize3D[0] = 7;
+  kernelSize3D[1] = 4;
+  kernelSize3D[2] = 5;
+  pass &= CompareWithSpatial< Image3DType >(imageSize3D, kernelSize3D, false, 0, false);
+  pass &= CompareWithSpatial< Image3DType >(imageSize3D, kernelSize3D, true, 1, true);
+  pass &= CompareWithSpatial< Image3DType >(imageSize3D, kernelSize3D, false, 2, true);
+
+  if ( !pass )
+    {
+    std::cerr << "Test FAILED" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
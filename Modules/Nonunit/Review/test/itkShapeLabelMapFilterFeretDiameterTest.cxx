@@ -0,0 +1,126 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkLabelImageToShapeLabelMapFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "vnl/vnl_sample.h"
+#include <map>
+#include <vector>
+
+// Compare the feret diameter computed by ShapeLabelMapFilter with the
+// largest distance between all the pairs of pixels of the objects.
+template< unsigned int VDimension >
+int ShapeLabelMapFilterFeretDiameterTest(unsigned int sizePerDimension)
+{
+  typedef unsigned char                                 PixelType;
+  typedef itk::Image< PixelType, VDimension >           ImageType;
+  typedef itk::ShapeLabelObject< PixelType, VDimension > LabelObjectType;
+  typedef itk::LabelMap< LabelObjectType >              LabelMapType;
+
+  typename ImageType::Pointer image = ImageType::New();
+  typename ImageType::SizeType size;
+  size.Fill(sizePerDimension);
+  typename ImageType::IndexType start;
+  start.Fill(-3);
+  typename ImageType::RegionType region(start, size);
+  image->SetRegions(region);
+  typename ImageType::SpacingType spacing;
+  for ( unsigned int i = 0; i < VDimension; i++ )
+    {
+    spacing[i] = 0.7 + 0.3 * i;
+    }
+  image->SetSpacing(spacing);
+  image->Allocate();
+
+  // scattered objects, with some compact ones to get long lines
+  typedef std::vector< typename ImageType::IndexType > IndexListType;
+  typedef std::map< PixelType, IndexListType >         ObjectsType;
+  ObjectsType objects;
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename ImageType::IndexType & idx = it.GetIndex();
+    PixelType label = 0;
+    if ( idx[0] > 2 && idx[0] < 9 )
+      {
+      label = 1;
+      }
+    else if ( vnl_sample_uniform(0.0, 1.0) < 0.2 )
+      {
+      label = static_cast< PixelType >( 2 + vnl_sample_uniform(0.0, 4.0) );
+      }
+    it.Set(label);
+    if ( label != 0 )
+      {
+      objects[label].push_back(idx);
+      }
+    }
+
+  typedef itk::LabelImageToShapeLabelMapFilter< ImageType, LabelMapType > FilterType;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetComputeFeretDiameter(true);
+  filter->SetNumberOfThreads(3);
+  filter->Update();
+
+  int status = EXIT_SUCCESS;
+  for ( typename ObjectsType::const_iterator oIt = objects.begin(); oIt != objects.end(); ++oIt )
+    {
+    const IndexListType & idxList = oIt->second;
+    double expected = 0;
+    for ( unsigned int i = 0; i < idxList.size(); i++ )
+      {
+      for ( unsigned int j = i + 1; j < idxList.size(); j++ )
+        {
+        double length = 0;
+        for ( unsigned int d = 0; d < VDimension; d++ )
+          {
+          const double diff = ( idxList[i][d] - idxList[j][d] ) * spacing[d];
+          length += diff * diff;
+          }
+        expected = vnl_math_max(expected, length);
+        }
+      }
+    expected = vcl_sqrt(expected);
+
+    const double feretDiameter = filter->GetOutput()->GetLabelObject(oIt->first)->GetFeretDiameter();
+    if ( vcl_abs(feretDiameter - expected) > 1e-6 )
+      {
+      std::cerr << "Wrong feret diameter in " << VDimension << "D for label " << (int)oIt->first
+                << ": " << feretDiameter << " instead of " << expected << std::endl;
+      status = EXIT_FAILURE;
+      }
+    }
+  return status;
+}
+
+int itkShapeLabelMapFilterFeretDiameterTest(int, char *[])
+{
+  vnl_sample_reseed(4321);
+
+  int status = EXIT_SUCCESS;
+  if ( ShapeLabelMapFilterFeretDiameterTest< 2 >(40) == EXIT_FAILURE )
+    {
+    status = EXIT_FAILURE;
+    }
+  if ( ShapeLabelMapFilterFeretDiameterTest< 3 >(14) == EXIT_FAILURE )
+    {
+    status = EXIT_FAILURE;
+    }
+  return status;
+}
@@ -585,6 +585,18 @@ private:
 };
 } // end namespace itk
 
+// Define instantiation macro for this template.
+#define ITK_TEMPLATE_ImageToImageMetric(_, EXPORT, TypeX, TypeY)     \
+  namespace itk                                                      \
+  {                                                                  \
+  _( 2 ( class EXPORT ImageToImageMetric< ITK_TEMPLATE_2 TypeX > ) ) \
+  namespace Templates                                                \
+  {                                                                  \
+  typedef ImageToImageMetric< ITK_TEMPLATE_2 TypeX >                 \
+  ImageToImageMetric##TypeY;                                         \
+  }                                                                  \
+  }
+
 #ifndef ITK_MANUAL_INSTANTIATION
 #include "itkImageToImageMetric.txx"
 #endif
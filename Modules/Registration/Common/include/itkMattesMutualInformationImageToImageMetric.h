@@ -345,6 +345,18 @@ private:
 };
 } // end namespace itk
 
+// Define instantiation macro for this template.
+#define ITK_TEMPLATE_MattesMutualInformationImageToImageMetric(_, EXPORT, TypeX, TypeY)     \
+  namespace itk                                                                             \
+  {                                                                                         \
+  _( 2 ( class EXPORT MattesMutualInformationImageToImageMetric< ITK_TEMPLATE_2 TypeX > ) ) \
+  namespace Templates                                                                       \
+  {                                                                                         \
+  typedef MattesMutualInformationImageToImageMetric< ITK_TEMPLATE_2 TypeX >                 \
+  MattesMutualInformationImageToImageMetric##TypeY;                                         \
+  }                                                                                         \
+  }
+
 #ifndef ITK_MANUAL_INSTANTIATION
 #include "itkMattesMutualInformationImageToImageMetric.txx"
 #endif
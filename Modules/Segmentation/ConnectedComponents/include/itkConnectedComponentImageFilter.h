@@ -41,6 +41,21 @@ namespace itk
  * component image filter which did not produce consecutive labels or
  * impose any particular ordering.
  *
+ * The run length encoding, the union-find merge of the runs and the
+ * final relabeling are all performed by the threads. Each thread owns
+ * the contiguous range of run labels found in its output region, so
+ * the merges inside a region never touch the sets of another thread,
+ * and the merges across the region boundaries are performed pairwise
+ * in a tree reduction.
+ *
+ * When RelabelBySize is on, the filter also performs the job of
+ * RelabelComponentImageFilter: the objects are sorted by decreasing
+ * size (ties are broken by the raster order), the objects smaller
+ * than MinimumObjectSize are sent to the background, and the sizes
+ * of the objects are available through GetSizeOfObjectsInPixels().
+ * This avoids the two extra passes on the label image of a separate
+ * relabeling filter.
+ *
  * \sa ImageToImageFilter
  *
  * \ingroup Singlethreaded
@@ -131,9 +146,37 @@ public:
   /** Type used as identifier of the different component labels. */
   typedef IdentifierType   LabelType;
 
+  /** Type used to count number of pixels in objects. */
+  typedef SizeValueType ObjectSizeType;
+
+  typedef std::vector< ObjectSizeType > ObjectSizeInPixelsContainerType;
+
   // only set after completion
   itkGetConstReferenceMacro(ObjectCount, LabelType);
 
+  /**
+   * Set/Get whether the labels are sorted by decreasing object size, as
+   * RelabelComponentImageFilter does. Default is RelabelBySizeOff, which
+   * sorts the labels in raster order.
+   */
+  itkSetMacro(RelabelBySize, bool);
+  itkGetConstReferenceMacro(RelabelBySize, bool);
+  itkBooleanMacro(RelabelBySize);
+
+  /** Set/Get the minimum size in pixels of an object. The smaller objects
+   * are set to the background value. This parameter is only used when
+   * RelabelBySize is on. The default is 0, which keeps all the objects. */
+  itkSetMacro(MinimumObjectSize, ObjectSizeType);
+  itkGetConstMacro(MinimumObjectSize, ObjectSizeType);
+
+  /** Get the size of each object in pixels, in label order. This
+   * information is only computed when RelabelBySize is on, and is only
+   * valid after the filter has executed. */
+  const ObjectSizeInPixelsContainerType & GetSizeOfObjectsInPixels() const
+    {
+    return this->m_SizeOfObjectsInPixels;
+    }
+
   // Concept checking -- input and output dimensions must be the same
   itkConceptMacro( SameDimension,
                    ( Concept::SameDimension< itkGetStaticConstMacro(InputImageDimension),
@@ -159,6 +202,8 @@ protected:
   {
     m_FullyConnected = false;
     m_ObjectCount = 0;
+    m_RelabelBySize = false;
+    m_MinimumObjectSize = 0;
     m_BackgroundValue = NumericTraits< OutputImagePixelType >::Zero;
   }
 
@@ -190,6 +235,10 @@ protected:
 private:
   LabelType            m_ObjectCount;
   OutputImagePixelType m_BackgroundValue;
+  bool                 m_RelabelBySize;
+  ObjectSizeType       m_MinimumObjectSize;
+
+  ObjectSizeInPixelsContainerType m_SizeOfObjectsInPixels;
 
   // some additional types
   typedef typename TOutputImage::RegionType::SizeType OutSizeType;
@@ -228,7 +277,50 @@ public:
 
   void LinkLabels(const LabelType lab1, const LabelType lab2);
 
-  SizeValueType CreateConsecutive();
+  /** Point all the labels in [firstLabel, lastLabel) directly to the
+   * root of their set, and return the number of roots in that range. */
+  SizeValueType FlattenSets(const LabelType firstLabel, const LabelType lastLabel);
+
+  /** Convert the index of an object to its output label, skipping
+   * the background value. */
+  OutputPixelType ConsecutiveLabel(const SizeValueType objectIndex) const
+  {
+    if ( objectIndex >= static_cast< SizeValueType >( m_BackgroundValue ) )
+      {
+      return static_cast< OutputPixelType >( objectIndex + 1 );
+      }
+    return static_cast< OutputPixelType >( objectIndex );
+  }
+
+  /** Give consecutive labels to the roots in [firstLabel, lastLabel),
+   * starting at the object index firstObject. */
+  void CreateConsecutive(const LabelType firstLabel, const LabelType lastLabel,
+                         SizeValueType firstObject);
+
+  /** Give labels to the roots by decreasing size of their set, and
+   * discard the sets smaller than MinimumObjectSize. Return the number
+   * of objects kept. */
+  SizeValueType CreateConsecutiveBySize();
+
+  struct ObjectType {
+    LabelType m_Root;
+    ObjectSizeType m_SizeInPixels;
+  };
+
+  // sort the objects in descending order of size, and in raster order
+  // for the objects of the same size
+  class ObjectSizeComparator
+  {
+public:
+    bool operator()(const ObjectType & a, const ObjectType & b) const
+    {
+      if ( a.m_SizeInPixels != b.m_SizeInPixels )
+        {
+        return a.m_SizeInPixels > b.m_SizeInPixels;
+        }
+      return a.m_Root < b.m_Root;
+    }
+  };
 
   //////////////////
   bool CheckNeighbors(const OutputIndexType & A,
@@ -251,6 +343,7 @@ public:
   }
 
   typename std::vector< IdentifierType > m_NumberOfLabels;
+  typename std::vector< IdentifierType > m_NumberOfObjects;
   typename std::vector< IdentifierType > m_FirstLineIdToJoin;
 
   typename Barrier::Pointer m_Barrier;
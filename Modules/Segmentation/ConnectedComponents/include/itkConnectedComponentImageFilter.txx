@@ -27,6 +27,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkMaskImageFilter.h"
 #include "itkConnectedComponentAlgorithm.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -101,6 +102,9 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   // set up the vars used in the threads
   m_NumberOfLabels.clear();
   m_NumberOfLabels.resize(nbOfThreads, 0);
+  m_NumberOfObjects.clear();
+  m_NumberOfObjects.resize(nbOfThreads, 0);
+  m_SizeOfObjectsInPixels.clear();
   m_Barrier = Barrier::New();
   m_Barrier->Initialize(nbOfThreads);
   SizeValueType pixelcount = output->GetRequestedRegion().GetNumberOfPixels();
@@ -205,33 +209,42 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   // wait for the other threads to complete that part
   this->Wait();
 
-  // compute the total number of labels
+  // compute the total number of labels, and the range of labels
+  // owned by that thread
   nbOfLabels = 0;
+  LabelType firstLabelForThread = 1;
   for ( ThreadIdType i = 0; i < nbOfThreads; i++ )
     {
+    if ( i == threadId )
+      {
+      firstLabelForThread = nbOfLabels + 1;
+      }
     nbOfLabels += m_NumberOfLabels[i];
     }
+  const LabelType lastLabelForThread = firstLabelForThread + m_NumberOfLabels[threadId];
 
   if ( threadId == 0 )
     {
     // set up the union find structure
     InitUnion(nbOfLabels);
-    // insert all the labels into the structure -- an extra loop but
-    // saves complicating the ones that come later
-    typename LineMapType::iterator MapBegin, MapEnd, LineIt;
-    MapBegin = m_LineMap.begin();
-    MapEnd = m_LineMap.end();
-    LineIt = MapBegin;
-    SizeValueType label = 1;
-    for ( LineIt = MapBegin; LineIt != MapEnd; ++LineIt )
+    m_Consecutive = UnionFindType(nbOfLabels + 1);
+    }
+
+  // wait for the other threads to complete that part
+  this->Wait();
+
+  // insert the labels of the runs of that thread into the structure.
+  // The threads own consecutive groups of lines in raster order, so the
+  // labels are the same as the ones given by a single thread.
+  LabelType label = firstLabelForThread;
+  for ( lineId = firstLineIdForThread; lineId < firstLineIdForThread + linecountForThread; ++lineId )
+    {
+    typename lineEncoding::iterator cIt;
+    for ( cIt = m_LineMap[lineId].begin(); cIt != m_LineMap[lineId].end(); ++cIt )
       {
-      typename lineEncoding::iterator cIt;
-      for ( cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt )
-        {
-        cIt->label = label;
-        InsertSet(label);
-        label++;
-        }
+      cIt->label = label;
+      InsertSet(label);
+      label++;
       }
     }
 
@@ -334,9 +347,38 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
     this->Wait();
     }
 
-  if ( threadId == 0 )
+  // resolve the equivalences in parallel: all the labels of that thread
+  // are linked directly to the root of their set
+  m_NumberOfObjects[threadId] = this->FlattenSets(firstLabelForThread, lastLabelForThread);
+
+  this->Wait();
+
+  if ( m_RelabelBySize )
     {
-    m_ObjectCount = CreateConsecutive();
+    if ( threadId == 0 )
+      {
+      m_ObjectCount = this->CreateConsecutiveBySize();
+      }
+    }
+  else
+    {
+    // the roots of that thread are numbered after the ones of the
+    // previous threads
+    SizeValueType firstObjectForThread = 0;
+    SizeValueType objectCount = 0;
+    for ( ThreadIdType i = 0; i < nbOfThreads; i++ )
+      {
+      if ( i == threadId )
+        {
+        firstObjectForThread = objectCount;
+        }
+      objectCount += m_NumberOfObjects[i];
+      }
+    this->CreateConsecutive(firstLabelForThread, lastLabelForThread, firstObjectForThread);
+    if ( threadId == 0 )
+      {
+      m_ObjectCount = objectCount;
+      }
     }
 
   this->Wait();
@@ -383,8 +425,8 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 
     for ( cIt = m_LineMap[ThisIdx].begin(); cIt != m_LineMap[ThisIdx].end(); ++cIt )
       {
-      SizeValueType   Ilab = LookupSet(cIt->label);
-      OutputPixelType lab = m_Consecutive[Ilab];
+      // the sets are flat at that point, no need to look up recursively
+      OutputPixelType lab = static_cast< OutputPixelType >( m_Consecutive[m_UnionFind[cIt->label]] );
       oit.SetIndex(cIt->where);
       // initialize the non labelled pixels
       for (; fstart != oit; ++fstart )
@@ -413,6 +455,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 ::AfterThreadedGenerateData()
 {
   m_NumberOfLabels.clear();
+  m_NumberOfObjects.clear();
   m_Barrier = NULL;
   m_LineMap.clear();
   m_Input = NULL;
@@ -602,27 +645,85 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 template< class TInputImage, class TOutputImage, class TMaskImage >
 SizeValueType
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
-::CreateConsecutive()
+::FlattenSets(const LabelType firstLabel, const LabelType lastLabel)
+{
+  // LookupSet() may compress paths going through the labels of the other
+  // threads. This is safe without any lock: the roots don't change
+  // anymore, and a compression only replaces a parent by an ancestor, so
+  // all the threads write the same value and always find the same root.
+  SizeValueType count = 0;
+
+  for ( LabelType I = firstLabel; I < lastLabel; I++ )
+    {
+    if ( this->LookupSet(I) == I )
+      {
+      ++count;
+      }
+    }
+  return count;
+}
+
+template< class TInputImage, class TOutputImage, class TMaskImage >
+void
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::CreateConsecutive(const LabelType firstLabel, const LabelType lastLabel,
+                    SizeValueType firstObject)
 {
-  m_Consecutive = UnionFindType( m_UnionFind.size() );
+  SizeValueType count = firstObject;
 
-  const LabelType background = static_cast< LabelType >( this->m_BackgroundValue );
+  for ( LabelType I = firstLabel; I < lastLabel; I++ )
+    {
+    if ( m_UnionFind[I] == I )
+      {
+      m_Consecutive[I] = this->ConsecutiveLabel(count);
+      ++count;
+      }
+    }
+}
 
-  m_Consecutive[background] = background;
+template< class TInputImage, class TOutputImage, class TMaskImage >
+SizeValueType
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::CreateConsecutiveBySize()
+{
+  // accumulate the size of the runs in their root. The sizes are computed
+  // from the run length encoding, without reading the image.
+  typename LineMapType::const_iterator LineIt;
+  for ( LineIt = m_LineMap.begin(); LineIt != m_LineMap.end(); ++LineIt )
+    {
+    typename lineEncoding::const_iterator cIt;
+    for ( cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt )
+      {
+      m_Consecutive[m_UnionFind[cIt->label]] += cIt->length;
+      }
+    }
+
+  typedef std::vector< ObjectType > ObjectVectorType;
+  ObjectVectorType objects;
+  for ( LabelType I = 1; I < m_UnionFind.size(); I++ )
+    {
+    if ( m_UnionFind[I] == I )
+      {
+      ObjectType object;
+      object.m_Root = I;
+      object.m_SizeInPixels = m_Consecutive[I];
+      objects.push_back(object);
+      }
+    }
+  std::sort( objects.begin(), objects.end(), ObjectSizeComparator() );
 
-  SizeValueType CLab = 0;
   SizeValueType count = 0;
-  for ( SizeValueType I = 1; I < m_UnionFind.size(); I++ )
+  for ( typename ObjectVectorType::const_iterator oIt = objects.begin();
+        oIt != objects.end(); ++oIt )
     {
-    SizeValueType L = m_UnionFind[I];
-    if ( L == I )
+    if ( m_MinimumObjectSize > 0 && oIt->m_SizeInPixels < m_MinimumObjectSize )
       {
-      if ( CLab == static_cast< SizeValueType >( m_BackgroundValue ) )
-        {
-        ++CLab;
-        }
-      m_Consecutive[L] = CLab;
-      ++CLab;
+      m_Consecutive[oIt->m_Root] = static_cast< LabelType >( m_BackgroundValue );
+      }
+    else
+      {
+      m_Consecutive[oIt->m_Root] = this->ConsecutiveLabel(count);
+      m_SizeOfObjectsInPixels.push_back(oIt->m_SizeInPixels);
       ++count;
       }
     }
@@ -669,6 +770,8 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 
   os << indent << "FullyConnected: "  << m_FullyConnected << std::endl;
   os << indent << "ObjectCount: "  << m_ObjectCount << std::endl;
+  os << indent << "RelabelBySize: "  << m_RelabelBySize << std::endl;
+  os << indent << "MinimumObjectSize: "  << m_MinimumObjectSize << std::endl;
   os << indent << "BackgroundValue: "
      << static_cast< typename NumericTraits< OutputImagePixelType >::PrintType >( m_BackgroundValue ) << std::endl;
 }
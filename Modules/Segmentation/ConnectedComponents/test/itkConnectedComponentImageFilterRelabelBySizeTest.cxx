@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#if defined(_MSC_VER)
+#pragma warning ( disable : 4786 )
+#endif
+#include "itkConnectedComponentImageFilter.h"
+#include "itkRelabelComponentImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkSimpleFilterWatcher.h"
+#include "vnl/vnl_sample.h"
+
+// Compare the fused "label and relabel by size" mode of
+// ConnectedComponentImageFilter with the ConnectedComponentImageFilter +
+// RelabelComponentImageFilter pipeline, for several numbers of threads.
+int itkConnectedComponentImageFilterRelabelBySizeTest(int itkNotUsed(argc), char*[] itkNotUsed(argv))
+{
+  typedef unsigned char  InputPixelType;
+  typedef unsigned int   OutputPixelType;
+  const   unsigned int   Dimension = 3;
+
+  typedef itk::Image< InputPixelType, Dimension >  InputImageType;
+  typedef itk::Image< OutputPixelType, Dimension > OutputImageType;
+
+  // random sparse binary image with objects of many sizes
+  InputImageType::Pointer img = InputImageType::New();
+  InputImageType::SizeType size;
+  size.Fill( 40 );
+  img->SetRegions( size );
+  img->Allocate();
+
+  vnl_sample_reseed( 1234 );
+  itk::ImageRegionIterator< InputImageType > it( img, img->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( vnl_sample_uniform( 0.0, 1.0 ) < 0.3 ? 1 : 0 );
+    }
+
+  typedef itk::ConnectedComponentImageFilter< InputImageType, OutputImageType > FilterType;
+  typedef itk::RelabelComponentImageFilter< OutputImageType, OutputImageType >  RelabelType;
+
+  const FilterType::ObjectSizeType minimumObjectSize = 3;
+
+  for( unsigned int fullyConnected = 0; fullyConnected < 2; fullyConnected++ )
+    {
+    FilterType::Pointer reference = FilterType::New();
+    reference->SetInput( img );
+    reference->SetFullyConnected( fullyConnected != 0 );
+    reference->SetNumberOfThreads( 1 );
+
+    RelabelType::Pointer relabel = RelabelType::New();
+    relabel->SetInput( reference->GetOutput() );
+    relabel->SetMinimumObjectSize( minimumObjectSize );
+    relabel->Update();
+
+    for( unsigned int threads = 1; threads <= 4; threads++ )
+      {
+      FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( img );
+      filter->SetFullyConnected( fullyConnected != 0 );
+      filter->SetNumberOfThreads( threads );
+      filter->RelabelBySizeOn();
+      filter->SetMinimumObjectSize( minimumObjectSize );
+      itk::SimpleFilterWatcher watcher( filter );
+      watcher.QuietOn();
+      filter->Update();
+
+      if( filter->GetObjectCount() != relabel->GetNumberOfObjects() )
+        {
+        std::cerr << "Wrong number of objects with " << threads << " threads: "
+                  << filter->GetObjectCount() << " instead of "
+                  << relabel->GetNumberOfObjects() << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      if( filter->GetSizeOfObjectsInPixels() != relabel->GetSizeOfObjectsInPixels() )
+        {
+        std::cerr << "Wrong object sizes with " << threads << " threads" << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      itk::ImageRegionConstIterator< OutputImageType >
+        rit( relabel->GetOutput(), relabel->GetOutput()->GetLargestPossibleRegion() );
+      itk::ImageRegionConstIterator< OutputImageType >
+        fit( filter->GetOutput(), filter->GetOutput()->GetLargestPossibleRegion() );
+      for( ; !rit.IsAtEnd(); ++rit, ++fit )
+        {
+        if( rit.Get() != fit.Get() )
+          {
+          std::cerr << "Wrong label at " << rit.GetIndex() << " with " << threads
+                    << " threads: " << fit.Get() << " instead of " << rit.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      // the default mode must still give the labels in raster order
+      filter->RelabelBySizeOff();
+      filter->Update();
+      if( filter->GetObjectCount() != relabel->GetOriginalNumberOfObjects() )
+        {
+        std::cerr << "Wrong number of objects in raster order mode with " << threads
+                  << " threads" << std::endl;
+        return EXIT_FAILURE;
+        }
+      itk::ImageRegionConstIterator< OutputImageType >
+        cit( reference->GetOutput(), reference->GetOutput()->GetLargestPossibleRegion() );
+      for( fit.GoToBegin(); !cit.IsAtEnd(); ++cit, ++fit )
+        {
+        if( cit.Get() != fit.Get() )
+          {
+          std::cerr << "Wrong raster order label at " << cit.GetIndex() << " with " << threads
+                    << " threads: " << fit.Get() << " instead of " << cit.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}